@@ -943,7 +943,7 @@ static void rdcu_compression_cmp_lib_demo(void)
 	if (1) {
 		uint32_t i;
 		uint32_t s = example_info.samples_used * sizeof(uint16_t);
-		uint8_t *mymodel = malloc(s);
+		uint16_t *mymodel = malloc(s);
 
 		if (!mymodel) {
 			printf("malloc failed!\n");
@@ -956,9 +956,10 @@ static void rdcu_compression_cmp_lib_demo(void)
 		printf("\n\nHere's the updated model (size %lu):\n"
 		       "====================================\n", s);
 
-		for (i = 0; i < s; i++) {
-			printf("%02X ", mymodel[i]);
-			if (i && !((i+1) % 40))
+		/* the model is returned in host byte order */
+		for (i = 0; i < example_info.samples_used; i++) {
+			printf("%04X ", mymodel[i]);
+			if (i && !((i+1) % 20))
 				printf("\n");
 		}
 		printf("\n");
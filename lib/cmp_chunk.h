@@ -27,6 +27,9 @@
 #include "common/cmp_entity.h"
 #include "common/cmp_error_list.h"
 
+/* maximum number of size estimation passes of the compress_chunk_budget() function */
+#define CMP_BUDGET_MAX_PASSES	16
+
 /* valid specific compression parameter ranges for chunk compression
  * (every parameter except cmp_mode, model_value, lossy_par)
  */
@@ -77,7 +80,7 @@
 struct cmp_par {
 	enum cmp_mode cmp_mode;		/**< compression mode parameter */
 	uint32_t model_value;		/**< model weighting parameter */
-	uint32_t lossy_par;		/**< lossy compression parameter */
+	uint32_t lossy_par;		/**< lossy compression parameter; only honoured for imagette, offset/background, smearing and fast chain chunks */
 
 	uint32_t nc_imagette;		/**< compression parameter for imagette compression */
 
@@ -112,6 +115,114 @@ struct cmp_par {
 	uint32_t fc_background_mean;		/**< compression parameter for fast camera background mean data */
 	uint32_t fc_background_variance;	/**< compression parameter for fast camera background variance data */
 	uint32_t fc_background_outlier_pixels;	/**< compression parameter for fast camera background outlier pixels data */
+
+	uint32_t f_fx;				/**< compression parameter for fast cadence normal flux data */
+	uint32_t f_ncob;			/**< compression parameter for fast cadence normal center of brightness data */
+	uint32_t f_efx;				/**< compression parameter for fast cadence extended flux data */
+	uint32_t f_ecob;			/**< compression parameter for fast cadence extended center of brightness data */
+};
+
+
+/* number of specific compression parameters in the cmp_par structure */
+#define CMP_PAR_NUM_SPECIFIC	31
+
+
+/* maximum number of differently encoded fields in a collection */
+#define CMP_STATS_MAX_FIELDS	7
+
+
+/**
+ * @struct cmp_field_stats
+ * @brief compression statistics of a collection field
+ *
+ * A field contains all values of a collection that are encoded together
+ * (e.g. the ncob_x and ncob_y values of a S_FX_NCOB collection). The fields
+ * are in the order in which they appear in a sample.
+ */
+
+struct cmp_field_stats {
+	uint32_t cmp_par;	/**< used compression parameter */
+	uint32_t spill;		/**< used spillover threshold parameter */
+	uint32_t values;	/**< number of encoded values */
+	uint32_t bits;		/**< number of bits used to encode the values */
+	uint32_t outliers;	/**< number of outliers; every outlier is signalled with one escape symbol */
+	uint32_t outlier_bits;	/**< number of unencoded outlier bits (included in bits) */
+	int32_t residual_min;	/**< smallest residual (data - model); 0 if no value was encoded */
+	int32_t residual_max;	/**< largest residual (data - model); 0 if no value was encoded */
+	int64_t residual_sum;	/**< sum of the residuals; mean = residual_sum / values */
+};
+
+
+/**
+ * @struct cmp_col_stats
+ * @brief compression statistics of a collection
+ */
+
+struct cmp_col_stats {
+	enum cmp_data_type data_type;	/**< data type of the collection */
+	uint32_t samples;		/**< number of samples in the collection */
+	uint32_t cmp_bits;		/**< compressed size of the collection data in bits (without collection header and padding) */
+	uint32_t raw_fallback;		/**< non-zero if the collection was not compressible and was stored uncompressed */
+	uint32_t num_fields;		/**< number of valid entries in the field array */
+	struct cmp_field_stats field[CMP_STATS_MAX_FIELDS]; /**< statistics of the encoded fields; on a raw fallback they cover the values encoded until the compression was aborted */
+};
+
+
+/**
+ * @struct cmp_stats
+ * @brief compression statistics sink for the compress_chunk() function
+ */
+
+struct cmp_stats {
+	struct cmp_col_stats *col;	/**< array to store the collection statistics */
+	uint32_t max_cols;		/**< number of elements in the col array */
+	uint32_t num_cols;		/**< number of collections seen by the last compress_chunk() call; can be larger than max_cols */
+};
+
+
+/**
+ * @struct cmp_chunk_iov
+ * @brief a piece of a chunk for the compress_chunk_iov() function
+ */
+
+struct cmp_chunk_iov {
+	const void *data;	/**< one or more complete collections (collection header followed by the data) */
+	const void *model;	/**< model of the collections; same size as the data (can be NULL if no model compression mode is used) */
+	void *up_model;		/**< buffer to store the updated model of the collections (can be the same as the model buffer or NULL) */
+	uint32_t size;		/**< byte size of the collections */
+};
+
+
+/**
+ * @struct cmp_col_desc
+ * @brief descriptor of a collection produced by the compress_chunk_scan()
+ *	function
+ */
+
+struct cmp_col_desc {
+	uint32_t offset;		/**< byte offset of the collection header from the chunk start */
+	uint32_t size;			/**< byte size of the collection including the collection header */
+	enum cmp_data_type data_type;	/**< compression data type of the collection */
+	uint32_t samples;		/**< number of samples in the collection */
+};
+
+
+/* size of the staging buffer of a segmented output sink; fits the largest
+ * compressed collection
+ */
+#define CMP_SEG_STAGE_SIZE	ROUND_UP_TO_4(CMP_COLLECTION_FILD_SIZE + COLLECTION_HDR_SIZE + UINT16_MAX)
+
+
+/**
+ * @struct cmp_seg_sink
+ * @brief segmented output sink for the compress_chunk_seg() function
+ */
+
+struct cmp_seg_sink {
+	void *const *seg;	/**< array of pointers to the segments (e.g. telemetry packet payloads) */
+	uint32_t num_seg;	/**< number of segments */
+	uint32_t seg_size;	/**< byte size of every segment */
+	uint32_t *stage;	/**< 4-byte aligned staging buffer of CMP_SEG_STAGE_SIZE bytes */
 };
 
 
@@ -136,6 +247,31 @@ struct cmp_par {
 uint32_t compress_chunk_cmp_size_bound(const void *chunk, size_t chunk_size);
 
 
+/**
+ * @brief check all collection headers of a chunk and build a descriptor array
+ *
+ * The collection headers are decoded once: the collection sizes have to add
+ * up to the chunk size, all collections have to belong to the same chunk type
+ * and every collection has to hold a whole number of samples.
+ *
+ * @note the returned number of collections can be used with the
+ *	COMPRESS_CHUNK_BOUND macro to get the compressed size bound without
+ *	walking the chunk again
+ *
+ * @param chunk		pointer to the chunk to check
+ * @param chunk_size	byte size of the chunk
+ * @param desc		pointer to an array to store a descriptor for every
+ *			collection (can be NULL to only check the chunk)
+ * @param max_desc	number of entries in the desc array
+ *
+ * @returns the number of collections in the chunk or an error code if it
+ *	fails (which can be tested with cmp_is_error())
+ */
+
+uint32_t compress_chunk_scan(const void *chunk, uint32_t chunk_size,
+			     struct cmp_col_desc *desc, uint32_t max_desc);
+
+
 /**
  * @brief initialise the compress_chunk() function
  *
@@ -150,6 +286,23 @@ uint32_t compress_chunk_cmp_size_bound(const void *chunk, size_t chunk_size);
 void compress_chunk_init(uint64_t (*return_timestamp)(void), uint32_t version_id);
 
 
+/**
+ * @brief set a statistics sink which is filled by the compress_chunk() function
+ *
+ * For every compressed collection the compress_chunk() function records the
+ * data type, the number of samples, the compressed size and for every encoded
+ * field the used bits, the outliers and the residual range in the sink. The
+ * num_cols counter of the sink is reset at the start of every compress_chunk()
+ * call. The collection statistics are only recorded as long as there is space
+ * in the col array.
+ *
+ * @param stats	pointer to a statistics sink; NULL disables the statistics
+ *		collection (default)
+ */
+
+void compress_chunk_set_stats(struct cmp_stats *stats);
+
+
 /**
  * @brief compress a data chunk consisting of put together data collections
  *
@@ -184,6 +337,213 @@ uint32_t compress_chunk(const void *chunk, uint32_t chunk_size,
 			const struct cmp_par *cmp_par);
 
 
+/**
+ * @brief compress a data chunk given as an array of chunk pieces
+ *
+ * The chunk is the concatenation of the pieces; every piece contains one or
+ * more complete collections. The compressed data are identical to a
+ * compress_chunk() call with the concatenated chunk, but the collections do
+ * not have to be copied into a contiguous buffer first.
+ *
+ * @param iov		pointer to an array of chunk pieces; the model and the
+ *			updated model pointers of a piece follow the rules of
+ *			the chunk_model and updated_chunk_model parameters of
+ *			compress_chunk(); if a model mode is used every piece
+ *			needs a model
+ * @param iovcnt	number of pieces in the iov array
+ * @param dst		destination pointer to the compressed data buffer;
+ *			has to be 4-byte aligned; can be NULL to only get the
+ *			compressed data size
+ * @param dst_capacity	capacity of the dst buffer (see compress_chunk())
+ * @param cmp_par	pointer to a compression parameters struct
+ *
+ * @returns the byte size of the compressed data or an error code if it
+ *	fails (which can be tested with cmp_is_error())
+ */
+
+uint32_t compress_chunk_iov(const struct cmp_chunk_iov *iov, uint32_t iovcnt,
+			    uint32_t *dst, uint32_t dst_capacity,
+			    const struct cmp_par *cmp_par);
+
+
+/**
+ * @brief compress a data chunk into a chain of fixed-size segments
+ *
+ * The compression entity is written one segment after another into the
+ * segments of the sink (e.g. the payloads of telemetry packets), so no
+ * contiguous buffer of compress_chunk_cmp_size_bound() bytes is needed. A
+ * collection which fits into the rest of the current segment is compressed
+ * directly into it if the segment is 4-byte aligned and the segment size is a
+ * multiple of 4. Every other collection is compressed into the staging
+ * buffer of the sink and then copied into the segments, so for collections
+ * larger than a segment the extra copy remains. The entity header is patched
+ * into the first segments at the end. The written data are identical to a
+ * compress_chunk() call with a dst buffer of the sink capacity.
+ *
+ * @param chunk			pointer to the chunk to be compressed
+ * @param chunk_size		byte size of the chunk
+ * @param chunk_model		pointer to a model of a chunk (see compress_chunk())
+ * @param updated_chunk_model	pointer to store the updated model (see
+ *				compress_chunk())
+ * @param sink			pointer to the segmented output sink
+ * @param cmp_par		pointer to a compression parameters struct
+ *
+ * @returns the byte size of the compressed data (the number of used segments
+ *	is the size divided by the segment size rounded up) or an error code
+ *	if it fails (which can be tested with cmp_is_error())
+ */
+
+uint32_t compress_chunk_seg(const void *chunk, uint32_t chunk_size,
+			    const void *chunk_model, void *updated_chunk_model,
+			    const struct cmp_seg_sink *sink,
+			    const struct cmp_par *cmp_par);
+
+
+/**
+ * @brief compress a data chunk so that it fits into a byte budget
+ *
+ * Starting with the given parameters, the Golomb parameters of all data
+ * types are scaled by powers of two in the direction in which the compressed
+ * size decreases. If this is not enough, the lossy_par is increased step by
+ * step up to max_lossy_par. The search stops as soon as the budget is met,
+ * when lossy compression gives no size reduction (e.g. the chunk type does
+ * not support it), or after CMP_BUDGET_MAX_PASSES size estimation passes. The
+ * estimation passes only count the bits, the chunk is encoded into the dst
+ * buffer once with the selected parameters. Only this final compression
+ * fills the statistics sink set with compress_chunk_set_stats(); without a
+ * dst buffer the sink is not touched.
+ *
+ * @param chunk			pointer to the chunk to be compressed
+ * @param chunk_size		byte size of the chunk
+ * @param chunk_model		pointer to a model of a chunk; has the same size
+ *				as the chunk (can be NULL if no model compression
+ *				mode is used)
+ * @param updated_chunk_model	pointer to store the updated model for the next
+ *				model mode compression; has the same size as the
+ *				chunk (can be the same as the model_of_data
+ *				buffer for in-place update or NULL if updated
+ *				model is not needed)
+ * @param dst			destination pointer to the compressed data
+ *				buffer; has to be 4-byte aligned; can be NULL to
+ *				only get the compressed data size and the
+ *				selected parameters
+ * @param dst_capacity		byte budget for the compressed data and capacity
+ *				of the dst buffer; rounded down to a multiple of 4
+ * @param cmp_par		pointer to the start compression parameters; on
+ *				return it contains the parameters used for the
+ *				compression (if the budget can not be met, the
+ *				parameters with the smallest size found)
+ * @param max_lossy_par		largest lossy_par the search is allowed to use;
+ *				use cmp_par->lossy_par for no lossy escalation
+ *
+ * @returns the byte size of the compressed data or an error code if it
+ *	fails (which can be tested with cmp_is_error()); CMP_ERROR_SMALL_BUFFER
+ *	if the chunk does not fit into the budget
+ */
+
+uint32_t compress_chunk_budget(const void *chunk, uint32_t chunk_size,
+			       const void *chunk_model, void *updated_chunk_model,
+			       uint32_t *dst, uint32_t dst_capacity,
+			       struct cmp_par *cmp_par, uint32_t max_lossy_par);
+
+
+/**
+ * @brief get a specific compression parameter of a compression parameters
+ *	struct by its index
+ *
+ * The specific compression parameters are all parameters except cmp_mode,
+ * model_value and lossy_par. The index allows to set or scale all of them in
+ * a loop without depending on the member order of the cmp_par structure.
+ *
+ * @param par	pointer to a compression parameters struct
+ * @param idx	index of the parameter; 0 to CMP_PAR_NUM_SPECIFIC-1
+ *
+ * @returns a pointer to the parameter; NULL if par is NULL or idx is out of
+ *	range
+ */
+
+uint32_t *cmp_par_specific(struct cmp_par *par, unsigned int idx);
+
+
+/**
+ * @brief split a chunk at collection boundaries into parts which fit into a
+ *	compression entity
+ *
+ * The collections are greedily put together until the next collection would
+ * exceed the maximum part size or the worst-case compressed size of the part
+ * would exceed CMP_ENTITY_MAX_SIZE. The parts can be compressed independently
+ * with compress_chunk(); the model and the updated model of a part are at the
+ * same offset as the part in the chunk.
+ *
+ * @note the parts can only be compressed in parallel if no statistics sink is
+ *	set with compress_chunk_set_stats() and CMP_TRACE is disabled; the
+ *	statistics sink and the trace ring are global and not thread-safe
+ *
+ * @param chunk		pointer to the chunk to be split
+ * @param chunk_size	byte size of the chunk
+ * @param max_part_size	maximum byte size of a part; 0 or a value larger than
+ *			the maximum chunk size of the compress_chunk_cmp_size_bound()
+ *			function selects the maximum possible part size
+ * @param part_sizes	pointer to an array where the byte sizes of the parts
+ *			are stored (can be NULL to only count the parts)
+ * @param max_parts	number of elements in the part_sizes array
+ *
+ * @returns the number of parts or an error code if it fails (which can be
+ *	tested with cmp_is_error()); CMP_ERROR_SMALL_BUFFER if the part_sizes
+ *	array is too small
+ */
+
+uint32_t compress_chunk_split_plan(const void *chunk, uint32_t chunk_size,
+				   uint32_t max_part_size, uint32_t *part_sizes,
+				   uint32_t max_parts);
+
+
+/**
+ * @brief compress a chunk of arbitrary size into one or more compression
+ *	entities
+ *
+ * The chunk is split with compress_chunk_split_plan() and every part is
+ * compressed like with compress_chunk() into its own compression entity. The
+ * entities are written without gaps one after another into the dst buffer
+ * (as expected by decompress_cmp_batch()); an entity which does not start at
+ * a 4-byte aligned position is compressed directly to its position, so it is
+ * not moved after the compression. A statistics sink set with
+ * compress_chunk_set_stats() holds the statistics of the last part.
+ *
+ * @param chunk			pointer to the chunk to be compressed
+ * @param chunk_size		byte size of the chunk
+ * @param chunk_model		pointer to a model of a chunk; has the same size
+ *				as the chunk (can be NULL if no model compression
+ *				mode is used)
+ * @param updated_chunk_model	pointer to store the updated model for the next
+ *				model mode compression; has the same size as the
+ *				chunk (can be the same as the model_of_data
+ *				buffer for in-place update or NULL if updated
+ *				model is not needed)
+ * @param dst			destination pointer to the compressed entities;
+ *				has to be 4-byte aligned; can be NULL to only
+ *				get the compressed data size
+ * @param dst_capacity		capacity of the dst buffer (see compress_chunk())
+ * @param cmp_par		pointer to a compression parameters struct
+ * @param max_part_size		maximum original data size of an entity (see
+ *				compress_chunk_split_plan())
+ * @param ent_sizes		pointer to an array where the byte sizes of the
+ *				compression entities are stored
+ * @param max_ent		number of elements in the ent_sizes array
+ * @param num_ent		pointer where the number of compression entities
+ *				is stored
+ *
+ * @returns the byte size of all compression entities or an error code if it
+ *	fails (which can be tested with cmp_is_error())
+ */
+
+uint32_t compress_chunk_split(const void *chunk, uint32_t chunk_size,
+			      const void *chunk_model, void *updated_chunk_model,
+			      uint32_t *dst, uint32_t dst_capacity,
+			      const struct cmp_par *cmp_par, uint32_t max_part_size,
+			      uint32_t *ent_sizes, uint32_t max_ent, uint32_t *num_ent);
+
+
 /**
  * @brief set the model id and model counter in the compression entity header
  *
@@ -26,4 +26,7 @@
 
 uint32_t compress_like_rdcu(const struct rdcu_cfg *rcfg, struct cmp_info *info);
 
+uint32_t compress_like_rdcu_trials(const struct rdcu_cfg *rcfg, struct cmp_info *info,
+				   struct cmp_par_trial *trials, uint32_t num_trials);
+
 #endif /* CMP_ICU_H */
@@ -41,6 +41,10 @@
 
 int rdcu_compress_data(const struct rdcu_cfg *rcfg);
 
+int rdcu_transfer_data(const struct rdcu_cfg *rcfg);
+int rdcu_compress_data_parallel(const struct rdcu_cfg *rcfg,
+				const struct cmp_info *last_info);
+
 int rdcu_read_cmp_status(struct cmp_status *status);
 
 int rdcu_read_cmp_info(struct cmp_info *info);
@@ -358,5 +358,38 @@ static __inline void __swab64s(uint64_t *p)
 #define be64_to_cpus __be64_to_cpus
 
 
+/**
+ * @brief read an unsigned big-endian integer of n_bytes bytes (up to 8) from
+ *	an unaligned address
+ */
+
+static __inline uint64_t get_unaligned_be(const void *p, unsigned int n_bytes)
+{
+	const uint8_t *b = (const uint8_t *)p;
+	uint64_t v = 0;
+	unsigned int i;
+
+	for (i = 0; i < n_bytes; i++)
+		v = (v << 8) | b[i];
+
+	return v;
+}
+
+
+/**
+ * @brief write an unsigned integer as big-endian integer of n_bytes bytes
+ *	(up to 8) to an unaligned address
+ */
+
+static __inline void put_unaligned_be(void *p, uint64_t v, unsigned int n_bytes)
+{
+	uint8_t *b = (uint8_t *)p;
+
+	while (n_bytes--) {
+		b[n_bytes] = (uint8_t)v;
+		v >>= 8;
+	}
+}
+
 
 #endif /* BYTEORDER_H */
@@ -0,0 +1,422 @@
+/**
+ * @file   cmp_container.c
+ * @date   2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief indexed container of compression entities
+ */
+
+
+#include <stdint.h>
+#include <string.h>
+
+#include "compiler.h"
+#include "byteorder.h"
+#include "cmp_debug.h"
+#include "cmp_support.h"
+#include "cmp_data_types.h"
+#include "cmp_entity.h"
+#include "cmp_container.h"
+#include "leon_inttypes.h"
+
+
+/* byte offsets of the fields in an index record */
+#define REC_OFF_OFFSET		0
+#define REC_OFF_SIZE		4
+#define REC_OFF_START_TIME	8
+#define REC_OFF_END_TIME	14
+#define REC_OFF_DATA_TYPE	20
+#define REC_OFF_MODEL_ID	22
+#define REC_OFF_MODEL_COUNTER	24
+#define REC_OFF_CCD_ID_MASK	25
+#define REC_OFF_SUBSERVICE_MASK	28
+
+/* byte offsets of the fields in the trailer */
+#define TRL_OFF_INDEX_OFFSET	0
+#define TRL_OFF_NUM_ENTRIES	4
+#define TRL_OFF_RECORD_SIZE	8
+#define TRL_OFF_VERSION		10
+#define TRL_OFF_MAGIC		12
+
+compile_time_assert(REC_OFF_SUBSERVICE_MASK + 8 == CMP_CONT_RECORD_SIZE,
+		    CMP_CONT_RECORD_SIZE_IS_NOT_CORRECT);
+compile_time_assert(TRL_OFF_MAGIC + 4 == CMP_CONT_TRAILER_SIZE,
+		    CMP_CONT_TRAILER_SIZE_IS_NOT_CORRECT);
+
+
+/**
+ * @brief collect the subservices and CCD IDs of the collections in a chunk
+ *	compression entity
+ *
+ * @param data		pointer to the data of the compression entity
+ * @param data_size	size of the entity data in bytes
+ * @param raw_mode_flag	set if the entity holds uncompressed collections
+ * @param entry		index entry in which the masks are set
+ *
+ * @returns 0 on success, -1 if the collections do not add up to the data size
+ */
+
+static int scan_collections(const uint8_t *data, uint32_t data_size,
+			    int raw_mode_flag, struct cmp_cont_entry *entry)
+{
+	/* compressed collections are prefixed with their compressed data size */
+	uint32_t const prefix = raw_mode_flag ? 0 : CMP_COLLECTION_FILD_SIZE;
+	uint32_t pos = 0;
+
+	while (pos + prefix + COLLECTION_HDR_SIZE <= data_size) {
+		const struct collection_hdr *col =
+			(const struct collection_hdr *)(data + pos + prefix);
+		uint32_t col_data_size;
+
+		if (raw_mode_flag)
+			col_data_size = cmp_col_get_data_length(col);
+		else
+			col_data_size = (uint32_t)get_unaligned_be(data + pos, CMP_COLLECTION_FILD_SIZE);
+
+		entry->subservice_mask |= 1ULL << cmp_col_get_subservice(col);
+		entry->ccd_id_mask |= 1U << cmp_col_get_ccd_id(col);
+		pos += prefix + COLLECTION_HDR_SIZE + col_data_size;
+	}
+
+	if (pos != data_size) {
+		debug_print("Error: The collections do not match the size of the data in the compression entity.");
+		return -1;
+	}
+	return 0;
+}
+
+
+/**
+ * @brief create the index entry of a compression entity
+ *
+ * For chunk entities the collection headers are scanned to set the
+ * subservice and CCD ID masks.
+ *
+ * @param ent		pointer to a compression entity
+ * @param ent_buf_size	number of bytes readable from ent; the entity size in
+ *			the header must not exceed it
+ * @param offset	offset of the entity in the container
+ * @param entry		pointer to the index entry to set
+ *
+ * @returns 0 on success, otherwise error
+ */
+
+int cmp_cont_index_entity(const struct cmp_entity *ent, uint32_t ent_buf_size,
+			  uint32_t offset, struct cmp_cont_entry *entry)
+{
+	struct cmp_ent_hdr hdr;
+	uint32_t hdr_size;
+
+	if (!entry)
+		return -1;
+
+	if (cmp_ent_hdr_decode(ent, ent_buf_size, &hdr))
+		return -1;
+
+	memset(entry, 0, sizeof(*entry));
+	entry->offset = offset;
+	entry->size = hdr.cmp_ent_size;
+	entry->start_timestamp = hdr.start_timestamp;
+	entry->end_timestamp = hdr.end_timestamp;
+	entry->data_type = hdr.data_type;
+	entry->raw_mode_flag = hdr.raw_mode_flag;
+	entry->model_id = hdr.model_id;
+	entry->model_counter = hdr.model_counter;
+
+	if (hdr.data_type != DATA_TYPE_CHUNK)
+		return 0;
+
+	hdr_size = cmp_ent_cal_hdr_size(hdr.data_type, hdr.raw_mode_flag);
+	return scan_collections((const uint8_t *)ent + hdr_size,
+				hdr.cmp_ent_size - hdr_size, hdr.raw_mode_flag,
+				entry);
+}
+
+
+/**
+ * @brief index a concatenation of compression entities
+ *
+ * @param entities	pointer to the concatenated compression entities
+ * @param entities_size	size of the concatenated entities in bytes
+ * @param entries	pointer to an array where the index entries are stored
+ *			(can be NULL to count the entities)
+ * @param max_entries	number of elements in the entries array
+ *
+ * @returns the number of entities on success; -1 on error (a broken entity or
+ *	more than max_entries entities)
+ */
+
+int32_t cmp_cont_scan(const void *entities, uint32_t entities_size,
+		      struct cmp_cont_entry *entries, uint32_t max_entries)
+{
+	const uint8_t *p = (const uint8_t *)entities;
+	uint32_t pos = 0;
+	int32_t n = 0;
+
+	if (!entities && entities_size)
+		return -1;
+
+	while (pos < entities_size) {
+		struct cmp_cont_entry entry;
+
+		if (n == INT32_MAX)
+			return -1;
+		if (cmp_cont_index_entity((const struct cmp_entity *)(p + pos),
+					  entities_size - pos, pos, &entry))
+			return -1;
+		if (entries) {
+			if ((uint32_t)n >= max_entries) {
+				debug_print("Error: The entries array is too small to index all entities.");
+				return -1;
+			}
+			entries[n] = entry;
+		}
+		n++;
+		pos += entry.size;
+	}
+
+	return n;
+}
+
+
+/**
+ * @brief get the size of the index and trailer of a container
+ *
+ * @param num_entries	number of indexed entities
+ *
+ * @returns the size in bytes; 0 if the index would be too large
+ */
+
+uint32_t cmp_cont_index_size(uint32_t num_entries)
+{
+	uint64_t const size = (uint64_t)num_entries * CMP_CONT_RECORD_SIZE
+		+ CMP_CONT_TRAILER_SIZE;
+
+	if (size > UINT32_MAX)
+		return 0;
+	return (uint32_t)size;
+}
+
+
+/**
+ * @brief write the index and trailer of a container
+ *
+ * The index has to be appended directly after the entities.
+ *
+ * @param dst		pointer to the buffer where the index is written
+ *			(can be NULL to get the size of the index)
+ * @param dst_capacity	size of the dst buffer in bytes
+ * @param entries	index entries sorted by the start timestamp
+ * @param num_entries	number of index entries
+ * @param entities_size	size of the entity area in front of the index in bytes
+ *
+ * @returns the number of bytes written on success; 0 on error (e.g. entries
+ *	not sorted by start timestamp or outside of the entity area)
+ */
+
+uint32_t cmp_cont_write_index(void *dst, uint32_t dst_capacity,
+			      const struct cmp_cont_entry *entries,
+			      uint32_t num_entries, uint32_t entities_size)
+{
+	uint32_t const index_size = cmp_cont_index_size(num_entries);
+	uint8_t *p = (uint8_t *)dst;
+	uint32_t i;
+
+	if (!index_size || (!entries && num_entries))
+		return 0;
+	if (!dst)
+		return index_size;
+	if (dst_capacity < index_size)
+		return 0;
+
+	for (i = 0; i < num_entries; i++) {
+		const struct cmp_cont_entry *e = &entries[i];
+
+		if (e->offset > entities_size || e->size > entities_size - e->offset) {
+			debug_print("Error: Index entry %" PRIu32 " is outside of the entity area.", i);
+			return 0;
+		}
+		if (i && e->start_timestamp < entries[i-1].start_timestamp) {
+			debug_print("Error: The index entries are not sorted by the start timestamp.");
+			return 0;
+		}
+		if (e->start_timestamp > 0xFFFFFFFFFFFFULL || e->end_timestamp > 0xFFFFFFFFFFFFULL ||
+		    e->data_type > 0x7FF || e->model_id > UINT16_MAX ||
+		    e->model_counter > UINT8_MAX || e->ccd_id_mask > UINT8_MAX)
+			return 0;
+	}
+
+	for (i = 0; i < num_entries; i++, p += CMP_CONT_RECORD_SIZE) {
+		const struct cmp_cont_entry *e = &entries[i];
+
+		memset(p, 0, CMP_CONT_RECORD_SIZE);
+		put_unaligned_be(p + REC_OFF_OFFSET, e->offset, 4);
+		put_unaligned_be(p + REC_OFF_SIZE, e->size, 4);
+		put_unaligned_be(p + REC_OFF_START_TIME, e->start_timestamp, 6);
+		put_unaligned_be(p + REC_OFF_END_TIME, e->end_timestamp, 6);
+		put_unaligned_be(p + REC_OFF_DATA_TYPE, (uint32_t)e->data_type |
+				 (e->raw_mode_flag ? 1U << RAW_BIT_DATA_TYPE_POS : 0), 2);
+		put_unaligned_be(p + REC_OFF_MODEL_ID, e->model_id, 2);
+		p[REC_OFF_MODEL_COUNTER] = (uint8_t)e->model_counter;
+		p[REC_OFF_CCD_ID_MASK] = (uint8_t)e->ccd_id_mask;
+		put_unaligned_be(p + REC_OFF_SUBSERVICE_MASK, e->subservice_mask, 8);
+	}
+
+	put_unaligned_be(p + TRL_OFF_INDEX_OFFSET, entities_size, 4);
+	put_unaligned_be(p + TRL_OFF_NUM_ENTRIES, num_entries, 4);
+	put_unaligned_be(p + TRL_OFF_RECORD_SIZE, CMP_CONT_RECORD_SIZE, 2);
+	put_unaligned_be(p + TRL_OFF_VERSION, CMP_CONT_VERSION, 2);
+	put_unaligned_be(p + TRL_OFF_MAGIC, CMP_CONT_MAGIC, 4);
+
+	return index_size;
+}
+
+
+/**
+ * @brief open a container by reading its trailer
+ *
+ * @param cont		pointer to the container structure to set up
+ * @param buf		pointer to the container
+ * @param buf_size	size of the container in bytes
+ *
+ * @returns 0 on success, otherwise error
+ */
+
+int cmp_cont_open(struct cmp_cont *cont, const void *buf, uint32_t buf_size)
+{
+	const uint8_t *trailer;
+	uint32_t index_offset, num_entries;
+
+	if (!cont || !buf || buf_size < CMP_CONT_TRAILER_SIZE)
+		return -1;
+
+	trailer = (const uint8_t *)buf + buf_size - CMP_CONT_TRAILER_SIZE;
+	if (get_unaligned_be(trailer + TRL_OFF_MAGIC, 4) != CMP_CONT_MAGIC ||
+	    get_unaligned_be(trailer + TRL_OFF_VERSION, 2) != CMP_CONT_VERSION ||
+	    get_unaligned_be(trailer + TRL_OFF_RECORD_SIZE, 2) != CMP_CONT_RECORD_SIZE) {
+		debug_print("Error: No supported container index found.");
+		return -1;
+	}
+
+	index_offset = (uint32_t)get_unaligned_be(trailer + TRL_OFF_INDEX_OFFSET, 4);
+	num_entries = (uint32_t)get_unaligned_be(trailer + TRL_OFF_NUM_ENTRIES, 4);
+	if ((uint64_t)index_offset + cmp_cont_index_size(num_entries) != buf_size ||
+	    !cmp_cont_index_size(num_entries)) {
+		debug_print("Error: The container index does not match the container size.");
+		return -1;
+	}
+
+	cont->base = (const uint8_t *)buf;
+	cont->entities_size = index_offset;
+	cont->index = cont->base + index_offset;
+	cont->num_entries = num_entries;
+
+	return 0;
+}
+
+
+/**
+ * @brief get an index entry of a container
+ *
+ * @param cont	pointer to an opened container
+ * @param i	number of the index entry
+ * @param entry	pointer where the index entry is stored
+ *
+ * @returns 0 on success, otherwise error
+ */
+
+int cmp_cont_get_entry(const struct cmp_cont *cont, uint32_t i,
+		       struct cmp_cont_entry *entry)
+{
+	const uint8_t *p;
+	uint32_t data_type;
+
+	if (!cont || !entry || i >= cont->num_entries)
+		return -1;
+
+	p = cont->index + (size_t)i * CMP_CONT_RECORD_SIZE;
+	entry->offset = (uint32_t)get_unaligned_be(p + REC_OFF_OFFSET, 4);
+	entry->size = (uint32_t)get_unaligned_be(p + REC_OFF_SIZE, 4);
+	entry->start_timestamp = get_unaligned_be(p + REC_OFF_START_TIME, 6);
+	entry->end_timestamp = get_unaligned_be(p + REC_OFF_END_TIME, 6);
+	data_type = (uint32_t)get_unaligned_be(p + REC_OFF_DATA_TYPE, 2);
+	entry->raw_mode_flag = (data_type >> RAW_BIT_DATA_TYPE_POS) & 1U;
+	entry->data_type = data_type & ((1U << RAW_BIT_DATA_TYPE_POS)-1);
+	entry->model_id = (uint32_t)get_unaligned_be(p + REC_OFF_MODEL_ID, 2);
+	entry->model_counter = p[REC_OFF_MODEL_COUNTER];
+	entry->ccd_id_mask = p[REC_OFF_CCD_ID_MASK];
+	entry->subservice_mask = get_unaligned_be(p + REC_OFF_SUBSERVICE_MASK, 8);
+
+	return 0;
+}
+
+
+/**
+ * @brief get a compression entity of a container
+ *
+ * @param cont	pointer to an opened container
+ * @param i	number of the index entry
+ *
+ * @returns a pointer to the compression entity; NULL on error (e.g. the index
+ *	entry points outside of the entity area)
+ */
+
+const struct cmp_entity *cmp_cont_get_entity(const struct cmp_cont *cont, uint32_t i)
+{
+	struct cmp_cont_entry entry;
+
+	if (cmp_cont_get_entry(cont, i, &entry))
+		return NULL;
+
+	if (entry.offset > cont->entities_size ||
+	    entry.size > cont->entities_size - entry.offset ||
+	    entry.size < GENERIC_HEADER_SIZE)
+		return NULL;
+
+	return (const struct cmp_entity *)(cont->base + entry.offset);
+}
+
+
+/**
+ * @brief find the first index entry with a start timestamp not less than the
+ *	given timestamp with a binary search
+ *
+ * All entities with a start timestamp in [t0, t1) are in the range
+ * [cmp_cont_lower_bound(cont, t0), cmp_cont_lower_bound(cont, t1)).
+ *
+ * @param cont		pointer to an opened container
+ * @param timestamp	timestamp to search for
+ *
+ * @returns the number of the found index entry; the number of entries if all
+ *	entities start before the timestamp; 0 on error
+ */
+
+uint32_t cmp_cont_lower_bound(const struct cmp_cont *cont, uint64_t timestamp)
+{
+	uint32_t lo = 0, hi;
+
+	if (!cont)
+		return 0;
+
+	hi = cont->num_entries;
+	while (lo < hi) {
+		uint32_t const mid = lo + (hi - lo) / 2;
+		const uint8_t *rec = cont->index + (size_t)mid * CMP_CONT_RECORD_SIZE;
+
+		if (get_unaligned_be(rec + REC_OFF_START_TIME, 6) < timestamp)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
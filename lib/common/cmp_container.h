@@ -0,0 +1,97 @@
+/**
+ * @file   cmp_container.h
+ * @date   2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief indexed container of compression entities
+ *
+ * A container is a concatenation of compression entities followed by an
+ * index and a trailer (all fields big-endian):
+ *
+ *	|---------------------|
+ *	| compression entity  | entities_size bytes
+ *	|        ...          |
+ *	|---------------------|- index_offset (= entities_size)
+ *	|   index record 0    | CMP_CONT_RECORD_SIZE bytes
+ *	|        ...          | num_entries records
+ *	|---------------------|
+ *	|       trailer       | CMP_CONT_TRAILER_SIZE bytes
+ *	|---------------------|
+ *
+ * The index records are sorted by the compression start timestamp, so a reader
+ * can binary-search the index instead of walking all entity headers. A raw
+ * concatenation of entities (without index) can be indexed with
+ * cmp_cont_scan().
+ */
+
+#ifndef CMP_CONTAINER_H
+#define CMP_CONTAINER_H
+
+#include <stdint.h>
+
+#include "cmp_entity.h"
+
+
+#define CMP_CONT_MAGIC		0x434D5058UL /* "CMPX" */
+#define CMP_CONT_VERSION	1
+#define CMP_CONT_RECORD_SIZE	36
+#define CMP_CONT_TRAILER_SIZE	16
+
+
+/**
+ * @brief index entry of a compression entity in a container
+ */
+
+struct cmp_cont_entry {
+	uint32_t offset;		/**< offset of the entity from the container start */
+	uint32_t size;			/**< size of the entity in bytes */
+	uint64_t start_timestamp;	/**< compression start timestamp of the entity */
+	uint64_t end_timestamp;		/**< compression end timestamp of the entity */
+	enum cmp_data_type data_type;	/**< data product type without the raw data bit */
+	int raw_mode_flag;		/**< raw data bit of the data product type */
+	uint32_t model_id;		/**< model ID */
+	uint32_t model_counter;		/**< model counter */
+	uint64_t subservice_mask;	/**< bit n is set if a collection with subservice n is in the (chunk) entity */
+	uint32_t ccd_id_mask;		/**< bit n is set if a collection with CCD ID n is in the (chunk) entity */
+};
+
+
+/**
+ * @brief a parsed container; the index is read on demand
+ */
+
+struct cmp_cont {
+	const uint8_t *base;		/**< start of the container */
+	uint32_t entities_size;		/**< size of the entity area in bytes */
+	const uint8_t *index;		/**< start of the index records */
+	uint32_t num_entries;		/**< number of indexed entities */
+};
+
+
+/* writing */
+int cmp_cont_index_entity(const struct cmp_entity *ent, uint32_t ent_buf_size,
+			  uint32_t offset, struct cmp_cont_entry *entry);
+int32_t cmp_cont_scan(const void *entities, uint32_t entities_size,
+		      struct cmp_cont_entry *entries, uint32_t max_entries);
+uint32_t cmp_cont_index_size(uint32_t num_entries);
+uint32_t cmp_cont_write_index(void *dst, uint32_t dst_capacity,
+			      const struct cmp_cont_entry *entries,
+			      uint32_t num_entries, uint32_t entities_size);
+
+/* reading */
+int cmp_cont_open(struct cmp_cont *cont, const void *buf, uint32_t buf_size);
+int cmp_cont_get_entry(const struct cmp_cont *cont, uint32_t i,
+		       struct cmp_cont_entry *entry);
+const struct cmp_entity *cmp_cont_get_entity(const struct cmp_cont *cont, uint32_t i);
+uint32_t cmp_cont_lower_bound(const struct cmp_cont *cont, uint64_t timestamp);
+
+#endif /* CMP_CONTAINER_H */
@@ -20,6 +20,7 @@
 #include <stddef.h>
 #include <stdint.h>
 #include <limits.h>
+#include <string.h>
 
 #include "compiler.h"
 #include "byteorder.h"
@@ -34,6 +35,15 @@
 #  define CMP_IS_BIG_ENDIAN 0
 #endif
 
+#ifndef ICU_ASW
+#  if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && defined __has_include
+#    if __has_include(<tmmintrin.h>)
+#      include <tmmintrin.h>
+#      define HAS_SSSE3_SWAP 1
+#    endif
+#  endif
+#endif
+
 /**
  * @brief get the collection timestamp from the collection header
  *
@@ -370,230 +380,6 @@ int cmp_col_set_data_length(struct collection_hdr *col, uint16_t length)
 }
 
 
-/**
- * @brief converts a subservice to its associated compression data type
- *
- * @param subservice	collection subservice type
- *
- * @returns the converted compression data type; DATA_TYPE_UNKNOWN if the
- *	subservice is unknown
- */
-
-enum cmp_data_type convert_subservice_to_cmp_data_type(uint8_t subservice)
-{
-	switch (subservice) {
-	case SST_NCxx_S_SCIENCE_IMAGETTE:
-		return DATA_TYPE_IMAGETTE;
-	case SST_NCxx_S_SCIENCE_SAT_IMAGETTE:
-		return DATA_TYPE_SAT_IMAGETTE;
-	case SST_NCxx_S_SCIENCE_OFFSET:
-		return DATA_TYPE_OFFSET;
-	case SST_NCxx_S_SCIENCE_BACKGROUND:
-		return DATA_TYPE_BACKGROUND;
-	case SST_NCxx_S_SCIENCE_SMEARING:
-		return DATA_TYPE_SMEARING;
-	case SST_NCxx_S_SCIENCE_S_FX:
-		return DATA_TYPE_S_FX;
-	case SST_NCxx_S_SCIENCE_S_FX_EFX:
-		return DATA_TYPE_S_FX_EFX;
-	case SST_NCxx_S_SCIENCE_S_FX_NCOB:
-		return DATA_TYPE_S_FX_NCOB;
-	case SST_NCxx_S_SCIENCE_S_FX_EFX_NCOB_ECOB:
-		return DATA_TYPE_S_FX_EFX_NCOB_ECOB;
-	case SST_NCxx_S_SCIENCE_L_FX:
-		return DATA_TYPE_L_FX;
-	case SST_NCxx_S_SCIENCE_L_FX_EFX:
-		return DATA_TYPE_L_FX_EFX;
-	case SST_NCxx_S_SCIENCE_L_FX_NCOB:
-		return DATA_TYPE_L_FX_NCOB;
-	case SST_NCxx_S_SCIENCE_L_FX_EFX_NCOB_ECOB:
-		return DATA_TYPE_L_FX_EFX_NCOB_ECOB;
-	case SST_NCxx_S_SCIENCE_F_FX:
-		return DATA_TYPE_F_FX;
-	case SST_NCxx_S_SCIENCE_F_FX_EFX:
-		return DATA_TYPE_F_FX_EFX;
-	case SST_NCxx_S_SCIENCE_F_FX_NCOB:
-		return DATA_TYPE_F_FX_NCOB;
-	case SST_NCxx_S_SCIENCE_F_FX_EFX_NCOB_ECOB:
-		return DATA_TYPE_F_FX_EFX_NCOB_ECOB;
-	case SST_FCx_S_SCIENCE_IMAGETTE:
-		return DATA_TYPE_F_CAM_IMAGETTE;
-	case SST_FCx_S_SCIENCE_OFFSET_VALUES:
-		return DATA_TYPE_F_CAM_OFFSET;
-	case SST_FCx_S_BACKGROUND_VALUES:
-		return DATA_TYPE_F_CAM_BACKGROUND;
-	default:
-		return DATA_TYPE_UNKNOWN;
-	};
-}
-
-
-/**
- * @brief converts a compression data type to its associated subservice.
- *
- * @param data_type	compression data type
- *
- * @returns the converted subservice; -1 if the data type is unknown.
- */
-
-uint8_t convert_cmp_data_type_to_subservice(enum cmp_data_type data_type)
-{
-	uint8_t sst = 0;
-
-	switch (data_type) {
-	case DATA_TYPE_IMAGETTE:
-	case DATA_TYPE_IMAGETTE_ADAPTIVE:
-		sst = SST_NCxx_S_SCIENCE_IMAGETTE;
-		break;
-	case DATA_TYPE_SAT_IMAGETTE:
-	case DATA_TYPE_SAT_IMAGETTE_ADAPTIVE:
-		sst = SST_NCxx_S_SCIENCE_SAT_IMAGETTE;
-		break;
-	case DATA_TYPE_OFFSET:
-		sst = SST_NCxx_S_SCIENCE_OFFSET;
-		break;
-	case DATA_TYPE_BACKGROUND:
-		sst = SST_NCxx_S_SCIENCE_BACKGROUND;
-		break;
-	case DATA_TYPE_SMEARING:
-		sst = SST_NCxx_S_SCIENCE_SMEARING;
-		break;
-	case DATA_TYPE_S_FX:
-		sst = SST_NCxx_S_SCIENCE_S_FX;
-		break;
-	case DATA_TYPE_S_FX_EFX:
-		sst = SST_NCxx_S_SCIENCE_S_FX_EFX;
-		break;
-	case DATA_TYPE_S_FX_NCOB:
-		sst = SST_NCxx_S_SCIENCE_S_FX_NCOB;
-		break;
-	case DATA_TYPE_S_FX_EFX_NCOB_ECOB:
-		sst = SST_NCxx_S_SCIENCE_S_FX_EFX_NCOB_ECOB;
-		break;
-	case DATA_TYPE_L_FX:
-		sst = SST_NCxx_S_SCIENCE_L_FX;
-		break;
-	case DATA_TYPE_L_FX_EFX:
-		sst = SST_NCxx_S_SCIENCE_L_FX_EFX;
-		break;
-	case DATA_TYPE_L_FX_NCOB:
-		sst = SST_NCxx_S_SCIENCE_L_FX_NCOB;
-		break;
-	case DATA_TYPE_L_FX_EFX_NCOB_ECOB:
-		sst = SST_NCxx_S_SCIENCE_L_FX_EFX_NCOB_ECOB;
-		break;
-	case DATA_TYPE_F_FX:
-		sst = SST_NCxx_S_SCIENCE_F_FX;
-		break;
-	case DATA_TYPE_F_FX_EFX:
-		sst = SST_NCxx_S_SCIENCE_F_FX_EFX;
-		break;
-	case DATA_TYPE_F_FX_NCOB:
-		sst = SST_NCxx_S_SCIENCE_F_FX_NCOB;
-		break;
-	case DATA_TYPE_F_FX_EFX_NCOB_ECOB:
-		sst = SST_NCxx_S_SCIENCE_F_FX_EFX_NCOB_ECOB;
-		break;
-	case DATA_TYPE_F_CAM_IMAGETTE:
-	case DATA_TYPE_F_CAM_IMAGETTE_ADAPTIVE:
-		sst = SST_FCx_S_SCIENCE_IMAGETTE;
-		break;
-	case DATA_TYPE_F_CAM_OFFSET:
-		sst = SST_FCx_S_SCIENCE_OFFSET_VALUES;
-		break;
-	case DATA_TYPE_F_CAM_BACKGROUND:
-		sst = SST_FCx_S_BACKGROUND_VALUES;
-		break;
-	default:
-	case DATA_TYPE_UNKNOWN:
-	case DATA_TYPE_CHUNK:
-		debug_print("Error: Unknown compression data type!");
-		sst = (uint8_t)-1;
-	};
-
-	return sst;
-}
-
-
-/**
- * @brief calculate the size of a sample for the different compression data type
- *
- * @param data_type	compression data_type
- *
- * @returns the size of a data sample in bytes for the selected compression
- *	data type; zero on unknown data type
- */
-
-size_t size_of_a_sample(enum cmp_data_type data_type)
-{
-	size_t sample_size = 0;
-
-	switch (data_type) {
-	case DATA_TYPE_IMAGETTE:
-	case DATA_TYPE_IMAGETTE_ADAPTIVE:
-	case DATA_TYPE_SAT_IMAGETTE:
-	case DATA_TYPE_SAT_IMAGETTE_ADAPTIVE:
-	case DATA_TYPE_F_CAM_IMAGETTE:
-	case DATA_TYPE_F_CAM_IMAGETTE_ADAPTIVE:
-		sample_size = sizeof(uint16_t);
-		break;
-	case DATA_TYPE_OFFSET:
-	case DATA_TYPE_F_CAM_OFFSET:
-		sample_size = sizeof(struct offset);
-		break;
-	case DATA_TYPE_BACKGROUND:
-	case DATA_TYPE_F_CAM_BACKGROUND:
-		sample_size = sizeof(struct background);
-		break;
-	case DATA_TYPE_SMEARING:
-		sample_size = sizeof(struct smearing);
-		break;
-	case DATA_TYPE_S_FX:
-		sample_size = sizeof(struct s_fx);
-		break;
-	case DATA_TYPE_S_FX_EFX:
-		sample_size = sizeof(struct s_fx_efx);
-		break;
-	case DATA_TYPE_S_FX_NCOB:
-		sample_size = sizeof(struct s_fx_ncob);
-		break;
-	case DATA_TYPE_S_FX_EFX_NCOB_ECOB:
-		sample_size = sizeof(struct s_fx_efx_ncob_ecob);
-		break;
-	case DATA_TYPE_L_FX:
-		sample_size = sizeof(struct l_fx);
-		break;
-	case DATA_TYPE_L_FX_EFX:
-		sample_size = sizeof(struct l_fx_efx);
-		break;
-	case DATA_TYPE_L_FX_NCOB:
-		sample_size = sizeof(struct l_fx_ncob);
-		break;
-	case DATA_TYPE_L_FX_EFX_NCOB_ECOB:
-		sample_size = sizeof(struct l_fx_efx_ncob_ecob);
-		break;
-	case DATA_TYPE_F_FX:
-		sample_size = sizeof(struct f_fx);
-		break;
-	case DATA_TYPE_F_FX_EFX:
-		sample_size = sizeof(struct f_fx_efx);
-		break;
-	case DATA_TYPE_F_FX_NCOB:
-		sample_size = sizeof(struct f_fx_ncob);
-		break;
-	case DATA_TYPE_F_FX_EFX_NCOB_ECOB:
-		sample_size = sizeof(struct f_fx_efx_ncob_ecob);
-		break;
-	case DATA_TYPE_CHUNK:
-	case DATA_TYPE_UNKNOWN:
-	default:
-		debug_print("Error: Compression data type is not supported.");
-		break;
-	}
-	return sample_size;
-}
-
-
 static uint32_t be24_to_cpu(uint32_t a)
 {
 #ifdef __LITTLE_ENDIAN
@@ -604,216 +390,528 @@ static uint32_t be24_to_cpu(uint32_t a)
 }
 
 
-static void be_to_cpus_16(uint16_t *a, uint32_t samples)
+static void be_to_cpus_16(void *dst_buf, const void *src_buf, uint32_t samples)
 {
+	uint16_t *dst = dst_buf;
+	const uint16_t *src = src_buf;
 	uint32_t i;
 
 	for (i = 0; i < samples; i++) {
 		uint16_t tmp;
 
-		tmp = be16_to_cpu(get_unaligned(&a[i]));
-		put_unaligned(tmp, &a[i]);
+		tmp = be16_to_cpu(get_unaligned(&src[i]));
+		put_unaligned(tmp, &dst[i]);
 	}
 }
 
 
-static void be_to_cpus_offset(struct offset *a, uint32_t samples)
+static void be_to_cpus_offset(void *dst_buf, const void *src_buf, uint32_t samples)
 {
+	struct offset *dst = dst_buf;
+	const struct offset *src = src_buf;
 	uint32_t i;
 
 	for (i = 0; i < samples; i++) {
-		a[i].mean = be32_to_cpu(a[i].mean);
-		a[i].variance = be32_to_cpu(a[i].variance);
+		dst[i].mean = be32_to_cpu(src[i].mean);
+		dst[i].variance = be32_to_cpu(src[i].variance);
 	}
 }
 
 
-static void be_to_cpus_background(struct background *a, uint32_t samples)
+static void be_to_cpus_background(void *dst_buf, const void *src_buf, uint32_t samples)
 {
+	struct background *dst = dst_buf;
+	const struct background *src = src_buf;
 	uint32_t i;
 
 	for (i = 0; i < samples; i++) {
-		a[i].mean = be32_to_cpu(a[i].mean);
-		a[i].variance = be32_to_cpu(a[i].variance);
-		a[i].outlier_pixels = be16_to_cpu(a[i].outlier_pixels);
+		dst[i].mean = be32_to_cpu(src[i].mean);
+		dst[i].variance = be32_to_cpu(src[i].variance);
+		dst[i].outlier_pixels = be16_to_cpu(src[i].outlier_pixels);
 	}
 }
 
 
-static void be_to_cpus_smearing(struct smearing *a, uint32_t samples)
+static void be_to_cpus_smearing(void *dst_buf, const void *src_buf, uint32_t samples)
 {
+	struct smearing *dst = dst_buf;
+	const struct smearing *src = src_buf;
 	uint32_t i;
 
 	for (i = 0; i < samples; i++) {
-		a[i].mean = be32_to_cpu(a[i].mean);
-		a[i].variance_mean = be32_to_cpu(a[i].variance_mean);
-		a[i].outlier_pixels = be16_to_cpu(a[i].outlier_pixels);
+		dst[i].mean = be32_to_cpu(src[i].mean);
+		dst[i].variance_mean = be32_to_cpu(src[i].variance_mean);
+		dst[i].outlier_pixels = be16_to_cpu(src[i].outlier_pixels);
 	}
 }
 
 
-static void be_to_cpus_s_fx(struct s_fx *a, uint32_t samples)
+static void be_to_cpus_s_fx(void *dst_buf, const void *src_buf, uint32_t samples)
 {
+	struct s_fx *dst = dst_buf;
+	const struct s_fx *src = src_buf;
 	uint32_t i;
 
-	for (i = 0; i < samples; i++)
-		a[i].fx = be32_to_cpu(a[i].fx);
+	for (i = 0; i < samples; i++) {
+		dst[i].exp_flags = src[i].exp_flags;
+		dst[i].fx = be32_to_cpu(src[i].fx);
+	}
 }
 
 
-static void be_to_cpus_s_fx_efx(struct s_fx_efx *a, uint32_t samples)
+static void be_to_cpus_s_fx_efx(void *dst_buf, const void *src_buf, uint32_t samples)
 {
+	struct s_fx_efx *dst = dst_buf;
+	const struct s_fx_efx *src = src_buf;
 	uint32_t i;
 
 	for (i = 0; i < samples; i++) {
-		a[i].fx = be32_to_cpu(a[i].fx);
-		a[i].efx = be32_to_cpu(a[i].efx);
+		dst[i].exp_flags = src[i].exp_flags;
+		dst[i].fx = be32_to_cpu(src[i].fx);
+		dst[i].efx = be32_to_cpu(src[i].efx);
 	}
 }
 
 
-static void be_to_cpus_s_fx_ncob(struct s_fx_ncob *a, uint32_t samples)
+static void be_to_cpus_s_fx_ncob(void *dst_buf, const void *src_buf, uint32_t samples)
 {
+	struct s_fx_ncob *dst = dst_buf;
+	const struct s_fx_ncob *src = src_buf;
 	uint32_t i;
 
 	for (i = 0; i < samples; i++) {
-		a[i].fx = be32_to_cpu(a[i].fx);
-		a[i].ncob_x = be32_to_cpu(a[i].ncob_x);
-		a[i].ncob_y = be32_to_cpu(a[i].ncob_y);
+		dst[i].exp_flags = src[i].exp_flags;
+		dst[i].fx = be32_to_cpu(src[i].fx);
+		dst[i].ncob_x = be32_to_cpu(src[i].ncob_x);
+		dst[i].ncob_y = be32_to_cpu(src[i].ncob_y);
 	}
 }
 
 
-static void be_to_cpus_s_fx_efx_ncob_ecob(struct s_fx_efx_ncob_ecob *a, uint32_t samples)
+static void be_to_cpus_s_fx_efx_ncob_ecob(void *dst_buf, const void *src_buf, uint32_t samples)
 {
+	struct s_fx_efx_ncob_ecob *dst = dst_buf;
+	const struct s_fx_efx_ncob_ecob *src = src_buf;
 	uint32_t i;
 
 	for (i = 0; i < samples; i++) {
-		a[i].fx = be32_to_cpu(a[i].fx);
-		a[i].ncob_x = be32_to_cpu(a[i].ncob_x);
-		a[i].ncob_y = be32_to_cpu(a[i].ncob_y);
-		a[i].efx = be32_to_cpu(a[i].efx);
-		a[i].ecob_x = be32_to_cpu(a[i].ecob_x);
-		a[i].ecob_y = be32_to_cpu(a[i].ecob_y);
+		dst[i].exp_flags = src[i].exp_flags;
+		dst[i].fx = be32_to_cpu(src[i].fx);
+		dst[i].ncob_x = be32_to_cpu(src[i].ncob_x);
+		dst[i].ncob_y = be32_to_cpu(src[i].ncob_y);
+		dst[i].efx = be32_to_cpu(src[i].efx);
+		dst[i].ecob_x = be32_to_cpu(src[i].ecob_x);
+		dst[i].ecob_y = be32_to_cpu(src[i].ecob_y);
 	}
 }
 
 
-static void be_to_cpus_l_fx(struct l_fx *a, uint32_t samples)
+static void be_to_cpus_l_fx(void *dst_buf, const void *src_buf, uint32_t samples)
 {
+	struct l_fx *dst = dst_buf;
+	const struct l_fx *src = src_buf;
 	uint32_t i;
 
 	for (i = 0; i < samples; i++) {
-		a[i].exp_flags = be24_to_cpu(a[i].exp_flags);
-		a[i].fx = be32_to_cpu(a[i].fx);
-		a[i].fx_variance = be32_to_cpu(a[i].fx_variance);
+		dst[i].exp_flags = be24_to_cpu(src[i].exp_flags);
+		dst[i].fx = be32_to_cpu(src[i].fx);
+		dst[i].fx_variance = be32_to_cpu(src[i].fx_variance);
 	}
 }
 
 
-static void be_to_cpus_l_fx_efx(struct l_fx_efx *a, uint32_t samples)
+static void be_to_cpus_l_fx_efx(void *dst_buf, const void *src_buf, uint32_t samples)
 {
+	struct l_fx_efx *dst = dst_buf;
+	const struct l_fx_efx *src = src_buf;
 	uint32_t i;
 
 	for (i = 0; i < samples; i++) {
-		a[i].exp_flags = be24_to_cpu(a[i].exp_flags);
-		a[i].fx = be32_to_cpu(a[i].fx);
-		a[i].efx = be32_to_cpu(a[i].efx);
-		a[i].fx_variance = be32_to_cpu(a[i].fx_variance);
+		dst[i].exp_flags = be24_to_cpu(src[i].exp_flags);
+		dst[i].fx = be32_to_cpu(src[i].fx);
+		dst[i].efx = be32_to_cpu(src[i].efx);
+		dst[i].fx_variance = be32_to_cpu(src[i].fx_variance);
 	}
 }
 
 
-static void be_to_cpus_l_fx_ncob(struct l_fx_ncob *a, uint32_t samples)
+static void be_to_cpus_l_fx_ncob(void *dst_buf, const void *src_buf, uint32_t samples)
 {
+	struct l_fx_ncob *dst = dst_buf;
+	const struct l_fx_ncob *src = src_buf;
 	uint32_t i;
 
 	for (i = 0; i < samples; i++) {
-		a[i].exp_flags = be24_to_cpu(a[i].exp_flags);
-		a[i].fx = be32_to_cpu(a[i].fx);
-		a[i].ncob_x = be32_to_cpu(a[i].ncob_x);
-		a[i].ncob_y = be32_to_cpu(a[i].ncob_y);
-		a[i].fx_variance = be32_to_cpu(a[i].fx_variance);
-		a[i].cob_x_variance = be32_to_cpu(a[i].cob_x_variance);
-		a[i].cob_y_variance = be32_to_cpu(a[i].cob_y_variance);
+		dst[i].exp_flags = be24_to_cpu(src[i].exp_flags);
+		dst[i].fx = be32_to_cpu(src[i].fx);
+		dst[i].ncob_x = be32_to_cpu(src[i].ncob_x);
+		dst[i].ncob_y = be32_to_cpu(src[i].ncob_y);
+		dst[i].fx_variance = be32_to_cpu(src[i].fx_variance);
+		dst[i].cob_x_variance = be32_to_cpu(src[i].cob_x_variance);
+		dst[i].cob_y_variance = be32_to_cpu(src[i].cob_y_variance);
 	}
 }
 
 
-static void be_to_cpus_l_fx_efx_ncob_ecob(struct l_fx_efx_ncob_ecob *a, uint32_t samples)
+static void be_to_cpus_l_fx_efx_ncob_ecob(void *dst_buf, const void *src_buf, uint32_t samples)
 {
+	struct l_fx_efx_ncob_ecob *dst = dst_buf;
+	const struct l_fx_efx_ncob_ecob *src = src_buf;
 	uint32_t i;
 
 	for (i = 0; i < samples; i++) {
-		a[i].exp_flags = be24_to_cpu(a[i].exp_flags);
-		a[i].fx = be32_to_cpu(a[i].fx);
-		a[i].ncob_x = be32_to_cpu(a[i].ncob_x);
-		a[i].ncob_y = be32_to_cpu(a[i].ncob_y);
-		a[i].efx = be32_to_cpu(a[i].efx);
-		a[i].ecob_x = be32_to_cpu(a[i].ecob_x);
-		a[i].ecob_y = be32_to_cpu(a[i].ecob_y);
-		a[i].fx_variance = be32_to_cpu(a[i].fx_variance);
-		a[i].cob_x_variance = be32_to_cpu(a[i].cob_x_variance);
-		a[i].cob_y_variance = be32_to_cpu(a[i].cob_y_variance);
+		dst[i].exp_flags = be24_to_cpu(src[i].exp_flags);
+		dst[i].fx = be32_to_cpu(src[i].fx);
+		dst[i].ncob_x = be32_to_cpu(src[i].ncob_x);
+		dst[i].ncob_y = be32_to_cpu(src[i].ncob_y);
+		dst[i].efx = be32_to_cpu(src[i].efx);
+		dst[i].ecob_x = be32_to_cpu(src[i].ecob_x);
+		dst[i].ecob_y = be32_to_cpu(src[i].ecob_y);
+		dst[i].fx_variance = be32_to_cpu(src[i].fx_variance);
+		dst[i].cob_x_variance = be32_to_cpu(src[i].cob_x_variance);
+		dst[i].cob_y_variance = be32_to_cpu(src[i].cob_y_variance);
 	}
 }
 
 
-static void be_to_cpus_f_fx(struct f_fx *a, uint32_t samples)
+static void be_to_cpus_f_fx(void *dst_buf, const void *src_buf, uint32_t samples)
 {
+	struct f_fx *dst = dst_buf;
+	const struct f_fx *src = src_buf;
 	uint32_t i;
 
 	for (i = 0; i < samples; i++)
-		a[i].fx = be32_to_cpu(a[i].fx);
+		dst[i].fx = be32_to_cpu(src[i].fx);
 }
 
 
-static void be_to_cpus_f_fx_efx(struct f_fx_efx *a, uint32_t samples)
+static void be_to_cpus_f_fx_efx(void *dst_buf, const void *src_buf, uint32_t samples)
 {
+	struct f_fx_efx *dst = dst_buf;
+	const struct f_fx_efx *src = src_buf;
 	uint32_t i;
 
 	for (i = 0; i < samples; i++) {
-		a[i].fx = be32_to_cpu(a[i].fx);
-		a[i].efx = be32_to_cpu(a[i].efx);
+		dst[i].fx = be32_to_cpu(src[i].fx);
+		dst[i].efx = be32_to_cpu(src[i].efx);
 	}
 }
 
 
-static void be_to_cpus_f_fx_ncob(struct f_fx_ncob *a, uint32_t samples)
+static void be_to_cpus_f_fx_ncob(void *dst_buf, const void *src_buf, uint32_t samples)
 {
+	struct f_fx_ncob *dst = dst_buf;
+	const struct f_fx_ncob *src = src_buf;
 	uint32_t i;
 
 	for (i = 0; i < samples; i++) {
-		a[i].fx = be32_to_cpu(a[i].fx);
-		a[i].ncob_x = be32_to_cpu(a[i].ncob_x);
-		a[i].ncob_y = be32_to_cpu(a[i].ncob_y);
+		dst[i].fx = be32_to_cpu(src[i].fx);
+		dst[i].ncob_x = be32_to_cpu(src[i].ncob_x);
+		dst[i].ncob_y = be32_to_cpu(src[i].ncob_y);
 	}
 }
 
 
-static void be_to_cpus_f_fx_efx_ncob_ecob(struct f_fx_efx_ncob_ecob *a, uint32_t samples)
+static void be_to_cpus_f_fx_efx_ncob_ecob(void *dst_buf, const void *src_buf, uint32_t samples)
 {
+	struct f_fx_efx_ncob_ecob *dst = dst_buf;
+	const struct f_fx_efx_ncob_ecob *src = src_buf;
 	uint32_t i;
 
 	for (i = 0; i < samples; i++) {
-		a[i].fx = be32_to_cpu(a[i].fx);
-		a[i].ncob_x = be32_to_cpu(a[i].ncob_x);
-		a[i].ncob_y = be32_to_cpu(a[i].ncob_y);
-		a[i].efx = be32_to_cpu(a[i].efx);
-		a[i].ecob_x = be32_to_cpu(a[i].ecob_x);
-		a[i].ecob_y = be32_to_cpu(a[i].ecob_y);
+		dst[i].fx = be32_to_cpu(src[i].fx);
+		dst[i].ncob_x = be32_to_cpu(src[i].ncob_x);
+		dst[i].ncob_y = be32_to_cpu(src[i].ncob_y);
+		dst[i].efx = be32_to_cpu(src[i].efx);
+		dst[i].ecob_x = be32_to_cpu(src[i].ecob_x);
+		dst[i].ecob_y = be32_to_cpu(src[i].ecob_y);
 	}
 }
 
 
+/* maximum number of fields in a sample */
+#define SAMPLE_MAX_FIELDS	10
+/* largest sample size (struct l_fx_efx_ncob_ecob) */
+#define SAMPLE_MAX_SIZE		39
+
+
 /**
- * @brief swaps the endianness of (collection) data from big endian to the CPU
- *	endianness (or vice versa) in place.
- * @note if you want to swap the data of a whole collection, including a
- *	collection header or a chunk of collections use the be_to_cpu_chunk() or
- *	cpu_to_be_chunk() functions
+ * @brief byte layout of a sample
+ * @note the field sizes in bits are also the maximum used bits of the fields
+ */
+
+struct sample_layout {
+	uint8_t sample_size;			/**< size of a sample in bytes */
+	uint8_t num_fields;			/**< number of fields in a sample */
+	uint8_t field_size[SAMPLE_MAX_FIELDS];	/**< byte size of every field; 1 byte fields are not swapped */
+	uint8_t swap_width;			/**< byte size of the fields if all fields are 2 or 4 bytes wide, otherwise 0; only these layouts are swapped with SSSE3 */
+};
+
+static const struct sample_layout layout_16 = {2, 1, {2}, 2};
+static const struct sample_layout layout_offset = {8, 2, {4, 4}, 4};
+static const struct sample_layout layout_background = {10, 3, {4, 4, 2}, 0};
+static const struct sample_layout layout_s_fx = {5, 2, {1, 4}, 0};
+static const struct sample_layout layout_s_fx_efx = {9, 3, {1, 4, 4}, 0};
+static const struct sample_layout layout_s_fx_ncob = {13, 4, {1, 4, 4, 4}, 0};
+static const struct sample_layout layout_s_fx_efx_ncob_ecob = {25, 7, {1, 4, 4, 4, 4, 4, 4}, 0};
+static const struct sample_layout layout_l_fx = {11, 3, {3, 4, 4}, 0};
+static const struct sample_layout layout_l_fx_efx = {15, 4, {3, 4, 4, 4}, 0};
+static const struct sample_layout layout_l_fx_ncob = {27, 7, {3, 4, 4, 4, 4, 4, 4}, 0};
+static const struct sample_layout layout_l_fx_efx_ncob_ecob = {39, 10, {3, 4, 4, 4, 4, 4, 4, 4, 4, 4}, 0};
+static const struct sample_layout layout_f_fx = {4, 1, {4}, 4};
+static const struct sample_layout layout_f_fx_efx = {8, 2, {4, 4}, 4};
+static const struct sample_layout layout_f_fx_ncob = {12, 3, {4, 4, 4}, 4};
+static const struct sample_layout layout_f_fx_efx_ncob_ecob = {24, 6, {4, 4, 4, 4, 4, 4}, 4};
+
+compile_time_assert(sizeof(uint16_t) == 2, IMAGETTE_SAMPLE_LAYOUT);
+compile_time_assert(sizeof(struct offset) == 8, OFFSET_SAMPLE_LAYOUT);
+compile_time_assert(sizeof(struct background) == 10, BACKGROUND_SAMPLE_LAYOUT);
+compile_time_assert(sizeof(struct smearing) == 10, SMEARING_SAMPLE_LAYOUT);
+compile_time_assert(sizeof(struct s_fx) == 5, S_FX_SAMPLE_LAYOUT);
+compile_time_assert(sizeof(struct s_fx_efx) == 9, S_FX_EFX_SAMPLE_LAYOUT);
+compile_time_assert(sizeof(struct s_fx_ncob) == 13, S_FX_NCOB_SAMPLE_LAYOUT);
+compile_time_assert(sizeof(struct s_fx_efx_ncob_ecob) == 25, S_FX_EFX_NCOB_ECOB_SAMPLE_LAYOUT);
+compile_time_assert(sizeof(struct l_fx) == 11, L_FX_SAMPLE_LAYOUT);
+compile_time_assert(sizeof(struct l_fx_efx) == 15, L_FX_EFX_SAMPLE_LAYOUT);
+compile_time_assert(sizeof(struct l_fx_ncob) == 27, L_FX_NCOB_SAMPLE_LAYOUT);
+compile_time_assert(sizeof(struct l_fx_efx_ncob_ecob) == SAMPLE_MAX_SIZE, L_FX_EFX_NCOB_ECOB_SAMPLE_LAYOUT);
+compile_time_assert(sizeof(struct f_fx) == 4, F_FX_SAMPLE_LAYOUT);
+compile_time_assert(sizeof(struct f_fx_efx) == 8, F_FX_EFX_SAMPLE_LAYOUT);
+compile_time_assert(sizeof(struct f_fx_ncob) == 12, F_FX_NCOB_SAMPLE_LAYOUT);
+compile_time_assert(sizeof(struct f_fx_efx_ncob_ecob) == 24, F_FX_EFX_NCOB_ECOB_SAMPLE_LAYOUT);
+
+
+/**
+ * @brief metadata of a compression data type
+ */
+
+struct data_type_info {
+	uint8_t subservice;			/**< associated collection subservice */
+	const struct sample_layout *layout;	/**< byte layout of a sample */
+	void (*be_to_cpus)(void *dst, const void *src, uint32_t samples); /**< endianness converter */
+};
+
+
+/**
+ * @brief compression data type metadata indexed by the data type; unsupported
+ *	data types have no layout
+ */
+
+static const struct data_type_info data_type_lut[DATA_TYPE_CHUNK + 1] = {
+	[DATA_TYPE_IMAGETTE] = {SST_NCxx_S_SCIENCE_IMAGETTE, &layout_16, be_to_cpus_16},
+	[DATA_TYPE_IMAGETTE_ADAPTIVE] = {SST_NCxx_S_SCIENCE_IMAGETTE, &layout_16, be_to_cpus_16},
+	[DATA_TYPE_SAT_IMAGETTE] = {SST_NCxx_S_SCIENCE_SAT_IMAGETTE, &layout_16, be_to_cpus_16},
+	[DATA_TYPE_SAT_IMAGETTE_ADAPTIVE] = {SST_NCxx_S_SCIENCE_SAT_IMAGETTE, &layout_16, be_to_cpus_16},
+	[DATA_TYPE_OFFSET] = {SST_NCxx_S_SCIENCE_OFFSET, &layout_offset, be_to_cpus_offset},
+	[DATA_TYPE_BACKGROUND] = {SST_NCxx_S_SCIENCE_BACKGROUND, &layout_background, be_to_cpus_background},
+	[DATA_TYPE_SMEARING] = {SST_NCxx_S_SCIENCE_SMEARING, &layout_background, be_to_cpus_smearing},
+	[DATA_TYPE_S_FX] = {SST_NCxx_S_SCIENCE_S_FX, &layout_s_fx, be_to_cpus_s_fx},
+	[DATA_TYPE_S_FX_EFX] = {SST_NCxx_S_SCIENCE_S_FX_EFX, &layout_s_fx_efx, be_to_cpus_s_fx_efx},
+	[DATA_TYPE_S_FX_NCOB] = {SST_NCxx_S_SCIENCE_S_FX_NCOB, &layout_s_fx_ncob, be_to_cpus_s_fx_ncob},
+	[DATA_TYPE_S_FX_EFX_NCOB_ECOB] = {SST_NCxx_S_SCIENCE_S_FX_EFX_NCOB_ECOB,
+		&layout_s_fx_efx_ncob_ecob, be_to_cpus_s_fx_efx_ncob_ecob},
+	[DATA_TYPE_L_FX] = {SST_NCxx_S_SCIENCE_L_FX, &layout_l_fx, be_to_cpus_l_fx},
+	[DATA_TYPE_L_FX_EFX] = {SST_NCxx_S_SCIENCE_L_FX_EFX, &layout_l_fx_efx, be_to_cpus_l_fx_efx},
+	[DATA_TYPE_L_FX_NCOB] = {SST_NCxx_S_SCIENCE_L_FX_NCOB, &layout_l_fx_ncob, be_to_cpus_l_fx_ncob},
+	[DATA_TYPE_L_FX_EFX_NCOB_ECOB] = {SST_NCxx_S_SCIENCE_L_FX_EFX_NCOB_ECOB,
+		&layout_l_fx_efx_ncob_ecob, be_to_cpus_l_fx_efx_ncob_ecob},
+	[DATA_TYPE_F_FX] = {SST_NCxx_S_SCIENCE_F_FX, &layout_f_fx, be_to_cpus_f_fx},
+	[DATA_TYPE_F_FX_EFX] = {SST_NCxx_S_SCIENCE_F_FX_EFX, &layout_f_fx_efx, be_to_cpus_f_fx_efx},
+	[DATA_TYPE_F_FX_NCOB] = {SST_NCxx_S_SCIENCE_F_FX_NCOB, &layout_f_fx_ncob, be_to_cpus_f_fx_ncob},
+	[DATA_TYPE_F_FX_EFX_NCOB_ECOB] = {SST_NCxx_S_SCIENCE_F_FX_EFX_NCOB_ECOB,
+		&layout_f_fx_efx_ncob_ecob, be_to_cpus_f_fx_efx_ncob_ecob},
+	[DATA_TYPE_F_CAM_IMAGETTE] = {SST_FCx_S_SCIENCE_IMAGETTE, &layout_16, be_to_cpus_16},
+	[DATA_TYPE_F_CAM_IMAGETTE_ADAPTIVE] = {SST_FCx_S_SCIENCE_IMAGETTE, &layout_16, be_to_cpus_16},
+	[DATA_TYPE_F_CAM_OFFSET] = {SST_FCx_S_SCIENCE_OFFSET_VALUES, &layout_offset, be_to_cpus_offset},
+	[DATA_TYPE_F_CAM_BACKGROUND] = {SST_FCx_S_BACKGROUND_VALUES, &layout_background, be_to_cpus_background},
+};
+
+
+/**
+ * @brief compression data types indexed by the (6 bit) collection subservice
+ */
+
+static const uint8_t subservice_lut[64] = {
+	[SST_NCxx_S_SCIENCE_IMAGETTE] = DATA_TYPE_IMAGETTE,
+	[SST_NCxx_S_SCIENCE_SAT_IMAGETTE] = DATA_TYPE_SAT_IMAGETTE,
+	[SST_NCxx_S_SCIENCE_OFFSET] = DATA_TYPE_OFFSET,
+	[SST_NCxx_S_SCIENCE_BACKGROUND] = DATA_TYPE_BACKGROUND,
+	[SST_NCxx_S_SCIENCE_SMEARING] = DATA_TYPE_SMEARING,
+	[SST_NCxx_S_SCIENCE_S_FX] = DATA_TYPE_S_FX,
+	[SST_NCxx_S_SCIENCE_S_FX_EFX] = DATA_TYPE_S_FX_EFX,
+	[SST_NCxx_S_SCIENCE_S_FX_NCOB] = DATA_TYPE_S_FX_NCOB,
+	[SST_NCxx_S_SCIENCE_S_FX_EFX_NCOB_ECOB] = DATA_TYPE_S_FX_EFX_NCOB_ECOB,
+	[SST_NCxx_S_SCIENCE_L_FX] = DATA_TYPE_L_FX,
+	[SST_NCxx_S_SCIENCE_L_FX_EFX] = DATA_TYPE_L_FX_EFX,
+	[SST_NCxx_S_SCIENCE_L_FX_NCOB] = DATA_TYPE_L_FX_NCOB,
+	[SST_NCxx_S_SCIENCE_L_FX_EFX_NCOB_ECOB] = DATA_TYPE_L_FX_EFX_NCOB_ECOB,
+	[SST_NCxx_S_SCIENCE_F_FX] = DATA_TYPE_F_FX,
+	[SST_NCxx_S_SCIENCE_F_FX_EFX] = DATA_TYPE_F_FX_EFX,
+	[SST_NCxx_S_SCIENCE_F_FX_NCOB] = DATA_TYPE_F_FX_NCOB,
+	[SST_NCxx_S_SCIENCE_F_FX_EFX_NCOB_ECOB] = DATA_TYPE_F_FX_EFX_NCOB_ECOB,
+	[SST_FCx_S_SCIENCE_IMAGETTE] = DATA_TYPE_F_CAM_IMAGETTE,
+	[SST_FCx_S_SCIENCE_OFFSET_VALUES] = DATA_TYPE_F_CAM_OFFSET,
+	[SST_FCx_S_BACKGROUND_VALUES] = DATA_TYPE_F_CAM_BACKGROUND,
+};
+
+compile_time_assert(DATA_TYPE_UNKNOWN == 0, UNKNOWN_DATA_TYPE_IS_ZERO);
+compile_time_assert(DATA_TYPE_CHUNK <= UINT8_MAX, DATA_TYPE_FITS_IN_LUT);
+
+
+/**
+ * @brief get the metadata of a compression data type
  *
- * @param data			a pointer to the data to swap (not including a
+ * @param data_type	compression data type
+ *
+ * @returns a pointer to the metadata; NULL on unknown or unsupported data type
+ */
+
+static const struct data_type_info *get_data_type_info(enum cmp_data_type data_type)
+{
+	if ((unsigned int)data_type >= ARRAY_SIZE(data_type_lut) ||
+	    !data_type_lut[data_type].layout)
+		return NULL;
+
+	return &data_type_lut[data_type];
+}
+
+
+/**
+ * @brief converts a subservice to its associated compression data type
+ *
+ * @param subservice	collection subservice type
+ *
+ * @returns the converted compression data type; DATA_TYPE_UNKNOWN if the
+ *	subservice is unknown
+ */
+
+enum cmp_data_type convert_subservice_to_cmp_data_type(uint8_t subservice)
+{
+	if (subservice >= ARRAY_SIZE(subservice_lut))
+		return DATA_TYPE_UNKNOWN;
+
+	return (enum cmp_data_type)subservice_lut[subservice];
+}
+
+
+/**
+ * @brief converts a compression data type to its associated subservice.
+ *
+ * @param data_type	compression data type
+ *
+ * @returns the converted subservice; -1 if the data type is unknown.
+ */
+
+uint8_t convert_cmp_data_type_to_subservice(enum cmp_data_type data_type)
+{
+	const struct data_type_info *info = get_data_type_info(data_type);
+
+	if (!info) {
+		debug_print("Error: Unknown compression data type!");
+		return (uint8_t)-1;
+	}
+
+	return info->subservice;
+}
+
+
+/**
+ * @brief calculate the size of a sample for the different compression data type
+ *
+ * @param data_type	compression data_type
+ *
+ * @returns the size of a data sample in bytes for the selected compression
+ *	data type; zero on unknown data type
+ */
+
+size_t size_of_a_sample(enum cmp_data_type data_type)
+{
+	const struct data_type_info *info = get_data_type_info(data_type);
+
+	if (!info) {
+		debug_print("Error: Compression data type is not supported.");
+		return 0;
+	}
+
+	return info->layout->sample_size;
+}
+
+
+#ifdef HAS_SSSE3_SWAP
+/**
+ * @brief byte shuffle masks swapping all 2 byte (index 0) or all 4 byte
+ *	(index 1) fields of a 16 byte block
+ */
+
+static const uint8_t swap_shuffle_masks[2][16] __attribute__((aligned(16))) = {
+	{1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14},
+	{3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12}
+};
+
+
+/**
+ * @brief copy the samples from src to dst and swap them with SSSE3 byte
+ *	shuffles; src and dst can be the same buffer
+ *
+ * Only layouts with a swap_width are supported: all their fields have the
+ * same width and do not cross a 16 byte block border, so every block is
+ * swapped with the same static mask. Layouts with 1, 2 or 3 byte fields in
+ * odd positions would need two additional shuffles per block; this is not
+ * faster than the scalar swaps, so they are left to the scalar code. Only
+ * whole periods of the least common multiple of the sample size and 16 bytes
+ * are processed.
+ *
+ * @returns the number of swapped samples; the remaining samples are left for
+ *	the scalar code
+ */
+
+__attribute__((target("ssse3")))
+static uint32_t swap_samples_ssse3(uint8_t *dst, const uint8_t *src,
+				   uint32_t samples, const struct sample_layout *layout)
+{
+	uint32_t const ss = layout->sample_size;
+	uint32_t const low_bit = ss & (~ss + 1); /* largest power of two dividing ss */
+	uint32_t const period = ss / (low_bit < 16 ? low_bit : 16); /* = lcm(ss, 16) / 16 */
+	uint32_t const num_blocks = samples * ss / (16 * period) * period;
+	__m128i const mask = _mm_load_si128((const __m128i *)swap_shuffle_masks[layout->swap_width / 4]);
+	uint32_t j;
+
+	for (j = 0; j < num_blocks; j++) {
+		__m128i const v = _mm_loadu_si128((const __m128i *)(src + 16*j));
+
+		_mm_storeu_si128((__m128i *)(dst + 16*j), _mm_shuffle_epi8(v, mask));
+	}
+
+	return num_blocks * 16 / ss;
+}
+
+
+/**
+ * @brief check if the CPU supports SSSE3
+ */
+
+static int cpu_has_ssse3(void)
+{
+	static int has_ssse3 = -1;
+
+	if (has_ssse3 < 0) {
+		__builtin_cpu_init();
+		has_ssse3 = __builtin_cpu_supports("ssse3") != 0;
+	}
+	return has_ssse3;
+}
+#endif /* HAS_SSSE3_SWAP */
+
+
+/**
+ * @brief copies (collection) data and swaps the endianness from big endian to
+ *	the CPU endianness (or vice versa) in one pass
+ * @note this replaces a memcpy() followed by be_to_cpu_data_type(), which
+ *	touches the data twice
+ *
+ * @param dst			pointer to the destination buffer; can be the same
+ *				as src for an in-place conversion
+ * @param src			pointer to the data to swap (not including a
  *				collection header); can be NULL
  * @param data_size_byte	size of the data in bytes
  * @param data_type		compression data type
@@ -821,133 +919,159 @@ static void be_to_cpus_f_fx_efx_ncob_ecob(struct f_fx_efx_ncob_ecob *a, uint32_t
  * @returns 0 on success; -1 on failure
  */
 
-int be_to_cpu_data_type(void *data, uint32_t data_size_byte, enum cmp_data_type data_type)
+int be_to_cpu_data_type_copy(void *dst, const void *src, uint32_t data_size_byte,
+			     enum cmp_data_type data_type)
 {
-	uint32_t sample_size = (uint32_t)size_of_a_sample(data_type);
-	uint32_t samples;
+	const struct data_type_info *info = get_data_type_info(data_type);
+	uint32_t sample_size, samples;
 
-	if (!data) /* nothing to do */
+	if (!src) /* nothing to do */
 		return 0;
 
-	if (!sample_size)
+	if (!dst)
 		return -1;
 
+	if (!info) {
+		debug_print("Error: Can not swap endianness for this compression data type.");
+		return -1;
+	}
+	sample_size = info->layout->sample_size;
+
 	if (data_size_byte % sample_size) {
 		debug_print("Error: Can not convert data size in samples.");
 		return -1;
 	}
 	samples = data_size_byte / sample_size;
 
-	if (CMP_IS_BIG_ENDIAN)
+	if (dst != src && (const uint8_t *)dst < (const uint8_t *)src + data_size_byte &&
+	    (const uint8_t *)src < (const uint8_t *)dst + data_size_byte) {
+		/* overlapping buffers; fall back to an in-place conversion */
+		memmove(dst, src, data_size_byte);
+		src = dst;
+	}
+
+	if (CMP_IS_BIG_ENDIAN) {
+		if (dst != src)
+			memcpy(dst, src, data_size_byte);
 		return 0;
+	}
 
-	switch (data_type) {
-	case DATA_TYPE_IMAGETTE:
-	case DATA_TYPE_IMAGETTE_ADAPTIVE:
-	case DATA_TYPE_SAT_IMAGETTE:
-	case DATA_TYPE_SAT_IMAGETTE_ADAPTIVE:
-	case DATA_TYPE_F_CAM_IMAGETTE:
-	case DATA_TYPE_F_CAM_IMAGETTE_ADAPTIVE:
-		be_to_cpus_16(data, samples);
-		break;
-	case DATA_TYPE_OFFSET:
-	case DATA_TYPE_F_CAM_OFFSET:
-		be_to_cpus_offset(data, samples);
-		break;
-	case DATA_TYPE_BACKGROUND:
-	case DATA_TYPE_F_CAM_BACKGROUND:
-		be_to_cpus_background(data, samples);
-		break;
-	case DATA_TYPE_SMEARING:
-		be_to_cpus_smearing(data, samples);
-		break;
-	case DATA_TYPE_S_FX:
-		be_to_cpus_s_fx(data, samples);
-		break;
-	case DATA_TYPE_S_FX_EFX:
-		be_to_cpus_s_fx_efx(data, samples);
-		break;
-	case DATA_TYPE_S_FX_NCOB:
-		be_to_cpus_s_fx_ncob(data, samples);
-		break;
-	case DATA_TYPE_S_FX_EFX_NCOB_ECOB:
-		be_to_cpus_s_fx_efx_ncob_ecob(data, samples);
-		break;
-	case DATA_TYPE_L_FX:
-		be_to_cpus_l_fx(data, samples);
-		break;
-	case DATA_TYPE_L_FX_EFX:
-		be_to_cpus_l_fx_efx(data, samples);
-		break;
-	case DATA_TYPE_L_FX_NCOB:
-		be_to_cpus_l_fx_ncob(data, samples);
-		break;
-	case DATA_TYPE_L_FX_EFX_NCOB_ECOB:
-		be_to_cpus_l_fx_efx_ncob_ecob(data, samples);
-		break;
-	case DATA_TYPE_F_FX:
-		be_to_cpus_f_fx(data, samples);
-		break;
-	case DATA_TYPE_F_FX_EFX:
-		be_to_cpus_f_fx_efx(data, samples);
-		break;
-	case DATA_TYPE_F_FX_NCOB:
-		be_to_cpus_f_fx_ncob(data, samples);
-		break;
-	case DATA_TYPE_F_FX_EFX_NCOB_ECOB:
-		be_to_cpus_f_fx_efx_ncob_ecob(data, samples);
-		break;
-	/* LCOV_EXCL_START */
-	default:
-		debug_print("Error: Can not swap endianness for this compression data type.");
-		return -1;
-	/* LCOV_EXCL_STOP */
+#ifdef HAS_SSSE3_SWAP
+	if (info->layout->swap_width && cpu_has_ssse3()) {
+		uint32_t const done = swap_samples_ssse3(dst, src, samples, info->layout);
+
+		dst = (uint8_t *)dst + done * sample_size;
+		src = (const uint8_t *)src + done * sample_size;
+		samples -= done;
 	}
+#endif
+
+	info->be_to_cpus(dst, src, samples);
 
 	return 0;
 }
 
 
 /**
- * @brief swaps the endianness of chunk data from big endian to the CPU
- *	endianness (or vice versa) in place
- * @note the endianness of the collection header is not changed!
+ * @brief swaps the endianness of (collection) data from big endian to the CPU
+ *	endianness (or vice versa) in place.
+ * @note if you want to swap the data of a whole collection, including a
+ *	collection header or a chunk of collections use the be_to_cpu_chunk() or
+ *	cpu_to_be_chunk() functions
  *
- * @param chunk		pointer to a chunk of collections (can be NULL)
+ * @param data			a pointer to the data to swap (not including a
+ *				collection header); can be NULL
+ * @param data_size_byte	size of the data in bytes
+ * @param data_type		compression data type
+ *
+ * @returns 0 on success; -1 on failure
+ */
+
+int be_to_cpu_data_type(void *data, uint32_t data_size_byte, enum cmp_data_type data_type)
+{
+	return be_to_cpu_data_type_copy(data, data, data_size_byte, data_type);
+}
+
+
+/**
+ * @brief copies chunk data and swaps the endianness from big endian to the CPU
+ *	endianness (or vice versa) in one pass
+ * @note the collection headers are copied without changing the endianness;
+ *	on failure the bytes after the last converted collection are copied
+ *	unchanged
+ *
+ * @param dst		pointer to the destination buffer with a size of at
+ *			least chunk_size; can be the same as src
+ * @param src		pointer to a chunk of collections (can be NULL)
  * @param chunk_size	size in bytes of the chunk
  *
  * @returns 0 on success; -1 on failure
  */
 
-int be_to_cpu_chunk(uint8_t *chunk, size_t chunk_size)
+int be_to_cpu_chunk_copy(uint8_t *dst, const uint8_t *src, size_t chunk_size)
 {
-	uint8_t *col_p = chunk;
+	size_t pos = 0;
+	int err = 0;
 
-	if (!chunk) /* nothing to do */
+	if (!src) /* nothing to do */
 		return 0;
 
+	if (!dst)
+		return -1;
+
 	if (chunk_size < COLLECTION_HDR_SIZE)
 		return -1;
 
-	while (col_p <= chunk + chunk_size - COLLECTION_HDR_SIZE) {
-		struct collection_hdr *col_hdr = (struct collection_hdr *)col_p;
+	if (dst != src && dst < src + chunk_size && src < dst + chunk_size) {
+		/* overlapping buffers; fall back to an in-place conversion */
+		memmove(dst, src, chunk_size);
+		src = dst;
+	}
+
+	while (pos + COLLECTION_HDR_SIZE <= chunk_size) {
+		const struct collection_hdr *col_hdr = (const struct collection_hdr *)(src + pos);
 		enum cmp_data_type data_type = convert_subservice_to_cmp_data_type(cmp_col_get_subservice(col_hdr));
 		uint32_t data_size = cmp_col_get_data_length(col_hdr);
+		size_t col_size = cmp_col_get_size(col_hdr);
 
-		col_p += cmp_col_get_size(col_hdr);
-		if (col_p > chunk + chunk_size)  /* over read chunk? */
+		if (col_size > chunk_size - pos)  /* over read chunk? */
 			break;
 
-		if (be_to_cpu_data_type(col_hdr->entry, data_size, data_type))
-			return -1;
+		if (be_to_cpu_data_type_copy(dst + pos + COLLECTION_HDR_SIZE,
+					     col_hdr->entry, data_size, data_type)) {
+			err = -1;
+			break;
+		}
+		if (dst != src)
+			memcpy(dst + pos, col_hdr, COLLECTION_HDR_SIZE);
+		pos += col_size;
 	}
 
-	if (col_p != chunk + chunk_size) {
+	if (!err && pos != chunk_size) {
 		debug_print("Error: The chunk size does not match the sum of the collection sizes.");
-		return -1;
+		err = -1;
 	}
+	if (err && dst != src)
+		memcpy(dst + pos, src + pos, chunk_size - pos);
 
-	return 0;
+	return err;
+}
+
+
+/**
+ * @brief swaps the endianness of chunk data from big endian to the CPU
+ *	endianness (or vice versa) in place
+ * @note the endianness of the collection header is not changed!
+ *
+ * @param chunk		pointer to a chunk of collections (can be NULL)
+ * @param chunk_size	size in bytes of the chunk
+ *
+ * @returns 0 on success; -1 on failure
+ */
+
+int be_to_cpu_chunk(uint8_t *chunk, size_t chunk_size)
+{
+	return be_to_cpu_chunk_copy(chunk, chunk, chunk_size);
 }
 
 
@@ -205,6 +205,25 @@ struct f_fx_efx_ncob_ecob {
 } __attribute__((packed));
 
 
+/*
+ * The short and fast cadence flux/COB samples consist of the exposure flags
+ * (short cadence only) followed by the 32-bit fields fx, ncob_x, ncob_y, efx,
+ * ecob_x and ecob_y; the fields not in the data type are left out. The
+ * FX_COB_* flags describe the fields of a data type.
+ */
+#define FX_COB_EXP_FLAGS	(1U << 0) /* 8-bit short cadence exposure flags */
+#define FX_COB_NCOB		(1U << 1) /* normal center of brightness */
+#define FX_COB_EFX		(1U << 2) /* extended flux */
+#define FX_COB_ECOB		(1U << 3) /* extended center of brightness */
+#define FX_COB_MAX_VALUES	6	  /* maximum number of 32-bit fields */
+compile_time_assert(offsetof(struct s_fx_efx_ncob_ecob, ecob_y) == 1 + 5*sizeof(uint32_t),
+		    S_FX_COB_FIELDS_ARE_NOT_CONSECUTIVE);
+compile_time_assert(offsetof(struct s_fx_efx, efx) == 1 + sizeof(uint32_t),
+		    S_FX_EFX_FIELDS_ARE_NOT_CONSECUTIVE);
+compile_time_assert(offsetof(struct f_fx_efx_ncob_ecob, ecob_y) == 5*sizeof(uint32_t),
+		    F_FX_COB_FIELDS_ARE_NOT_CONSECUTIVE);
+
+
 /**
  * @brief long cadence normal light flux entry definition
  */
@@ -334,9 +353,16 @@ size_t size_of_a_sample(enum cmp_data_type data_type);
 int be_to_cpu_data_type(void *data, uint32_t data_size_byte, enum cmp_data_type data_type);
 #define cpu_to_be_data_type(data, data_size_byte, data_type) be_to_cpu_data_type(data, data_size_byte, data_type)
 
+int be_to_cpu_data_type_copy(void *dst, const void *src, uint32_t data_size_byte,
+			     enum cmp_data_type data_type);
+#define cpu_to_be_data_type_copy(dst, src, data_size_byte, data_type) be_to_cpu_data_type_copy(dst, src, data_size_byte, data_type)
+
 int be_to_cpu_chunk(uint8_t *chunk, size_t chunk_size);
 #define cpu_to_be_chunk(chunk, chunk_size) be_to_cpu_chunk(chunk, chunk_size)
 
+int be_to_cpu_chunk_copy(uint8_t *dst, const uint8_t *src, size_t chunk_size);
+#define cpu_to_be_chunk_copy(dst, src, chunk_size) be_to_cpu_chunk_copy(dst, src, chunk_size)
+
 int cmp_input_big_to_cpu_endianness(void *data, uint32_t data_size_byte,
 				    enum cmp_data_type data_type);
 
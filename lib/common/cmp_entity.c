@@ -19,6 +19,7 @@
 
 
 #include <stdint.h>
+#include <stddef.h>
 #include <string.h>
 
 #ifndef ICU_ASW
@@ -1894,6 +1895,207 @@ uint32_t cmp_ent_create(struct cmp_entity *ent, enum cmp_data_type data_type,
 }
 
 
+/* byte offsets of the fields in the compression entity header */
+#define ENT_OFF_CMP_ENT_SIZE	4
+#define ENT_OFF_ORIGINAL_SIZE	7
+#define ENT_OFF_START_TIME	10
+#define ENT_OFF_END_TIME	16
+#define ENT_IMA_PAR_SIZE	3 /* 16 bit spillover threshold + 8 bit Golomb parameter */
+#define ENT_NON_IMA_PAR_SIZE	5 /* 24 bit spillover threshold + 16 bit compression parameter */
+
+compile_time_assert(offsetof(struct cmp_entity, data_type) == ENT_OFF_END_TIME + 6,
+		    CMP_ENT_HDR_OFFSETS_ARE_NOT_CORRECT);
+compile_time_assert(offsetof(struct cmp_entity, ima) == GENERIC_HEADER_SIZE,
+		    CMP_ENT_SPECIFIC_HDR_OFFSET_IS_NOT_CORRECT);
+
+
+/**
+ * @brief decode a whole compression entity header
+ *
+ * In contrast to the cmp_ent_get_* functions, the header is read in a single
+ * pass and is validated once: the data product type must be known, the
+ * entity must be large enough to hold the header of its data product type and
+ * the entity must fit into the buffer. No byte after buf_size is read.
+ *
+ * @param ent		pointer to a compression entity
+ * @param buf_size	number of bytes readable from ent
+ * @param hdr		pointer to a structure where the decoded header is stored
+ *
+ * @returns 0 on success, otherwise error
+ */
+
+int cmp_ent_hdr_decode(const struct cmp_entity *ent, size_t buf_size,
+		       struct cmp_ent_hdr *hdr)
+{
+	const uint8_t *p = (const uint8_t *)ent;
+	uint32_t data_type, hdr_size;
+	unsigned int i, num_pars;
+
+	if (!ent || !hdr)
+		return -1;
+
+	memset(hdr, 0, sizeof(*hdr));
+
+	if (buf_size < GENERIC_HEADER_SIZE) {
+		debug_print("Error: The buffer is too small for a compression entity header.");
+		return -1;
+	}
+
+	hdr->version_id = (uint32_t)get_unaligned_be(p, 4);
+	hdr->cmp_ent_size = (uint32_t)get_unaligned_be(p + ENT_OFF_CMP_ENT_SIZE, 3);
+	hdr->original_size = (uint32_t)get_unaligned_be(p + ENT_OFF_ORIGINAL_SIZE, 3);
+	hdr->start_timestamp = get_unaligned_be(p + ENT_OFF_START_TIME, 6);
+	hdr->end_timestamp = get_unaligned_be(p + ENT_OFF_END_TIME, 6);
+
+	data_type = (uint32_t)get_unaligned_be(p + offsetof(struct cmp_entity, data_type), 2);
+	hdr->raw_mode_flag = (data_type >> RAW_BIT_DATA_TYPE_POS) & 1U;
+	hdr->data_type = data_type & ((1U << RAW_BIT_DATA_TYPE_POS)-1);
+
+	hdr->cmp_mode = ent->cmp_mode_used;
+	hdr->model_value = ent->model_value_used;
+	hdr->model_id = (uint32_t)get_unaligned_be(p + offsetof(struct cmp_entity, model_id), 2);
+	hdr->model_counter = ent->model_counter;
+	hdr->reserved = ent->reserved;
+	hdr->lossy_cmp_par = (uint32_t)get_unaligned_be(p + offsetof(struct cmp_entity, lossy_cmp_par_used), 2);
+
+	if (cmp_data_type_is_invalid(hdr->data_type)) {
+		debug_print("Error: The compression entity data product type is unknown.");
+		hdr->data_type = DATA_TYPE_UNKNOWN;
+		return -1;
+	}
+	hdr_size = cmp_ent_cal_hdr_size(hdr->data_type, hdr->raw_mode_flag);
+	if (hdr_size > hdr->cmp_ent_size) {
+		debug_print("Error: The compression entity size is smaller than the entity header.");
+		return -1;
+	}
+	if (hdr->cmp_ent_size > buf_size) {
+		debug_print("Error: The compression entity is larger than the buffer.");
+		return -1;
+	}
+
+	/* read the specific header; no specific header is used in raw mode */
+	p += GENERIC_HEADER_SIZE;
+	switch (hdr_size - GENERIC_HEADER_SIZE) {
+	case SPECIFIC_IMAGETTE_HEADER_SIZE:
+	case SPECIFIC_IMAGETTE_ADAPTIVE_HEADER_SIZE:
+		/* the spare byte of the imagette header holds the adaptive parameters */
+		num_pars = hdr_size == IMAGETTE_HEADER_SIZE ? 1 : 3;
+		for (i = 0; i < num_pars; i++, p += ENT_IMA_PAR_SIZE) {
+			hdr->spill[i] = (uint32_t)get_unaligned_be(p, 2);
+			hdr->cmp_par[i] = p[2];
+		}
+		break;
+	case SPECIFIC_NON_IMAGETTE_HEADER_SIZE:
+		for (i = 0; i < CMP_ENT_MAX_PARS; i++, p += ENT_NON_IMA_PAR_SIZE) {
+			hdr->spill[i] = (uint32_t)get_unaligned_be(p, 3);
+			hdr->cmp_par[i] = (uint32_t)get_unaligned_be(p + 3, 2);
+		}
+		break;
+	default:
+		break;
+	}
+
+	return 0;
+}
+
+
+/**
+ * @brief encode a whole compression entity header
+ *
+ * All fields are range checked before anything is written, so the entity is
+ * not modified on error. The spare fields of the specific header are set to
+ * zero; no specific header is written in raw mode.
+ *
+ * @param ent	pointer to a compression entity; must be large enough to hold
+ *		the header of hdr->data_type
+ * @param hdr	pointer to the header to encode
+ *
+ * @returns 0 on success, otherwise error
+ */
+
+int cmp_ent_hdr_encode(struct cmp_entity *ent, const struct cmp_ent_hdr *hdr)
+{
+	uint8_t *p = (uint8_t *)ent;
+	uint32_t hdr_size, spec_size, max_spill, max_par;
+	unsigned int i, num_pars;
+
+	if (!ent || !hdr)
+		return -1;
+
+	hdr_size = cmp_ent_cal_hdr_size(hdr->data_type, hdr->raw_mode_flag);
+	if (!hdr_size || hdr->data_type > 0x7FF)
+		return -1;
+	if (hdr->cmp_ent_size > CMP_ENTITY_MAX_SIZE ||
+	    hdr->original_size > CMP_ENTITY_MAX_ORIGINAL_SIZE ||
+	    hdr->start_timestamp > 0xFFFFFFFFFFFFULL ||
+	    hdr->end_timestamp > 0xFFFFFFFFFFFFULL ||
+	    (uint32_t)hdr->cmp_mode > UINT8_MAX ||
+	    hdr->model_value > UINT8_MAX ||
+	    hdr->model_id > UINT16_MAX ||
+	    hdr->model_counter > UINT8_MAX ||
+	    hdr->reserved > UINT8_MAX ||
+	    hdr->lossy_cmp_par > UINT16_MAX)
+		return -1;
+
+	spec_size = hdr_size - GENERIC_HEADER_SIZE;
+	switch (spec_size) {
+	case SPECIFIC_IMAGETTE_HEADER_SIZE:
+		num_pars = 1;
+		max_spill = UINT16_MAX;
+		max_par = UINT8_MAX;
+		break;
+	case SPECIFIC_IMAGETTE_ADAPTIVE_HEADER_SIZE:
+		num_pars = 3;
+		max_spill = UINT16_MAX;
+		max_par = UINT8_MAX;
+		break;
+	case SPECIFIC_NON_IMAGETTE_HEADER_SIZE:
+		num_pars = CMP_ENT_MAX_PARS;
+		max_spill = 0xFFFFFF;
+		max_par = UINT16_MAX;
+		break;
+	default:
+		num_pars = 0;
+		max_spill = 0;
+		max_par = 0;
+		break;
+	}
+	for (i = 0; i < num_pars; i++)
+		if (hdr->spill[i] > max_spill || hdr->cmp_par[i] > max_par)
+			return -1;
+
+	put_unaligned_be(p, hdr->version_id, 4);
+	put_unaligned_be(p + ENT_OFF_CMP_ENT_SIZE, hdr->cmp_ent_size, 3);
+	put_unaligned_be(p + ENT_OFF_ORIGINAL_SIZE, hdr->original_size, 3);
+	put_unaligned_be(p + ENT_OFF_START_TIME, hdr->start_timestamp, 6);
+	put_unaligned_be(p + ENT_OFF_END_TIME, hdr->end_timestamp, 6);
+	put_unaligned_be(p + offsetof(struct cmp_entity, data_type), (uint32_t)hdr->data_type |
+	       (hdr->raw_mode_flag ? 1U << RAW_BIT_DATA_TYPE_POS : 0), 2);
+	ent->cmp_mode_used = (uint8_t)hdr->cmp_mode;
+	ent->model_value_used = (uint8_t)hdr->model_value;
+	put_unaligned_be(p + offsetof(struct cmp_entity, model_id), hdr->model_id, 2);
+	ent->model_counter = (uint8_t)hdr->model_counter;
+	ent->reserved = (uint8_t)hdr->reserved;
+	put_unaligned_be(p + offsetof(struct cmp_entity, lossy_cmp_par_used), hdr->lossy_cmp_par, 2);
+
+	p += GENERIC_HEADER_SIZE;
+	memset(p, 0, spec_size);
+	if (spec_size == SPECIFIC_NON_IMAGETTE_HEADER_SIZE) {
+		for (i = 0; i < num_pars; i++, p += ENT_NON_IMA_PAR_SIZE) {
+			put_unaligned_be(p, hdr->spill[i], 3);
+			put_unaligned_be(p + 3, hdr->cmp_par[i], 2);
+		}
+	} else {
+		for (i = 0; i < num_pars; i++, p += ENT_IMA_PAR_SIZE) {
+			put_unaligned_be(p, hdr->spill[i], 2);
+			p[2] = (uint8_t)hdr->cmp_par[i];
+		}
+	}
+
+	return 0;
+}
+
+
 #ifdef HAS_TIME_H
 /**
  * @brief Convert a calendar time expressed as a struct tm object to time since
@@ -27,6 +27,7 @@
 #ifndef CMP_ENTITY_H
 #define CMP_ENTITY_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "compiler.h"
@@ -144,6 +145,37 @@ struct cmp_entity {
 compile_time_assert(sizeof(struct cmp_entity) == NON_IMAGETTE_HEADER_SIZE, CMP_ENTITY_SIZE_IS_NOT_CORRECT);
 
 
+/* number of spillover threshold/compression parameter pairs in an entity header */
+#define CMP_ENT_MAX_PARS 6
+
+
+/**
+ * @brief decoded compression entity header in CPU byte order
+ *
+ * The imagette data product types use spill[0]/cmp_par[0] for the imagette
+ * and spill[1..2]/cmp_par[1..2] for the adaptive parameters; the non-imagette
+ * types use all pairs. No specific header is used in raw mode.
+ */
+
+struct cmp_ent_hdr {
+	uint32_t version_id;			/**< ICU ASW/cmp_tool Version ID */
+	uint32_t cmp_ent_size;			/**< Compression Entity Size */
+	uint32_t original_size;			/**< Original Data Size */
+	uint64_t start_timestamp;		/**< Compression Start Timestamp */
+	uint64_t end_timestamp;			/**< Compression End Timestamp */
+	enum cmp_data_type data_type;		/**< Data Product Type without the raw data bit */
+	int raw_mode_flag;			/**< raw data bit of the Data Product Type */
+	enum cmp_mode cmp_mode;			/**< used Compression Mode */
+	uint32_t model_value;			/**< used Model Updating Weighing Value */
+	uint32_t model_id;			/**< Model ID */
+	uint32_t model_counter;			/**< Model Counter */
+	uint32_t reserved;
+	uint32_t lossy_cmp_par;			/**< used Lossy Compression Parameters */
+	uint32_t spill[CMP_ENT_MAX_PARS];	/**< used spillover thresholds */
+	uint32_t cmp_par[CMP_ENT_MAX_PARS];	/**< used compression parameters */
+};
+
+
 
 /*
  * create a compression entity by setting the size of the compression entity and
@@ -160,6 +192,12 @@ int cmp_ent_write_rdcu_cmp_pars(struct cmp_entity *ent, const struct cmp_info *i
 				const struct rdcu_cfg *rcfg);
 
 
+/* read or write the whole compression entity header at once */
+int cmp_ent_hdr_decode(const struct cmp_entity *ent, size_t buf_size,
+		       struct cmp_ent_hdr *hdr);
+int cmp_ent_hdr_encode(struct cmp_entity *ent, const struct cmp_ent_hdr *hdr);
+
+
 /* set functions for generic compression entity header */
 int cmp_ent_set_version_id(struct cmp_entity *ent, uint32_t version_id);
 int cmp_ent_set_size(struct cmp_entity *ent, uint32_t cmp_ent_size);
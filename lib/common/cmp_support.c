@@ -90,7 +90,8 @@ int cmp_data_type_is_invalid(enum cmp_data_type data_type)
 int model_mode_is_used(enum cmp_mode cmp_mode)
 {
 	if (cmp_mode == CMP_MODE_MODEL_ZERO ||
-	    cmp_mode == CMP_MODE_MODEL_MULTI)
+	    cmp_mode == CMP_MODE_MODEL_MULTI ||
+	    cmp_mode == CMP_MODE_MODEL_ADAPTIVE)
 		return 1;
 
 	return 0;
@@ -114,6 +115,55 @@ int raw_mode_is_used(enum cmp_mode cmp_mode)
 }
 
 
+/* sets of compression data types as bit masks (bit n = data type n) */
+#define DATA_TYPE_BIT(data_type)	(1UL << (data_type))
+
+#define AP_IMAGETTE_DATA_TYPES	(DATA_TYPE_BIT(DATA_TYPE_IMAGETTE_ADAPTIVE) | \
+				 DATA_TYPE_BIT(DATA_TYPE_SAT_IMAGETTE_ADAPTIVE) | \
+				 DATA_TYPE_BIT(DATA_TYPE_F_CAM_IMAGETTE_ADAPTIVE))
+#define IMAGETTE_DATA_TYPES	(DATA_TYPE_BIT(DATA_TYPE_IMAGETTE) | \
+				 DATA_TYPE_BIT(DATA_TYPE_SAT_IMAGETTE) | \
+				 DATA_TYPE_BIT(DATA_TYPE_F_CAM_IMAGETTE) | \
+				 AP_IMAGETTE_DATA_TYPES)
+#define FX_COB_DATA_TYPES	(DATA_TYPE_BIT(DATA_TYPE_S_FX) | \
+				 DATA_TYPE_BIT(DATA_TYPE_S_FX_EFX) | \
+				 DATA_TYPE_BIT(DATA_TYPE_S_FX_NCOB) | \
+				 DATA_TYPE_BIT(DATA_TYPE_S_FX_EFX_NCOB_ECOB) | \
+				 DATA_TYPE_BIT(DATA_TYPE_L_FX) | \
+				 DATA_TYPE_BIT(DATA_TYPE_L_FX_EFX) | \
+				 DATA_TYPE_BIT(DATA_TYPE_L_FX_NCOB) | \
+				 DATA_TYPE_BIT(DATA_TYPE_L_FX_EFX_NCOB_ECOB) | \
+				 DATA_TYPE_BIT(DATA_TYPE_F_FX) | \
+				 DATA_TYPE_BIT(DATA_TYPE_F_FX_EFX) | \
+				 DATA_TYPE_BIT(DATA_TYPE_F_FX_NCOB) | \
+				 DATA_TYPE_BIT(DATA_TYPE_F_FX_EFX_NCOB_ECOB))
+#define AUX_DATA_TYPES		(DATA_TYPE_BIT(DATA_TYPE_OFFSET) | \
+				 DATA_TYPE_BIT(DATA_TYPE_BACKGROUND) | \
+				 DATA_TYPE_BIT(DATA_TYPE_SMEARING) | \
+				 DATA_TYPE_BIT(DATA_TYPE_F_CAM_OFFSET) | \
+				 DATA_TYPE_BIT(DATA_TYPE_F_CAM_BACKGROUND))
+
+compile_time_assert(DATA_TYPE_CHUNK < 32, DATA_TYPE_FITS_IN_BIT_MASK);
+
+
+/**
+ * @brief check if a compression data type is in a set of data types
+ *
+ * @param data_type	compression data type
+ * @param set		bit mask of the data types in the set
+ *
+ * @returns 1 when data_type is in the set, otherwise 0
+ */
+
+static int data_type_in_set(enum cmp_data_type data_type, unsigned long set)
+{
+	if ((unsigned int)data_type >= 32)
+		return 0;
+
+	return (set >> data_type) & 1;
+}
+
+
 /**
  * @brief check if the data product data type is supported by the RDCU compressor
  *
@@ -124,17 +174,7 @@ int raw_mode_is_used(enum cmp_mode cmp_mode)
 
 int rdcu_supported_data_type_is_used(enum cmp_data_type data_type)
 {
-	switch (data_type) {
-	case DATA_TYPE_IMAGETTE:
-	case DATA_TYPE_IMAGETTE_ADAPTIVE:
-	case DATA_TYPE_SAT_IMAGETTE:
-	case DATA_TYPE_SAT_IMAGETTE_ADAPTIVE:
-	case DATA_TYPE_F_CAM_IMAGETTE:
-	case DATA_TYPE_F_CAM_IMAGETTE_ADAPTIVE:
-		return 1;
-	default:
-		return 0;
-	}
+	return data_type_in_set(data_type, IMAGETTE_DATA_TYPES);
 }
 
 
@@ -154,6 +194,8 @@ int cmp_mode_is_supported(enum cmp_mode cmp_mode)
 	case CMP_MODE_DIFF_ZERO:
 	case CMP_MODE_MODEL_MULTI:
 	case CMP_MODE_DIFF_MULTI:
+	case CMP_MODE_MODEL_ADAPTIVE:
+	case CMP_MODE_DIFF_ADAPTIVE:
 		return 1;
 	default:
 		return 0;
@@ -190,7 +232,28 @@ int zero_escape_mech_is_used(enum cmp_mode cmp_mode)
 int multi_escape_mech_is_used(enum cmp_mode cmp_mode)
 {
 	if (cmp_mode == CMP_MODE_MODEL_MULTI ||
-	    cmp_mode == CMP_MODE_DIFF_MULTI)
+	    cmp_mode == CMP_MODE_DIFF_MULTI ||
+	    cmp_mode == CMP_MODE_MODEL_ADAPTIVE ||
+	    cmp_mode == CMP_MODE_DIFF_ADAPTIVE)
+		return 1;
+
+	return 0;
+}
+
+
+/**
+ * @brief check if a block-adaptive compression mode is used
+ * @note the adaptive modes use the multi escape symbol mechanism
+ *
+ * @param cmp_mode	compression mode
+ *
+ * @returns 1 when the compression parameters are selected per block, otherwise 0
+ */
+
+int adaptive_mode_is_used(enum cmp_mode cmp_mode)
+{
+	if (cmp_mode == CMP_MODE_MODEL_ADAPTIVE ||
+	    cmp_mode == CMP_MODE_DIFF_ADAPTIVE)
 		return 1;
 
 	return 0;
@@ -222,14 +285,7 @@ int cmp_imagette_data_type_is_used(enum cmp_data_type data_type)
 
 int cmp_ap_imagette_data_type_is_used(enum cmp_data_type data_type)
 {
-	switch (data_type) {
-	case DATA_TYPE_IMAGETTE_ADAPTIVE:
-	case DATA_TYPE_SAT_IMAGETTE_ADAPTIVE:
-	case DATA_TYPE_F_CAM_IMAGETTE_ADAPTIVE:
-		return 1;
-	default:
-		return 0;
-	}
+	return data_type_in_set(data_type, AP_IMAGETTE_DATA_TYPES);
 }
 
 
@@ -243,23 +299,7 @@ int cmp_ap_imagette_data_type_is_used(enum cmp_data_type data_type)
 
 int cmp_fx_cob_data_type_is_used(enum cmp_data_type data_type)
 {
-	switch (data_type) {
-	case DATA_TYPE_S_FX:
-	case DATA_TYPE_S_FX_EFX:
-	case DATA_TYPE_S_FX_NCOB:
-	case DATA_TYPE_S_FX_EFX_NCOB_ECOB:
-	case DATA_TYPE_L_FX:
-	case DATA_TYPE_L_FX_EFX:
-	case DATA_TYPE_L_FX_NCOB:
-	case DATA_TYPE_L_FX_EFX_NCOB_ECOB:
-	case DATA_TYPE_F_FX:
-	case DATA_TYPE_F_FX_EFX:
-	case DATA_TYPE_F_FX_NCOB:
-	case DATA_TYPE_F_FX_EFX_NCOB_ECOB:
-		return 1;
-	default:
-		return 0;
-	}
+	return data_type_in_set(data_type, FX_COB_DATA_TYPES);
 }
 
 
@@ -273,16 +313,7 @@ int cmp_fx_cob_data_type_is_used(enum cmp_data_type data_type)
 
 int cmp_aux_data_type_is_used(enum cmp_data_type data_type)
 {
-	switch (data_type) {
-	case DATA_TYPE_OFFSET:
-	case DATA_TYPE_BACKGROUND:
-	case DATA_TYPE_SMEARING:
-	case DATA_TYPE_F_CAM_OFFSET:
-	case DATA_TYPE_F_CAM_BACKGROUND:
-		return 1;
-	default:
-		return 0;
-	}
+	return data_type_in_set(data_type, AUX_DATA_TYPES);
 }
 
 
@@ -338,6 +369,56 @@ uint32_t cmp_icu_max_spill(unsigned int cmp_par)
 }
 
 
+/**
+ * @brief get a candidate compression parameter of the block-adaptive
+ *	compression modes
+ *
+ * The candidates are the configured compression parameter scaled by 1/2, 1, 2
+ * and 4, limited to the valid non-imagette compression parameter range.
+ *
+ * @param cmp_par	configured compression parameter
+ * @param sel		block parameter selector (0 to CMP_ADAPTIVE_NUM_PARS-1)
+ *
+ * @returns the compression parameter selected by sel
+ */
+
+uint32_t cmp_adaptive_par(uint32_t cmp_par, unsigned int sel)
+{
+	uint64_t par = sel ? (uint64_t)cmp_par << (sel - 1) : cmp_par >> 1;
+
+	if (par < MIN_NON_IMA_GOLOMB_PAR)
+		par = MIN_NON_IMA_GOLOMB_PAR;
+	if (par > MAX_NON_IMA_GOLOMB_PAR)
+		par = MAX_NON_IMA_GOLOMB_PAR;
+
+	return (uint32_t)par;
+}
+
+
+/**
+ * @brief get the spillover threshold of a candidate compression parameter of
+ *	the block-adaptive compression modes
+ *
+ * @param cmp_par	configured compression parameter
+ * @param spill		configured spillover threshold
+ * @param sel		block parameter selector (0 to CMP_ADAPTIVE_NUM_PARS-1)
+ *
+ * @returns the configured spillover threshold for the configured compression
+ *	parameter, otherwise the largest valid spillover threshold of the
+ *	candidate
+ */
+
+uint32_t cmp_adaptive_spill(uint32_t cmp_par, uint32_t spill, unsigned int sel)
+{
+	uint32_t const par = cmp_adaptive_par(cmp_par, sel);
+
+	if (par == cmp_par)
+		return spill;
+
+	return cmp_icu_max_spill(par);
+}
+
+
 /**
  * @brief calculate the need bytes to hold a bitstream
  *
@@ -427,6 +508,8 @@ static int cmp_pars_are_invalid(uint32_t cmp_par, uint32_t spill, enum cmp_mode
 	case CMP_MODE_DIFF_MULTI:
 	case CMP_MODE_MODEL_ZERO:
 	case CMP_MODE_MODEL_MULTI:
+	case CMP_MODE_MODEL_ADAPTIVE:
+	case CMP_MODE_DIFF_ADAPTIVE:
 		if (cmp_par < MIN_NON_IMA_GOLOMB_PAR || cmp_par > MAX_NON_IMA_GOLOMB_PAR) {
 			debug_print("Error: The selected %s compression parameter: %" PRIu32 " is not supported in the selected compression mode. The compression parameter has to be between [%" PRIu32 ", %" PRIu32 "] in this mode.",
 				    par_name, cmp_par, MIN_NON_IMA_GOLOMB_PAR, MAX_NON_IMA_GOLOMB_PAR);
@@ -129,7 +129,41 @@ enum cmp_mode {
 	CMP_MODE_MODEL_ZERO,  /**< model compression mode with zero escape symbol mechanism */
 	CMP_MODE_DIFF_ZERO,   /**< 1-D differential compression mode with zero escape symbol mechanism */
 	CMP_MODE_MODEL_MULTI, /**< model compression mode with multi escape symbol mechanism */
-	CMP_MODE_DIFF_MULTI   /**< 1-D differential multi compression mode with multi escape symbol mechanism*/
+	CMP_MODE_DIFF_MULTI,  /**< 1-D differential multi compression mode with multi escape symbol mechanism*/
+	CMP_MODE_MODEL_ADAPTIVE, /**< model compression mode with multi escape symbol mechanism and block-adaptive compression parameters (ICU only) */
+	CMP_MODE_DIFF_ADAPTIVE   /**< 1-D differential compression mode with multi escape symbol mechanism and block-adaptive compression parameters (ICU only) */
+};
+
+
+/*
+ * In the adaptive compression modes the values encoded with the same
+ * compression parameter are split into blocks of CMP_ADAPTIVE_BLOCK_SIZE
+ * values. Every block starts with CMP_ADAPTIVE_SEL_BITS bits selecting the
+ * compression parameter of the block out of the candidates returned by
+ * cmp_adaptive_par().
+ */
+#define CMP_ADAPTIVE_BLOCK_SIZE	32U
+#define CMP_ADAPTIVE_SEL_BITS	2U
+#define CMP_ADAPTIVE_NUM_PARS	(1U << CMP_ADAPTIVE_SEL_BITS)
+
+
+struct cmp_col_stats;
+struct cmp_adaptive_state;
+
+
+/* maximum number of parameter trials of compress_like_rdcu_trials() */
+#define CMP_MAX_PAR_TRIALS	8
+
+
+/**
+ * @brief an alternative imagette compression parameter pair and the resulting
+ *	compressed data size
+ */
+
+struct cmp_par_trial {
+	uint32_t golomb_par;	/**< Golomb parameter to try */
+	uint32_t spill;		/**< spillover threshold to try */
+	uint32_t cmp_size;	/**< resulting compressed data size in bits; 0 if the parameters are invalid */
 };
 
 
@@ -152,6 +186,8 @@ struct cmp_cfg {
 				       * 2: 1d differencing mode without input model with zero escape symbol mechanism
 				       * 3: model mode with multi escape symbol mechanism
 				       * 4: 1d differencing mode without input model multi escape symbol mechanism
+				       * 5: model mode with block-adaptive compression parameters
+				       * 6: 1d differencing mode with block-adaptive compression parameters
 				       */
 	uint32_t model_value;         /**< Model weighting parameter */
 	uint32_t round;               /**< lossy compression parameter */
@@ -226,6 +262,10 @@ struct cmp_cfg {
 		uint32_t spill_background_pixels_error; /**< Spillover threshold parameter for auxiliary science outlier pixels number compression */
 		uint32_t spill_smearing_pixels_error;   /**< Spillover threshold parameter for auxiliary science outlier pixels number compression */
 	};
+	struct cmp_col_stats *col_stats; /**< Statistics of the compressed collection (chunk compression only); can be NULL */
+	struct cmp_par_trial *par_trials; /**< Alternative parameters to determine the compressed size (imagette compression only); can be NULL */
+	uint32_t num_par_trials;          /**< Number of alternative parameters */
+	struct cmp_adaptive_state *adaptive; /**< Block parameter selection state (adaptive compression modes only); managed by the compressor */
 };
 
 
@@ -329,6 +369,8 @@ int cmp_cfg_fx_cob_is_invalid(const struct cmp_cfg *cfg);
 int cmp_cfg_aux_is_invalid(const struct cmp_cfg *cfg);
 uint32_t cmp_ima_max_spill(unsigned int golomb_par);
 uint32_t cmp_icu_max_spill(unsigned int cmp_par);
+uint32_t cmp_adaptive_par(uint32_t cmp_par, unsigned int sel);
+uint32_t cmp_adaptive_spill(uint32_t cmp_par, uint32_t spill, unsigned int sel);
 
 int cmp_data_type_is_invalid(enum cmp_data_type data_type);
 int rdcu_supported_data_type_is_used(enum cmp_data_type data_type);
@@ -343,6 +385,7 @@ int model_mode_is_used(enum cmp_mode cmp_mode);
 int raw_mode_is_used(enum cmp_mode cmp_mode);
 int zero_escape_mech_is_used(enum cmp_mode cmp_mode);
 int multi_escape_mech_is_used(enum cmp_mode cmp_mode);
+int adaptive_mode_is_used(enum cmp_mode cmp_mode);
 
 
 void print_cmp_info(const struct cmp_info *info);
@@ -0,0 +1,132 @@
+/**
+ * @file   cmp_trace.c
+ * @date   2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief lightweight timing instrumentation of the (de)compression hot paths
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "cmp_trace.h"
+
+
+static uint32_t (*trace_get_cycles)(void);
+static struct cmp_trace_event *trace_buf;
+static uint32_t trace_buf_len;
+static uint32_t trace_idx;
+static uint32_t trace_cnt;
+
+
+/**
+ * @brief set up the trace ring buffer and the cycle counter
+ *
+ * @param get_cycles	function returning the current value of a cycle
+ *			counter; NULL disables the tracing
+ * @param buf		pointer to the ring buffer for the trace events
+ * @param buf_len	length of the ring buffer in events
+ *
+ * @note if the ring buffer is full the oldest events are overwritten
+ */
+
+void cmp_trace_init(uint32_t (*get_cycles)(void),
+		    struct cmp_trace_event *buf, uint32_t buf_len)
+{
+	trace_get_cycles = NULL;
+	trace_buf = buf;
+	trace_buf_len = buf ? buf_len : 0;
+	cmp_trace_reset();
+	if (trace_buf_len)
+		trace_get_cycles = get_cycles;
+}
+
+
+/**
+ * @brief discard all recorded trace events
+ */
+
+void cmp_trace_reset(void)
+{
+	trace_idx = 0;
+	trace_cnt = 0;
+}
+
+
+/**
+ * @brief record a trace event
+ *
+ * @param stage	processing stage of the event
+ * @param type	begin or end of the stage
+ */
+
+void cmp_trace_record(enum cmp_trace_stage stage, enum cmp_trace_type type)
+{
+	struct cmp_trace_event *ev;
+
+	if (!trace_get_cycles)
+		return;
+
+	ev = &trace_buf[trace_idx];
+	ev->cycles = trace_get_cycles();
+	ev->stage = (uint16_t)stage;
+	ev->type = (uint16_t)type;
+
+	trace_idx++;
+	if (trace_idx >= trace_buf_len)
+		trace_idx = 0;
+	trace_cnt++;
+}
+
+
+/**
+ * @brief get the number of trace events recorded since the last reset
+ *
+ * @returns the number of recorded events, including overwritten ones
+ */
+
+uint32_t cmp_trace_get_count(void)
+{
+	return trace_cnt;
+}
+
+
+/**
+ * @brief copy the recorded trace events in chronological order
+ *
+ * @param events	pointer to the destination array
+ * @param max_events	length of the destination array in events
+ *
+ * @returns the number of copied events; if more events are available than
+ *	fit into the destination array, the most recent events are copied
+ */
+
+uint32_t cmp_trace_get_events(struct cmp_trace_event *events, uint32_t max_events)
+{
+	uint32_t num_events, i, idx;
+
+	if (!events || !trace_buf_len)
+		return 0;
+
+	num_events = trace_cnt < trace_buf_len ? trace_cnt : trace_buf_len;
+	if (num_events > max_events)
+		num_events = max_events;
+
+	idx = trace_idx + trace_buf_len - num_events;
+	for (i = 0; i < num_events; i++) {
+		if (idx >= trace_buf_len)
+			idx -= trace_buf_len;
+		events[i] = trace_buf[idx++];
+	}
+
+	return num_events;
+}
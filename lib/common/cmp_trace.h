@@ -0,0 +1,95 @@
+/**
+ * @file   cmp_trace.h
+ * @date   2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief lightweight timing instrumentation of the (de)compression hot paths
+ *
+ * The library records begin and end events of its processing stages into a
+ * user-supplied ring buffer. The timestamps are taken from a user-supplied
+ * cycle counter, e.g. the LEON %asr22/%asr23 up-counter or a GPTIMER.
+ * The instrumentation is only compiled in if CMP_TRACE is set to a non-zero
+ * value, usually via the compiler command line (make CMP_TRACE=1); otherwise
+ * the CMP_TRACE_BEGIN/END() macros compile to nothing.
+ * If a stage is left because of an error, its begin event has no matching end
+ * event.
+ */
+
+#ifndef CMP_TRACE_H
+#define CMP_TRACE_H
+
+#include <stdint.h>
+
+
+/* CMP_TRACE should be externally defined, usually via the compiler command
+ * line.  Its value must be a numeric value. */
+#ifndef CMP_TRACE
+#  define CMP_TRACE 0
+#endif
+
+
+/**
+ * @brief instrumented processing stages
+ */
+
+enum cmp_trace_stage {
+	CMP_TRACE_HDR_SETUP,	/**< chunk configuration and header setup */
+	CMP_TRACE_VALIDATION,	/**< compression parameter validation */
+	CMP_TRACE_ENCODE,	/**< encoding of a collection */
+	CMP_TRACE_PAD,		/**< bitstream padding */
+	CMP_TRACE_RAW_FALLBACK,	/**< uncompressed copy of a collection */
+	CMP_TRACE_DECODE,	/**< decoding of a compressed data unit */
+	CMP_TRACE_RMAP_TX,	/**< transmission of an RMAP command */
+	CMP_TRACE_RMAP_RX,	/**< processing of an RMAP reply */
+	CMP_TRACE_SRAM_SYNC,	/**< RDCU SRAM synchronisation */
+	CMP_TRACE_NUM_STAGES
+};
+
+
+/**
+ * @brief type of a trace event
+ */
+
+enum cmp_trace_type {
+	CMP_TRACE_EV_BEGIN,
+	CMP_TRACE_EV_END
+};
+
+
+/**
+ * @brief a single trace event
+ */
+
+struct cmp_trace_event {
+	uint32_t cycles;	/**< value of the cycle counter */
+	uint16_t stage;		/**< enum cmp_trace_stage */
+	uint16_t type;		/**< enum cmp_trace_type */
+};
+
+
+void cmp_trace_init(uint32_t (*get_cycles)(void),
+		    struct cmp_trace_event *buf, uint32_t buf_len);
+void cmp_trace_reset(void);
+void cmp_trace_record(enum cmp_trace_stage stage, enum cmp_trace_type type);
+uint32_t cmp_trace_get_count(void);
+uint32_t cmp_trace_get_events(struct cmp_trace_event *events, uint32_t max_events);
+
+
+#if CMP_TRACE
+#  define CMP_TRACE_BEGIN(stage) cmp_trace_record((stage), CMP_TRACE_EV_BEGIN)
+#  define CMP_TRACE_END(stage) cmp_trace_record((stage), CMP_TRACE_EV_END)
+#else
+#  define CMP_TRACE_BEGIN(stage) do {} while (0)
+#  define CMP_TRACE_END(stage) do {} while (0)
+#endif
+
+#endif /* CMP_TRACE_H */
@@ -20,6 +20,7 @@
 #define DECMP_H
 
 #include <stdint.h>
+#include <stddef.h>
 
 #include "common/cmp_entity.h"
 #include "common/cmp_support.h"
@@ -31,4 +32,21 @@ int decompress_rdcu_data(const uint32_t *compressed_data, const struct cmp_info
 			 const uint16_t *model_of_data, uint16_t *up_model_buf,
 			 uint16_t *decompressed_data);
 
+/* batch decompression of an archive of concatenated compression entities */
+int decompress_cmp_batch_size(const void *archive, size_t archive_size,
+			      size_t *decmp_size);
+int decompress_cmp_batch(const void *archive, size_t archive_size,
+			 void *model_buf, size_t model_buf_size,
+			 void *dst, size_t dst_capacity, size_t *decmp_size);
+
+#ifndef ICU_ASW
+#  if defined __has_include
+#    if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+/* decompress an archive file into an output file using memory mappings */
+int decompress_cmp_archive_fd(int archive_fd, int output_fd, void *model_buf,
+			      size_t model_buf_size, size_t *decmp_size);
+#    endif
+#  endif
+#endif
+
 #endif /* DECMP_H */
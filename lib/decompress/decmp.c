@@ -39,6 +39,7 @@
 #include "../common/cmp_entity.h"
 #include "../common/cmp_cal_up_model.h"
 #include "../common/cmp_max_used_bits.h"
+#include "../common/cmp_trace.h"
 
 
 #define CORRUPTION_DETECTED (-1)
@@ -69,6 +70,9 @@ struct decoder_setup {
 	uint32_t outlier_par;    /* outlier parameter */
 	uint32_t lossy_par;      /* lossy compression parameter */
 	uint32_t max_data_bits;  /* bit length of the decoded value */
+	uint32_t adaptive_par;   /* configured compression parameter in an adaptive mode; 0 if not used */
+	uint32_t adaptive_spill; /* configured spillover parameter in an adaptive mode */
+	uint32_t block_left;     /* number of values left in the current adaptive block */
 };
 
 
@@ -297,6 +301,31 @@ static __inline uint32_t re_map_to_pos(uint32_t value_to_unmap)
 }
 
 
+/**
+ * @brief read the selected compression parameter of the next block in an
+ *	adaptive compression mode and set up the decoder for the block
+ *
+ * @param setup		pointer to the decoder setup
+ *
+ * @returns 0 on success; otherwise error
+ */
+
+static int decode_block_par(struct decoder_setup *setup)
+{
+	unsigned int const sel = bit_read_bits32(setup->dec, CMP_ADAPTIVE_SEL_BITS);
+	uint32_t const par = cmp_adaptive_par(setup->adaptive_par, sel);
+
+	setup->decode_cw_f = select_decoder(par);
+	setup->encoder_par1 = par;
+	setup->encoder_par2 = ilog_2(par);
+	setup->outlier_par = cmp_adaptive_spill(setup->adaptive_par,
+						setup->adaptive_spill, sel);
+	setup->block_left = CMP_ADAPTIVE_BLOCK_SIZE;
+
+	return bit_refill(setup->dec) == BIT_OVERFLOW;
+}
+
+
 /**
  * @brief decompress the next code word in the bitstream and decorrelate it with
  *	the model
@@ -308,11 +337,20 @@ static __inline uint32_t re_map_to_pos(uint32_t value_to_unmap)
  * @returns 0 on success; otherwise error
  */
 
-static int decode_value(const struct decoder_setup *setup, uint32_t *decoded_value,
+static int decode_value(struct decoder_setup *setup, uint32_t *decoded_value,
 			uint32_t model)
 {
+	int err;
+
+	/* in an adaptive mode every block starts with its compression parameter */
+	if (unlikely(setup->adaptive_par)) {
+		if (setup->block_left == 0 && decode_block_par(setup))
+			return CORRUPTION_DETECTED;
+		setup->block_left--;
+	}
+
 	/* decode the next value from the bitstream */
-	int const err = setup->decode_method_f(setup, decoded_value);
+	err = setup->decode_method_f(setup, decoded_value);
 
 	/* map the unsigned decode value back to a signed value */
 	*decoded_value = re_map_to_pos(*decoded_value);
@@ -367,6 +405,9 @@ static void configure_decoder_setup(struct decoder_setup *setup, struct bit_deco
 	setup->outlier_par = spillover; /* outlier parameter */
 	setup->lossy_par = lossy_par; /* lossy compression parameter */
 	setup->max_data_bits = max_data_bits; /* how many bits are needed to represent the highest possible value */
+	setup->adaptive_par = adaptive_mode_is_used(cmp_mode) ? cmp_par : 0;
+	setup->adaptive_spill = spillover;
+	setup->block_left = 0;
 }
 
 
@@ -488,318 +529,112 @@ static int decompress_imagette(const struct cmp_cfg *cfg, struct bit_decoder *de
 
 
 /**
- * @brief decompress short normal light flux (S_FX) data
- *
- * @param cfg	pointer to the compression configuration structure
- * @param dec	a pointer to a bit_decoder context
+ * @brief decompress short (S_FX) or fast (F_FX) cadence flux and center of
+ *	brightness data
  *
- * @returns 0 on success; otherwise error
- */
-
-static int decompress_s_fx(const struct cmp_cfg *cfg, struct bit_decoder *dec)
-{
-	size_t i;
-	int err;
-	uint32_t decoded_value;
-	struct decoder_setup setup_exp_flags, setup_fx;
-	struct s_fx *data_buf = get_collection_data(cfg->dst);
-	const struct s_fx *model_buf = get_collection_data_const(cfg->model_buf);
-	struct s_fx *up_model_buf;
-	const struct s_fx *next_model_p;
-	struct s_fx model;
-
-	if (model_mode_is_used(cfg->cmp_mode)) {
-		model = model_buf[0];
-		next_model_p = &model_buf[1];
-		up_model_buf = get_collection_data(cfg->updated_model_buf);
-	} else {
-		memset(&model, 0, sizeof(model));
-		next_model_p = data_buf;
-		up_model_buf = NULL;
-	}
-
-	configure_decoder_setup(&setup_exp_flags, dec, cfg->cmp_mode, cfg->cmp_par_exp_flags,
-				cfg->spill_exp_flags, cfg->round, MAX_USED_BITS.s_exp_flags);
-	configure_decoder_setup(&setup_fx, dec, cfg->cmp_mode, cfg->cmp_par_fx,
-				cfg->spill_fx, cfg->round, MAX_USED_BITS.s_fx);
-
-	for (i = 0; ; i++) {
-		err = decode_value(&setup_exp_flags, &decoded_value, model.exp_flags);
-		if (err)
-			break;
-		data_buf[i].exp_flags = (__typeof__(data_buf[i].exp_flags))decoded_value;
-
-		err = decode_value(&setup_fx, &decoded_value, model.fx);
-		if (err)
-			break;
-		data_buf[i].fx = decoded_value;
-
-		if (up_model_buf) {
-			up_model_buf[i].exp_flags = cmp_up_model(data_buf[i].exp_flags, model.exp_flags,
-								 cfg->model_value, setup_exp_flags.lossy_par);
-			up_model_buf[i].fx = cmp_up_model(data_buf[i].fx, model.fx,
-							  cfg->model_value, setup_fx.lossy_par);
-		}
-
-		if (i >= cfg->samples-1)
-			break;
-
-		model = next_model_p[i];
-	}
-	return err;
-}
-
-
-/**
- * @brief decompress S_FX_EFX data
+ * The short and fast cadence samples only differ in the exposure flags field
+ * of the short cadence samples, so one kernel serves all eight data types.
  *
- * @param cfg	pointer to the compression configuration structure
- * @param dec	a pointer to a bit_decoder context
+ * @param cfg		pointer to the compression configuration structure
+ * @param dec		a pointer to a bit_decoder context
+ * @param fields	FX_COB_* flags of the fields in a sample
  *
  * @returns 0 on success; otherwise error
  */
 
-static int decompress_s_fx_efx(const struct cmp_cfg *cfg, struct bit_decoder *dec)
+static int decompress_fx_cob(const struct cmp_cfg *cfg, struct bit_decoder *dec,
+			     unsigned int fields)
 {
+	static const uint8_t zero_model[sizeof(struct s_fx_efx_ncob_ecob)];
+	struct decoder_setup setup_exp_flags, setup_fx, setup_ncob, setup_efx, setup_ecob;
+	struct decoder_setup *setup[FX_COB_MAX_VALUES];
+	int const short_cadence = !!(fields & FX_COB_EXP_FLAGS);
+	uint32_t const base = short_cadence ? sizeof(uint8_t) : 0;
+	uint32_t sample_size, decoded_value, n = 0, k;
+	uint8_t *data_p = get_collection_data(cfg->dst);
+	const uint8_t *model_p, *next_model_p;
+	uint8_t *up_model_p = NULL;
 	size_t i;
-	int err;
-	uint32_t decoded_value;
-	struct decoder_setup setup_exp_flags, setup_fx, setup_efx;
-	struct s_fx_efx *data_buf = get_collection_data(cfg->dst);
-	const struct s_fx_efx *model_buf = get_collection_data_const(cfg->model_buf);
-	struct s_fx_efx *up_model_buf;
-	const struct s_fx_efx *next_model_p;
-	struct s_fx_efx model;
+	int err = 0;
 
-	if (model_mode_is_used(cfg->cmp_mode)) {
-		up_model_buf = get_collection_data(cfg->updated_model_buf);
-		model = model_buf[0];
-		next_model_p = &model_buf[1];
-	} else {
-		up_model_buf = NULL;
-		memset(&model, 0, sizeof(model));
-		next_model_p = data_buf;
+	if (short_cadence)
+		configure_decoder_setup(&setup_exp_flags, dec, cfg->cmp_mode, cfg->cmp_par_exp_flags,
+					cfg->spill_exp_flags, cfg->round, MAX_USED_BITS.s_exp_flags);
+	configure_decoder_setup(&setup_fx, dec, cfg->cmp_mode, cfg->cmp_par_fx, cfg->spill_fx,
+				cfg->round, short_cadence ? MAX_USED_BITS.s_fx : MAX_USED_BITS.f_fx);
+	setup[n++] = &setup_fx;
+	if (fields & FX_COB_NCOB) {
+		configure_decoder_setup(&setup_ncob, dec, cfg->cmp_mode, cfg->cmp_par_ncob,
+					cfg->spill_ncob, cfg->round,
+					short_cadence ? MAX_USED_BITS.s_ncob : MAX_USED_BITS.f_ncob);
+		setup[n++] = &setup_ncob; /* ncob_x */
+		setup[n++] = &setup_ncob; /* ncob_y */
 	}
-
-	configure_decoder_setup(&setup_exp_flags, dec, cfg->cmp_mode, cfg->cmp_par_exp_flags,
-				cfg->spill_exp_flags, cfg->round, MAX_USED_BITS.s_exp_flags);
-	configure_decoder_setup(&setup_fx, dec, cfg->cmp_mode, cfg->cmp_par_fx,
-				cfg->spill_fx, cfg->round, MAX_USED_BITS.s_fx);
-	configure_decoder_setup(&setup_efx, dec, cfg->cmp_mode, cfg->cmp_par_efx,
-				cfg->spill_efx, cfg->round, MAX_USED_BITS.s_efx);
-
-	for (i = 0; ; i++) {
-		err = decode_value(&setup_exp_flags, &decoded_value, model.exp_flags);
-		if (err)
-			break;
-		data_buf[i].exp_flags = (__typeof__(data_buf[i].exp_flags)) decoded_value;
-
-		err = decode_value(&setup_fx, &decoded_value, model.fx);
-		if (err)
-			break;
-		data_buf[i].fx = decoded_value;
-
-		err = decode_value(&setup_efx, &decoded_value, model.efx);
-		if (err)
-			break;
-		data_buf[i].efx = decoded_value;
-
-		if (up_model_buf) {
-			up_model_buf[i].exp_flags = cmp_up_model(data_buf[i].exp_flags, model.exp_flags,
-								 cfg->model_value, setup_exp_flags.lossy_par);
-			up_model_buf[i].fx = cmp_up_model(data_buf[i].fx, model.fx,
-							  cfg->model_value, setup_fx.lossy_par);
-			up_model_buf[i].efx = cmp_up_model(data_buf[i].efx, model.efx,
-							   cfg->model_value, setup_efx.lossy_par);
-		}
-
-		if (i >= cfg->samples-1)
-			break;
-
-		model = next_model_p[i];
+	if (fields & FX_COB_EFX) {
+		configure_decoder_setup(&setup_efx, dec, cfg->cmp_mode, cfg->cmp_par_efx,
+					cfg->spill_efx, cfg->round,
+					short_cadence ? MAX_USED_BITS.s_efx : MAX_USED_BITS.f_efx);
+		setup[n++] = &setup_efx;
 	}
-	return err;
-}
-
-
-/**
- * @brief decompress short S_FX_NCOB data
- *
- * @param cfg	pointer to the compression configuration structure
- * @param dec	a pointer to a bit_decoder context
- *
- * @returns 0 on success; otherwise error
- */
-
-static int decompress_s_fx_ncob(const struct cmp_cfg *cfg, struct bit_decoder *dec)
-{
-	size_t i;
-	int err;
-	uint32_t decoded_value;
-	struct decoder_setup setup_exp_flags, setup_fx, setup_ncob;
-	struct s_fx_ncob *data_buf = get_collection_data(cfg->dst);
-	const struct s_fx_ncob *model_buf = get_collection_data_const(cfg->model_buf);
-	struct s_fx_ncob *up_model_buf;
-	const struct s_fx_ncob *next_model_p;
-	struct s_fx_ncob model;
-
-	if (model_mode_is_used(cfg->cmp_mode)) {
-		up_model_buf = get_collection_data(cfg->updated_model_buf);
-		model = model_buf[0];
-		next_model_p = &model_buf[1];
-	} else {
-		up_model_buf = NULL;
-		memset(&model, 0, sizeof(model));
-		next_model_p = data_buf;
+	if (fields & FX_COB_ECOB) {
+		configure_decoder_setup(&setup_ecob, dec, cfg->cmp_mode, cfg->cmp_par_ecob,
+					cfg->spill_ecob, cfg->round,
+					short_cadence ? MAX_USED_BITS.s_ecob : MAX_USED_BITS.f_ecob);
+		setup[n++] = &setup_ecob; /* ecob_x */
+		setup[n++] = &setup_ecob; /* ecob_y */
 	}
-
-	configure_decoder_setup(&setup_exp_flags, dec, cfg->cmp_mode, cfg->cmp_par_exp_flags,
-				cfg->spill_exp_flags, cfg->round, MAX_USED_BITS.s_exp_flags);
-	configure_decoder_setup(&setup_fx, dec, cfg->cmp_mode, cfg->cmp_par_fx,
-				cfg->spill_fx, cfg->round, MAX_USED_BITS.s_fx);
-	configure_decoder_setup(&setup_ncob, dec, cfg->cmp_mode, cfg->cmp_par_ncob,
-				cfg->spill_ncob, cfg->round, MAX_USED_BITS.s_ncob);
-
-	for (i = 0; ; i++) {
-		err = decode_value(&setup_exp_flags, &decoded_value, model.exp_flags);
-		if (err)
-			break;
-		data_buf[i].exp_flags = (__typeof__(data_buf[i].exp_flags)) decoded_value;
-
-		err = decode_value(&setup_fx, &decoded_value, model.fx);
-		if (err)
-			break;
-		data_buf[i].fx = decoded_value;
-
-		err = decode_value(&setup_ncob, &decoded_value, model.ncob_x);
-		if (err)
-			break;
-		data_buf[i].ncob_x = decoded_value;
-
-		err = decode_value(&setup_ncob, &decoded_value, model.ncob_y);
-		if (err)
-			break;
-		data_buf[i].ncob_y = decoded_value;
-
-		if (up_model_buf) {
-			up_model_buf[i].exp_flags = cmp_up_model(data_buf[i].exp_flags, model.exp_flags,
-								 cfg->model_value, setup_exp_flags.lossy_par);
-			up_model_buf[i].fx = cmp_up_model(data_buf[i].fx, model.fx,
-							  cfg->model_value, setup_fx.lossy_par);
-			up_model_buf[i].ncob_x = cmp_up_model(data_buf[i].ncob_x, model.ncob_x,
-							      cfg->model_value, setup_ncob.lossy_par);
-			up_model_buf[i].ncob_y = cmp_up_model(data_buf[i].ncob_y, model.ncob_y,
-							      cfg->model_value, setup_ncob.lossy_par);
-		}
-
-		if (i >= cfg->samples-1)
-			break;
-
-		model = next_model_p[i];
-	}
-	return err;
-}
-
-
-/**
- * @brief decompress short S_FX_NCOB_ECOB data
- *
- * @param cfg	pointer to the compression configuration structure
- * @param dec	a pointer to a bit_decoder context
- *
- * @returns 0 on success; otherwise error
- */
-
-static int decompress_s_fx_efx_ncob_ecob(const struct cmp_cfg *cfg, struct bit_decoder *dec)
-{
-	size_t i;
-	int err;
-	uint32_t decoded_value;
-	struct decoder_setup setup_exp_flags, setup_fx, setup_ncob, setup_efx, setup_ecob;
-	struct s_fx_efx_ncob_ecob *data_buf = get_collection_data(cfg->dst);
-	const struct s_fx_efx_ncob_ecob *model_buf = get_collection_data_const(cfg->model_buf);
-	struct s_fx_efx_ncob_ecob *up_model_buf;
-	const struct s_fx_efx_ncob_ecob *next_model_p;
-	struct s_fx_efx_ncob_ecob model;
+	sample_size = base + n * sizeof(uint32_t);
 
 	if (model_mode_is_used(cfg->cmp_mode)) {
-		up_model_buf = get_collection_data(cfg->updated_model_buf);
-		model = model_buf[0];
-		next_model_p = &model_buf[1];
+		model_p = get_collection_data_const(cfg->model_buf);
+		next_model_p = model_p + sample_size;
+		up_model_p = get_collection_data(cfg->updated_model_buf);
 	} else {
-		up_model_buf = NULL;
-		memset(&model, 0, sizeof(model));
-		next_model_p = data_buf;
+		model_p = zero_model;
+		next_model_p = data_p;
 	}
 
-	configure_decoder_setup(&setup_exp_flags, dec, cfg->cmp_mode, cfg->cmp_par_exp_flags,
-				cfg->spill_exp_flags, cfg->round, MAX_USED_BITS.s_exp_flags);
-	configure_decoder_setup(&setup_fx, dec, cfg->cmp_mode, cfg->cmp_par_fx, cfg->spill_fx,
-				cfg->round, MAX_USED_BITS.s_fx);
-	configure_decoder_setup(&setup_ncob, dec, cfg->cmp_mode, cfg->cmp_par_ncob, cfg->spill_ncob,
-				cfg->round, MAX_USED_BITS.s_ncob);
-	configure_decoder_setup(&setup_efx, dec, cfg->cmp_mode, cfg->cmp_par_efx, cfg->spill_efx,
-				cfg->round, MAX_USED_BITS.s_efx);
-	configure_decoder_setup(&setup_ecob, dec, cfg->cmp_mode, cfg->cmp_par_ecob, cfg->spill_ecob,
-				cfg->round, MAX_USED_BITS.s_ecob);
-
 	for (i = 0; ; i++) {
-		err = decode_value(&setup_exp_flags, &decoded_value, model.exp_flags);
-		if (err)
-			break;
-		data_buf[i].exp_flags = (__typeof__(data_buf[i].exp_flags)) decoded_value;
-
-		err = decode_value(&setup_fx, &decoded_value, model.fx);
-		if (err)
-			break;
-		data_buf[i].fx = decoded_value;
-
-		err = decode_value(&setup_ncob, &decoded_value, model.ncob_x);
-		if (err)
-			break;
-		data_buf[i].ncob_x = decoded_value;
-
-		err = decode_value(&setup_ncob, &decoded_value, model.ncob_y);
-		if (err)
-			break;
-		data_buf[i].ncob_y = decoded_value;
-
-		err = decode_value(&setup_efx, &decoded_value, model.efx);
-		if (err)
-			break;
-		data_buf[i].efx = decoded_value;
+		uint8_t *d = data_p + i * sample_size;
+		uint8_t model_exp_flags = model_p[0];
+		uint32_t model[FX_COB_MAX_VALUES];
+
+		/* copy the model, the data or the updated model can overwrite it */
+		for (k = 0; k < n; k++)
+			model[k] = get_unaligned((const uint32_t *)(model_p + base) + k);
+
+		if (short_cadence) {
+			err = decode_value(&setup_exp_flags, &decoded_value, model_exp_flags);
+			if (err)
+				return err;
+			d[0] = (uint8_t)decoded_value;
+		}
+		for (k = 0; k < n; k++) {
+			err = decode_value(setup[k], &decoded_value, model[k]);
+			if (err)
+				return err;
+			put_unaligned(decoded_value, (uint32_t *)(d + base) + k);
+		}
 
-		err = decode_value(&setup_ecob, &decoded_value, model.ecob_x);
-		if (err)
-			break;
-		data_buf[i].ecob_x = decoded_value;
+		if (up_model_p) {
+			uint8_t *up = up_model_p + i * sample_size;
 
-		err = decode_value(&setup_ecob, &decoded_value, model.ecob_y);
-		if (err)
-			break;
-		data_buf[i].ecob_y = decoded_value;
+			if (short_cadence)
+				up[0] = cmp_up_model(d[0], model_exp_flags, cfg->model_value,
+						     setup_exp_flags.lossy_par);
+			for (k = 0; k < n; k++) {
+				uint32_t const v = get_unaligned((const uint32_t *)(d + base) + k);
 
-		if (up_model_buf) {
-			up_model_buf[i].exp_flags = cmp_up_model(data_buf[i].exp_flags, model.exp_flags,
-								 cfg->model_value, setup_exp_flags.lossy_par);
-			up_model_buf[i].fx = cmp_up_model(data_buf[i].fx, model.fx,
-							  cfg->model_value, setup_fx.lossy_par);
-			up_model_buf[i].ncob_x = cmp_up_model(data_buf[i].ncob_x, model.ncob_x,
-							      cfg->model_value, setup_ncob.lossy_par);
-			up_model_buf[i].ncob_y = cmp_up_model(data_buf[i].ncob_y, model.ncob_y,
-							      cfg->model_value, setup_ncob.lossy_par);
-			up_model_buf[i].efx = cmp_up_model(data_buf[i].efx, model.efx,
-							   cfg->model_value, setup_efx.lossy_par);
-			up_model_buf[i].ecob_x = cmp_up_model(data_buf[i].ecob_x, model.ecob_x,
-							      cfg->model_value, setup_ecob.lossy_par);
-			up_model_buf[i].ecob_y = cmp_up_model(data_buf[i].ecob_y, model.ecob_y,
-							      cfg->model_value, setup_ecob.lossy_par);
+				put_unaligned(cmp_up_model(v, model[k], cfg->model_value,
+							   setup[k]->lossy_par),
+					      (uint32_t *)(up + base) + k);
+			}
 		}
 
 		if (i >= cfg->samples-1)
 			break;
 
-		model = next_model_p[i];
+		model_p = next_model_p + i * sample_size;
 	}
 	return err;
 }
@@ -1513,34 +1348,37 @@ static int decompressed_data_internal(const struct cmp_cfg *cfg, enum decmp_type
 	if (decmp_type == ICU_DECOMRESSION)
 		data_size += COLLECTION_HDR_SIZE;
 
+	if (cfg->cmp_mode == CMP_MODE_RAW && cfg->stream_size < data_size) {
+		debug_print("Error: The compressed data size is too small for uncompressed data.");
+		return -1;
+	}
+
+	/* the error paths leave through out to end the trace span */
+	CMP_TRACE_BEGIN(CMP_TRACE_DECODE);
+	err = 0;
 	if (cfg->cmp_mode == CMP_MODE_RAW) {
 		if (cfg->dst) {
-			memcpy(cfg->dst, cfg->src, data_size);
 			switch (decmp_type) {
 			case ICU_DECOMRESSION:
-				if (be_to_cpu_chunk(cfg->dst, data_size))
-					return -1;
+				err = be_to_cpu_chunk_copy(cfg->dst, cfg->src, data_size);
 				break;
 			case RDCU_DECOMPRESSION:
-				if (be_to_cpu_data_type(cfg->dst, data_size,
-							cfg->data_type))
-					return -1;
+				err = be_to_cpu_data_type_copy(cfg->dst, cfg->src, data_size,
+							       cfg->data_type);
 				break;
 			}
 		}
-		err = 0;
 
-	} else {
+	} else if (cfg->dst) {
 		struct bit_decoder dec;
 		int hdr_size = 0;
 
-		if (!cfg->dst)
-			return (int)data_size;
-
 		if (decmp_type == ICU_DECOMRESSION) {
 			hdr_size = decompress_collection_hdr(cfg);
-			if (hdr_size < 0)
-				return -1;
+			if (hdr_size < 0) {
+				err = -1;
+				goto out;
+			}
 		}
 
 		bit_init_decoder(&dec, (const uint8_t *)cfg->src+hdr_size,
@@ -1556,16 +1394,17 @@ static int decompressed_data_internal(const struct cmp_cfg *cfg, enum decmp_type
 			err = decompress_imagette(cfg, &dec, decmp_type);
 			break;
 		case DATA_TYPE_S_FX:
-			err = decompress_s_fx(cfg, &dec);
+			err = decompress_fx_cob(cfg, &dec, FX_COB_EXP_FLAGS);
 			break;
 		case DATA_TYPE_S_FX_EFX:
-			err = decompress_s_fx_efx(cfg, &dec);
+			err = decompress_fx_cob(cfg, &dec, FX_COB_EXP_FLAGS | FX_COB_EFX);
 			break;
 		case DATA_TYPE_S_FX_NCOB:
-			err = decompress_s_fx_ncob(cfg, &dec);
+			err = decompress_fx_cob(cfg, &dec, FX_COB_EXP_FLAGS | FX_COB_NCOB);
 			break;
 		case DATA_TYPE_S_FX_EFX_NCOB_ECOB:
-			err = decompress_s_fx_efx_ncob_ecob(cfg, &dec);
+			err = decompress_fx_cob(cfg, &dec, FX_COB_EXP_FLAGS | FX_COB_NCOB |
+						FX_COB_EFX | FX_COB_ECOB);
 			break;
 
 		case DATA_TYPE_L_FX:
@@ -1594,9 +1433,18 @@ static int decompressed_data_internal(const struct cmp_cfg *cfg, enum decmp_type
 			break;
 
 		case DATA_TYPE_F_FX:
+			err = decompress_fx_cob(cfg, &dec, 0);
+			break;
 		case DATA_TYPE_F_FX_EFX:
+			err = decompress_fx_cob(cfg, &dec, FX_COB_EFX);
+			break;
 		case DATA_TYPE_F_FX_NCOB:
+			err = decompress_fx_cob(cfg, &dec, FX_COB_NCOB);
+			break;
 		case DATA_TYPE_F_FX_EFX_NCOB_ECOB:
+			err = decompress_fx_cob(cfg, &dec, FX_COB_NCOB | FX_COB_EFX | FX_COB_ECOB);
+			break;
+
 		case DATA_TYPE_CHUNK:
 		case DATA_TYPE_UNKNOWN:
 		default:
@@ -1627,6 +1475,8 @@ static int decompressed_data_internal(const struct cmp_cfg *cfg, enum decmp_type
 			break;
 		}
 	}
+out:
+	CMP_TRACE_END(CMP_TRACE_DECODE);
 	if (err)
 		return -1;
 
@@ -1646,31 +1496,37 @@ static int decompressed_data_internal(const struct cmp_cfg *cfg, enum decmp_type
 
 static int cmp_ent_read_header(const struct cmp_entity *ent, struct cmp_cfg *cfg)
 {
-	uint32_t org_size;
+	struct cmp_ent_hdr hdr;
+	uint32_t hdr_size;
 
 	if (!cfg)
 		return -1;
 
-	cfg->data_type = cmp_ent_get_data_type(ent);
+	/* the decompression trusts the entity size of the header */
+	if (cmp_ent_hdr_decode(ent, cmp_ent_get_size(ent), &hdr))
+		return -1;
+
+	cfg->data_type = hdr.data_type;
 	/* the compression entity data type field only supports imagette or chunk data types */
 	if (cfg->data_type != DATA_TYPE_CHUNK && !rdcu_supported_data_type_is_used(cfg->data_type)) {
 		debug_print("Error: Compression entity data type not supported.");
 		return -1;
 	}
 
-	cfg->cmp_mode = cmp_ent_get_cmp_mode(ent);
-	if (cmp_ent_get_data_type_raw_bit(ent) != (cfg->cmp_mode == CMP_MODE_RAW)) {
+	cfg->cmp_mode = hdr.cmp_mode;
+	if (hdr.raw_mode_flag != (cfg->cmp_mode == CMP_MODE_RAW)) {
 		debug_print("Error: The entity's raw data bit does not match up with the compression mode.");
 		return -1;
 	}
-	cfg->model_value = cmp_ent_get_model_value(ent);
-	cfg->round = cmp_ent_get_lossy_cmp_par(ent);
-	cfg->stream_size = cmp_ent_get_cmp_data_size(ent);
+	cfg->model_value = hdr.model_value;
+	cfg->round = hdr.lossy_cmp_par;
+	/* cmp_ent_hdr_decode() ensures that the entity holds the whole header */
+	hdr_size = cmp_ent_cal_hdr_size(hdr.data_type, hdr.raw_mode_flag);
+	cfg->stream_size = hdr.cmp_ent_size - hdr_size;
 
 	if (cmp_cfg_gen_par_is_invalid(cfg))
 		return -1;
 
-	org_size = cmp_ent_get_original_size(ent);
 	if (cfg->data_type == DATA_TYPE_CHUNK) {
 		cfg->samples = 0;
 		if ((cfg->stream_size < (COLLECTION_HDR_SIZE + CMP_COLLECTION_FILD_SIZE) && (cfg->cmp_mode != CMP_MODE_RAW)) ||
@@ -1678,26 +1534,26 @@ static int cmp_ent_read_header(const struct cmp_entity *ent, struct cmp_cfg *cfg
 			debug_print("Error: The compressed data size in the compression header is smaller than a collection header.");
 			return -1;
 		}
-		if (org_size < COLLECTION_HDR_SIZE) {
+		if (hdr.original_size < COLLECTION_HDR_SIZE) {
 			debug_print("Error: The original decompressed data size in the compression header is smaller than the minimum size.");
 			return -1;
 		}
 	} else {
-		if (org_size % sizeof(uint16_t)) {
+		if (hdr.original_size % sizeof(uint16_t)) {
 			debug_print("Error: The original size of an imagette product type in the compression header must be a multiple of 2.");
 			cfg->samples = 0;
 			return -1;
 		}
-		cfg->samples = org_size/sizeof(uint16_t);
+		cfg->samples = hdr.original_size/sizeof(uint16_t);
 	}
 
-	cfg->src = cmp_ent_get_data_buf_const(ent);
+	cfg->src = (const uint8_t *)ent + hdr_size;
 
-	if (cmp_ent_get_reserved(ent))
+	if (hdr.reserved)
 		debug_print("Warning: The reserved field in the compressed header should be zero.");
 
 	if (cfg->cmp_mode == CMP_MODE_RAW) {
-		if (cmp_ent_get_original_size(ent) != cmp_ent_get_cmp_data_size(ent)) {
+		if (hdr.original_size != cfg->stream_size) {
 			debug_print("Error: The compressed data size and the decompressed original data size in the compression header should be the same in raw mode.");
 			return -1;
 		}
@@ -1705,12 +1561,6 @@ static int cmp_ent_read_header(const struct cmp_entity *ent, struct cmp_cfg *cfg
 		return 0;
 	}
 
-	if (cmp_ent_cal_hdr_size(cfg->data_type, cfg->cmp_mode == CMP_MODE_RAW)
-	    > cmp_ent_get_size(ent)) {
-		debug_print("Error: The compression entity size is smaller than the minimum allowed size.");
-		return -1;
-	}
-
 	switch (cfg->data_type) {
 	case DATA_TYPE_IMAGETTE_ADAPTIVE:
 	case DATA_TYPE_SAT_IMAGETTE_ADAPTIVE:
@@ -1719,8 +1569,8 @@ static int cmp_ent_read_header(const struct cmp_entity *ent, struct cmp_cfg *cfg
 	case DATA_TYPE_IMAGETTE:
 	case DATA_TYPE_SAT_IMAGETTE:
 	case DATA_TYPE_F_CAM_IMAGETTE:
-		cfg->cmp_par_imagette = cmp_ent_get_ima_golomb_par(ent);
-		cfg->spill_imagette = cmp_ent_get_ima_spill(ent);
+		cfg->cmp_par_imagette = hdr.cmp_par[0];
+		cfg->spill_imagette = hdr.spill[0];
 		break;
 	case DATA_TYPE_OFFSET:
 	case DATA_TYPE_F_CAM_OFFSET:
@@ -1740,18 +1590,18 @@ static int cmp_ent_read_header(const struct cmp_entity *ent, struct cmp_cfg *cfg
 	case DATA_TYPE_F_FX_NCOB:
 	case DATA_TYPE_F_FX_EFX_NCOB_ECOB:
 	case DATA_TYPE_CHUNK:
-		cfg->cmp_par_exp_flags = cmp_ent_get_non_ima_cmp_par1(ent);
-		cfg->spill_exp_flags = cmp_ent_get_non_ima_spill1(ent);
-		cfg->cmp_par_fx = cmp_ent_get_non_ima_cmp_par2(ent);
-		cfg->spill_fx = cmp_ent_get_non_ima_spill2(ent);
-		cfg->cmp_par_ncob = cmp_ent_get_non_ima_cmp_par3(ent);
-		cfg->spill_ncob = cmp_ent_get_non_ima_spill3(ent);
-		cfg->cmp_par_efx = cmp_ent_get_non_ima_cmp_par4(ent);
-		cfg->spill_efx = cmp_ent_get_non_ima_spill4(ent);
-		cfg->cmp_par_ecob = cmp_ent_get_non_ima_cmp_par5(ent);
-		cfg->spill_ecob = cmp_ent_get_non_ima_spill5(ent);
-		cfg->cmp_par_fx_cob_variance = cmp_ent_get_non_ima_cmp_par6(ent);
-		cfg->spill_fx_cob_variance = cmp_ent_get_non_ima_spill6(ent);
+		cfg->cmp_par_exp_flags = hdr.cmp_par[0];
+		cfg->spill_exp_flags = hdr.spill[0];
+		cfg->cmp_par_fx = hdr.cmp_par[1];
+		cfg->spill_fx = hdr.spill[1];
+		cfg->cmp_par_ncob = hdr.cmp_par[2];
+		cfg->spill_ncob = hdr.spill[2];
+		cfg->cmp_par_efx = hdr.cmp_par[3];
+		cfg->spill_efx = hdr.spill[3];
+		cfg->cmp_par_ecob = hdr.cmp_par[4];
+		cfg->spill_ecob = hdr.spill[4];
+		cfg->cmp_par_fx_cob_variance = hdr.cmp_par[5];
+		cfg->spill_fx_cob_variance = hdr.spill[5];
 		break;
 	/* LCOV_EXCL_START */
 	case DATA_TYPE_UNKNOWN:
@@ -1986,8 +1836,7 @@ int decompress_cmp_entiy(const struct cmp_entity *ent, const void *model_of_data
 
 	if (cfg.cmp_mode == CMP_MODE_RAW) {
 		if (decompressed_data) {
-			memcpy(decompressed_data, cfg.src, cfg.stream_size);
-			cpu_to_be_chunk(decompressed_data, cfg.stream_size);
+			cpu_to_be_chunk_copy(decompressed_data, cfg.src, cfg.stream_size);
 		}
 		return (int)cfg.stream_size;
 	}
@@ -2015,8 +1864,7 @@ int decompress_cmp_entiy(const struct cmp_entity *ent, const void *model_of_data
 		if (col_uncompressed) {
 			if (cmp_cpy.updated_model_buf && model_mode_is_used(cmp_cpy.cmp_mode)) {
 				uint32_t s = cmp_cpy.stream_size;
-				memcpy(cmp_cpy.updated_model_buf, cmp_cpy.src, s);
-				if (be_to_cpu_chunk(cmp_cpy.updated_model_buf, s))
+				if (be_to_cpu_chunk_copy(cmp_cpy.updated_model_buf, cmp_cpy.src, s))
 					return -1;
 			}
 			cmp_cpy.cmp_mode = CMP_MODE_RAW;
@@ -2064,6 +1912,9 @@ int decompress_rdcu_data(const uint32_t *compressed_data, const struct cmp_info
 	if (info->cmp_err)
 		return -1;
 
+	if (adaptive_mode_is_used(info->cmp_mode_used))
+		return -1;
+
 	memset(&cfg, 0, sizeof(struct cmp_cfg));
 
 	cfg.data_type = DATA_TYPE_IMAGETTE;
@@ -0,0 +1,263 @@
+/**
+ * @file   decmp_batch.c
+ * @date   2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief batch decompression of an archive of concatenated compression
+ *	entities
+ *
+ * The entities are decompressed directly from the archive into the output
+ * buffer without intermediate copies. On POSIX hosts
+ * decompress_cmp_archive_fd() maps the archive and the output file into
+ * memory, so no read()/write() double buffering is needed.
+ */
+
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifndef ICU_ASW
+#  if defined __has_include
+#    if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+#      include <sys/mman.h>
+#      include <sys/stat.h>
+#      include <unistd.h>
+#      define HAS_MMAN_H 1
+#    endif
+#  endif
+#endif
+
+#include "../common/cmp_debug.h"
+#include "../common/cmp_support.h"
+#include "../common/cmp_entity.h"
+#include "../decmp.h"
+
+
+/**
+ * @brief get the size of the decompressed data of an archive of concatenated
+ *	compression entities
+ *
+ * Only the entity headers are read.
+ *
+ * @param archive	pointer to the concatenated compression entities
+ * @param archive_size	size of the archive in bytes
+ * @param decmp_size	pointer where the sum of the original data sizes is
+ *			stored
+ *
+ * @returns 0 on success; -1 on error (e.g. an entity does not fit into the
+ *	archive)
+ */
+
+int decompress_cmp_batch_size(const void *archive, size_t archive_size,
+			      size_t *decmp_size)
+{
+	const uint8_t *p = (const uint8_t *)archive;
+	size_t pos = 0;
+
+	if ((!archive && archive_size) || !decmp_size)
+		return -1;
+
+	*decmp_size = 0;
+	while (pos < archive_size) {
+		struct cmp_ent_hdr hdr;
+
+		if (cmp_ent_hdr_decode((const struct cmp_entity *)(p + pos),
+				       archive_size - pos, &hdr)) {
+			debug_print("Error: Broken compression entity at archive offset %lu.",
+				    (unsigned long)pos);
+			return -1;
+		}
+		*decmp_size += hdr.original_size;
+		pos += hdr.cmp_ent_size;
+	}
+
+	return 0;
+}
+
+
+/**
+ * @brief decompress an archive of concatenated compression entities
+ *
+ * The decompressed data of all entities are written one after another to dst.
+ *
+ * Model mode entities are decompressed with a model chain: the decompressed
+ * data of a non-model mode entity are the model of the following model mode
+ * entity, which writes its updated model to the model buffer; the model buffer
+ * is then updated in place by every further model mode entity. Products with
+ * separate model chains should therefore be stored in separate archives.
+ *
+ * @param archive		pointer to the concatenated compression entities
+ * @param archive_size		size of the archive in bytes
+ * @param model_buf		pointer to the model buffer; must hold the largest
+ *				original data size of the archive (can be NULL
+ *				if no model mode entity is in the archive)
+ * @param model_buf_size	size of the model buffer in bytes
+ * @param dst			pointer to the output buffer (can be NULL to
+ *				only check the entity headers and the model
+ *				chain; then only the non-model mode entities
+ *				needed as model are decoded, the model mode
+ *				entities are not decoded)
+ * @param dst_capacity		size of the output buffer in bytes
+ * @param decmp_size		pointer where the number of decompressed bytes is
+ *				stored (can be NULL)
+ *
+ * @returns 0 on success; -1 on error
+ */
+
+int decompress_cmp_batch(const void *archive, size_t archive_size,
+			 void *model_buf, size_t model_buf_size,
+			 void *dst, size_t dst_capacity, size_t *decmp_size)
+{
+	const uint8_t *p = (const uint8_t *)archive;
+	uint8_t *out = (uint8_t *)dst;
+	const void *model = NULL;
+	size_t pos = 0, out_pos = 0, model_size = 0;
+
+	if (!archive && archive_size)
+		return -1;
+
+	while (pos < archive_size) {
+		const struct cmp_entity *ent = (const struct cmp_entity *)(p + pos);
+		struct cmp_ent_hdr hdr;
+		void *out_p;
+		int model_mode, chain, size;
+
+		if (cmp_ent_hdr_decode(ent, archive_size - pos, &hdr)) {
+			debug_print("Error: Broken compression entity at archive offset %lu.",
+				    (unsigned long)pos);
+			return -1;
+		}
+		if (dst && hdr.original_size > dst_capacity - out_pos) {
+			debug_print("Error: The output buffer is too small for the decompressed archive.");
+			return -1;
+		}
+
+		model_mode = model_mode_is_used(hdr.cmp_mode);
+		if (model_mode && (!model_buf || model_size != hdr.original_size)) {
+			debug_print("Error: No matching model for the model mode entity at archive offset %lu.",
+				    (unsigned long)pos);
+			return -1;
+		}
+		/* an entity larger than the model buffer breaks the model chain */
+		chain = model_buf && hdr.original_size <= model_buf_size;
+
+		if (dst)
+			out_p = out + out_pos;
+		else if (chain && !model_mode)
+			out_p = model_buf; /* needed as model of the next entity */
+		else
+			out_p = NULL;
+		size = decompress_cmp_entiy(ent, model_mode ? model : NULL,
+					    model_mode ? model_buf : NULL, out_p);
+		if (size < 0 || (uint32_t)size != hdr.original_size) {
+			debug_print("Error: Decompression of the entity at archive offset %lu failed.",
+				    (unsigned long)pos);
+			return -1;
+		}
+
+		if (chain) {
+			/* the decompressed data of a non-model mode entity are
+			 * used as model where they are; a model mode entity
+			 * writes the updated model to the model buffer
+			 */
+			model = model_mode ? model_buf : out_p;
+			model_size = (size_t)size;
+		} else {
+			model = NULL;
+			model_size = 0;
+		}
+
+		pos += hdr.cmp_ent_size;
+		if (dst)
+			out_pos += (size_t)size;
+	}
+
+	if (decmp_size)
+		*decmp_size = out_pos;
+	return 0;
+}
+
+
+#ifdef HAS_MMAN_H
+/**
+ * @brief decompress an archive file into an output file using memory mappings
+ *
+ * The archive is mapped read-only with sequential read-ahead; the output file
+ * is resized to the decompressed size and mapped shared, so the entities are
+ * decompressed straight from the page cache into the page cache.
+ *
+ * @param archive_fd		file descriptor of the archive opened for reading
+ * @param output_fd		file descriptor of the output file opened for
+ *				reading and writing
+ * @param model_buf		pointer to the model buffer (see
+ *				decompress_cmp_batch())
+ * @param model_buf_size	size of the model buffer in bytes
+ * @param decmp_size		pointer where the number of decompressed bytes is
+ *				stored (can be NULL)
+ *
+ * @returns 0 on success; -1 on error
+ */
+
+int decompress_cmp_archive_fd(int archive_fd, int output_fd, void *model_buf,
+			      size_t model_buf_size, size_t *decmp_size)
+{
+	struct stat st;
+	void *archive = NULL, *out = NULL;
+	size_t archive_size, out_size = 0;
+	int err = -1;
+
+	if (fstat(archive_fd, &st) || st.st_size < 0)
+		return -1;
+	archive_size = (size_t)st.st_size;
+	if ((off_t)archive_size != st.st_size)
+		return -1;
+
+	if (archive_size) {
+		archive = mmap(NULL, archive_size, PROT_READ, MAP_PRIVATE, archive_fd, 0);
+		if (archive == MAP_FAILED) {
+			debug_print("Error: Can not map the archive into memory.");
+			return -1;
+		}
+		/* MADV_WILLNEED would read the whole (possibly huge) archive at once */
+		madvise(archive, archive_size, MADV_SEQUENTIAL);
+	}
+
+	if (decompress_cmp_batch_size(archive, archive_size, &out_size))
+		goto out;
+
+	if (ftruncate(output_fd, (off_t)out_size)) {
+		debug_print("Error: Can not resize the output file.");
+		goto out;
+	}
+	if (out_size) {
+		out = mmap(NULL, out_size, PROT_READ | PROT_WRITE, MAP_SHARED, output_fd, 0);
+		if (out == MAP_FAILED) {
+			debug_print("Error: Can not map the output file into memory.");
+			out = NULL;
+			goto out;
+		}
+		madvise(out, out_size, MADV_SEQUENTIAL);
+	}
+
+	err = decompress_cmp_batch(archive, archive_size, model_buf, model_buf_size,
+				   out, out_size, decmp_size);
+	if (!err && out && msync(out, out_size, MS_SYNC))
+		err = -1;
+
+out:
+	if (out)
+		munmap(out, out_size);
+	if (archive)
+		munmap(archive, archive_size);
+	return err;
+}
+#endif /* HAS_MMAN_H */
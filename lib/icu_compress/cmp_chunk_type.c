@@ -22,9 +22,39 @@
 
 
 /**
- * @brief get the chunk_type of a collection
+ * @brief chunk types indexed by the (6 bit) collection subservice
  * @details map a sub-service to a chunk service according to
  *	DetailedBudgetWorking_2023-10-11
+ */
+
+static const uint8_t chunk_type_lut[64] = {
+	[SST_NCxx_S_SCIENCE_IMAGETTE] = CHUNK_TYPE_NCAM_IMAGETTE,
+	[SST_NCxx_S_SCIENCE_SAT_IMAGETTE] = CHUNK_TYPE_SAT_IMAGETTE,
+	[SST_NCxx_S_SCIENCE_OFFSET] = CHUNK_TYPE_OFFSET_BACKGROUND,
+	[SST_NCxx_S_SCIENCE_BACKGROUND] = CHUNK_TYPE_OFFSET_BACKGROUND,
+	[SST_NCxx_S_SCIENCE_SMEARING] = CHUNK_TYPE_SMEARING,
+	[SST_NCxx_S_SCIENCE_S_FX] = CHUNK_TYPE_SHORT_CADENCE,
+	[SST_NCxx_S_SCIENCE_S_FX_EFX] = CHUNK_TYPE_SHORT_CADENCE,
+	[SST_NCxx_S_SCIENCE_S_FX_NCOB] = CHUNK_TYPE_SHORT_CADENCE,
+	[SST_NCxx_S_SCIENCE_S_FX_EFX_NCOB_ECOB] = CHUNK_TYPE_SHORT_CADENCE,
+	[SST_NCxx_S_SCIENCE_L_FX] = CHUNK_TYPE_LONG_CADENCE,
+	[SST_NCxx_S_SCIENCE_L_FX_EFX] = CHUNK_TYPE_LONG_CADENCE,
+	[SST_NCxx_S_SCIENCE_L_FX_NCOB] = CHUNK_TYPE_LONG_CADENCE,
+	[SST_NCxx_S_SCIENCE_L_FX_EFX_NCOB_ECOB] = CHUNK_TYPE_LONG_CADENCE,
+	[SST_NCxx_S_SCIENCE_F_FX] = CHUNK_TYPE_FAST_CADENCE,
+	[SST_NCxx_S_SCIENCE_F_FX_EFX] = CHUNK_TYPE_FAST_CADENCE,
+	[SST_NCxx_S_SCIENCE_F_FX_NCOB] = CHUNK_TYPE_FAST_CADENCE,
+	[SST_NCxx_S_SCIENCE_F_FX_EFX_NCOB_ECOB] = CHUNK_TYPE_FAST_CADENCE,
+	[SST_FCx_S_SCIENCE_IMAGETTE] = CHUNK_TYPE_F_CHAIN,
+	[SST_FCx_S_SCIENCE_OFFSET_VALUES] = CHUNK_TYPE_F_CHAIN,
+	[SST_FCx_S_BACKGROUND_VALUES] = CHUNK_TYPE_F_CHAIN,
+};
+
+compile_time_assert(CHUNK_TYPE_UNKNOWN == 0, UNKNOWN_CHUNK_TYPE_IS_ZERO);
+
+
+/**
+ * @brief get the chunk_type of a collection
  *
  * @param col	pointer to a collection header
  *
@@ -34,49 +64,43 @@
 
 enum chunk_type cmp_col_get_chunk_type(const struct collection_hdr *col)
 {
-	enum chunk_type chunk_type;
+	uint8_t const subservice = cmp_col_get_subservice(col);
+
+	if (subservice >= ARRAY_SIZE(chunk_type_lut))
+		return CHUNK_TYPE_UNKNOWN;
+
+	return (enum chunk_type)chunk_type_lut[subservice];
+}
+
+
+/**
+ * @brief check if lossy compression is allowed for a chunk type
+ *
+ * Lossy rounding is only allowed for chunk types where the loss of the least
+ * significant bits is scientifically acceptable. The short and long cadence
+ * chunks are excluded because the exposure flags are bit fields, the fast
+ * cadence chunks to keep all flux/COB products lossless and the saturated
+ * imagettes because the saturation level would be lost.
+ *
+ * @param chunk_type	chunk type to check
+ *
+ * @returns non-zero if lossy_par is honoured for the chunk type
+ */
 
-	switch (cmp_col_get_subservice(col)) {
-	case SST_NCxx_S_SCIENCE_IMAGETTE:
-		chunk_type = CHUNK_TYPE_NCAM_IMAGETTE;
-		break;
-	case SST_NCxx_S_SCIENCE_SAT_IMAGETTE:
-		chunk_type = CHUNK_TYPE_SAT_IMAGETTE;
-		break;
-	case SST_NCxx_S_SCIENCE_OFFSET:
-	case SST_NCxx_S_SCIENCE_BACKGROUND:
-		chunk_type = CHUNK_TYPE_OFFSET_BACKGROUND;
-		break;
-	case SST_NCxx_S_SCIENCE_SMEARING:
-		chunk_type = CHUNK_TYPE_SMEARING;
-		break;
-	case SST_NCxx_S_SCIENCE_S_FX:
-	case SST_NCxx_S_SCIENCE_S_FX_EFX:
-	case SST_NCxx_S_SCIENCE_S_FX_NCOB:
-	case SST_NCxx_S_SCIENCE_S_FX_EFX_NCOB_ECOB:
-		chunk_type = CHUNK_TYPE_SHORT_CADENCE;
-		break;
-	case SST_NCxx_S_SCIENCE_L_FX:
-	case SST_NCxx_S_SCIENCE_L_FX_EFX:
-	case SST_NCxx_S_SCIENCE_L_FX_NCOB:
-	case SST_NCxx_S_SCIENCE_L_FX_EFX_NCOB_ECOB:
-		chunk_type = CHUNK_TYPE_LONG_CADENCE;
-		break;
-	case SST_FCx_S_SCIENCE_IMAGETTE:
-	case SST_FCx_S_SCIENCE_OFFSET_VALUES:
-	case SST_FCx_S_BACKGROUND_VALUES:
-		chunk_type = CHUNK_TYPE_F_CHAIN;
-		break;
-	case SST_NCxx_S_SCIENCE_F_FX:
-	case SST_NCxx_S_SCIENCE_F_FX_EFX:
-	case SST_NCxx_S_SCIENCE_F_FX_NCOB:
-	case SST_NCxx_S_SCIENCE_F_FX_EFX_NCOB_ECOB:
-		debug_print("Error: No chunk is defined for fast cadence subservices");
-		/* fall through */
+int chunk_type_supports_lossy(enum chunk_type chunk_type)
+{
+	switch (chunk_type) {
+	case CHUNK_TYPE_NCAM_IMAGETTE:
+	case CHUNK_TYPE_OFFSET_BACKGROUND:
+	case CHUNK_TYPE_SMEARING:
+	case CHUNK_TYPE_F_CHAIN:
+		return 1;
+	case CHUNK_TYPE_SHORT_CADENCE:
+	case CHUNK_TYPE_LONG_CADENCE:
+	case CHUNK_TYPE_FAST_CADENCE:
+	case CHUNK_TYPE_SAT_IMAGETTE:
+	case CHUNK_TYPE_UNKNOWN:
 	default:
-		chunk_type = CHUNK_TYPE_UNKNOWN;
-		break;
+		return 0;
 	}
-
-	return chunk_type;
 }
@@ -35,10 +35,13 @@ enum chunk_type {
 	CHUNK_TYPE_SAT_IMAGETTE,
 	CHUNK_TYPE_OFFSET_BACKGROUND, /* N-CAM */
 	CHUNK_TYPE_SMEARING,
-	CHUNK_TYPE_F_CHAIN
+	CHUNK_TYPE_F_CHAIN,
+	CHUNK_TYPE_FAST_CADENCE
 };
 
 
 enum chunk_type cmp_col_get_chunk_type(const struct collection_hdr *col);
 
+int chunk_type_supports_lossy(enum chunk_type chunk_type);
+
 #endif /* CMP_CHUNK_TYPE_H */
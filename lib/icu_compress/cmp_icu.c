@@ -21,6 +21,7 @@
 #include <stdint.h>
 #include <string.h>
 #include <limits.h>
+#include <assert.h>
 
 #include "../common/byteorder.h"
 #include "../common/compiler.h"
@@ -33,6 +34,7 @@
 #include "../common/cmp_error.h"
 #include "../common/cmp_error_list.h"
 #include "../common/leon_inttypes.h"
+#include "../common/cmp_trace.h"
 #include "cmp_chunk_type.h"
 
 #include "../cmp_icu.h"
@@ -67,6 +69,14 @@ static uint64_t (*get_timestamp)(void) = default_get_timestamp;
 static uint32_t version_identifier;
 
 
+/**
+ * @brief compression statistics sink set with the compress_chunk_set_stats()
+ *	function
+ */
+
+static struct cmp_stats *stats_sink;
+
+
 /**
  * @brief structure to hold a setup to encode a value
  */
@@ -83,6 +93,51 @@ struct encoder_setup {
 	uint32_t spillover_par;  /**< outlier parameter */
 	uint32_t lossy_par;      /**< lossy compression parameter */
 	uint32_t max_data_bits;  /**< how many bits are needed to represent the highest possible value */
+	struct cmp_field_stats *stats; /**< field statistics to update; NULL if not used */
+	struct adaptive_field *adaptive; /**< block parameter selection; NULL if not used */
+};
+
+
+/* most encoder setups used to compress a data type (L_FX_EFX_NCOB_ECOB) */
+#define ADAPTIVE_MAX_FIELDS	CMP_STATS_MAX_FIELDS
+/*
+ * a collection holds at most UINT16_MAX data bytes and no encoder setup
+ * encodes more than one value per two bytes
+ */
+#define ADAPTIVE_MAX_BLOCKS	((UINT16_MAX/2 + CMP_ADAPTIVE_BLOCK_SIZE-1) / CMP_ADAPTIVE_BLOCK_SIZE)
+#define ADAPTIVE_SEL_PER_BYTE	(8 / CMP_ADAPTIVE_SEL_BITS)
+
+compile_time_assert(8 % CMP_ADAPTIVE_SEL_BITS == 0, CMP_ADAPTIVE_SEL_BITS_DO_NOT_FIT_IN_A_BYTE);
+
+/* number of collection headers decoded at once by the chunk compression */
+#define CMP_COL_DESC_BATCH	16
+
+
+/**
+ * @brief block parameter selection of an encoder setup in an adaptive
+ *	compression mode
+ */
+
+struct adaptive_field {
+	struct encoder_setup cand[CMP_ADAPTIVE_NUM_PARS]; /**< setups of the candidate parameters; only count bits */
+	uint32_t cost[CMP_ADAPTIVE_NUM_PARS]; /**< bit costs of the candidates in the current block */
+	uint32_t values;                      /**< number of values passed to the setup */
+	int analyse;                          /**< non-zero during the analysis pass */
+	uint8_t sel[(ADAPTIVE_MAX_BLOCKS + ADAPTIVE_SEL_PER_BYTE-1) / ADAPTIVE_SEL_PER_BYTE]; /**< packed selected candidate of every block */
+};
+
+
+/**
+ * @brief block parameter selection state of a collection; the collection is
+ *	first analysed to select the parameter of every block and then encoded
+ *	with the selected parameters
+ */
+
+struct cmp_adaptive_state {
+	int analyse;                 /**< non-zero during the analysis pass */
+	unsigned int num_fields;     /**< number of bound encoder setups */
+	unsigned int fields_missing; /**< number of encoder setups which could not be bound */
+	struct adaptive_field field[ADAPTIVE_MAX_FIELDS];
 };
 
 
@@ -325,6 +380,11 @@ static uint32_t encode_value_zero(uint32_t data, uint32_t model, uint32_t stream
 
 	data++; /* add 1 to every value so we can use 0 as the escape symbol */
 
+	if (setup->stats) {
+		setup->stats->outliers++;
+		setup->stats->outlier_bits += setup->max_data_bits;
+	}
+
 	/* use zero as escape symbol */
 	stream_len = encode_normal(0, stream_len, setup);
 	if (cmp_is_error(stream_len))
@@ -388,6 +448,11 @@ static uint32_t encode_value_multi(uint32_t data, uint32_t model, uint32_t strea
 	escape_sym = setup->spillover_par + escape_sym_offset;
 	unencoded_data_len = (escape_sym_offset + 1U) << 1;
 
+	if (setup->stats) {
+		setup->stats->outliers++;
+		setup->stats->outlier_bits += unencoded_data_len;
+	}
+
 	/* put the escape symbol in the bitstream */
 	stream_len = encode_normal(escape_sym, stream_len, setup);
 	if (cmp_is_error(stream_len))
@@ -400,6 +465,140 @@ static uint32_t encode_value_multi(uint32_t data, uint32_t model, uint32_t strea
 }
 
 
+/**
+ * @brief encodes the data with the model and updates the field statistics
+ *
+ * @param data		data to encode
+ * @param model		model of the data (0 if not used)
+ * @param stream_len	length of the bitstream in bits
+ * @param setup		pointer to the encoder setup with a statistics field
+ *
+ * @returns the bit length of the bitstream on success or an error code if it
+ *	fails (which can be tested with cmp_is_error())
+ */
+
+static uint32_t encode_value_stats(uint32_t data, uint32_t model, uint32_t stream_len,
+				   const struct encoder_setup *setup)
+{
+	struct cmp_field_stats *stats = setup->stats;
+	/* max_data_bits is not 0, see configure_encoder_setup() */
+	unsigned int const shift = 32 - setup->max_data_bits;
+	/* sign extend the max_data_bits wide difference */
+	int32_t const residual = (int32_t)((data - model) << shift) >> shift;
+	uint32_t const new_stream_len = setup->encode_method_f(data, model, stream_len, setup);
+
+	if (cmp_is_error(new_stream_len))
+		return new_stream_len;
+
+	stats->values++;
+	stats->bits += new_stream_len - stream_len;
+	stats->residual_sum += residual;
+	if (residual < stats->residual_min)
+		stats->residual_min = residual;
+	if (residual > stats->residual_max)
+		stats->residual_max = residual;
+
+	return new_stream_len;
+}
+
+
+/**
+ * @brief get the selected candidate parameter of a block
+ */
+
+static unsigned int adaptive_get_sel(const struct adaptive_field *af, uint32_t block)
+{
+	unsigned int const shift = (block % ADAPTIVE_SEL_PER_BYTE) * CMP_ADAPTIVE_SEL_BITS;
+
+	return (af->sel[block / ADAPTIVE_SEL_PER_BYTE] >> shift) &
+		(CMP_ADAPTIVE_NUM_PARS - 1);
+}
+
+
+/**
+ * @brief set the selected candidate parameter of a block
+ */
+
+static void adaptive_set_sel(struct adaptive_field *af, uint32_t block, unsigned int sel)
+{
+	unsigned int const shift = (block % ADAPTIVE_SEL_PER_BYTE) * CMP_ADAPTIVE_SEL_BITS;
+	uint8_t *p = &af->sel[block / ADAPTIVE_SEL_PER_BYTE];
+
+	*p = (uint8_t)((*p & ~((CMP_ADAPTIVE_NUM_PARS - 1) << shift)) | (sel << shift));
+}
+
+
+/**
+ * @brief encode a value in an adaptive compression mode
+ *
+ * In the analysis pass the exact code length of the value is added to the bit
+ * costs of every candidate parameter and the cheapest candidate is selected
+ * for the block; nothing is written to the bitstream. In the encoding pass the
+ * selected candidate is put in the bitstream at the start of every block
+ * before the values of the block are encoded with it.
+ *
+ * @param data		data to encode
+ * @param model		model of the data (0 if not used)
+ * @param stream_len	length of the bitstream in bits
+ * @param setup		pointer to the encoder setup with a block parameter
+ *			selection
+ *
+ * @returns the bit length of the bitstream on success or an error code if it
+ *	fails (which can be tested with cmp_is_error())
+ */
+
+static uint32_t encode_value_adaptive(uint32_t data, uint32_t model, uint32_t stream_len,
+				      struct encoder_setup *setup)
+{
+	struct adaptive_field *af = setup->adaptive;
+	uint32_t const block = af->values / CMP_ADAPTIVE_BLOCK_SIZE;
+	int const block_start = af->values % CMP_ADAPTIVE_BLOCK_SIZE == 0;
+	unsigned int sel;
+
+	RETURN_ERROR_IF(block >= ADAPTIVE_MAX_BLOCKS, PAR_GENERIC,
+			"Too many values for the adaptive compression mode.");
+	af->values++;
+
+	if (af->analyse) {
+		unsigned int best = 0;
+
+		if (block_start)
+			memset(af->cost, 0, sizeof(af->cost));
+
+		for (sel = 0; sel < CMP_ADAPTIVE_NUM_PARS; sel++) {
+			if (!cmp_is_error(af->cost[sel]))
+				af->cost[sel] = af->cand[sel].encode_method_f(data, model,
+						af->cost[sel], &af->cand[sel]);
+			if (af->cost[sel] < af->cost[best])
+				best = sel;
+		}
+		adaptive_set_sel(af, block, best);
+		return stream_len;
+	}
+
+	if (block_start) {
+		const struct encoder_setup *cand;
+
+		sel = adaptive_get_sel(af, block);
+		stream_len = put_n_bits32(sel, CMP_ADAPTIVE_SEL_BITS, stream_len,
+					  setup->bitstream_adr, setup->max_stream_len);
+		if (cmp_is_error(stream_len))
+			return stream_len;
+
+		cand = &af->cand[sel];
+		setup->generate_cw_f = cand->generate_cw_f;
+		setup->encoder_par1 = cand->encoder_par1;
+		setup->encoder_par2 = cand->encoder_par2;
+		setup->spillover_par = cand->spillover_par;
+	}
+
+	if (unlikely(setup->stats))
+		return encode_value_stats(data, model, stream_len, setup);
+
+	return setup->encode_method_f(data, model, stream_len, setup);
+}
+
+
 /**
  * @brief encodes the data with the model and the given setup and put it into
  *	the bitstream
@@ -414,7 +613,7 @@ static uint32_t encode_value_multi(uint32_t data, uint32_t model, uint32_t strea
  */
 
 static uint32_t encode_value(uint32_t data, uint32_t model, uint32_t stream_len,
-			     const struct encoder_setup *setup)
+			     struct encoder_setup *setup)
 {
 	uint32_t const mask = ~(0xFFFFFFFFU >> (32-setup->max_data_bits));
 
@@ -424,6 +623,12 @@ static uint32_t encode_value(uint32_t data, uint32_t model, uint32_t stream_len,
 
 	RETURN_ERROR_IF(data & mask || model & mask, DATA_VALUE_TOO_LARGE, "");
 
+	if (unlikely(setup->adaptive))
+		return encode_value_adaptive(data, model, stream_len, setup);
+
+	if (unlikely(setup->stats))
+		return encode_value_stats(data, model, stream_len, setup);
+
 	return setup->encode_method_f(data, model, stream_len, setup);
 }
 
@@ -451,7 +656,8 @@ static uint32_t cmp_stream_size_to_bits(uint32_t stream_size)
  * @param cmp_par	compression parameter
  * @param spillover	spillover_par parameter
  * @param lossy_par	lossy compression parameter
- * @param max_data_bits	how many bits are needed to represent the highest possible value
+ * @param max_data_bits	how many bits are needed to represent the highest
+ *			possible value (1 to 32)
  * @param cfg		pointer to the compression configuration structure
  *
  * @warning input parameters are not checked for validity
@@ -462,6 +668,9 @@ static void configure_encoder_setup(struct encoder_setup *setup,
 				    uint32_t lossy_par, uint32_t max_data_bits,
 				    const struct cmp_cfg *cfg)
 {
+	/* the encoders shift by 32 - max_data_bits */
+	assert(max_data_bits > 0 && max_data_bits <= 32);
+
 	memset(setup, 0, sizeof(struct encoder_setup));
 
 	setup->encoder_par1 = cmp_par;
@@ -484,6 +693,46 @@ static void configure_encoder_setup(struct encoder_setup *setup,
 		setup->encode_method_f = &encode_value_zero;
 	else
 		setup->encode_method_f = &encode_value_multi;
+
+	if (cfg->col_stats && cfg->col_stats->num_fields < CMP_STATS_MAX_FIELDS) {
+		setup->stats = &cfg->col_stats->field[cfg->col_stats->num_fields++];
+		setup->stats->cmp_par = cmp_par;
+		setup->stats->spill = spillover;
+		setup->stats->residual_min = INT32_MAX;
+		setup->stats->residual_max = INT32_MIN;
+	}
+
+	if (cfg->adaptive) {
+		struct cmp_adaptive_state *state = cfg->adaptive;
+		struct adaptive_field *af;
+		unsigned int sel;
+
+		if (state->num_fields >= ADAPTIVE_MAX_FIELDS) {
+			state->fields_missing++;
+			return;
+		}
+		af = &state->field[state->num_fields++];
+		af->values = 0;
+		af->analyse = state->analyse;
+		setup->adaptive = af;
+
+		/* the candidate setups only count the bits of the code words */
+		for (sel = 0; sel < CMP_ADAPTIVE_NUM_PARS; sel++) {
+			struct encoder_setup *cand = &af->cand[sel];
+
+			*cand = *setup;
+			cand->bitstream_adr = NULL;
+			cand->stats = NULL;
+			cand->adaptive = NULL;
+			cand->encoder_par1 = cmp_adaptive_par(cmp_par, sel);
+			cand->encoder_par2 = ilog_2(cand->encoder_par1);
+			cand->spillover_par = cmp_adaptive_spill(cmp_par, spillover, sel);
+			if (is_a_pow_of_2(cand->encoder_par1))
+				cand->generate_cw_f = &rice_encoder;
+			else
+				cand->generate_cw_f = &golomb_encoder;
+		}
+	}
 }
 
 
@@ -501,7 +750,10 @@ static uint32_t compress_imagette(const struct cmp_cfg *cfg, uint32_t stream_len
 {
 	size_t i;
 	struct encoder_setup setup;
-	uint32_t max_data_bits;
+	struct encoder_setup trial_setups[CMP_MAX_PAR_TRIALS];
+	uint32_t max_data_bits, t;
+	uint32_t const num_trials = cfg->num_par_trials < CMP_MAX_PAR_TRIALS ?
+		cfg->num_par_trials : CMP_MAX_PAR_TRIALS;
 
 	const uint16_t *data_buf = cfg->src;
 	const uint16_t *model_buf = cfg->model_buf;
@@ -528,12 +780,32 @@ static uint32_t compress_imagette(const struct cmp_cfg *cfg, uint32_t stream_len
 	configure_encoder_setup(&setup, cfg->cmp_par_imagette,
 				cfg->spill_imagette, cfg->round, max_data_bits, cfg);
 
+	/* the parameter trials only count the bits of their code words; they
+	 * must not take statistics fields or run the adaptive selection
+	 */
+	if (num_trials) {
+		struct cmp_cfg trial_cfg = *cfg;
+
+		trial_cfg.dst = NULL;
+		trial_cfg.col_stats = NULL;
+		trial_cfg.adaptive = NULL;
+		for (t = 0; t < num_trials; t++)
+			configure_encoder_setup(&trial_setups[t], cfg->par_trials[t].golomb_par,
+						cfg->par_trials[t].spill, cfg->round,
+						max_data_bits, &trial_cfg);
+	}
+
 	for (i = 0;; i++) {
 		stream_len = encode_value(get_unaligned(&data_buf[i]),
 					  model, stream_len, &setup);
 		if (cmp_is_error(stream_len))
 			break;
 
+		for (t = 0; t < num_trials; t++)
+			cfg->par_trials[t].cmp_size =
+				encode_value(get_unaligned(&data_buf[i]), model,
+					     cfg->par_trials[t].cmp_size, &trial_setups[t]);
+
 		if (up_model_buf) {
 			uint16_t data = get_unaligned(&data_buf[i]);
 			up_model_buf[i] = cmp_up_model(data, model, cfg->model_value,
@@ -549,7 +821,118 @@ static uint32_t compress_imagette(const struct cmp_cfg *cfg, uint32_t stream_len
 
 
 /**
- * @brief compress short normal light flux (S_FX) data
+ * @brief compress short (S_FX) or fast (F_FX) cadence flux and center of
+ *	brightness data
+ *
+ * The short and fast cadence samples only differ in the exposure flags field
+ * of the short cadence samples, so one kernel serves all eight data types.
+ * The fields are encoded in the order in which they are stored in a sample.
+ *
+ * @param cfg		pointer to the compression configuration structure
+ * @param stream_len	already used length of the bitstream in bits
+ * @param fields	FX_COB_* flags of the fields in a sample
+ *
+ * @returns the bit length of the bitstream on success or an error code if it
+ *	fails (which can be tested with cmp_is_error())
+ */
+
+static uint32_t compress_fx_cob(const struct cmp_cfg *cfg, uint32_t stream_len,
+				unsigned int fields)
+{
+	static const uint8_t zero_model[sizeof(struct s_fx_efx_ncob_ecob)];
+	struct encoder_setup setup_exp_flags, setup_fx, setup_ncob, setup_efx, setup_ecob;
+	struct encoder_setup *setup[FX_COB_MAX_VALUES];
+	int const short_cadence = !!(fields & FX_COB_EXP_FLAGS);
+	uint32_t const base = short_cadence ? sizeof(uint8_t) : 0;
+	uint32_t sample_size, n = 0, k;
+	const uint8_t *data_p = cfg->src;
+	const uint8_t *model_p, *next_model_p;
+	uint8_t *up_model_p = NULL;
+	size_t i;
+
+	if (short_cadence)
+		configure_encoder_setup(&setup_exp_flags, cfg->cmp_par_exp_flags,
+					cfg->spill_exp_flags, cfg->round,
+					MAX_USED_BITS.s_exp_flags, cfg);
+	configure_encoder_setup(&setup_fx, cfg->cmp_par_fx, cfg->spill_fx, cfg->round,
+				short_cadence ? MAX_USED_BITS.s_fx : MAX_USED_BITS.f_fx, cfg);
+	setup[n++] = &setup_fx;
+	if (fields & FX_COB_NCOB) {
+		configure_encoder_setup(&setup_ncob, cfg->cmp_par_ncob, cfg->spill_ncob, cfg->round,
+					short_cadence ? MAX_USED_BITS.s_ncob : MAX_USED_BITS.f_ncob, cfg);
+		setup[n++] = &setup_ncob; /* ncob_x */
+		setup[n++] = &setup_ncob; /* ncob_y */
+	}
+	if (fields & FX_COB_EFX) {
+		configure_encoder_setup(&setup_efx, cfg->cmp_par_efx, cfg->spill_efx, cfg->round,
+					short_cadence ? MAX_USED_BITS.s_efx : MAX_USED_BITS.f_efx, cfg);
+		setup[n++] = &setup_efx;
+	}
+	if (fields & FX_COB_ECOB) {
+		configure_encoder_setup(&setup_ecob, cfg->cmp_par_ecob, cfg->spill_ecob, cfg->round,
+					short_cadence ? MAX_USED_BITS.s_ecob : MAX_USED_BITS.f_ecob, cfg);
+		setup[n++] = &setup_ecob; /* ecob_x */
+		setup[n++] = &setup_ecob; /* ecob_y */
+	}
+	sample_size = base + n * sizeof(uint32_t);
+
+	if (model_mode_is_used(cfg->cmp_mode)) {
+		model_p = cfg->model_buf;
+		next_model_p = model_p + sample_size;
+		up_model_p = cfg->updated_model_buf;
+	} else {
+		model_p = zero_model;
+		next_model_p = data_p;
+	}
+
+	for (i = 0;; i++) {
+		const uint8_t *d = data_p + i * sample_size;
+		uint8_t const model_exp_flags = model_p[0];
+		uint32_t model[FX_COB_MAX_VALUES];
+
+		/* copy the model, an in-place model update overwrites it */
+		for (k = 0; k < n; k++)
+			model[k] = get_unaligned((const uint32_t *)(model_p + base) + k);
+
+		if (short_cadence) {
+			stream_len = encode_value(d[0], model_exp_flags, stream_len,
+						  &setup_exp_flags);
+			if (cmp_is_error(stream_len))
+				return stream_len;
+		}
+		for (k = 0; k < n; k++) {
+			stream_len = encode_value(get_unaligned((const uint32_t *)(d + base) + k),
+						  model[k], stream_len, setup[k]);
+			if (cmp_is_error(stream_len))
+				return stream_len;
+		}
+
+		if (up_model_p) {
+			uint8_t *up = up_model_p + i * sample_size;
+
+			if (short_cadence)
+				up[0] = cmp_up_model(d[0], model_exp_flags, cfg->model_value,
+						     setup_exp_flags.lossy_par);
+			for (k = 0; k < n; k++) {
+				uint32_t const v = get_unaligned((const uint32_t *)(d + base) + k);
+
+				put_unaligned(cmp_up_model(v, model[k], cfg->model_value,
+							   setup[k]->lossy_par),
+					      (uint32_t *)(up + base) + k);
+			}
+		}
+
+		if (i >= cfg->samples-1)
+			break;
+
+		model_p = next_model_p + i * sample_size;
+	}
+	return stream_len;
+}
+
+
+/**
+ * @brief compress L_FX data
  *
  * @param cfg		pointer to the compression configuration structure
  * @param stream_len	already used length of the bitstream in bits
@@ -558,16 +941,16 @@ static uint32_t compress_imagette(const struct cmp_cfg *cfg, uint32_t stream_len
  *	fails (which can be tested with cmp_is_error())
  */
 
-static uint32_t compress_s_fx(const struct cmp_cfg *cfg, uint32_t stream_len)
+static uint32_t compress_l_fx(const struct cmp_cfg *cfg, uint32_t stream_len)
 {
 	size_t i;
 
-	const struct s_fx *data_buf = cfg->src;
-	const struct s_fx *model_buf = cfg->model_buf;
-	struct s_fx *up_model_buf = NULL;
-	const struct s_fx *next_model_p;
-	struct s_fx model;
-	struct encoder_setup setup_exp_flag, setup_fx;
+	const struct l_fx *data_buf = cfg->src;
+	const struct l_fx *model_buf = cfg->model_buf;
+	struct l_fx *up_model_buf = NULL;
+	const struct l_fx *next_model_p;
+	struct l_fx model;
+	struct encoder_setup setup_exp_flag, setup_fx, setup_fx_var;
 
 	if (model_mode_is_used(cfg->cmp_mode)) {
 		model = model_buf[0];
@@ -579,9 +962,11 @@ static uint32_t compress_s_fx(const struct cmp_cfg *cfg, uint32_t stream_len)
 	}
 
 	configure_encoder_setup(&setup_exp_flag, cfg->cmp_par_exp_flags, cfg->spill_exp_flags,
-				cfg->round, MAX_USED_BITS.s_exp_flags, cfg);
+				cfg->round, MAX_USED_BITS.l_exp_flags, cfg);
 	configure_encoder_setup(&setup_fx, cfg->cmp_par_fx, cfg->spill_fx,
-				cfg->round, MAX_USED_BITS.s_fx, cfg);
+				cfg->round, MAX_USED_BITS.l_fx, cfg);
+	configure_encoder_setup(&setup_fx_var, cfg->cmp_par_fx_cob_variance, cfg->spill_fx_cob_variance,
+				cfg->round, MAX_USED_BITS.l_fx_cob_variance, cfg);
 
 	for (i = 0;; i++) {
 		stream_len = encode_value(data_buf[i].exp_flags, model.exp_flags,
@@ -592,12 +977,18 @@ static uint32_t compress_s_fx(const struct cmp_cfg *cfg, uint32_t stream_len)
 					  &setup_fx);
 		if (cmp_is_error(stream_len))
 			break;
+		stream_len = encode_value(data_buf[i].fx_variance, model.fx_variance,
+					  stream_len, &setup_fx_var);
+		if (cmp_is_error(stream_len))
+			break;
 
 		if (up_model_buf) {
-			up_model_buf[i].exp_flags = cmp_up_model(data_buf[i].exp_flags, model.exp_flags,
-								 cfg->model_value, setup_exp_flag.lossy_par);
+			up_model_buf[i].exp_flags = cmp_up_model32(data_buf[i].exp_flags, model.exp_flags,
+				cfg->model_value, setup_exp_flag.lossy_par);
 			up_model_buf[i].fx = cmp_up_model(data_buf[i].fx, model.fx,
-							  cfg->model_value, setup_fx.lossy_par);
+				cfg->model_value, setup_fx.lossy_par);
+			up_model_buf[i].fx_variance = cmp_up_model(data_buf[i].fx_variance, model.fx_variance,
+				cfg->model_value, setup_fx_var.lossy_par);
 		}
 
 		if (i >= cfg->samples-1)
@@ -610,7 +1001,7 @@ static uint32_t compress_s_fx(const struct cmp_cfg *cfg, uint32_t stream_len)
 
 
 /**
- * @brief compress S_FX_EFX data
+ * @brief compress L_FX_EFX data
  *
  * @param cfg		pointer to the compression configuration structure
  * @param stream_len	already used length of the bitstream in bits
@@ -619,16 +1010,16 @@ static uint32_t compress_s_fx(const struct cmp_cfg *cfg, uint32_t stream_len)
  *	fails (which can be tested with cmp_is_error())
  */
 
-static uint32_t compress_s_fx_efx(const struct cmp_cfg *cfg, uint32_t stream_len)
+static uint32_t compress_l_fx_efx(const struct cmp_cfg *cfg, uint32_t stream_len)
 {
 	size_t i;
 
-	const struct s_fx_efx *data_buf = cfg->src;
-	const struct s_fx_efx *model_buf = cfg->model_buf;
-	struct s_fx_efx *up_model_buf = NULL;
-	const struct s_fx_efx *next_model_p;
-	struct s_fx_efx model;
-	struct encoder_setup setup_exp_flag, setup_fx, setup_efx;
+	const struct l_fx_efx *data_buf = cfg->src;
+	const struct l_fx_efx *model_buf = cfg->model_buf;
+	struct l_fx_efx *up_model_buf = NULL;
+	const struct l_fx_efx *next_model_p;
+	struct l_fx_efx model;
+	struct encoder_setup setup_exp_flag, setup_fx, setup_efx, setup_fx_var;
 
 	if (model_mode_is_used(cfg->cmp_mode)) {
 		model = model_buf[0];
@@ -640,11 +1031,13 @@ static uint32_t compress_s_fx_efx(const struct cmp_cfg *cfg, uint32_t stream_len
 	}
 
 	configure_encoder_setup(&setup_exp_flag, cfg->cmp_par_exp_flags, cfg->spill_exp_flags,
-				cfg->round, MAX_USED_BITS.s_exp_flags, cfg);
+				cfg->round, MAX_USED_BITS.l_exp_flags, cfg);
 	configure_encoder_setup(&setup_fx, cfg->cmp_par_fx, cfg->spill_fx,
-				cfg->round, MAX_USED_BITS.s_fx, cfg);
+				cfg->round, MAX_USED_BITS.l_fx, cfg);
 	configure_encoder_setup(&setup_efx, cfg->cmp_par_efx, cfg->spill_efx,
-				cfg->round, MAX_USED_BITS.s_efx, cfg);
+				cfg->round, MAX_USED_BITS.l_efx, cfg);
+	configure_encoder_setup(&setup_fx_var, cfg->cmp_par_fx_cob_variance, cfg->spill_fx_cob_variance,
+				cfg->round, MAX_USED_BITS.l_fx_cob_variance, cfg);
 
 	for (i = 0;; i++) {
 		stream_len = encode_value(data_buf[i].exp_flags, model.exp_flags,
@@ -658,15 +1051,21 @@ static uint32_t compress_s_fx_efx(const struct cmp_cfg *cfg, uint32_t stream_len
 		stream_len = encode_value(data_buf[i].efx, model.efx,
 					  stream_len, &setup_efx);
 		if (cmp_is_error(stream_len))
-			return stream_len;
+			break;
+		stream_len = encode_value(data_buf[i].fx_variance, model.fx_variance,
+					  stream_len, &setup_fx_var);
+		if (cmp_is_error(stream_len))
+			break;
 
 		if (up_model_buf) {
-			up_model_buf[i].exp_flags = cmp_up_model(data_buf[i].exp_flags, model.exp_flags,
+			up_model_buf[i].exp_flags = cmp_up_model32(data_buf[i].exp_flags, model.exp_flags,
 				cfg->model_value, setup_exp_flag.lossy_par);
 			up_model_buf[i].fx = cmp_up_model(data_buf[i].fx, model.fx,
 				cfg->model_value, setup_fx.lossy_par);
 			up_model_buf[i].efx = cmp_up_model(data_buf[i].efx, model.efx,
 				cfg->model_value, setup_efx.lossy_par);
+			up_model_buf[i].fx_variance = cmp_up_model(data_buf[i].fx_variance, model.fx_variance,
+				cfg->model_value, setup_fx_var.lossy_par);
 		}
 
 		if (i >= cfg->samples-1)
@@ -679,7 +1078,7 @@ static uint32_t compress_s_fx_efx(const struct cmp_cfg *cfg, uint32_t stream_len
 
 
 /**
- * @brief compress S_FX_NCOB data
+ * @brief compress L_FX_NCOB data
  *
  * @param cfg		pointer to the compression configuration structure
  * @param stream_len	already used length of the bitstream in bits
@@ -688,16 +1087,17 @@ static uint32_t compress_s_fx_efx(const struct cmp_cfg *cfg, uint32_t stream_len
  *	fails (which can be tested with cmp_is_error())
  */
 
-static uint32_t compress_s_fx_ncob(const struct cmp_cfg *cfg, uint32_t stream_len)
+static uint32_t compress_l_fx_ncob(const struct cmp_cfg *cfg, uint32_t stream_len)
 {
 	size_t i;
 
-	const struct s_fx_ncob *data_buf = cfg->src;
-	const struct s_fx_ncob *model_buf = cfg->model_buf;
-	struct s_fx_ncob *up_model_buf = NULL;
-	const struct s_fx_ncob *next_model_p;
-	struct s_fx_ncob model;
-	struct encoder_setup setup_exp_flag, setup_fx, setup_ncob;
+	const struct l_fx_ncob *data_buf = cfg->src;
+	const struct l_fx_ncob *model_buf = cfg->model_buf;
+	struct l_fx_ncob *up_model_buf = NULL;
+	const struct l_fx_ncob *next_model_p;
+	struct l_fx_ncob model;
+	struct encoder_setup setup_exp_flag, setup_fx, setup_ncob,
+			      setup_fx_var, setup_cob_var;
 
 	if (model_mode_is_used(cfg->cmp_mode)) {
 		model = model_buf[0];
@@ -709,11 +1109,16 @@ static uint32_t compress_s_fx_ncob(const struct cmp_cfg *cfg, uint32_t stream_le
 	}
 
 	configure_encoder_setup(&setup_exp_flag, cfg->cmp_par_exp_flags, cfg->spill_exp_flags,
-				cfg->round, MAX_USED_BITS.s_exp_flags, cfg);
+				cfg->round, MAX_USED_BITS.l_exp_flags, cfg);
 	configure_encoder_setup(&setup_fx, cfg->cmp_par_fx, cfg->spill_fx,
-				cfg->round, MAX_USED_BITS.s_fx, cfg);
+				cfg->round, MAX_USED_BITS.l_fx, cfg);
 	configure_encoder_setup(&setup_ncob, cfg->cmp_par_ncob, cfg->spill_ncob,
-				cfg->round, MAX_USED_BITS.s_ncob, cfg);
+				cfg->round, MAX_USED_BITS.l_ncob, cfg);
+	/* we use the cmp_par_fx_cob_variance parameter for fx and cob variance data */
+	configure_encoder_setup(&setup_fx_var, cfg->cmp_par_fx_cob_variance, cfg->spill_fx_cob_variance,
+				cfg->round, MAX_USED_BITS.l_fx_cob_variance, cfg);
+	configure_encoder_setup(&setup_cob_var, cfg->cmp_par_fx_cob_variance, cfg->spill_fx_cob_variance,
+				cfg->round, MAX_USED_BITS.l_fx_cob_variance, cfg);
 
 	for (i = 0;; i++) {
 		stream_len = encode_value(data_buf[i].exp_flags, model.exp_flags,
@@ -732,9 +1137,21 @@ static uint32_t compress_s_fx_ncob(const struct cmp_cfg *cfg, uint32_t stream_le
 					  stream_len, &setup_ncob);
 		if (cmp_is_error(stream_len))
 			break;
+		stream_len = encode_value(data_buf[i].fx_variance, model.fx_variance,
+					  stream_len, &setup_fx_var);
+		if (cmp_is_error(stream_len))
+			break;
+		stream_len = encode_value(data_buf[i].cob_x_variance, model.cob_x_variance,
+					  stream_len, &setup_cob_var);
+		if (cmp_is_error(stream_len))
+			break;
+		stream_len = encode_value(data_buf[i].cob_y_variance, model.cob_y_variance,
+					  stream_len, &setup_cob_var);
+		if (cmp_is_error(stream_len))
+			break;
 
 		if (up_model_buf) {
-			up_model_buf[i].exp_flags = cmp_up_model(data_buf[i].exp_flags, model.exp_flags,
+			up_model_buf[i].exp_flags = cmp_up_model32(data_buf[i].exp_flags, model.exp_flags,
 				cfg->model_value, setup_exp_flag.lossy_par);
 			up_model_buf[i].fx = cmp_up_model(data_buf[i].fx, model.fx,
 				cfg->model_value, setup_fx.lossy_par);
@@ -742,6 +1159,12 @@ static uint32_t compress_s_fx_ncob(const struct cmp_cfg *cfg, uint32_t stream_le
 				cfg->model_value, setup_ncob.lossy_par);
 			up_model_buf[i].ncob_y = cmp_up_model(data_buf[i].ncob_y, model.ncob_y,
 				cfg->model_value, setup_ncob.lossy_par);
+			up_model_buf[i].fx_variance = cmp_up_model(data_buf[i].fx_variance, model.fx_variance,
+				cfg->model_value, setup_fx_var.lossy_par);
+			up_model_buf[i].cob_x_variance = cmp_up_model(data_buf[i].cob_x_variance, model.cob_x_variance,
+				cfg->model_value, setup_cob_var.lossy_par);
+			up_model_buf[i].cob_y_variance = cmp_up_model(data_buf[i].cob_y_variance, model.cob_y_variance,
+				cfg->model_value, setup_cob_var.lossy_par);
 		}
 
 		if (i >= cfg->samples-1)
@@ -754,7 +1177,7 @@ static uint32_t compress_s_fx_ncob(const struct cmp_cfg *cfg, uint32_t stream_le
 
 
 /**
- * @brief compress S_FX_EFX_NCOB_ECOB data
+ * @brief compress L_FX_EFX_NCOB_ECOB data
  *
  * @param cfg		pointer to the compression configuration structure
  * @param stream_len	already used length of the bitstream in bits
@@ -763,17 +1186,17 @@ static uint32_t compress_s_fx_ncob(const struct cmp_cfg *cfg, uint32_t stream_le
  *	fails (which can be tested with cmp_is_error())
  */
 
-static uint32_t compress_s_fx_efx_ncob_ecob(const struct cmp_cfg *cfg, uint32_t stream_len)
+static uint32_t compress_l_fx_efx_ncob_ecob(const struct cmp_cfg *cfg, uint32_t stream_len)
 {
 	size_t i;
 
-	const struct s_fx_efx_ncob_ecob *data_buf = cfg->src;
-	const struct s_fx_efx_ncob_ecob *model_buf = cfg->model_buf;
-	struct s_fx_efx_ncob_ecob *up_model_buf = NULL;
-	const struct s_fx_efx_ncob_ecob *next_model_p;
-	struct s_fx_efx_ncob_ecob model;
+	const struct l_fx_efx_ncob_ecob *data_buf = cfg->src;
+	const struct l_fx_efx_ncob_ecob *model_buf = cfg->model_buf;
+	struct l_fx_efx_ncob_ecob *up_model_buf = NULL;
+	const struct l_fx_efx_ncob_ecob *next_model_p;
+	struct l_fx_efx_ncob_ecob model;
 	struct encoder_setup setup_exp_flag, setup_fx, setup_ncob, setup_efx,
-			      setup_ecob;
+			      setup_ecob, setup_fx_var, setup_cob_var;
 
 	if (model_mode_is_used(cfg->cmp_mode)) {
 		model = model_buf[0];
@@ -785,15 +1208,20 @@ static uint32_t compress_s_fx_efx_ncob_ecob(const struct cmp_cfg *cfg, uint32_t
 	}
 
 	configure_encoder_setup(&setup_exp_flag, cfg->cmp_par_exp_flags, cfg->spill_exp_flags,
-				cfg->round, MAX_USED_BITS.s_exp_flags, cfg);
+				cfg->round, MAX_USED_BITS.l_exp_flags, cfg);
 	configure_encoder_setup(&setup_fx, cfg->cmp_par_fx, cfg->spill_fx,
-				cfg->round, MAX_USED_BITS.s_fx, cfg);
+				cfg->round, MAX_USED_BITS.l_fx, cfg);
 	configure_encoder_setup(&setup_ncob, cfg->cmp_par_ncob, cfg->spill_ncob,
-				cfg->round, MAX_USED_BITS.s_ncob, cfg);
+				cfg->round, MAX_USED_BITS.l_ncob, cfg);
 	configure_encoder_setup(&setup_efx, cfg->cmp_par_efx, cfg->spill_efx,
-				cfg->round, MAX_USED_BITS.s_efx, cfg);
+				cfg->round, MAX_USED_BITS.l_efx, cfg);
 	configure_encoder_setup(&setup_ecob, cfg->cmp_par_ecob, cfg->spill_ecob,
-				cfg->round, MAX_USED_BITS.s_ecob, cfg);
+				cfg->round, MAX_USED_BITS.l_ecob, cfg);
+	/* we use compression parameters for both variance data fields */
+	configure_encoder_setup(&setup_fx_var, cfg->cmp_par_fx_cob_variance, cfg->spill_fx_cob_variance,
+				cfg->round, MAX_USED_BITS.l_fx_cob_variance, cfg);
+	configure_encoder_setup(&setup_cob_var, cfg->cmp_par_fx_cob_variance, cfg->spill_fx_cob_variance,
+				cfg->round, MAX_USED_BITS.l_fx_cob_variance, cfg);
 
 	for (i = 0;; i++) {
 		stream_len = encode_value(data_buf[i].exp_flags, model.exp_flags,
@@ -824,9 +1252,21 @@ static uint32_t compress_s_fx_efx_ncob_ecob(const struct cmp_cfg *cfg, uint32_t
 					  stream_len, &setup_ecob);
 		if (cmp_is_error(stream_len))
 			break;
+		stream_len = encode_value(data_buf[i].fx_variance, model.fx_variance,
+					  stream_len, &setup_fx_var);
+		if (cmp_is_error(stream_len))
+			break;
+		stream_len = encode_value(data_buf[i].cob_x_variance, model.cob_x_variance,
+					  stream_len, &setup_cob_var);
+		if (cmp_is_error(stream_len))
+			break;
+		stream_len = encode_value(data_buf[i].cob_y_variance, model.cob_y_variance,
+					  stream_len, &setup_cob_var);
+		if (cmp_is_error(stream_len))
+			break;
 
 		if (up_model_buf) {
-			up_model_buf[i].exp_flags = cmp_up_model(data_buf[i].exp_flags, model.exp_flags,
+			up_model_buf[i].exp_flags = cmp_up_model32(data_buf[i].exp_flags, model.exp_flags,
 				cfg->model_value, setup_exp_flag.lossy_par);
 			up_model_buf[i].fx = cmp_up_model(data_buf[i].fx, model.fx,
 				cfg->model_value, setup_fx.lossy_par);
@@ -840,6 +1280,12 @@ static uint32_t compress_s_fx_efx_ncob_ecob(const struct cmp_cfg *cfg, uint32_t
 				cfg->model_value, setup_ecob.lossy_par);
 			up_model_buf[i].ecob_y = cmp_up_model(data_buf[i].ecob_y, model.ecob_y,
 				cfg->model_value, setup_ecob.lossy_par);
+			up_model_buf[i].fx_variance = cmp_up_model(data_buf[i].fx_variance, model.fx_variance,
+				cfg->model_value, setup_fx_var.lossy_par);
+			up_model_buf[i].cob_x_variance = cmp_up_model(data_buf[i].cob_x_variance, model.cob_x_variance,
+				cfg->model_value, setup_cob_var.lossy_par);
+			up_model_buf[i].cob_y_variance = cmp_up_model(data_buf[i].cob_y_variance, model.cob_y_variance,
+				cfg->model_value, setup_cob_var.lossy_par);
 		}
 
 		if (i >= cfg->samples-1)
@@ -852,7 +1298,7 @@ static uint32_t compress_s_fx_efx_ncob_ecob(const struct cmp_cfg *cfg, uint32_t
 
 
 /**
- * @brief compress L_FX data
+ * @brief compress offset data from the normal and fast cameras
  *
  * @param cfg		pointer to the compression configuration structure
  * @param stream_len	already used length of the bitstream in bits
@@ -861,373 +1307,7 @@ static uint32_t compress_s_fx_efx_ncob_ecob(const struct cmp_cfg *cfg, uint32_t
  *	fails (which can be tested with cmp_is_error())
  */
 
-static uint32_t compress_l_fx(const struct cmp_cfg *cfg, uint32_t stream_len)
-{
-	size_t i;
-
-	const struct l_fx *data_buf = cfg->src;
-	const struct l_fx *model_buf = cfg->model_buf;
-	struct l_fx *up_model_buf = NULL;
-	const struct l_fx *next_model_p;
-	struct l_fx model;
-	struct encoder_setup setup_exp_flag, setup_fx, setup_fx_var;
-
-	if (model_mode_is_used(cfg->cmp_mode)) {
-		model = model_buf[0];
-		next_model_p = &model_buf[1];
-		up_model_buf = cfg->updated_model_buf;
-	} else {
-		memset(&model, 0, sizeof(model));
-		next_model_p = data_buf;
-	}
-
-	configure_encoder_setup(&setup_exp_flag, cfg->cmp_par_exp_flags, cfg->spill_exp_flags,
-				cfg->round, MAX_USED_BITS.l_exp_flags, cfg);
-	configure_encoder_setup(&setup_fx, cfg->cmp_par_fx, cfg->spill_fx,
-				cfg->round, MAX_USED_BITS.l_fx, cfg);
-	configure_encoder_setup(&setup_fx_var, cfg->cmp_par_fx_cob_variance, cfg->spill_fx_cob_variance,
-				cfg->round, MAX_USED_BITS.l_fx_cob_variance, cfg);
-
-	for (i = 0;; i++) {
-		stream_len = encode_value(data_buf[i].exp_flags, model.exp_flags,
-					  stream_len, &setup_exp_flag);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].fx, model.fx, stream_len,
-					  &setup_fx);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].fx_variance, model.fx_variance,
-					  stream_len, &setup_fx_var);
-		if (cmp_is_error(stream_len))
-			break;
-
-		if (up_model_buf) {
-			up_model_buf[i].exp_flags = cmp_up_model32(data_buf[i].exp_flags, model.exp_flags,
-				cfg->model_value, setup_exp_flag.lossy_par);
-			up_model_buf[i].fx = cmp_up_model(data_buf[i].fx, model.fx,
-				cfg->model_value, setup_fx.lossy_par);
-			up_model_buf[i].fx_variance = cmp_up_model(data_buf[i].fx_variance, model.fx_variance,
-				cfg->model_value, setup_fx_var.lossy_par);
-		}
-
-		if (i >= cfg->samples-1)
-			break;
-
-		model = next_model_p[i];
-	}
-	return stream_len;
-}
-
-
-/**
- * @brief compress L_FX_EFX data
- *
- * @param cfg		pointer to the compression configuration structure
- * @param stream_len	already used length of the bitstream in bits
- *
- * @returns the bit length of the bitstream on success or an error code if it
- *	fails (which can be tested with cmp_is_error())
- */
-
-static uint32_t compress_l_fx_efx(const struct cmp_cfg *cfg, uint32_t stream_len)
-{
-	size_t i;
-
-	const struct l_fx_efx *data_buf = cfg->src;
-	const struct l_fx_efx *model_buf = cfg->model_buf;
-	struct l_fx_efx *up_model_buf = NULL;
-	const struct l_fx_efx *next_model_p;
-	struct l_fx_efx model;
-	struct encoder_setup setup_exp_flag, setup_fx, setup_efx, setup_fx_var;
-
-	if (model_mode_is_used(cfg->cmp_mode)) {
-		model = model_buf[0];
-		next_model_p = &model_buf[1];
-		up_model_buf = cfg->updated_model_buf;
-	} else {
-		memset(&model, 0, sizeof(model));
-		next_model_p = data_buf;
-	}
-
-	configure_encoder_setup(&setup_exp_flag, cfg->cmp_par_exp_flags, cfg->spill_exp_flags,
-				cfg->round, MAX_USED_BITS.l_exp_flags, cfg);
-	configure_encoder_setup(&setup_fx, cfg->cmp_par_fx, cfg->spill_fx,
-				cfg->round, MAX_USED_BITS.l_fx, cfg);
-	configure_encoder_setup(&setup_efx, cfg->cmp_par_efx, cfg->spill_efx,
-				cfg->round, MAX_USED_BITS.l_efx, cfg);
-	configure_encoder_setup(&setup_fx_var, cfg->cmp_par_fx_cob_variance, cfg->spill_fx_cob_variance,
-				cfg->round, MAX_USED_BITS.l_fx_cob_variance, cfg);
-
-	for (i = 0;; i++) {
-		stream_len = encode_value(data_buf[i].exp_flags, model.exp_flags,
-					  stream_len, &setup_exp_flag);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].fx, model.fx, stream_len,
-					  &setup_fx);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].efx, model.efx,
-					  stream_len, &setup_efx);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].fx_variance, model.fx_variance,
-					  stream_len, &setup_fx_var);
-		if (cmp_is_error(stream_len))
-			break;
-
-		if (up_model_buf) {
-			up_model_buf[i].exp_flags = cmp_up_model32(data_buf[i].exp_flags, model.exp_flags,
-				cfg->model_value, setup_exp_flag.lossy_par);
-			up_model_buf[i].fx = cmp_up_model(data_buf[i].fx, model.fx,
-				cfg->model_value, setup_fx.lossy_par);
-			up_model_buf[i].efx = cmp_up_model(data_buf[i].efx, model.efx,
-				cfg->model_value, setup_efx.lossy_par);
-			up_model_buf[i].fx_variance = cmp_up_model(data_buf[i].fx_variance, model.fx_variance,
-				cfg->model_value, setup_fx_var.lossy_par);
-		}
-
-		if (i >= cfg->samples-1)
-			break;
-
-		model = next_model_p[i];
-	}
-	return stream_len;
-}
-
-
-/**
- * @brief compress L_FX_NCOB data
- *
- * @param cfg		pointer to the compression configuration structure
- * @param stream_len	already used length of the bitstream in bits
- *
- * @returns the bit length of the bitstream on success or an error code if it
- *	fails (which can be tested with cmp_is_error())
- */
-
-static uint32_t compress_l_fx_ncob(const struct cmp_cfg *cfg, uint32_t stream_len)
-{
-	size_t i;
-
-	const struct l_fx_ncob *data_buf = cfg->src;
-	const struct l_fx_ncob *model_buf = cfg->model_buf;
-	struct l_fx_ncob *up_model_buf = NULL;
-	const struct l_fx_ncob *next_model_p;
-	struct l_fx_ncob model;
-	struct encoder_setup setup_exp_flag, setup_fx, setup_ncob,
-			      setup_fx_var, setup_cob_var;
-
-	if (model_mode_is_used(cfg->cmp_mode)) {
-		model = model_buf[0];
-		next_model_p = &model_buf[1];
-		up_model_buf = cfg->updated_model_buf;
-	} else {
-		memset(&model, 0, sizeof(model));
-		next_model_p = data_buf;
-	}
-
-	configure_encoder_setup(&setup_exp_flag, cfg->cmp_par_exp_flags, cfg->spill_exp_flags,
-				cfg->round, MAX_USED_BITS.l_exp_flags, cfg);
-	configure_encoder_setup(&setup_fx, cfg->cmp_par_fx, cfg->spill_fx,
-				cfg->round, MAX_USED_BITS.l_fx, cfg);
-	configure_encoder_setup(&setup_ncob, cfg->cmp_par_ncob, cfg->spill_ncob,
-				cfg->round, MAX_USED_BITS.l_ncob, cfg);
-	/* we use the cmp_par_fx_cob_variance parameter for fx and cob variance data */
-	configure_encoder_setup(&setup_fx_var, cfg->cmp_par_fx_cob_variance, cfg->spill_fx_cob_variance,
-				cfg->round, MAX_USED_BITS.l_fx_cob_variance, cfg);
-	configure_encoder_setup(&setup_cob_var, cfg->cmp_par_fx_cob_variance, cfg->spill_fx_cob_variance,
-				cfg->round, MAX_USED_BITS.l_fx_cob_variance, cfg);
-
-	for (i = 0;; i++) {
-		stream_len = encode_value(data_buf[i].exp_flags, model.exp_flags,
-					  stream_len, &setup_exp_flag);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].fx, model.fx, stream_len,
-					  &setup_fx);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].ncob_x, model.ncob_x,
-					  stream_len, &setup_ncob);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].ncob_y, model.ncob_y,
-					  stream_len, &setup_ncob);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].fx_variance, model.fx_variance,
-					  stream_len, &setup_fx_var);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].cob_x_variance, model.cob_x_variance,
-					  stream_len, &setup_cob_var);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].cob_y_variance, model.cob_y_variance,
-					  stream_len, &setup_cob_var);
-		if (cmp_is_error(stream_len))
-			break;
-
-		if (up_model_buf) {
-			up_model_buf[i].exp_flags = cmp_up_model32(data_buf[i].exp_flags, model.exp_flags,
-				cfg->model_value, setup_exp_flag.lossy_par);
-			up_model_buf[i].fx = cmp_up_model(data_buf[i].fx, model.fx,
-				cfg->model_value, setup_fx.lossy_par);
-			up_model_buf[i].ncob_x = cmp_up_model(data_buf[i].ncob_x, model.ncob_x,
-				cfg->model_value, setup_ncob.lossy_par);
-			up_model_buf[i].ncob_y = cmp_up_model(data_buf[i].ncob_y, model.ncob_y,
-				cfg->model_value, setup_ncob.lossy_par);
-			up_model_buf[i].fx_variance = cmp_up_model(data_buf[i].fx_variance, model.fx_variance,
-				cfg->model_value, setup_fx_var.lossy_par);
-			up_model_buf[i].cob_x_variance = cmp_up_model(data_buf[i].cob_x_variance, model.cob_x_variance,
-				cfg->model_value, setup_cob_var.lossy_par);
-			up_model_buf[i].cob_y_variance = cmp_up_model(data_buf[i].cob_y_variance, model.cob_y_variance,
-				cfg->model_value, setup_cob_var.lossy_par);
-		}
-
-		if (i >= cfg->samples-1)
-			break;
-
-		model = next_model_p[i];
-	}
-	return stream_len;
-}
-
-
-/**
- * @brief compress L_FX_EFX_NCOB_ECOB data
- *
- * @param cfg		pointer to the compression configuration structure
- * @param stream_len	already used length of the bitstream in bits
- *
- * @returns the bit length of the bitstream on success or an error code if it
- *	fails (which can be tested with cmp_is_error())
- */
-
-static uint32_t compress_l_fx_efx_ncob_ecob(const struct cmp_cfg *cfg, uint32_t stream_len)
-{
-	size_t i;
-
-	const struct l_fx_efx_ncob_ecob *data_buf = cfg->src;
-	const struct l_fx_efx_ncob_ecob *model_buf = cfg->model_buf;
-	struct l_fx_efx_ncob_ecob *up_model_buf = NULL;
-	const struct l_fx_efx_ncob_ecob *next_model_p;
-	struct l_fx_efx_ncob_ecob model;
-	struct encoder_setup setup_exp_flag, setup_fx, setup_ncob, setup_efx,
-			      setup_ecob, setup_fx_var, setup_cob_var;
-
-	if (model_mode_is_used(cfg->cmp_mode)) {
-		model = model_buf[0];
-		next_model_p = &model_buf[1];
-		up_model_buf = cfg->updated_model_buf;
-	} else {
-		memset(&model, 0, sizeof(model));
-		next_model_p = data_buf;
-	}
-
-	configure_encoder_setup(&setup_exp_flag, cfg->cmp_par_exp_flags, cfg->spill_exp_flags,
-				cfg->round, MAX_USED_BITS.l_exp_flags, cfg);
-	configure_encoder_setup(&setup_fx, cfg->cmp_par_fx, cfg->spill_fx,
-				cfg->round, MAX_USED_BITS.l_fx, cfg);
-	configure_encoder_setup(&setup_ncob, cfg->cmp_par_ncob, cfg->spill_ncob,
-				cfg->round, MAX_USED_BITS.l_ncob, cfg);
-	configure_encoder_setup(&setup_efx, cfg->cmp_par_efx, cfg->spill_efx,
-				cfg->round, MAX_USED_BITS.l_efx, cfg);
-	configure_encoder_setup(&setup_ecob, cfg->cmp_par_ecob, cfg->spill_ecob,
-				cfg->round, MAX_USED_BITS.l_ecob, cfg);
-	/* we use compression parameters for both variance data fields */
-	configure_encoder_setup(&setup_fx_var, cfg->cmp_par_fx_cob_variance, cfg->spill_fx_cob_variance,
-				cfg->round, MAX_USED_BITS.l_fx_cob_variance, cfg);
-	configure_encoder_setup(&setup_cob_var, cfg->cmp_par_fx_cob_variance, cfg->spill_fx_cob_variance,
-				cfg->round, MAX_USED_BITS.l_fx_cob_variance, cfg);
-
-	for (i = 0;; i++) {
-		stream_len = encode_value(data_buf[i].exp_flags, model.exp_flags,
-					  stream_len, &setup_exp_flag);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].fx, model.fx, stream_len,
-					  &setup_fx);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].ncob_x, model.ncob_x,
-					  stream_len, &setup_ncob);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].ncob_y, model.ncob_y,
-					  stream_len, &setup_ncob);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].efx, model.efx,
-					  stream_len, &setup_efx);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].ecob_x, model.ecob_x,
-					  stream_len, &setup_ecob);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].ecob_y, model.ecob_y,
-					  stream_len, &setup_ecob);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].fx_variance, model.fx_variance,
-					  stream_len, &setup_fx_var);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].cob_x_variance, model.cob_x_variance,
-					  stream_len, &setup_cob_var);
-		if (cmp_is_error(stream_len))
-			break;
-		stream_len = encode_value(data_buf[i].cob_y_variance, model.cob_y_variance,
-					  stream_len, &setup_cob_var);
-		if (cmp_is_error(stream_len))
-			break;
-
-		if (up_model_buf) {
-			up_model_buf[i].exp_flags = cmp_up_model32(data_buf[i].exp_flags, model.exp_flags,
-				cfg->model_value, setup_exp_flag.lossy_par);
-			up_model_buf[i].fx = cmp_up_model(data_buf[i].fx, model.fx,
-				cfg->model_value, setup_fx.lossy_par);
-			up_model_buf[i].ncob_x = cmp_up_model(data_buf[i].ncob_x, model.ncob_x,
-				cfg->model_value, setup_ncob.lossy_par);
-			up_model_buf[i].ncob_y = cmp_up_model(data_buf[i].ncob_y, model.ncob_y,
-				cfg->model_value, setup_ncob.lossy_par);
-			up_model_buf[i].efx = cmp_up_model(data_buf[i].efx, model.efx,
-				cfg->model_value, setup_efx.lossy_par);
-			up_model_buf[i].ecob_x = cmp_up_model(data_buf[i].ecob_x, model.ecob_x,
-				cfg->model_value, setup_ecob.lossy_par);
-			up_model_buf[i].ecob_y = cmp_up_model(data_buf[i].ecob_y, model.ecob_y,
-				cfg->model_value, setup_ecob.lossy_par);
-			up_model_buf[i].fx_variance = cmp_up_model(data_buf[i].fx_variance, model.fx_variance,
-				cfg->model_value, setup_fx_var.lossy_par);
-			up_model_buf[i].cob_x_variance = cmp_up_model(data_buf[i].cob_x_variance, model.cob_x_variance,
-				cfg->model_value, setup_cob_var.lossy_par);
-			up_model_buf[i].cob_y_variance = cmp_up_model(data_buf[i].cob_y_variance, model.cob_y_variance,
-				cfg->model_value, setup_cob_var.lossy_par);
-		}
-
-		if (i >= cfg->samples-1)
-			break;
-
-		model = next_model_p[i];
-	}
-	return stream_len;
-}
-
-
-/**
- * @brief compress offset data from the normal and fast cameras
- *
- * @param cfg		pointer to the compression configuration structure
- * @param stream_len	already used length of the bitstream in bits
- *
- * @returns the bit length of the bitstream on success or an error code if it
- *	fails (which can be tested with cmp_is_error())
- */
-
-static uint32_t compress_offset(const struct cmp_cfg *cfg, uint32_t stream_len)
+static uint32_t compress_offset(const struct cmp_cfg *cfg, uint32_t stream_len)
 {
 	size_t i;
 
@@ -1505,6 +1585,113 @@ static uint32_t pad_bitstream(const struct cmp_cfg *cfg, uint32_t cmp_size)
 }
 
 
+/**
+ * @brief encode the data of a collection with the kernel of its data type
+ *
+ * @param cfg		pointer to the compression configuration structure
+ * @param stream_len	already used length of the bitstream in bits
+ *
+ * @returns the bit length of the bitstream on success or an error code if it
+ *	fails (which can be tested with cmp_is_error())
+ */
+
+static uint32_t encode_data(const struct cmp_cfg *cfg, uint32_t stream_len)
+{
+	switch (cfg->data_type) {
+	case DATA_TYPE_IMAGETTE:
+	case DATA_TYPE_IMAGETTE_ADAPTIVE:
+	case DATA_TYPE_SAT_IMAGETTE:
+	case DATA_TYPE_SAT_IMAGETTE_ADAPTIVE:
+	case DATA_TYPE_F_CAM_IMAGETTE:
+	case DATA_TYPE_F_CAM_IMAGETTE_ADAPTIVE:
+		return compress_imagette(cfg, stream_len);
+
+	case DATA_TYPE_S_FX:
+		return compress_fx_cob(cfg, stream_len, FX_COB_EXP_FLAGS);
+	case DATA_TYPE_S_FX_EFX:
+		return compress_fx_cob(cfg, stream_len, FX_COB_EXP_FLAGS | FX_COB_EFX);
+	case DATA_TYPE_S_FX_NCOB:
+		return compress_fx_cob(cfg, stream_len, FX_COB_EXP_FLAGS | FX_COB_NCOB);
+	case DATA_TYPE_S_FX_EFX_NCOB_ECOB:
+		return compress_fx_cob(cfg, stream_len, FX_COB_EXP_FLAGS | FX_COB_NCOB |
+				       FX_COB_EFX | FX_COB_ECOB);
+
+
+	case DATA_TYPE_L_FX:
+		return compress_l_fx(cfg, stream_len);
+	case DATA_TYPE_L_FX_EFX:
+		return compress_l_fx_efx(cfg, stream_len);
+	case DATA_TYPE_L_FX_NCOB:
+		return compress_l_fx_ncob(cfg, stream_len);
+	case DATA_TYPE_L_FX_EFX_NCOB_ECOB:
+		return compress_l_fx_efx_ncob_ecob(cfg, stream_len);
+
+	case DATA_TYPE_OFFSET:
+	case DATA_TYPE_F_CAM_OFFSET:
+		return compress_offset(cfg, stream_len);
+	case DATA_TYPE_BACKGROUND:
+	case DATA_TYPE_F_CAM_BACKGROUND:
+		return compress_background(cfg, stream_len);
+	case DATA_TYPE_SMEARING:
+		return compress_smearing(cfg, stream_len);
+
+	case DATA_TYPE_F_FX:
+		return compress_fx_cob(cfg, stream_len, 0);
+	case DATA_TYPE_F_FX_EFX:
+		return compress_fx_cob(cfg, stream_len, FX_COB_EFX);
+	case DATA_TYPE_F_FX_NCOB:
+		return compress_fx_cob(cfg, stream_len, FX_COB_NCOB);
+	case DATA_TYPE_F_FX_EFX_NCOB_ECOB:
+		return compress_fx_cob(cfg, stream_len, FX_COB_NCOB | FX_COB_EFX | FX_COB_ECOB);
+
+	case DATA_TYPE_CHUNK:
+	case DATA_TYPE_UNKNOWN:
+	default:
+		RETURN_ERROR(INT_DATA_TYPE_UNSUPPORTED, "");
+	}
+}
+
+
+/**
+ * @brief encode the data of a collection in an adaptive compression mode
+ *
+ * The data are encoded twice: the analysis pass determines the exact bit
+ * costs of the candidate parameters of every block without writing anything;
+ * the encoding pass encodes every block with its cheapest candidate.
+ *
+ * @param cfg		pointer to the compression configuration structure
+ * @param stream_len	already used length of the bitstream in bits
+ *
+ * @returns the bit length of the bitstream on success or an error code if it
+ *	fails (which can be tested with cmp_is_error())
+ */
+
+static uint32_t encode_data_adaptive(const struct cmp_cfg *cfg, uint32_t stream_len)
+{
+	struct cmp_adaptive_state state;
+	struct cmp_cfg pass_cfg = *cfg;
+
+	state.analyse = 1;
+	state.num_fields = 0;
+	state.fields_missing = 0;
+
+	/* the analysis pass must not touch the output buffers */
+	pass_cfg.dst = NULL;
+	pass_cfg.updated_model_buf = NULL;
+	pass_cfg.col_stats = NULL;
+	pass_cfg.adaptive = &state;
+	FORWARD_IF_ERROR(encode_data(&pass_cfg, stream_len), "");
+	RETURN_ERROR_IF(state.fields_missing, GENERIC,
+			"Too many encoder setups for the adaptive compression mode.");
+
+	state.analyse = 0;
+	state.num_fields = 0;
+	pass_cfg = *cfg;
+	pass_cfg.adaptive = &state;
+	return encode_data(&pass_cfg, stream_len);
+}
+
+
 /**
  * @brief internal data compression function
  * This function can compress all types of collection data (one at a time).
@@ -1530,6 +1717,7 @@ static uint32_t compress_data_internal(const struct cmp_cfg *cfg, uint32_t strea
 	if (cfg->samples == 0) /* nothing to compress we are done */
 		return stream_len;
 
+	CMP_TRACE_BEGIN(CMP_TRACE_ENCODE);
 	if (raw_mode_is_used(cfg->cmp_mode)) {
 		uint32_t raw_size = cfg->samples * (uint32_t)size_of_a_sample(cfg->data_type);
 
@@ -1538,77 +1726,28 @@ static uint32_t compress_data_internal(const struct cmp_cfg *cfg, uint32_t strea
 			uint8_t *p = (uint8_t *)cfg->dst + offset_bytes;
 			uint32_t new_stream_size = offset_bytes + raw_size;
 
-			RETURN_ERROR_IF(new_stream_size > cfg->stream_size, SMALL_BUFFER, "");
-			memcpy(p, cfg->src, raw_size);
-			RETURN_ERROR_IF(cpu_to_be_data_type(p, raw_size, cfg->data_type),
-					INT_DATA_TYPE_UNSUPPORTED, "");
+			/* no early return, the trace span has to be ended */
+			if (new_stream_size > cfg->stream_size)
+				bitsize = CMP_ERROR(SMALL_BUFFER);
+			else if (cpu_to_be_data_type_copy(p, cfg->src, raw_size, cfg->data_type))
+				bitsize = CMP_ERROR(INT_DATA_TYPE_UNSUPPORTED);
 		}
-		bitsize += stream_len + raw_size * 8; /* convert to bits */
+		if (!cmp_is_error(bitsize))
+			bitsize = stream_len + raw_size * 8; /* convert to bits */
 	} else {
-		switch (cfg->data_type) {
-		case DATA_TYPE_IMAGETTE:
-		case DATA_TYPE_IMAGETTE_ADAPTIVE:
-		case DATA_TYPE_SAT_IMAGETTE:
-		case DATA_TYPE_SAT_IMAGETTE_ADAPTIVE:
-		case DATA_TYPE_F_CAM_IMAGETTE:
-		case DATA_TYPE_F_CAM_IMAGETTE_ADAPTIVE:
-			bitsize = compress_imagette(cfg, stream_len);
-			break;
-
-		case DATA_TYPE_S_FX:
-			bitsize = compress_s_fx(cfg, stream_len);
-			break;
-		case DATA_TYPE_S_FX_EFX:
-			bitsize = compress_s_fx_efx(cfg, stream_len);
-			break;
-		case DATA_TYPE_S_FX_NCOB:
-			bitsize = compress_s_fx_ncob(cfg, stream_len);
-			break;
-		case DATA_TYPE_S_FX_EFX_NCOB_ECOB:
-			bitsize = compress_s_fx_efx_ncob_ecob(cfg, stream_len);
-			break;
-
-
-		case DATA_TYPE_L_FX:
-			bitsize = compress_l_fx(cfg, stream_len);
-			break;
-		case DATA_TYPE_L_FX_EFX:
-			bitsize = compress_l_fx_efx(cfg, stream_len);
-			break;
-		case DATA_TYPE_L_FX_NCOB:
-			bitsize = compress_l_fx_ncob(cfg, stream_len);
-			break;
-		case DATA_TYPE_L_FX_EFX_NCOB_ECOB:
-			bitsize = compress_l_fx_efx_ncob_ecob(cfg, stream_len);
-			break;
-
-		case DATA_TYPE_OFFSET:
-		case DATA_TYPE_F_CAM_OFFSET:
-			bitsize = compress_offset(cfg, stream_len);
-			break;
-		case DATA_TYPE_BACKGROUND:
-		case DATA_TYPE_F_CAM_BACKGROUND:
-			bitsize = compress_background(cfg, stream_len);
-			break;
-		case DATA_TYPE_SMEARING:
-			bitsize = compress_smearing(cfg, stream_len);
-			break;
-
-		case DATA_TYPE_F_FX:
-		case DATA_TYPE_F_FX_EFX:
-		case DATA_TYPE_F_FX_NCOB:
-		case DATA_TYPE_F_FX_EFX_NCOB_ECOB:
-		case DATA_TYPE_CHUNK:
-		case DATA_TYPE_UNKNOWN:
-		default:
-			RETURN_ERROR(INT_DATA_TYPE_UNSUPPORTED, "");
-		}
+		if (adaptive_mode_is_used(cfg->cmp_mode))
+			bitsize = encode_data_adaptive(cfg, stream_len);
+		else
+			bitsize = encode_data(cfg, stream_len);
 	}
+	CMP_TRACE_END(CMP_TRACE_ENCODE);
 
 	if (cmp_is_error(bitsize))
 		return bitsize;
 
+	CMP_TRACE_BEGIN(CMP_TRACE_PAD);
 	bitsize = pad_bitstream(cfg, bitsize);
+	CMP_TRACE_END(CMP_TRACE_PAD);
 
 	return bitsize;
 }
@@ -1769,6 +1908,7 @@ static uint32_t set_cmp_col_size(uint8_t *cmp_col_size_field, uint32_t cmp_col_s
  * @brief compresses a collection (with a collection header followed by data)
  *
  * @param col		pointer to a collection header
+ * @param desc		pointer to the checked descriptor of the collection
  * @param model		pointer to the model to be used for compression, or NULL
  *			if not applicable
  * @param updated_model	pointer to the buffer where the updated model will be
@@ -1783,33 +1923,37 @@ static uint32_t set_cmp_col_size(uint8_t *cmp_col_size_field, uint32_t cmp_col_s
  *	success or an error code if it fails (which can be tested with
  *	cmp_is_error())
  */
-static uint32_t cmp_collection(const uint8_t *col,
+static uint32_t cmp_collection(const uint8_t *col, const struct cmp_col_desc *desc,
 			       const uint8_t *model, uint8_t *updated_model,
 			       uint32_t *dst, uint32_t dst_capacity,
 			       struct cmp_cfg *cfg, uint32_t dst_size)
 {
 	uint32_t const dst_size_begin = dst_size;
 	uint32_t dst_size_bits;
-	const struct collection_hdr *col_hdr = (const struct collection_hdr *)col;
-	uint16_t const col_data_length = cmp_col_get_data_length(col_hdr);
-	uint16_t sample_size;
-
-	/* sanity check of the collection header */
-	cfg->data_type = convert_subservice_to_cmp_data_type(cmp_col_get_subservice(col_hdr));
-	sample_size = (uint16_t)size_of_a_sample(cfg->data_type);
-	RETURN_ERROR_IF(col_data_length % sample_size, COL_SIZE_INCONSISTENT,
-			"col_data_length: %u %% sample_size: %u != 0", col_data_length, sample_size);
-	cfg->samples = col_data_length/sample_size;
+	uint32_t const col_data_length = desc->size - COLLECTION_HDR_SIZE;
+
+	/* the collection header was already checked by scan_collections() */
+	cfg->data_type = desc->data_type;
+	cfg->samples = desc->samples;
+
+	cfg->col_stats = NULL;
+	if (stats_sink && stats_sink->num_cols++ < stats_sink->max_cols && stats_sink->col) {
+		cfg->col_stats = &stats_sink->col[stats_sink->num_cols-1];
+		memset(cfg->col_stats, 0, sizeof(*cfg->col_stats));
+		cfg->col_stats->data_type = cfg->data_type;
+		cfg->col_stats->samples = cfg->samples;
+	}
 
 	/* prepare the different buffers */
 	cfg->src = col + COLLECTION_HDR_SIZE;
-	if (model)
-		cfg->model_buf = model + COLLECTION_HDR_SIZE;
-	if (updated_model)
-		cfg->updated_model_buf = updated_model + COLLECTION_HDR_SIZE;
+	cfg->model_buf = model ? model + COLLECTION_HDR_SIZE : NULL;
+	cfg->updated_model_buf = updated_model ? updated_model + COLLECTION_HDR_SIZE : NULL;
 	cfg->dst = dst;
 	cfg->stream_size = dst_capacity;
-	FORWARD_IF_ERROR(cmp_cfg_icu_is_invalid_error_code(cfg), "");
+	CMP_TRACE_BEGIN(CMP_TRACE_VALIDATION);
+	dst_size_bits = cmp_cfg_icu_is_invalid_error_code(cfg);
+	CMP_TRACE_END(CMP_TRACE_VALIDATION);
+	FORWARD_IF_ERROR(dst_size_bits, "");
 
 	if (cfg->cmp_mode != CMP_MODE_RAW) {
 		/* hear we reserve space for the compressed data size field */
@@ -1843,6 +1987,7 @@ static uint32_t cmp_collection(const uint8_t *col,
 			 * put them uncompressed (raw) into the dst buffer */
 			enum cmp_mode cmp_mode_cpy = cfg->cmp_mode;
 
+			CMP_TRACE_BEGIN(CMP_TRACE_RAW_FALLBACK);
 			cfg->stream_size = dst_size + col_data_length;
 			cfg->cmp_mode = CMP_MODE_RAW;
 			dst_size_bits = compress_data_internal(cfg, dst_size << 3);
@@ -1850,12 +1995,30 @@ static uint32_t cmp_collection(const uint8_t *col,
 			/* updated model is in this case a copy of the data to compress */
 			if (model_mode_is_used(cfg->cmp_mode) && cfg->updated_model_buf)
 				memcpy(cfg->updated_model_buf, cfg->src, col_data_length);
+			if (cfg->col_stats)
+				cfg->col_stats->raw_fallback = 1;
+			CMP_TRACE_END(CMP_TRACE_RAW_FALLBACK);
 		}
 	} else {
 		cfg->stream_size = dst_capacity;
 		dst_size_bits = compress_data_internal(cfg, dst_size << 3);
 	}
+	if (cfg->col_stats) {
+		uint32_t i;
+
+		/* a field without values (e.g. after an aborted compression) has
+		 * no residual range
+		 */
+		for (i = 0; i < cfg->col_stats->num_fields; i++) {
+			if (cfg->col_stats->field[i].values == 0) {
+				cfg->col_stats->field[i].residual_min = 0;
+				cfg->col_stats->field[i].residual_max = 0;
+			}
+		}
+	}
 	FORWARD_IF_ERROR(dst_size_bits, "compression failed");
+	if (cfg->col_stats)
+		cfg->col_stats->cmp_bits = dst_size_bits - (dst_size << 3);
 
 	dst_size = cmp_bit_to_byte(dst_size_bits);
 	if (cfg->cmp_mode != CMP_MODE_RAW && dst) {
@@ -1870,6 +2033,108 @@ static uint32_t cmp_collection(const uint8_t *col,
 }
 
 
+/**
+ * @brief decode and check the collection headers at the start of a chunk
+ *
+ * The headers are decoded until the chunk ends, the descriptor array is full
+ * or the remaining bytes are too few for a collection header.
+ *
+ * @param chunk		pointer to the (remaining) chunk
+ * @param chunk_size	byte size of the (remaining) chunk
+ * @param chunk_type	chunk type all collections have to belong to
+ * @param desc		pointer to a descriptor array; the offsets are relative
+ *			to chunk (can be NULL to only check the headers)
+ * @param max_desc	number of entries in the desc array
+ * @param scanned_size	pointer to store the byte size of the decoded
+ *			collections
+ *
+ * @returns the number of decoded collections or an error code if it fails
+ *	(which can be tested with cmp_is_error())
+ */
+
+static uint32_t scan_collections(const uint8_t *chunk, uint32_t chunk_size,
+				 enum chunk_type chunk_type, struct cmp_col_desc *desc,
+				 uint32_t max_desc, uint32_t *scanned_size)
+{
+	uint32_t pos = 0, num_col = 0;
+
+	while (chunk_size - pos >= COLLECTION_HDR_SIZE && (!desc || num_col < max_desc)) {
+		const struct collection_hdr *col = (const struct collection_hdr *)(chunk + pos);
+		uint32_t const col_data_length = cmp_col_get_data_length(col);
+		uint32_t const col_size = COLLECTION_HDR_SIZE + col_data_length;
+		enum cmp_data_type data_type;
+		uint32_t sample_size;
+
+		RETURN_ERROR_IF(cmp_col_get_chunk_type(col) != chunk_type,
+				CHUNK_SUBSERVICE_INCONSISTENT, "");
+		/* chunk size is inconsistent with the sum of sizes in the collection headers */
+		RETURN_ERROR_IF(col_size > chunk_size - pos, CHUNK_SIZE_INCONSISTENT, "");
+
+		data_type = convert_subservice_to_cmp_data_type(cmp_col_get_subservice(col));
+		sample_size = (uint32_t)size_of_a_sample(data_type);
+		RETURN_ERROR_IF(col_data_length % sample_size, COL_SIZE_INCONSISTENT,
+				"col_data_length: %"PRIu32" %% sample_size: %"PRIu32" != 0",
+				col_data_length, sample_size);
+
+		if (desc) {
+			desc[num_col].offset = pos;
+			desc[num_col].size = col_size;
+			desc[num_col].data_type = data_type;
+			desc[num_col].samples = col_data_length / sample_size;
+		}
+		pos += col_size;
+		num_col++;
+	}
+
+	*scanned_size = pos;
+	return num_col;
+}
+
+
+/**
+ * @brief check all collection headers of a chunk and build a descriptor array
+ *
+ * The collection headers are decoded once: the collection sizes have to add
+ * up to the chunk size, all collections have to belong to the same chunk type
+ * and every collection has to hold a whole number of samples.
+ *
+ * @note the returned number of collections can be used with the
+ *	COMPRESS_CHUNK_BOUND macro to get the compressed size bound without
+ *	walking the chunk again
+ *
+ * @param chunk		pointer to the chunk to check
+ * @param chunk_size	byte size of the chunk
+ * @param desc		pointer to an array to store a descriptor for every
+ *			collection (can be NULL to only check the chunk)
+ * @param max_desc	number of entries in the desc array
+ *
+ * @returns the number of collections in the chunk or an error code if it
+ *	fails (which can be tested with cmp_is_error())
+ */
+
+uint32_t compress_chunk_scan(const void *chunk, uint32_t chunk_size,
+			     struct cmp_col_desc *desc, uint32_t max_desc)
+{
+	enum chunk_type chunk_type;
+	uint32_t num_col, scanned_size;
+
+	RETURN_ERROR_IF(chunk == NULL, CHUNK_NULL, "");
+	RETURN_ERROR_IF(chunk_size < COLLECTION_HDR_SIZE, CHUNK_SIZE_INCONSISTENT, "");
+	chunk_type = cmp_col_get_chunk_type(chunk);
+	RETURN_ERROR_IF(chunk_type == CHUNK_TYPE_UNKNOWN, COL_SUBSERVICE_UNSUPPORTED,
+			"unsupported subservice: %u", cmp_col_get_subservice(chunk));
+
+	num_col = scan_collections(chunk, chunk_size, chunk_type, desc, max_desc,
+				   &scanned_size);
+	FORWARD_IF_ERROR(num_col, "");
+	RETURN_ERROR_IF(chunk_size - scanned_size >= COLLECTION_HDR_SIZE, SMALL_BUFFER,
+			"more than %"PRIu32" collections in the chunk", max_desc);
+	RETURN_ERROR_IF(scanned_size != chunk_size, CHUNK_SIZE_INCONSISTENT, "");
+
+	return num_col;
+}
+
+
 /**
  * @brief builds a compressed entity header for a compressed chunk
  *
@@ -1892,39 +2157,39 @@ static uint32_t cmp_ent_build_chunk_header(uint32_t *entity, uint32_t chunk_size
 					   uint32_t cmp_ent_size_byte)
 {
 	if (entity) { /* setup the compressed entity header */
-		struct cmp_entity *ent = (struct cmp_entity *)entity;
-		int err = 0;
-
-		err |= cmp_ent_set_version_id(ent, version_identifier); /* set by compress_chunk_init */
-		err |= cmp_ent_set_size(ent, cmp_ent_size_byte);
-		err |= cmp_ent_set_original_size(ent, chunk_size);
-		err |= cmp_ent_set_data_type(ent, DATA_TYPE_CHUNK, cfg->cmp_mode == CMP_MODE_RAW);
-		err |= cmp_ent_set_cmp_mode(ent, cfg->cmp_mode);
-		err |= cmp_ent_set_model_value(ent, cfg->model_value);
+		struct cmp_ent_hdr hdr;
+
+		memset(&hdr, 0, sizeof(hdr));
+		hdr.version_id = version_identifier; /* set by compress_chunk_init */
+		hdr.cmp_ent_size = cmp_ent_size_byte;
+		hdr.original_size = chunk_size;
+		hdr.start_timestamp = start_timestamp;
+		hdr.end_timestamp = get_timestamp();
+		hdr.data_type = DATA_TYPE_CHUNK;
+		hdr.raw_mode_flag = cfg->cmp_mode == CMP_MODE_RAW;
+		hdr.cmp_mode = cfg->cmp_mode;
+		hdr.model_value = cfg->model_value;
 		/* model id/counter are set by the user with the compress_chunk_set_model_id_and_counter() */
-		err |= cmp_ent_set_model_id(ent, 0);
-		err |= cmp_ent_set_model_counter(ent, 0);
-		err |= cmp_ent_set_reserved(ent, 0);
-		err |= cmp_ent_set_lossy_cmp_par(ent, cfg->round);
-		if (cfg->cmp_mode != CMP_MODE_RAW) {
-			err |= cmp_ent_set_non_ima_spill1(ent, cfg->spill_par_1);
-			err |= cmp_ent_set_non_ima_cmp_par1(ent, cfg->cmp_par_1);
-			err |= cmp_ent_set_non_ima_spill2(ent, cfg->spill_par_2);
-			err |= cmp_ent_set_non_ima_cmp_par2(ent, cfg->cmp_par_2);
-			err |= cmp_ent_set_non_ima_spill3(ent, cfg->spill_par_3);
-			err |= cmp_ent_set_non_ima_cmp_par3(ent, cfg->cmp_par_3);
-			err |= cmp_ent_set_non_ima_spill4(ent, cfg->spill_par_4);
-			err |= cmp_ent_set_non_ima_cmp_par4(ent, cfg->cmp_par_4);
-			err |= cmp_ent_set_non_ima_spill5(ent, cfg->spill_par_5);
-			err |= cmp_ent_set_non_ima_cmp_par5(ent, cfg->cmp_par_5);
-			err |= cmp_ent_set_non_ima_spill6(ent, cfg->spill_par_6);
-			err |= cmp_ent_set_non_ima_cmp_par6(ent, cfg->cmp_par_6);
+		hdr.lossy_cmp_par = cfg->round;
+		hdr.spill[0] = cfg->spill_par_1;
+		hdr.cmp_par[0] = cfg->cmp_par_1;
+		hdr.spill[1] = cfg->spill_par_2;
+		hdr.cmp_par[1] = cfg->cmp_par_2;
+		hdr.spill[2] = cfg->spill_par_3;
+		hdr.cmp_par[2] = cfg->cmp_par_3;
+		hdr.spill[3] = cfg->spill_par_4;
+		hdr.cmp_par[3] = cfg->cmp_par_4;
+		hdr.spill[4] = cfg->spill_par_5;
+		hdr.cmp_par[4] = cfg->cmp_par_5;
+		hdr.spill[5] = cfg->spill_par_6;
+		hdr.cmp_par[5] = cfg->cmp_par_6;
+
+		if (cmp_ent_hdr_encode((struct cmp_entity *)entity, &hdr)) {
+			RETURN_ERROR_IF(hdr.start_timestamp > 0xFFFFFFFFFFFFULL ||
+					hdr.end_timestamp > 0xFFFFFFFFFFFFULL,
+					ENTITY_TIMESTAMP, "");
+			RETURN_ERROR(ENTITY_HEADER, "");
 		}
-		RETURN_ERROR_IF(err, ENTITY_HEADER, "");
-		RETURN_ERROR_IF(cmp_ent_set_start_timestamp(ent, start_timestamp),
-				ENTITY_TIMESTAMP, "");
-		RETURN_ERROR_IF(cmp_ent_set_end_timestamp(ent, get_timestamp()),
-				ENTITY_TIMESTAMP, "");
 	}
 
 	if (cfg->cmp_mode == CMP_MODE_RAW)
@@ -1956,9 +2221,13 @@ static enum chunk_type init_cmp_cfg_from_cmp_par(const struct collection_hdr *co
 	/* the ranges of the parameters are checked in cmp_cfg_icu_is_invalid_error_code() */
 	cfg->cmp_mode = par->cmp_mode;
 	cfg->model_value = par->model_value;
-	if (par->lossy_par)
-		debug_print("Warning: lossy compression is not supported for chunk compression, lossy_par will be ignored.");
 	cfg->round = 0;
+	if (par->lossy_par) {
+		if (chunk_type_supports_lossy(chunk_type) && par->cmp_mode != CMP_MODE_RAW)
+			cfg->round = par->lossy_par;
+		else
+			debug_print("Warning: lossy compression is not supported for this chunk type or compression mode, lossy_par will be ignored.");
+	}
 
 	switch (chunk_type) {
 	case CHUNK_TYPE_NCAM_IMAGETTE:
@@ -2008,6 +2277,20 @@ static enum chunk_type init_cmp_cfg_from_cmp_par(const struct collection_hdr *co
 		cfg->spill_fx_cob_variance = cmp_get_spill(cfg->cmp_par_fx_cob_variance,
 							   cfg->cmp_mode, MAX_USED_BITS.l_fx_cob_variance);
 		break;
+	case CHUNK_TYPE_FAST_CADENCE:
+		cfg->cmp_par_fx = par->f_fx;
+		cfg->spill_fx = cmp_get_spill(cfg->cmp_par_fx, cfg->cmp_mode,
+					      MAX_USED_BITS.f_fx);
+		cfg->cmp_par_ncob = par->f_ncob;
+		cfg->spill_ncob = cmp_get_spill(cfg->cmp_par_ncob, cfg->cmp_mode,
+						MAX_USED_BITS.f_ncob);
+		cfg->cmp_par_efx = par->f_efx;
+		cfg->spill_efx = cmp_get_spill(cfg->cmp_par_efx, cfg->cmp_mode,
+					       MAX_USED_BITS.f_efx);
+		cfg->cmp_par_ecob = par->f_ecob;
+		cfg->spill_ecob = cmp_get_spill(cfg->cmp_par_ecob, cfg->cmp_mode,
+						MAX_USED_BITS.f_ecob);
+		break;
 	case CHUNK_TYPE_OFFSET_BACKGROUND:
 		cfg->cmp_par_offset_mean = par->nc_offset_mean;
 		cfg->spill_offset_mean = cmp_get_spill(cfg->cmp_par_offset_mean,
@@ -2026,75 +2309,650 @@ static enum chunk_type init_cmp_cfg_from_cmp_par(const struct collection_hdr *co
 						cfg->cmp_mode, MAX_USED_BITS.nc_background_outlier_pixels);
 		break;
 
-	case CHUNK_TYPE_SMEARING:
-		cfg->cmp_par_smearing_mean = par->smearing_mean;
-		cfg->spill_smearing_mean = cmp_get_spill(cfg->cmp_par_smearing_mean,
-						cfg->cmp_mode, MAX_USED_BITS.smearing_mean);
-		cfg->cmp_par_smearing_variance = par->smearing_variance_mean;
-		cfg->spill_smearing_variance = cmp_get_spill(cfg->cmp_par_smearing_variance,
-						cfg->cmp_mode, MAX_USED_BITS.smearing_variance_mean);
-		cfg->cmp_par_smearing_pixels_error = par->smearing_outlier_pixels;
-		cfg->spill_smearing_pixels_error = cmp_get_spill(cfg->cmp_par_smearing_pixels_error,
-						cfg->cmp_mode, MAX_USED_BITS.smearing_outlier_pixels);
-		break;
+	case CHUNK_TYPE_SMEARING:
+		cfg->cmp_par_smearing_mean = par->smearing_mean;
+		cfg->spill_smearing_mean = cmp_get_spill(cfg->cmp_par_smearing_mean,
+						cfg->cmp_mode, MAX_USED_BITS.smearing_mean);
+		cfg->cmp_par_smearing_variance = par->smearing_variance_mean;
+		cfg->spill_smearing_variance = cmp_get_spill(cfg->cmp_par_smearing_variance,
+						cfg->cmp_mode, MAX_USED_BITS.smearing_variance_mean);
+		cfg->cmp_par_smearing_pixels_error = par->smearing_outlier_pixels;
+		cfg->spill_smearing_pixels_error = cmp_get_spill(cfg->cmp_par_smearing_pixels_error,
+						cfg->cmp_mode, MAX_USED_BITS.smearing_outlier_pixels);
+		break;
+
+	case CHUNK_TYPE_F_CHAIN:
+		cfg->cmp_par_imagette = par->fc_imagette;
+		cfg->spill_imagette = cmp_get_spill(cfg->cmp_par_imagette,
+						cfg->cmp_mode, MAX_USED_BITS.fc_imagette);
+
+		cfg->cmp_par_offset_mean = par->fc_offset_mean;
+		cfg->spill_offset_mean = cmp_get_spill(cfg->cmp_par_offset_mean,
+						cfg->cmp_mode, MAX_USED_BITS.fc_offset_mean);
+		cfg->cmp_par_offset_variance = par->fc_offset_variance;
+		cfg->spill_offset_variance = cmp_get_spill(cfg->cmp_par_offset_variance,
+						cfg->cmp_mode, MAX_USED_BITS.fc_offset_variance);
+
+		cfg->cmp_par_background_mean = par->fc_background_mean;
+		cfg->spill_background_mean = cmp_get_spill(cfg->cmp_par_background_mean,
+						cfg->cmp_mode, MAX_USED_BITS.fc_background_mean);
+		cfg->cmp_par_background_variance = par->fc_background_variance;
+		cfg->spill_background_variance = cmp_get_spill(cfg->cmp_par_background_variance,
+						cfg->cmp_mode, MAX_USED_BITS.fc_background_variance);
+		cfg->cmp_par_background_pixels_error = par->fc_background_outlier_pixels;
+		cfg->spill_background_pixels_error = cmp_get_spill(cfg->cmp_par_background_pixels_error,
+						cfg->cmp_mode, MAX_USED_BITS.fc_background_outlier_pixels);
+		break;
+	case CHUNK_TYPE_UNKNOWN:
+	default: /*
+		  * default case never reached because cmp_col_get_chunk_type
+		  * returns CHUNK_TYPE_UNKNOWN if the type is unknown
+		  */
+		chunk_type = CHUNK_TYPE_UNKNOWN;
+		break;
+	}
+
+	return chunk_type;
+}
+
+
+/**
+ * @brief initialise the compress_chunk() function
+ *
+ * If not initialised the compress_chunk() function sets the timestamps and
+ * version_id in the compression entity header to zero
+ *
+ * @param return_timestamp	pointer to a function returning a current 48-bit
+ *				timestamp
+ * @param version_id		application software version identifier
+ */
+
+void compress_chunk_init(uint64_t (*return_timestamp)(void), uint32_t version_id)
+{
+	if (return_timestamp)
+		get_timestamp = return_timestamp;
+
+	version_identifier = version_id;
+}
+
+
+/**
+ * @brief set a statistics sink which is filled by the compress_chunk() function
+ *
+ * @param stats	pointer to a statistics sink; NULL disables the statistics
+ *		collection (default)
+ */
+
+void compress_chunk_set_stats(struct cmp_stats *stats)
+{
+	stats_sink = stats;
+}
+
+
+/**
+ * @brief compress a data chunk consisting of put together data collections
+ *
+ * @param chunk			pointer to the chunk to be compressed
+ * @param chunk_size		byte size of the chunk
+ * @param chunk_model		pointer to a model of a chunk; has the same size
+ *				as the chunk (can be NULL if no model compression
+ *				mode is used)
+ * @param updated_chunk_model	pointer to store the updated model for the next
+ *				model mode compression; has the same size as the
+ *				chunk (can be the same as the model_of_data
+ *				buffer for in-place update or NULL if updated
+ *				model is not needed)
+ * @param dst			destination pointer to the compressed data
+ *				buffer; has to be 4-byte aligned; can be NULL to
+ *				only get the compressed data size
+ * @param dst_capacity		capacity of the dst buffer; it's recommended to
+ *				provide a dst_capacity >=
+ *				compress_chunk_cmp_size_bound(chunk, chunk_size)
+ *				as it eliminates one potential failure scenario:
+ *				not enough space in the dst buffer to write the
+ *				compressed data; size is internally rounded down
+ *				to a multiple of 4
+ * @param cmp_par		pointer to a compression parameters struct
+ * @returns the byte size of the compressed data or an error code if it
+ *	fails (which can be tested with cmp_is_error())
+ */
+
+uint32_t compress_chunk(const void *chunk, uint32_t chunk_size,
+			const void *chunk_model, void *updated_chunk_model,
+			uint32_t *dst, uint32_t dst_capacity,
+			const struct cmp_par *cmp_par)
+{
+	struct cmp_chunk_iov iov;
+
+	iov.data = chunk;
+	iov.model = chunk_model;
+	iov.up_model = updated_chunk_model;
+	iov.size = chunk_size;
+
+	RETURN_ERROR_IF(chunk == NULL, CHUNK_NULL, "");
+
+	return compress_chunk_iov(&iov, 1, dst, dst_capacity, cmp_par);
+}
+
+
+/**
+ * @brief write data to a segmented output sink
+ *
+ * @param sink	pointer to the output sink
+ * @param pos	byte position in the concatenated segments
+ * @param src	pointer to the data to write
+ * @param n	number of bytes to write; the caller checks that they fit into
+ *		the sink
+ */
+
+static void seg_sink_write(const struct cmp_seg_sink *sink, uint32_t pos,
+			   const void *src, uint32_t n)
+{
+	const uint8_t *p = (const uint8_t *)src;
+
+	while (n) {
+		uint32_t const seg_pos = pos % sink->seg_size;
+		uint32_t const seg_free = sink->seg_size - seg_pos;
+		uint32_t const len = n < seg_free ? n : seg_free;
+
+		memcpy((uint8_t *)sink->seg[pos / sink->seg_size] + seg_pos, p, len);
+		p += len;
+		pos += len;
+		n -= len;
+	}
+}
+
+
+/**
+ * @brief get the capacity of a segmented output sink in bytes
+ */
+
+static uint32_t seg_sink_capacity(const struct cmp_seg_sink *sink)
+{
+	uint64_t const cap = (uint64_t)sink->num_seg * sink->seg_size;
+
+	return cap > CMP_ENTITY_MAX_SIZE ? CMP_ENTITY_MAX_SIZE : (uint32_t)cap;
+}
+
+
+/**
+ * @brief compresses a collection into a segmented output sink
+ *
+ * If the worst case size of the compressed collection fits into the rest of
+ * the current segment and the segment has the 4-byte alignment of the entity
+ * position, the collection is compressed directly into the segment. Otherwise
+ * it is compressed into the staging buffer of the sink and copied to the
+ * segments, because the bit writer needs a contiguous output buffer. The
+ * staging buffer capacity is limited to the free sink capacity, so the result
+ * is the same as with a contiguous dst buffer.
+ *
+ * @param col		pointer to a collection header
+ * @param model		pointer to the model of the collection (or NULL)
+ * @param updated_model	pointer to the updated model buffer (or NULL)
+ * @param sink		pointer to the output sink
+ * @param cfg		pointer to the compression configuration
+ * @param dst_size	number of bytes already written to the sink
+ *
+ * @returns the number of bytes written to the sink after the collection was
+ *	added or an error code if it fails (which can be tested with cmp_is_error())
+ */
+
+static uint32_t cmp_collection_seg(const uint8_t *col, const struct cmp_col_desc *desc,
+				   const uint8_t *model, uint8_t *updated_model,
+				   const struct cmp_seg_sink *sink,
+				   struct cmp_cfg *cfg, uint32_t dst_size)
+{
+	uint32_t stage_cap = seg_sink_capacity(sink) - dst_size;
+	uint32_t const col_bound = CMP_COLLECTION_FILD_SIZE + desc->size;
+	uint32_t size;
+
+	if (stage_cap >= col_bound) {
+		uint32_t const seg_pos = dst_size % sink->seg_size;
+		uint32_t const seg_free = sink->seg_size - seg_pos;
+		uint32_t const misalign = dst_size & 0x3;
+		uint8_t *seg_p = (uint8_t *)sink->seg[dst_size / sink->seg_size] + seg_pos;
+
+		if (seg_free >= col_bound && seg_pos >= misalign &&
+		    !((uintptr_t)(seg_p - misalign) & 0x3)) {
+			size = cmp_collection(col, desc, model, updated_model,
+					      (uint32_t *)(void *)(seg_p - misalign),
+					      misalign + seg_free, cfg, misalign);
+			FORWARD_IF_ERROR(size, "");
+			return dst_size + size - misalign;
+		}
+	}
+
+	if (stage_cap > CMP_SEG_STAGE_SIZE)
+		stage_cap = CMP_SEG_STAGE_SIZE;
+	size = cmp_collection(col, desc, model, updated_model, sink->stage, stage_cap, cfg, 0);
+	FORWARD_IF_ERROR(size, "");
+	seg_sink_write(sink, dst_size, sink->stage, size);
+
+	return dst_size + size;
+}
+
+
+/**
+ * @brief compress a data chunk given as an array of chunk pieces into a
+ *	contiguous buffer or a segmented output sink
+ *
+ * @param iov		pointer to an array of chunk pieces
+ * @param iovcnt	number of pieces in the iov array
+ * @param dst		destination pointer to the compressed data buffer (can
+ *			be NULL); ignored if a sink is used
+ * @param dst_capacity	capacity of the dst buffer
+ * @param dst_offset	byte offset of the compression entity in the dst
+ *			buffer (0 to 3); the bytes before it are preserved
+ * @param sink		pointer to a segmented output sink; NULL to use dst
+ * @param cmp_par	pointer to a compression parameters struct
+ *
+ * @returns the byte size of the compressed data or an error code if it
+ *	fails (which can be tested with cmp_is_error())
+ */
+
+static uint32_t compress_chunk_pieces(const struct cmp_chunk_iov *iov, uint32_t iovcnt,
+				      uint32_t *dst, uint32_t dst_capacity,
+				      uint32_t dst_offset,
+				      const struct cmp_seg_sink *sink,
+				      const struct cmp_par *cmp_par)
+{
+	uint64_t const start_timestamp = get_timestamp();
+	const struct collection_hdr *col;
+	struct cmp_col_desc desc[CMP_COL_DESC_BATCH];
+	enum chunk_type chunk_type;
+	struct cmp_cfg cfg;
+	uint32_t cmp_size_byte; /* size of the compressed data in bytes */
+	uint32_t hdr_size;
+	uint32_t chunk_size = 0, i;
+
+	RETURN_ERROR_IF(iov == NULL || iovcnt == 0, CHUNK_NULL, "");
+	RETURN_ERROR_IF(cmp_par == NULL, PAR_NULL, "");
+	for (i = 0; i < iovcnt; i++) {
+		RETURN_ERROR_IF(iov[i].data == NULL, CHUNK_NULL, "piece %"PRIu32"", i);
+		RETURN_ERROR_IF(iov[i].size > CMP_ENTITY_MAX_ORIGINAL_SIZE - chunk_size,
+				CHUNK_TOO_LARGE, "piece %"PRIu32"", i);
+		chunk_size += iov[i].size;
+	}
+	RETURN_ERROR_IF(iov[0].size < COLLECTION_HDR_SIZE, CHUNK_SIZE_INCONSISTENT,
+			"chunk_size: %"PRIu32"", chunk_size);
+
+	if (stats_sink)
+		stats_sink->num_cols = 0;
+
+	CMP_TRACE_BEGIN(CMP_TRACE_HDR_SETUP);
+	col = (const struct collection_hdr *)iov[0].data;
+	chunk_type = init_cmp_cfg_from_cmp_par(col, cmp_par, &cfg);
+
+	/* reserve space for the compression entity header, we will build the
+	 * header after the compression of the chunk
+	 */
+	cmp_size_byte = cmp_ent_build_chunk_header(NULL, chunk_size, &cfg, start_timestamp, 0);
+	CMP_TRACE_END(CMP_TRACE_HDR_SETUP);
+	RETURN_ERROR_IF(chunk_type == CHUNK_TYPE_UNKNOWN, COL_SUBSERVICE_UNSUPPORTED,
+			"unsupported subservice: %u", cmp_col_get_subservice(col));
+	if (sink) {
+		dst = sink->stage;
+		dst_capacity = seg_sink_capacity(sink);
+		dst_offset = 0;
+	}
+	if (!dst)
+		dst_offset = 0;
+	/* the collections are compressed behind the entity position */
+	cmp_size_byte += dst_offset;
+	RETURN_ERROR_IF(dst && dst_capacity < cmp_size_byte, SMALL_BUFFER,
+			"dst_capacity must be at least as large as the minimum size of the compression unit.");
+
+
+	for (i = 0; i < iovcnt; i++) {
+		const uint8_t *piece = (const uint8_t *)iov[i].data;
+		uint32_t const piece_size = iov[i].size;
+		uint32_t read_bytes = 0;
+
+		/* decode a batch of collection headers, then compress one
+		 * collection of the batch after another
+		 */
+		while (read_bytes < piece_size) {
+			uint32_t num_col, scanned_size, k;
+
+			num_col = scan_collections(piece + read_bytes, piece_size - read_bytes,
+						   chunk_type, desc, ARRAY_SIZE(desc), &scanned_size);
+			FORWARD_IF_ERROR(num_col, "");
+			/* piece size is inconsistent with the sum of sizes in the collection headers */
+			RETURN_ERROR_IF(num_col == 0, CHUNK_SIZE_INCONSISTENT, "");
+
+			for (k = 0; k < num_col; k++) {
+				uint32_t const offset = read_bytes + desc[k].offset;
+				const uint8_t *col_model = NULL;
+				uint8_t *col_up_model = NULL;
+
+				/* setup pointers for the next collection we want to compress */
+				if (iov[i].model)
+					col_model = (const uint8_t *)iov[i].model + offset;
+				if (iov[i].up_model)
+					col_up_model = (uint8_t *)iov[i].up_model + offset;
+
+				if (sink)
+					cmp_size_byte = cmp_collection_seg(piece + offset, &desc[k],
+									   col_model, col_up_model,
+									   sink, &cfg, cmp_size_byte);
+				else
+					cmp_size_byte = cmp_collection(piece + offset, &desc[k],
+								       col_model, col_up_model,
+								       dst, dst_capacity, &cfg,
+								       cmp_size_byte);
+				FORWARD_IF_ERROR(cmp_size_byte, "error occurred when compressing the collection with offset %u of piece %u",
+						 offset, i);
+			}
+			read_bytes += scanned_size;
+		}
+	}
+
+	CMP_TRACE_BEGIN(CMP_TRACE_HDR_SETUP);
+	if (sink) {
+		/* the staging buffer is free again, so the entity header is built
+		 * there and patched into the first segments
+		 */
+		hdr_size = cmp_ent_build_chunk_header(sink->stage, chunk_size, &cfg,
+						      start_timestamp, cmp_size_byte);
+		if (!cmp_is_error(hdr_size))
+			seg_sink_write(sink, 0, sink->stage, hdr_size);
+	} else {
+		cmp_size_byte -= dst_offset;
+		hdr_size = cmp_ent_build_chunk_header(dst ? (uint32_t *)(void *)((uint8_t *)dst + dst_offset) : NULL,
+						      chunk_size, &cfg, start_timestamp,
+						      cmp_size_byte);
+	}
+	CMP_TRACE_END(CMP_TRACE_HDR_SETUP);
+	FORWARD_IF_ERROR(hdr_size, "");
+
+	return cmp_size_byte;
+}
+
+
+/**
+ * @brief compress a data chunk given as an array of chunk pieces
+ *
+ * The chunk is the concatenation of the pieces; every piece contains one or
+ * more complete collections. The compressed data are identical to a
+ * compress_chunk() call with the concatenated chunk, but the collections do
+ * not have to be copied into a contiguous buffer first.
+ *
+ * @param iov		pointer to an array of chunk pieces; the model and the
+ *			updated model pointers of a piece follow the rules of
+ *			the chunk_model and updated_chunk_model parameters of
+ *			compress_chunk(); if a model mode is used every piece
+ *			needs a model
+ * @param iovcnt	number of pieces in the iov array
+ * @param dst		destination pointer to the compressed data buffer;
+ *			has to be 4-byte aligned; can be NULL to only get the
+ *			compressed data size
+ * @param dst_capacity	capacity of the dst buffer (see compress_chunk())
+ * @param cmp_par	pointer to a compression parameters struct
+ *
+ * @returns the byte size of the compressed data or an error code if it
+ *	fails (which can be tested with cmp_is_error())
+ */
+
+uint32_t compress_chunk_iov(const struct cmp_chunk_iov *iov, uint32_t iovcnt,
+			    uint32_t *dst, uint32_t dst_capacity,
+			    const struct cmp_par *cmp_par)
+{
+	return compress_chunk_pieces(iov, iovcnt, dst, dst_capacity, 0, NULL, cmp_par);
+}
+
+
+/**
+ * @brief compress a data chunk into a chain of fixed-size segments
+ *
+ * The compression entity is written one segment after another into the
+ * segments of the sink (e.g. the payloads of telemetry packets), so no
+ * contiguous buffer of compress_chunk_cmp_size_bound() bytes is needed. A
+ * collection which fits into the rest of the current segment is compressed
+ * directly into it if the segment is 4-byte aligned and the segment size is a
+ * multiple of 4. Every other collection is compressed into the staging
+ * buffer of the sink and then copied into the segments, so for collections
+ * larger than a segment the extra copy remains. The entity header is patched
+ * into the first segments at the end. The written data are identical to a
+ * compress_chunk() call with a dst buffer of the sink capacity.
+ *
+ * @param chunk			pointer to the chunk to be compressed
+ * @param chunk_size		byte size of the chunk
+ * @param chunk_model		pointer to a model of a chunk (see compress_chunk())
+ * @param updated_chunk_model	pointer to store the updated model (see
+ *				compress_chunk())
+ * @param sink			pointer to the segmented output sink
+ * @param cmp_par		pointer to a compression parameters struct
+ *
+ * @returns the byte size of the compressed data (the number of used segments
+ *	is the size divided by the segment size rounded up) or an error code
+ *	if it fails (which can be tested with cmp_is_error())
+ */
+
+uint32_t compress_chunk_seg(const void *chunk, uint32_t chunk_size,
+			    const void *chunk_model, void *updated_chunk_model,
+			    const struct cmp_seg_sink *sink,
+			    const struct cmp_par *cmp_par)
+{
+	struct cmp_chunk_iov iov;
+
+	RETURN_ERROR_IF(chunk == NULL, CHUNK_NULL, "");
+	RETURN_ERROR_IF(sink == NULL || sink->seg == NULL || sink->stage == NULL,
+			PAR_NULL, "");
+	RETURN_ERROR_IF(sink->seg_size == 0, PAR_BUFFERS, "");
 
-	case CHUNK_TYPE_F_CHAIN:
-		cfg->cmp_par_imagette = par->fc_imagette;
-		cfg->spill_imagette = cmp_get_spill(cfg->cmp_par_imagette,
-						cfg->cmp_mode, MAX_USED_BITS.fc_imagette);
+	iov.data = chunk;
+	iov.model = chunk_model;
+	iov.up_model = updated_chunk_model;
+	iov.size = chunk_size;
 
-		cfg->cmp_par_offset_mean = par->fc_offset_mean;
-		cfg->spill_offset_mean = cmp_get_spill(cfg->cmp_par_offset_mean,
-						cfg->cmp_mode, MAX_USED_BITS.fc_offset_mean);
-		cfg->cmp_par_offset_variance = par->fc_offset_variance;
-		cfg->spill_offset_variance = cmp_get_spill(cfg->cmp_par_offset_variance,
-						cfg->cmp_mode, MAX_USED_BITS.fc_offset_variance);
+	return compress_chunk_pieces(&iov, 1, NULL, 0, 0, sink, cmp_par);
+}
 
-		cfg->cmp_par_background_mean = par->fc_background_mean;
-		cfg->spill_background_mean = cmp_get_spill(cfg->cmp_par_background_mean,
-						cfg->cmp_mode, MAX_USED_BITS.fc_background_mean);
-		cfg->cmp_par_background_variance = par->fc_background_variance;
-		cfg->spill_background_variance = cmp_get_spill(cfg->cmp_par_background_variance,
-						cfg->cmp_mode, MAX_USED_BITS.fc_background_variance);
-		cfg->cmp_par_background_pixels_error = par->fc_background_outlier_pixels;
-		cfg->spill_background_pixels_error = cmp_get_spill(cfg->cmp_par_background_pixels_error,
-						cfg->cmp_mode, MAX_USED_BITS.fc_background_outlier_pixels);
-		break;
-	case CHUNK_TYPE_UNKNOWN:
-	default: /*
-		  * default case never reached because cmp_col_get_chunk_type
-		  * returns CHUNK_TYPE_UNKNOWN if the type is unknown
-		  */
-		chunk_type = CHUNK_TYPE_UNKNOWN;
-		break;
-	}
+/* range of the Golomb parameter scaling of the compress_chunk_budget() search */
+#define BUDGET_MAX_SHIFT	16
 
-	return chunk_type;
+
+/**
+ * @brief state of the compress_chunk_budget() parameter search
+ */
+
+struct budget_search {
+	const void *chunk;		/**< chunk to compress */
+	uint32_t chunk_size;		/**< byte size of the chunk */
+	const void *chunk_model;	/**< model of the chunk (can be NULL) */
+	uint32_t budget;		/**< target size in bytes */
+	struct cmp_par start;		/**< start parameters of the search */
+	struct cmp_par best;		/**< parameters with the smallest size so far */
+	uint32_t best_size;		/**< compressed size with the best parameters */
+	int best_shift;			/**< Golomb parameter scaling of the best parameters */
+	unsigned int passes;		/**< number of executed size estimation passes */
+};
+
+
+/**
+ * @brief offsets of the specific compression parameters in the cmp_par
+ *	structure
+ */
+
+static const size_t cmp_par_specific_offsets[] = {
+	offsetof(struct cmp_par, nc_imagette),
+	offsetof(struct cmp_par, s_exp_flags),
+	offsetof(struct cmp_par, s_fx),
+	offsetof(struct cmp_par, s_ncob),
+	offsetof(struct cmp_par, s_efx),
+	offsetof(struct cmp_par, s_ecob),
+	offsetof(struct cmp_par, l_exp_flags),
+	offsetof(struct cmp_par, l_fx),
+	offsetof(struct cmp_par, l_ncob),
+	offsetof(struct cmp_par, l_efx),
+	offsetof(struct cmp_par, l_ecob),
+	offsetof(struct cmp_par, l_fx_cob_variance),
+	offsetof(struct cmp_par, saturated_imagette),
+	offsetof(struct cmp_par, nc_offset_mean),
+	offsetof(struct cmp_par, nc_offset_variance),
+	offsetof(struct cmp_par, nc_background_mean),
+	offsetof(struct cmp_par, nc_background_variance),
+	offsetof(struct cmp_par, nc_background_outlier_pixels),
+	offsetof(struct cmp_par, smearing_mean),
+	offsetof(struct cmp_par, smearing_variance_mean),
+	offsetof(struct cmp_par, smearing_outlier_pixels),
+	offsetof(struct cmp_par, fc_imagette),
+	offsetof(struct cmp_par, fc_offset_mean),
+	offsetof(struct cmp_par, fc_offset_variance),
+	offsetof(struct cmp_par, fc_background_mean),
+	offsetof(struct cmp_par, fc_background_variance),
+	offsetof(struct cmp_par, fc_background_outlier_pixels),
+	offsetof(struct cmp_par, f_fx),
+	offsetof(struct cmp_par, f_ncob),
+	offsetof(struct cmp_par, f_efx),
+	offsetof(struct cmp_par, f_ecob),
+};
+compile_time_assert(ARRAY_SIZE(cmp_par_specific_offsets) == CMP_PAR_NUM_SPECIFIC,
+		    CMP_PAR_SPECIFIC_OFFSETS_INCOMPLETE);
+
+
+/**
+ * @brief get a specific compression parameter of a compression parameters
+ *	struct by its index
+ *
+ * @param par	pointer to a compression parameters struct
+ * @param idx	index of the parameter; 0 to CMP_PAR_NUM_SPECIFIC-1
+ *
+ * @returns a pointer to the parameter; NULL if par is NULL or idx is out of
+ *	range
+ */
+
+uint32_t *cmp_par_specific(struct cmp_par *par, unsigned int idx)
+{
+	if (!par || idx >= CMP_PAR_NUM_SPECIFIC)
+		return NULL;
+
+	return (uint32_t *)((uint8_t *)par + cmp_par_specific_offsets[idx]);
 }
 
 
 /**
- * @brief initialise the compress_chunk() function
+ * @brief scale all Golomb parameters of the start parameters by 2^shift
  *
- * If not initialised the compress_chunk() function sets the timestamps and
- * version_id in the compression entity header to zero
+ * The scaled parameters are clamped to the valid chunk compression parameter
+ * range; unused (zero) parameters are left untouched.
+ */
+
+static void budget_scale_par(struct cmp_par *par, const struct cmp_par *start,
+			     int shift)
+{
+	unsigned int i;
+
+	for (i = 0; i < CMP_PAR_NUM_SPECIFIC; i++) {
+		size_t const off = cmp_par_specific_offsets[i];
+		uint32_t v = *(const uint32_t *)((const uint8_t *)start + off);
+
+		if (v == 0)
+			continue;
+		if (shift >= 0)
+			v = v > ((uint32_t)MAX_CHUNK_CMP_PAR >> shift) ? MAX_CHUNK_CMP_PAR : v << shift;
+		else
+			v >>= -shift;
+		if (v < MIN_CHUNK_CMP_PAR)
+			v = MIN_CHUNK_CMP_PAR;
+		*(uint32_t *)((uint8_t *)par + off) = v;
+	}
+}
+
+
+/**
+ * @brief estimate the compressed size for a parameter set of the search
  *
- * @param return_timestamp	pointer to a function returning a current 48-bit
- *				timestamp
- * @param version_id		application software version identifier
+ * The size is determined with a compress_chunk() call without a destination
+ * buffer and without a model update, nothing is written. The statistics sink
+ * is detached during the estimation, so it is not overwritten. The best
+ * parameters of the search are updated if the size is smaller than the best
+ * size so far.
+ *
+ * @returns the compressed size in bytes or an error code
  */
 
-void compress_chunk_init(uint64_t (*return_timestamp)(void), uint32_t version_id)
+static uint32_t budget_pass(struct budget_search *s, int shift, uint32_t lossy_par)
 {
-	if (return_timestamp)
-		get_timestamp = return_timestamp;
+	struct cmp_par par = s->start;
+	struct cmp_stats *const sink = stats_sink;
+	uint32_t size;
+
+	budget_scale_par(&par, &s->start, shift);
+	par.lossy_par = lossy_par;
+
+	s->passes++;
+	stats_sink = NULL;
+	size = compress_chunk(s->chunk, s->chunk_size, s->chunk_model, NULL, NULL, 0, &par);
+	stats_sink = sink;
+	if (!cmp_is_error(size) && size < s->best_size) {
+		s->best = par;
+		s->best_size = size;
+		s->best_shift = shift;
+	}
+	return size;
+}
 
-	version_identifier = version_id;
+
+/**
+ * @brief scale the Golomb parameters of the best parameters up or down as
+ *	long as the size does not increase and the budget is not met
+ *
+ * The search walks over plateaus, e.g. if the collections are stored
+ * uncompressed with more than one parameter set.
+ *
+ * @returns 0 on success or an error code
+ */
+
+static uint32_t budget_climb(struct budget_search *s, uint32_t lossy_par)
+{
+	int dir;
+
+	for (dir = 1; dir >= -1; dir -= 2) {
+		uint32_t const start_size = s->best_size;
+		uint32_t cur_size = s->best_size;
+		int shift = s->best_shift;
+
+		while (s->best_size > s->budget && s->passes < CMP_BUDGET_MAX_PASSES) {
+			int const next_shift = shift + dir;
+			struct cmp_par par = s->start, next_par = s->start;
+			uint32_t size;
+
+			if (next_shift < -BUDGET_MAX_SHIFT || next_shift > BUDGET_MAX_SHIFT)
+				break;
+			/* all parameters are clamped to the valid range */
+			budget_scale_par(&par, &s->start, shift);
+			budget_scale_par(&next_par, &s->start, next_shift);
+			if (!memcmp(&par, &next_par, sizeof(par)))
+				break;
+			size = budget_pass(s, next_shift, lossy_par);
+			FORWARD_IF_ERROR(size, "");
+			if (size > cur_size)
+				break;
+			shift = next_shift;
+			cur_size = size;
+		}
+		/* no need to search in the other direction after an improvement */
+		if (s->best_size < start_size)
+			break;
+	}
+	return 0;
 }
 
 
 /**
- * @brief compress a data chunk consisting of put together data collections
+ * @brief compress a data chunk so that it fits into a byte budget
+ *
+ * Starting with the given parameters, the Golomb parameters of all data
+ * types are scaled by powers of two in the direction in which the compressed
+ * size decreases. If this is not enough, the lossy_par is increased step by
+ * step up to max_lossy_par. The search stops as soon as the budget is met,
+ * when lossy compression gives no size reduction (e.g. the chunk type does
+ * not support it), or after CMP_BUDGET_MAX_PASSES size estimation passes. The
+ * estimation passes only count the bits, the chunk is encoded into the dst
+ * buffer once with the selected parameters. Only this final compression
+ * fills the statistics sink set with compress_chunk_set_stats(); without a
+ * dst buffer the sink is not touched.
  *
  * @param chunk			pointer to the chunk to be compressed
  * @param chunk_size		byte size of the chunk
@@ -2108,84 +2966,74 @@ void compress_chunk_init(uint64_t (*return_timestamp)(void), uint32_t version_id
  *				model is not needed)
  * @param dst			destination pointer to the compressed data
  *				buffer; has to be 4-byte aligned; can be NULL to
- *				only get the compressed data size
- * @param dst_capacity		capacity of the dst buffer; it's recommended to
- *				provide a dst_capacity >=
- *				compress_chunk_cmp_size_bound(chunk, chunk_size)
- *				as it eliminates one potential failure scenario:
- *				not enough space in the dst buffer to write the
- *				compressed data; size is internally rounded down
- *				to a multiple of 4
- * @param cmp_par		pointer to a compression parameters struct
+ *				only get the compressed data size and the
+ *				selected parameters
+ * @param dst_capacity		byte budget for the compressed data and capacity
+ *				of the dst buffer; rounded down to a multiple of 4
+ * @param cmp_par		pointer to the start compression parameters; on
+ *				return it contains the parameters used for the
+ *				compression (if the budget can not be met, the
+ *				parameters with the smallest size found)
+ * @param max_lossy_par		largest lossy_par the search is allowed to use;
+ *				use cmp_par->lossy_par for no lossy escalation
+ *
  * @returns the byte size of the compressed data or an error code if it
- *	fails (which can be tested with cmp_is_error())
+ *	fails (which can be tested with cmp_is_error()); CMP_ERROR_SMALL_BUFFER
+ *	if the chunk does not fit into the budget
  */
 
-uint32_t compress_chunk(const void *chunk, uint32_t chunk_size,
-			const void *chunk_model, void *updated_chunk_model,
-			uint32_t *dst, uint32_t dst_capacity,
-			const struct cmp_par *cmp_par)
+uint32_t compress_chunk_budget(const void *chunk, uint32_t chunk_size,
+			       const void *chunk_model, void *updated_chunk_model,
+			       uint32_t *dst, uint32_t dst_capacity,
+			       struct cmp_par *cmp_par, uint32_t max_lossy_par)
 {
-	uint64_t const start_timestamp = get_timestamp();
-	const struct collection_hdr *col = (const struct collection_hdr *)chunk;
-	enum chunk_type chunk_type;
-	struct cmp_cfg cfg;
-	uint32_t cmp_size_byte; /* size of the compressed data in bytes */
-	size_t read_bytes;
+	struct budget_search s;
+	uint32_t lossy_par;
 
-	RETURN_ERROR_IF(chunk == NULL, CHUNK_NULL, "");
 	RETURN_ERROR_IF(cmp_par == NULL, PAR_NULL, "");
-	RETURN_ERROR_IF(chunk_size < COLLECTION_HDR_SIZE, CHUNK_SIZE_INCONSISTENT,
-			"chunk_size: %"PRIu32"", chunk_size);
-	RETURN_ERROR_IF(chunk_size > CMP_ENTITY_MAX_ORIGINAL_SIZE, CHUNK_TOO_LARGE,
-			"chunk_size: %"PRIu32"", chunk_size);
-
-	chunk_type = init_cmp_cfg_from_cmp_par(col, cmp_par, &cfg);
-	RETURN_ERROR_IF(chunk_type == CHUNK_TYPE_UNKNOWN, COL_SUBSERVICE_UNSUPPORTED,
-			"unsupported subservice: %u", cmp_col_get_subservice(col));
-
-	/* reserve space for the compression entity header, we will build the
-	 * header after the compression of the chunk
-	 */
-	cmp_size_byte = cmp_ent_build_chunk_header(NULL, chunk_size, &cfg, start_timestamp, 0);
-	RETURN_ERROR_IF(dst && dst_capacity < cmp_size_byte, SMALL_BUFFER,
-			"dst_capacity must be at least as large as the minimum size of the compression unit.");
-
 
-	/* compress one collection after another */
-	for (read_bytes = 0;
-	     read_bytes <= chunk_size - COLLECTION_HDR_SIZE;
-	     read_bytes += cmp_col_get_size(col)) {
-		const uint8_t *col_model = NULL;
-		uint8_t *col_up_model = NULL;
+	memset(&s, 0, sizeof(s));
+	s.chunk = chunk;
+	s.chunk_size = chunk_size;
+	s.chunk_model = chunk_model;
+	s.budget = dst_capacity & ~0x3U;
+	s.start = *cmp_par;
+	s.best = *cmp_par;
+	s.best_size = UINT32_MAX;
 
-		/* setup pointers for the next collection we want to compress */
-		col = (const struct collection_hdr *)((const uint8_t *)chunk + read_bytes);
-		if (chunk_model)
-			col_model = (const uint8_t *)chunk_model + read_bytes;
-		if (updated_chunk_model)
-			col_up_model = (uint8_t *)updated_chunk_model + read_bytes;
+	lossy_par = cmp_par->lossy_par;
+	FORWARD_IF_ERROR(budget_pass(&s, 0, lossy_par), "");
 
-		RETURN_ERROR_IF(cmp_col_get_chunk_type(col) != chunk_type, CHUNK_SUBSERVICE_INCONSISTENT, "");
+	while (1) {
+		uint32_t prev_size;
 
-		/* chunk size is inconsistent with the sum of sizes in the collection headers */
-		if (read_bytes + cmp_col_get_size(col) > chunk_size)
+		FORWARD_IF_ERROR(budget_climb(&s, lossy_par), "");
+		if (s.best_size <= s.budget || lossy_par >= max_lossy_par ||
+		    s.passes >= CMP_BUDGET_MAX_PASSES)
 			break;
 
-		cmp_size_byte = cmp_collection((const uint8_t *)col, col_model, col_up_model,
-					       dst, dst_capacity, &cfg, cmp_size_byte);
-		FORWARD_IF_ERROR(cmp_size_byte, "error occurred when compressing the collection with offset %u", read_bytes);
+		prev_size = s.best_size;
+		lossy_par++;
+		FORWARD_IF_ERROR(budget_pass(&s, s.best_shift, lossy_par), "");
+		if (s.best_size >= prev_size)
+			break; /* lossy compression does not reduce the size */
 	}
 
-	RETURN_ERROR_IF(read_bytes != chunk_size, CHUNK_SIZE_INCONSISTENT, "");
+	debug_print("compress_chunk_budget: %u passes, size: %"PRIu32", budget: %"PRIu32"",
+		    s.passes, s.best_size, s.budget);
+	*cmp_par = s.best;
+	RETURN_ERROR_IF(s.best_size > s.budget, SMALL_BUFFER,
+			"the chunk does not fit into the budget of %"PRIu32" bytes", s.budget);
 
-	FORWARD_IF_ERROR(cmp_ent_build_chunk_header(dst, chunk_size, &cfg,
-					    start_timestamp, cmp_size_byte), "");
+	if (!dst)
+		return s.best_size;
 
-	return cmp_size_byte;
+	return compress_chunk(chunk, chunk_size, chunk_model, updated_chunk_model,
+			      dst, dst_capacity, cmp_par);
 }
 
 
+
 /**
  * @brief returns the maximum compressed size in a worst-case scenario
  * In case the input data is not compressible
@@ -2233,6 +3081,229 @@ uint32_t compress_chunk_cmp_size_bound(const void *chunk, size_t chunk_size)
 }
 
 
+/**
+ * @brief get the size of the next part of a chunk split at collection
+ *	boundaries
+ *
+ * @param chunk		pointer to the remaining chunk
+ * @param chunk_size	byte size of the remaining chunk
+ * @param max_part_size	maximum byte size of a part
+ * @param chunk_type	chunk type of the whole chunk
+ *
+ * @returns the byte size of the next part or an error code if it fails
+ */
+
+static uint32_t chunk_split_next_part(const uint8_t *chunk, uint32_t chunk_size,
+				      uint32_t max_part_size, enum chunk_type chunk_type)
+{
+	uint32_t part_size = 0, num_col = 0;
+
+	while (chunk_size - part_size >= COLLECTION_HDR_SIZE) {
+		const struct collection_hdr *col =
+			(const struct collection_hdr *)(chunk + part_size);
+		uint32_t const col_size = cmp_col_get_size(col);
+
+		RETURN_ERROR_IF(cmp_col_get_chunk_type(col) != chunk_type,
+				CHUNK_SUBSERVICE_INCONSISTENT, "");
+		if (col_size > chunk_size - part_size)
+			break;
+		if (part_size + col_size > max_part_size ||
+		    COMPRESS_CHUNK_BOUND_UNSAFE(part_size + col_size, num_col + 1) > CMP_ENTITY_MAX_SIZE)
+			break;
+		part_size += col_size;
+		num_col++;
+	}
+
+	if (part_size == 0) {
+		RETURN_ERROR_IF(chunk_size < COLLECTION_HDR_SIZE ||
+				cmp_col_get_size((const struct collection_hdr *)chunk) > chunk_size,
+				CHUNK_SIZE_INCONSISTENT, "");
+		RETURN_ERROR(CHUNK_TOO_LARGE, "collection larger than the maximum part size of %"PRIu32" bytes",
+			     max_part_size);
+	}
+
+	return part_size;
+}
+
+
+/**
+ * @brief get the maximum part size of a chunk split
+ */
+
+static uint32_t chunk_split_max_part_size(uint32_t max_part_size)
+{
+	uint32_t const max_size = CMP_ENTITY_MAX_ORIGINAL_SIZE
+		- NON_IMAGETTE_HEADER_SIZE - CMP_COLLECTION_FILD_SIZE;
+
+	if (max_part_size == 0 || max_part_size > max_size)
+		return max_size;
+	return max_part_size;
+}
+
+
+/**
+ * @brief split a chunk at collection boundaries into parts which fit into a
+ *	compression entity
+ *
+ * The collections are greedily put together until the next collection would
+ * exceed the maximum part size or the worst-case compressed size of the part
+ * would exceed CMP_ENTITY_MAX_SIZE. The parts can be compressed independently
+ * with compress_chunk(); the model and the updated model of a part are at the
+ * same offset as the part in the chunk.
+ *
+ * @note the parts can only be compressed in parallel if no statistics sink is
+ *	set with compress_chunk_set_stats() and CMP_TRACE is disabled; the
+ *	statistics sink and the trace ring are global and not thread-safe
+ *
+ * @param chunk		pointer to the chunk to be split
+ * @param chunk_size	byte size of the chunk
+ * @param max_part_size	maximum byte size of a part; 0 or a value larger than
+ *			the maximum chunk size of the compress_chunk_cmp_size_bound()
+ *			function selects the maximum possible part size
+ * @param part_sizes	pointer to an array where the byte sizes of the parts
+ *			are stored (can be NULL to only count the parts)
+ * @param max_parts	number of elements in the part_sizes array
+ *
+ * @returns the number of parts or an error code if it fails (which can be
+ *	tested with cmp_is_error()); CMP_ERROR_SMALL_BUFFER if the part_sizes
+ *	array is too small
+ */
+
+uint32_t compress_chunk_split_plan(const void *chunk, uint32_t chunk_size,
+				   uint32_t max_part_size, uint32_t *part_sizes,
+				   uint32_t max_parts)
+{
+	enum chunk_type chunk_type;
+	uint32_t offset = 0, num_parts = 0;
+
+	RETURN_ERROR_IF(chunk == NULL, CHUNK_NULL, "");
+	RETURN_ERROR_IF(chunk_size < COLLECTION_HDR_SIZE, CHUNK_SIZE_INCONSISTENT,
+			"chunk_size: %"PRIu32"", chunk_size);
+	chunk_type = cmp_col_get_chunk_type(chunk);
+	RETURN_ERROR_IF(chunk_type == CHUNK_TYPE_UNKNOWN, COL_SUBSERVICE_UNSUPPORTED,
+			"unsupported subservice: %u", cmp_col_get_subservice(chunk));
+	max_part_size = chunk_split_max_part_size(max_part_size);
+
+	while (offset < chunk_size) {
+		uint32_t const part_size = chunk_split_next_part((const uint8_t *)chunk + offset,
+								 chunk_size - offset,
+								 max_part_size, chunk_type);
+		FORWARD_IF_ERROR(part_size, "chunk offset: %"PRIu32"", offset);
+
+		if (part_sizes) {
+			RETURN_ERROR_IF(num_parts >= max_parts, SMALL_BUFFER,
+					"more than %"PRIu32" parts", max_parts);
+			part_sizes[num_parts] = part_size;
+		}
+		num_parts++;
+		offset += part_size;
+	}
+
+	return num_parts;
+}
+
+
+/**
+ * @brief compress a chunk of arbitrary size into one or more compression
+ *	entities
+ *
+ * The chunk is split with compress_chunk_split_plan() and every part is
+ * compressed like with compress_chunk() into its own compression entity. The
+ * entities are written without gaps one after another into the dst buffer
+ * (as expected by decompress_cmp_batch()); an entity which does not start at
+ * a 4-byte aligned position is compressed directly to its position, so it is
+ * not moved after the compression. A statistics sink set with
+ * compress_chunk_set_stats() holds the statistics of the last part.
+ *
+ * @param chunk			pointer to the chunk to be compressed
+ * @param chunk_size		byte size of the chunk
+ * @param chunk_model		pointer to a model of a chunk; has the same size
+ *				as the chunk (can be NULL if no model compression
+ *				mode is used)
+ * @param updated_chunk_model	pointer to store the updated model for the next
+ *				model mode compression; has the same size as the
+ *				chunk (can be the same as the model_of_data
+ *				buffer for in-place update or NULL if updated
+ *				model is not needed)
+ * @param dst			destination pointer to the compressed entities;
+ *				has to be 4-byte aligned; can be NULL to only
+ *				get the compressed data size
+ * @param dst_capacity		capacity of the dst buffer (see compress_chunk())
+ * @param cmp_par		pointer to a compression parameters struct
+ * @param max_part_size		maximum original data size of an entity (see
+ *				compress_chunk_split_plan())
+ * @param ent_sizes		pointer to an array where the byte sizes of the
+ *				compression entities are stored
+ * @param max_ent		number of elements in the ent_sizes array
+ * @param num_ent		pointer where the number of compression entities
+ *				is stored
+ *
+ * @returns the byte size of all compression entities or an error code if it
+ *	fails (which can be tested with cmp_is_error())
+ */
+
+uint32_t compress_chunk_split(const void *chunk, uint32_t chunk_size,
+			      const void *chunk_model, void *updated_chunk_model,
+			      uint32_t *dst, uint32_t dst_capacity,
+			      const struct cmp_par *cmp_par, uint32_t max_part_size,
+			      uint32_t *ent_sizes, uint32_t max_ent, uint32_t *num_ent)
+{
+	enum chunk_type chunk_type;
+	uint32_t offset = 0, n = 0;
+	uint64_t dst_size = 0;
+
+	RETURN_ERROR_IF(chunk == NULL, CHUNK_NULL, "");
+	RETURN_ERROR_IF(ent_sizes == NULL || num_ent == NULL, PAR_NULL, "");
+	RETURN_ERROR_IF(chunk_size < COLLECTION_HDR_SIZE, CHUNK_SIZE_INCONSISTENT,
+			"chunk_size: %"PRIu32"", chunk_size);
+	chunk_type = cmp_col_get_chunk_type(chunk);
+	RETURN_ERROR_IF(chunk_type == CHUNK_TYPE_UNKNOWN, COL_SUBSERVICE_UNSUPPORTED,
+			"unsupported subservice: %u", cmp_col_get_subservice(chunk));
+	max_part_size = chunk_split_max_part_size(max_part_size);
+	*num_ent = 0;
+
+	while (offset < chunk_size) {
+		struct cmp_chunk_iov iov;
+		uint32_t *part_dst = NULL;
+		uint32_t part_capacity = 0, ent_size, part_size;
+
+		part_size = chunk_split_next_part((const uint8_t *)chunk + offset,
+						  chunk_size - offset, max_part_size,
+						  chunk_type);
+		FORWARD_IF_ERROR(part_size, "chunk offset: %"PRIu32"", offset);
+		RETURN_ERROR_IF(n >= max_ent, SMALL_BUFFER, "more than %"PRIu32" entities", max_ent);
+
+		iov.data = (const uint8_t *)chunk + offset;
+		iov.model = chunk_model ? (const uint8_t *)chunk_model + offset : NULL;
+		iov.up_model = updated_chunk_model ? (uint8_t *)updated_chunk_model + offset : NULL;
+		iov.size = part_size;
+		if (dst) {
+			RETURN_ERROR_IF(dst_size >= dst_capacity, SMALL_BUFFER, "");
+			/* the bit writer needs a 4-byte aligned buffer, so the
+			 * entity is written at its byte offset in the word
+			 * holding the end of the previous entity
+			 */
+			part_dst = dst + dst_size/4;
+			part_capacity = dst_capacity - (uint32_t)(dst_size & ~(uint64_t)0x3);
+		}
+
+		ent_size = compress_chunk_pieces(&iov, 1, part_dst, part_capacity,
+						 (uint32_t)(dst_size & 0x3), NULL, cmp_par);
+		FORWARD_IF_ERROR(ent_size, "compression of the part at chunk offset %"PRIu32" failed",
+				 offset);
+
+		dst_size += ent_size;
+		RETURN_ERROR_IF(dst_size > UINT32_MAX || cmp_is_error((uint32_t)dst_size),
+				CHUNK_TOO_LARGE, "");
+		ent_sizes[n++] = ent_size;
+		offset += part_size;
+	}
+
+	*num_ent = n;
+	return (uint32_t)dst_size;
+}
+
+
 /**
  * @brief set the model id and model counter in the compression entity header
  *
@@ -2264,24 +3335,40 @@ uint32_t compress_chunk_set_model_id_and_counter(void *dst, uint32_t dst_size,
 
 
 /**
- * @brief compress data the same way as the RDCU HW compressor
- *
- * @param rcfg	pointer to a RDCU compression configuration (created with the
- *		rdcu_cfg_create() function, set up with the rdcu_cfg_buffers()
- *		and rdcu_cfg_imagette() functions)
- * @param info	pointer to a compression information structure contains the
- *		metadata of a compression (can be NULL)
+ * @brief compress data the same way as the RDCU HW compressor and determine
+ *	the compressed sizes with alternative compression parameters
+ *
+ * The compressed sizes for the alternative parameters are determined in the
+ * same pass over the data as the compression with the parameters of the RDCU
+ * configuration. This can also be used for parameter sweeps, in this case the
+ * icu_output_buf of the RDCU configuration can be NULL.
+ *
+ * @param rcfg		pointer to a RDCU compression configuration (created
+ *			with the rdcu_cfg_create() function, set up with the
+ *			rdcu_cfg_buffers() and rdcu_cfg_imagette() functions)
+ * @param info		pointer to a compression information structure
+ *			contains the metadata of a compression (can be NULL);
+ *			the adaptive compressed sizes are not set
+ * @param trials	pointer to an array of alternative compression
+ *			parameters; the compressed sizes are stored in the
+ *			array; invalid parameters result in a size of 0
+ * @param num_trials	number of alternative compression parameters; must
+ *			not be larger than CMP_MAX_PAR_TRIALS
  *
  * @returns the bit length of the bitstream on success or an error code if it
- *	fails (which can be tested with cmp_is_error())
+ *	fails (which can be tested with cmp_is_error()); in case of an error all
+ *	trial sizes are 0
  *
  * @warning only the small buffer error in the info.cmp_err field is implemented
  */
 
-uint32_t compress_like_rdcu(const struct rdcu_cfg *rcfg, struct cmp_info *info)
+uint32_t compress_like_rdcu_trials(const struct rdcu_cfg *rcfg, struct cmp_info *info,
+				   struct cmp_par_trial *trials, uint32_t num_trials)
 {
 	struct cmp_cfg cfg;
-	uint32_t cmp_size_bit;
+	struct cmp_par_trial valid_trials[CMP_MAX_PAR_TRIALS];
+	uint32_t trial_idx[CMP_MAX_PAR_TRIALS];
+	uint32_t cmp_size_bit, num_valid = 0, i;
 
 	memset(&cfg, 0, sizeof(cfg));
 
@@ -2291,6 +3378,10 @@ uint32_t compress_like_rdcu(const struct rdcu_cfg *rcfg, struct cmp_info *info)
 	if (!rcfg)
 		return compress_data_internal(NULL, 0);
 
+	RETURN_ERROR_IF(num_trials > CMP_MAX_PAR_TRIALS, PAR_GENERIC,
+			"num_trials: %"PRIu32" > %u", num_trials, CMP_MAX_PAR_TRIALS);
+	RETURN_ERROR_IF(num_trials && !trials, PAR_NULL, "");
+
 	cfg.data_type = DATA_TYPE_IMAGETTE;
 
 	cfg.src = rcfg->input_buf;
@@ -2314,19 +3405,19 @@ uint32_t compress_like_rdcu(const struct rdcu_cfg *rcfg, struct cmp_info *info)
 		info->cmp_size = 0;
 		info->ap1_cmp_size = 0;
 		info->ap2_cmp_size = 0;
+	}
 
-		cfg.cmp_par_imagette = rcfg->ap1_golomb_par;
-		cfg.spill_imagette = rcfg->ap1_spill;
-		if (cfg.cmp_par_imagette &&
-		    cmp_cfg_icu_is_invalid_error_code(&cfg) == CMP_ERROR_NO_ERROR)
-			info->ap1_cmp_size = compress_data_internal(&cfg, 0);
-
-
-		cfg.cmp_par_imagette = rcfg->ap2_golomb_par;
-		cfg.spill_imagette = rcfg->ap2_spill;
+	/* only the valid parameter trials are passed to the encoder */
+	for (i = 0; i < num_trials; i++) {
+		trials[i].cmp_size = 0;
+		cfg.cmp_par_imagette = trials[i].golomb_par;
+		cfg.spill_imagette = trials[i].spill;
 		if (cfg.cmp_par_imagette &&
-		    cmp_cfg_icu_is_invalid_error_code(&cfg) == CMP_ERROR_NO_ERROR)
-			info->ap2_cmp_size = compress_data_internal(&cfg, 0);
+		    cmp_cfg_icu_is_invalid_error_code(&cfg) == CMP_ERROR_NO_ERROR) {
+			valid_trials[num_valid] = trials[i];
+			trial_idx[num_valid] = i;
+			num_valid++;
+		}
 	}
 
 	cfg.cmp_par_imagette = rcfg->golomb_par;
@@ -2334,21 +3425,69 @@ uint32_t compress_like_rdcu(const struct rdcu_cfg *rcfg, struct cmp_info *info)
 	cfg.updated_model_buf = rcfg->icu_new_model_buf;
 	cfg.dst = rcfg->icu_output_buf;
 
+	RETURN_ERROR_IF(adaptive_mode_is_used(cfg.cmp_mode), PAR_GENERIC,
+			"The RDCU does not support the adaptive compression modes.");
 	FORWARD_IF_ERROR(cmp_cfg_icu_is_invalid_error_code(&cfg), "");
 
+	cfg.par_trials = valid_trials;
+	cfg.num_par_trials = num_valid;
+
 	cmp_size_bit = compress_data_internal(&cfg, 0);
 
 	if (info) {
 		if (cmp_get_error_code(cmp_size_bit) == CMP_ERROR_SMALL_BUFFER)
 			info->cmp_err |= 1UL << 0;/* SMALL_BUFFER_ERR_BIT;*/ /* set small buffer error */
-		if (cmp_is_error(cmp_size_bit)) {
-			info->cmp_size = 0;
-			info->ap1_cmp_size = 0;
-			info->ap2_cmp_size = 0;
-		} else {
+		if (!cmp_is_error(cmp_size_bit))
 			info->cmp_size = cmp_size_bit;
+	}
+
+	if (!cmp_is_error(cmp_size_bit)) {
+		for (i = 0; i < num_valid; i++) {
+			/* in raw mode the size does not depend on the parameters */
+			if (raw_mode_is_used(cfg.cmp_mode))
+				trials[trial_idx[i]].cmp_size = cmp_size_bit;
+			else
+				trials[trial_idx[i]].cmp_size = valid_trials[i].cmp_size;
 		}
 	}
 
 	return cmp_size_bit;
 }
+
+
+/**
+ * @brief compress data the same way as the RDCU HW compressor
+ *
+ * @param rcfg	pointer to a RDCU compression configuration (created with the
+ *		rdcu_cfg_create() function, set up with the rdcu_cfg_buffers()
+ *		and rdcu_cfg_imagette() functions)
+ * @param info	pointer to a compression information structure contains the
+ *		metadata of a compression (can be NULL)
+ *
+ * @returns the bit length of the bitstream on success or an error code if it
+ *	fails (which can be tested with cmp_is_error())
+ *
+ * @warning only the small buffer error in the info.cmp_err field is implemented
+ */
+
+uint32_t compress_like_rdcu(const struct rdcu_cfg *rcfg, struct cmp_info *info)
+{
+	struct cmp_par_trial ap_trials[2];
+	uint32_t cmp_size_bit;
+
+	/* the adaptive sizes are only needed for the compression information */
+	if (!rcfg || !info)
+		return compress_like_rdcu_trials(rcfg, info, NULL, 0);
+
+	ap_trials[0].golomb_par = rcfg->ap1_golomb_par;
+	ap_trials[0].spill = rcfg->ap1_spill;
+	ap_trials[1].golomb_par = rcfg->ap2_golomb_par;
+	ap_trials[1].spill = rcfg->ap2_spill;
+
+	cmp_size_bit = compress_like_rdcu_trials(rcfg, info, ap_trials,
+						 ARRAY_SIZE(ap_trials));
+	info->ap1_cmp_size = ap_trials[0].cmp_size;
+	info->ap2_cmp_size = ap_trials[1].cmp_size;
+
+	return cmp_size_bit;
+}
@@ -24,12 +24,21 @@
  * function.
  * Finally, you can compress the data with the RDCU using the
  * rdcu_compress_data() function.
+ *
+ * To keep the RDCU busy during the SpaceWire transfers, the
+ * rdcu_cfg_pipeline_buffers() function sets up two alternating RDCU SRAM
+ * layouts. The data of the next job are transferred with rdcu_transfer_data()
+ * while the RDCU compresses, and rdcu_compress_data_parallel() reads back the
+ * last compressed data while the next compression is running.
+ * In model mode, rdcu_cfg_model_resident() reuses the updated model left in
+ * the RDCU SRAM by the last compression instead of uploading the model again.
  */
 
 
 #include <stddef.h>
 #include <stdint.h>
 
+#include "../common/byteorder.h"
 #include "../common/cmp_debug.h"
 #include "../common/cmp_support.h"
 #include "cmp_rdcu_testing.h"
@@ -43,37 +52,39 @@
 #define RDCU_INTR_SIG_DIS 0 /* RDCU interrupt signal disable */
 #define RDCU_INTR_SIG_DEFAULT RDCU_INTR_SIG_ENA /* default start value for RDCU interrupt signal */
 
+#define RDCU_SYNC_TIMEOUT_US 1000000 /* maximum time to wait for RDCU replies */
+
 
 /* RDCU interrupt signal status */
 static int interrupt_signal_enabled = RDCU_INTR_SIG_DEFAULT;
 
+/* is the raw mode used for the configured/last started compression;
+ * -1: unknown, 0: no, 1: yes
+ */
+static int configured_cmp_mode_raw = -1;
+static int last_cmp_mode_raw = -1;
+
 
 /**
- * @brief save repeating 3 lines of code...
+ * @brief wait until all pending RMAP transactions with the RDCU are completed
  *
- * @note This function depends on the SpW implementation and must be adjusted to it.
+ * @note prints an error message if a transaction failed or the RDCU did not
+ *	answer within RDCU_SYNC_TIMEOUT_US; without a timer set with
+ *	rdcu_rmap_set_timer(), the poll limit of rdcu_wait() applies instead
  *
- * @note prints abort message if pending status is non-zero after 10 retries
+ * @returns 0 on success, error otherwise
  */
 
-static void rdcu_syncing(void)
+static int rdcu_syncing(void)
 {
-#if 1
-
-	int cnt = 0;
-
 	debug_print("syncing...");
-	while (rdcu_rmap_sync_status()) {
-		debug_print("pending: %d", rdcu_rmap_sync_status());
-
-		if (cnt++ > 10) {
-			debug_print("aborting; de-");
-			break;
-		}
-
+	if (rdcu_wait(RDCU_SYNC_TIMEOUT_US)) {
+		debug_print("Error: synchronisation with the RDCU failed.");
+		return -1;
 	}
 	debug_print("synced");
-#endif
+
+	return 0;
 }
 
 
@@ -89,7 +100,6 @@ int rdcu_interrupt_compression(void)
 	rdcu_set_data_compr_interrupt();
 	if (rdcu_sync_compr_ctrl())
 		return -1;
-	rdcu_syncing();
 
 	/* clear local bit immediately, this is a write-only register.
 	 * we would not want to restart compression by accidentally calling
@@ -97,7 +107,7 @@ int rdcu_interrupt_compression(void)
 	 */
 	rdcu_clear_data_compr_interrupt();
 
-	return 0;
+	return rdcu_syncing();
 }
 
 
@@ -120,12 +130,19 @@ static int rdcu_set_compression_register(const struct rdcu_cfg *rcfg)
 	 * compression is performed after a raw mode compression, the compressor
 	 * gets stuck due to a deadlock condition. Performing a compression
 	 * interrupt after a raw mode compression work around this bug.
+	 * We only have to ask the RDCU if we did not start the last compression
+	 * ourselves.
 	 */
-	if (rdcu_sync_used_param1())
-		return -1;
-	rdcu_syncing();
-	if (rdcu_get_compression_mode() == CMP_MODE_RAW)
-		rdcu_interrupt_compression();
+	if (last_cmp_mode_raw != 0) {
+		if (rdcu_sync_used_param1())
+			return -1;
+		if (rdcu_syncing())
+			return -1;
+		if (rdcu_get_compression_mode() == CMP_MODE_RAW)
+			if (rdcu_interrupt_compression())
+				return -1;
+		last_cmp_mode_raw = 0;
+	}
 #endif
 
 
@@ -165,30 +182,18 @@ static int rdcu_set_compression_register(const struct rdcu_cfg *rcfg)
 	if (rdcu_set_compr_data_buf_len(rcfg->buffer_length))
 		return -1;
 
-	/* now sync the configuration registers to the RDCU... */
-	if (rdcu_sync_compressor_param1())
-		return -1;
-	if (rdcu_sync_compressor_param2())
-		return -1;
-	if (rdcu_sync_adaptive_param1())
-		return -1;
-	if (rdcu_sync_adaptive_param2())
-		return -1;
-	if (rdcu_sync_data_start_addr())
-		return -1;
-	if (rdcu_sync_model_start_addr())
-		return -1;
-	if (rdcu_sync_num_samples())
-		return -1;
-	if (rdcu_sync_new_model_start_addr())
-		return -1;
-	if (rdcu_sync_compr_data_buf_start_addr())
-		return -1;
-	if (rdcu_sync_compr_data_buf_len())
+	/* now sync the changed configuration registers to the RDCU... */
+	if (rdcu_sync_compr_param_regs())
 		return -1;
 
 	/* wait for it */
-	rdcu_syncing();
+	if (rdcu_syncing()) {
+		/* we do not know what the RDCU got; write all registers next time */
+		rdcu_mark_compr_param_regs_dirty();
+		return -1;
+	}
+
+	configured_cmp_mode_raw = rcfg->cmp_mode == CMP_MODE_RAW;
 
 	return 0;
 }
@@ -212,9 +217,9 @@ int rdcu_start_compression(void)
 
 	/* start the compression */
 	rdcu_set_data_compr_start();
+	last_cmp_mode_raw = -1;
 	if (rdcu_sync_compr_ctrl())
 		return -1;
-	rdcu_syncing();
 
 	/* clear local bit immediately, this is a write-only register.
 	 * we would not want to restart compression by accidentally calling
@@ -222,19 +227,30 @@ int rdcu_start_compression(void)
 	 */
 	rdcu_clear_data_compr_start();
 
+	if (rdcu_syncing())
+		return -1;
+
+	last_cmp_mode_raw = configured_cmp_mode_raw;
+
 	return 0;
 }
 
 
 /**
- * @brief set up RDCU SRAM for compression
+ * @brief transfer the data to compress and the model (only in model mode) to
+ *	the RDCU SRAM
  *
  * @param rcfg  pointer to a RDCU compression configuration
  *
+ * @note no data are transferred if the input_buf or model_buf is NULL
+ * @note this function does not touch the compressor registers; it can be used
+ *	to transfer the data of the next job while the RDCU compresses data in
+ *	another part of the SRAM (see rdcu_cfg_pipeline_buffers())
+ *
  * @returns 0 on success, error otherwise
  */
 
-static int rdcu_transfer_sram(const struct rdcu_cfg *rcfg)
+int rdcu_transfer_data(const struct rdcu_cfg *rcfg)
 {
 	if (rcfg->input_buf != NULL) {
 		/* round up needed size must be a multiple of 4 bytes */
@@ -268,7 +284,8 @@ static int rdcu_transfer_sram(const struct rdcu_cfg *rcfg)
 	}
 
 	/* ...and wait for completion */
-	rdcu_syncing();
+	if (rdcu_syncing())
+		return -1;
 
 	return 0;
 }
@@ -293,7 +310,7 @@ int rdcu_compress_data(const struct rdcu_cfg *rcfg)
 	if (rdcu_set_compression_register(rcfg))
 		return -1;
 
-	if (rdcu_transfer_sram(rcfg))
+	if (rdcu_transfer_data(rcfg))
 		return -1;
 
 	if (rdcu_start_compression())
@@ -318,7 +335,8 @@ int rdcu_read_cmp_status(struct cmp_status *status)
 
 	if (rdcu_sync_compr_status())
 		return -1;
-	rdcu_syncing();
+	if (rdcu_syncing())
+		return -1;
 
 	if (status) {
 		status->data_valid = (uint8_t)rdcu_get_compr_status_valid();
@@ -344,27 +362,12 @@ int rdcu_read_cmp_status(struct cmp_status *status)
 
 int rdcu_read_cmp_info(struct cmp_info *info)
 {
-	/* read out the compressor information register*/
-	if (rdcu_sync_used_param1())
-		return -1;
-	if (rdcu_sync_used_param2())
-		return -1;
-	if (rdcu_sync_compr_data_start_addr())
-		return -1;
-	if (rdcu_sync_compr_data_size())
-		return -1;
-	if (rdcu_sync_compr_data_adaptive_1_size())
-		return -1;
-	if (rdcu_sync_compr_data_adaptive_2_size())
-		return -1;
-	if (rdcu_sync_compr_error())
-		return -1;
-	if (rdcu_sync_new_model_addr_used())
-		return -1;
-	if (rdcu_sync_samples_used())
+	/* read out all compressor information registers at once */
+	if (rdcu_sync_compr_info_regs())
 		return -1;
 
-	rdcu_syncing();
+	if (rdcu_syncing())
+		return -1;
 
 	if (info) {
 		/* put the data in the cmp_info structure */
@@ -449,7 +452,8 @@ int rdcu_read_cmp_bitstream(const struct cmp_info *info, void *compressed_data)
 		return -1;
 
 	/* wait for it */
-	rdcu_syncing();
+	if (rdcu_syncing())
+		return -1;
 
 	return rdcu_read_sram(compressed_data, info->rdcu_cmp_adr_used, s);
 }
@@ -460,15 +464,16 @@ int rdcu_read_cmp_bitstream(const struct cmp_info *info, void *compressed_data)
  *
  * @param info		compression information contains the metadata of a compression
  *
- * @param updated_model	the buffer to store the updated model (if NULL, the required size
- *			is returned)
+ * @param updated_model	the buffer to store the updated model in host byte
+ *			order (if NULL, the required size is returned)
  *
  * @returns the number of bytes read, < 0 on error
  */
 
 int rdcu_read_model(const struct cmp_info *info, void *updated_model)
 {
-	uint32_t s;
+	uint32_t s, i;
+	uint16_t *model = updated_model;
 
 	if (info == NULL)
 		return -1;
@@ -484,9 +489,107 @@ int rdcu_read_model(const struct cmp_info *info, void *updated_model)
 		return -1;
 
 	/* wait for it */
-	rdcu_syncing();
+	if (rdcu_syncing())
+		return -1;
 
-	return rdcu_read_sram(updated_model, info->rdcu_new_model_adr_used, s);
+	if (rdcu_read_sram(updated_model, info->rdcu_new_model_adr_used, s) < 0)
+		return -1;
+
+	/* the model samples are stored big-endian in the SRAM */
+	for (i = 0; i < info->samples_used; i++)
+		be16_to_cpus(&model[i]);
+
+	return (int)s;
+}
+
+
+/**
+ * @brief check if two RDCU SRAM areas are overlapping
+ *
+ * @param adr_a		start address of the 1st area
+ * @param size_a	size of the 1st area in bytes
+ * @param adr_b		start address of the 2nd area
+ * @param size_b	size of the 2nd area in bytes
+ *
+ * @returns 0 if the areas are not overlapping, otherwise they are overlapping
+ */
+
+static int sram_areas_overlap(uint32_t adr_a, uint32_t size_a,
+			      uint32_t adr_b, uint32_t size_b)
+{
+	return adr_a < adr_b + size_b && adr_a + size_a > adr_b;
+}
+
+
+/**
+ * @brief start an RDCU compression and read back the compressed data of the
+ *	last compression while the RDCU is busy
+ *
+ * @param rcfg		RDCU configuration of the compression to start; the
+ *			data to compress (and the model) must already be in the
+ *			RDCU SRAM, e.g. transferred with rdcu_transfer_data()
+ *			while the last compression was running
+ * @param last_info	compression information of the last compression (read
+ *			with rdcu_read_cmp_info()); can be NULL if there is no
+ *			last compression; nothing is read back if the last
+ *			compression failed
+ *
+ * @note This is the building block of a double-buffered compression, where
+ *	two RDCU SRAM layouts are used alternately (see
+ *	rdcu_cfg_pipeline_buffers()):
+ *	  rdcu_transfer_data(job[0]); rdcu_compress_data_parallel(job[0], NULL);
+ *	  for n = 1, 2, ...:
+ *	    rdcu_transfer_data(job[n]);   (overlaps the compression of n-1)
+ *	    wait until the RDCU is ready, rdcu_read_cmp_info(info[n-1])
+ *	    rdcu_compress_data_parallel(job[n], info[n-1])
+ * @note the compressed data of the last compression are read into the local
+ *	SRAM mirror, use rdcu_read_sram() with last_info->rdcu_cmp_adr_used to
+ *	copy them out
+ *
+ * @returns 0 on success, error otherwise
+ */
+
+int rdcu_compress_data_parallel(const struct rdcu_cfg *rcfg,
+				const struct cmp_info *last_info)
+{
+	uint32_t last_size = 0;
+	int read_back = last_info && !last_info->cmp_err;
+
+	if (!rcfg)
+		return -1;
+
+	if (read_back) {
+		last_size = cmp_bit_to_4byte(last_info->cmp_size);
+
+		/* the new compression must not overwrite the data we still read back */
+		if (sram_areas_overlap(last_info->rdcu_cmp_adr_used, last_size,
+				       rcfg->rdcu_buffer_adr, rcfg->buffer_length * IMA_SAM2BYT)) {
+			debug_print("Error: The RDCU compressed data buffer overlaps the compressed data of the last compression.");
+			return -1;
+		}
+		if (model_mode_is_used(rcfg->cmp_mode) &&
+		    sram_areas_overlap(last_info->rdcu_cmp_adr_used, last_size,
+				       rcfg->rdcu_new_model_adr, rcfg->samples * IMA_SAM2BYT)) {
+			debug_print("Error: The RDCU updated model buffer overlaps the compressed data of the last compression.");
+			return -1;
+		}
+	}
+
+	if (rdcu_set_compression_register(rcfg))
+		return -1;
+
+	if (rdcu_start_compression())
+		return -1;
+
+	if (!read_back)
+		return 0;
+
+	/* read back the last bitstream while the RDCU is compressing */
+	if (rdcu_sync_sram_to_mirror(last_info->rdcu_cmp_adr_used, last_size,
+				     rdcu_get_data_mtu()))
+		return -1;
+
+	return rdcu_syncing();
 }
 
 
@@ -525,7 +628,7 @@ int rdcu_inject_edac_error(const struct rdcu_cfg *rcfg, uint32_t addr)
 	if (rdcu_set_compression_register(rcfg))
 		return -1;
 
-	if (rdcu_transfer_sram(rcfg))
+	if (rdcu_transfer_data(rcfg))
 		return -1;
 
 	/* disable edac */
@@ -537,19 +640,22 @@ int rdcu_inject_edac_error(const struct rdcu_cfg *rcfg, uint32_t addr)
 			debug_print("Error: rdcu_sync_sram_edac_ctrl");
 			return -1;
 		}
-		rdcu_syncing();
+		if (rdcu_syncing())
+			return -1;
 		/* verify bypass aktiv */
 		rdcu_edac_set_ctrl_reg_read_op();
 		if (rdcu_sync_sram_edac_ctrl()) {
 			debug_print("Error: rdcu_sync_sram_edac_ctrl");
 			return -1;
 		}
-		rdcu_syncing();
+		if (rdcu_syncing())
+			return -1;
 		if (rdcu_sync_sram_edac_status()) {
 			debug_print("Error: rdcu_sync_sram_edac_status");
 			return -1;
 		}
-		rdcu_syncing();
+		if (rdcu_syncing())
+			return -1;
 		if (rdcu_edac_get_sub_chip_die_addr() != sub_chip_die_addr) {
 			debug_print("Error: sub_chip_die_addr unexpected!");
 			return -1;
@@ -567,7 +673,8 @@ int rdcu_inject_edac_error(const struct rdcu_cfg *rcfg, uint32_t addr)
 	/* inject multi bit error */
 	if (rdcu_sync_sram_to_mirror(addr, sizeof(buf), rdcu_get_data_mtu()))
 		return -1;
-	rdcu_syncing();
+	if (rdcu_syncing())
+		return -1;
 	if (rdcu_read_sram(buf, addr, sizeof(buf)) < 0)
 		return -1;
 
@@ -582,7 +689,8 @@ int rdcu_inject_edac_error(const struct rdcu_cfg *rcfg, uint32_t addr)
 		debug_print("Error: The data to be compressed cannot be transferred to the SRAM of the RDCU.");
 		return -1;
 	}
-	rdcu_syncing();
+	if (rdcu_syncing())
+		return -1;
 
 
 	/* enable edac again */
@@ -595,19 +703,22 @@ int rdcu_inject_edac_error(const struct rdcu_cfg *rcfg, uint32_t addr)
 			debug_print("Error: rdcu_sync_sram_edac_ctrl");
 			return -1;
 		}
-		rdcu_syncing();
+		if (rdcu_syncing())
+			return -1;
 		/* verify bypass disable */
 		rdcu_edac_set_ctrl_reg_read_op();
 		if (rdcu_sync_sram_edac_ctrl()) {
 			debug_print("Error: rdcu_sync_sram_edac_ctrl");
 			return -1;
 		}
-		rdcu_syncing();
+		if (rdcu_syncing())
+			return -1;
 		if (rdcu_sync_sram_edac_status()) {
 			debug_print("Error: rdcu_sync_sram_edac_status");
 			return -1;
 		}
-		rdcu_syncing();
+		if (rdcu_syncing())
+			return -1;
 		if (rdcu_edac_get_sub_chip_die_addr() != sub_chip_die_addr) {
 			debug_print("Error: sub_chip_die_addr unexpected!");
 			return -1;
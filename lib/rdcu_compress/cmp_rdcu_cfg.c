@@ -46,7 +46,7 @@ static int rdcu_cfg_gen_pars_are_invalid(const struct rdcu_cfg *rcfg)
 {
 	int rcfg_invalid = 0;
 
-	if (!cmp_mode_is_supported(rcfg->cmp_mode)) {
+	if (!cmp_mode_is_supported(rcfg->cmp_mode) || adaptive_mode_is_used(rcfg->cmp_mode)) {
 		debug_print("Error: selected cmp_mode: %i is not supported for a RDCU compression.", rcfg->cmp_mode);
 		rcfg_invalid++;
 	}
@@ -325,6 +325,121 @@ int rdcu_cfg_buffers(struct rdcu_cfg *rcfg, uint16_t *data_to_compress,
 }
 
 
+/**
+ * @brief set up the RDCU SRAM buffers of one of the two layouts used for a
+ *	double-buffered (pipelined) RDCU compression
+ *
+ * The RDCU SRAM is split in two halves. Each half holds the data to compress,
+ * the model, the updated model and the compressed data buffer of one job, so
+ * the data of the next job can be transferred to one half while the RDCU
+ * compresses the data in the other half.
+ *
+ * @param rcfg			pointer to a RDCU compression configuration
+ *				(created with the rdcu_cfg_create() function)
+ * @param data_to_compress	pointer to the data to be compressed (if NULL no
+ *				data transfer to the RDCU)
+ * @param data_samples		length of the data to be compressed measured in
+ *				16-bit data samples
+ * @param model_of_data		pointer to the model data buffer (only needed for
+ *				model compression mode)
+ * @param layout		SRAM layout to use; only the lowest bit is
+ *				evaluated, so the job counter can be passed
+ *
+ * @returns 0 if parameters are valid, non-zero if parameters are invalid
+ */
+
+int rdcu_cfg_pipeline_buffers(struct rdcu_cfg *rcfg, uint16_t *data_to_compress,
+			      uint32_t data_samples, uint16_t *model_of_data,
+			      unsigned int layout)
+{
+	uint32_t const base = (layout & 1U) * RDCU_PIPELINE_LAYOUT_SIZE;
+
+	if (data_samples > RDCU_PIPELINE_MAX_SAMPLES) {
+		debug_print("Error: The data to compress do not fit into a RDCU SRAM pipeline layout. The maximum number of samples is %lu.",
+			    RDCU_PIPELINE_MAX_SAMPLES);
+		return -1;
+	}
+
+	return rdcu_cfg_buffers(rcfg, data_to_compress, data_samples, model_of_data,
+				base + RDCU_PIPELINE_DATA_OFFSET,
+				base + RDCU_PIPELINE_MODEL_OFFSET,
+				base + RDCU_PIPELINE_UP_MODEL_OFFSET,
+				base + RDCU_PIPELINE_BUFFER_OFFSET,
+				RDCU_PIPELINE_MAX_SAMPLES);
+}
+
+
+/**
+ * @brief keep the model resident in the RDCU SRAM for the next compression
+ *
+ * The updated model of the last compression is already in the RDCU SRAM, so
+ * instead of uploading the model again, the updated model of the last
+ * compression becomes the model of the next compression. If the updated model
+ * was written to the rdcu_new_model_adr of the configuration, the roles of
+ * rdcu_model_adr and rdcu_new_model_adr are swapped, so the next updated model
+ * does not overwrite the model in use.
+ *
+ * @param rcfg		pointer to a RDCU compression configuration for the next
+ *			compression (with the buffers already set up)
+ * @param last_info	compression information of the last compression
+ *
+ * @note the model_buf of the configuration is set to NULL, so no model is
+ *	transferred to the RDCU; reading back the updated model with
+ *	rdcu_read_model() is only needed if the ICU needs a copy of it
+ *
+ * @returns 0 if parameters are valid, non-zero if parameters are invalid; on
+ *	error the configuration is not modified
+ */
+
+int rdcu_cfg_model_resident(struct rdcu_cfg *rcfg, const struct cmp_info *last_info)
+{
+	struct rdcu_cfg cfg;
+
+	if (!rcfg) {
+		debug_print("Error: pointer to the compression configuration structure is NULL.");
+		return -1;
+	}
+
+	if (!last_info) {
+		debug_print("Error: pointer to the last compression information structure is NULL.");
+		return -1;
+	}
+
+	if (!model_mode_is_used(rcfg->cmp_mode)) {
+		debug_print("Error: A resident model can only be used in model compression mode.");
+		return -1;
+	}
+
+	if (last_info->cmp_err) {
+		debug_print("Error: The last compression failed; no updated model is available.");
+		return -1;
+	}
+
+	if (!model_mode_is_used(last_info->cmp_mode_used)) {
+		debug_print("Error: The last compression did not produce an updated model.");
+		return -1;
+	}
+
+	if (last_info->samples_used != rcfg->samples) {
+		debug_print("Error: The number of samples does not match the resident model.");
+		return -1;
+	}
+
+	/* check a copy, so that rcfg is not modified on error */
+	cfg = *rcfg;
+	if (cfg.rdcu_new_model_adr == last_info->rdcu_new_model_adr_used)
+		cfg.rdcu_new_model_adr = cfg.rdcu_model_adr;
+	cfg.rdcu_model_adr = last_info->rdcu_new_model_adr_used;
+	cfg.model_buf = NULL;
+
+	if (rdcu_cfg_buffers_is_invalid(&cfg))
+		return -1;
+
+	*rcfg = cfg;
+	return 0;
+}
+
+
 /**
  * @brief check if the combination of the Golomb and spill parameters is invalid
  *
@@ -22,6 +22,17 @@
 #include <stdint.h>
 
 #include "../common/cmp_support.h"
+#include "rdcu_cmd.h"
+
+
+/* RDCU SRAM layouts used for a double-buffered (pipelined) compression */
+#define RDCU_PIPELINE_LAYOUT_SIZE	(RDCU_SRAM_SIZE / 2)
+#define RDCU_PIPELINE_REGION_SIZE	(RDCU_PIPELINE_LAYOUT_SIZE / 4)
+#define RDCU_PIPELINE_DATA_OFFSET	(0 * RDCU_PIPELINE_REGION_SIZE)
+#define RDCU_PIPELINE_MODEL_OFFSET	(1 * RDCU_PIPELINE_REGION_SIZE)
+#define RDCU_PIPELINE_UP_MODEL_OFFSET	(2 * RDCU_PIPELINE_REGION_SIZE)
+#define RDCU_PIPELINE_BUFFER_OFFSET	(3 * RDCU_PIPELINE_REGION_SIZE)
+#define RDCU_PIPELINE_MAX_SAMPLES	(RDCU_PIPELINE_REGION_SIZE / IMA_SAM2BYT)
 
 
 int rdcu_cfg_create(struct rdcu_cfg *rcfg, enum cmp_mode cmp_mode,
@@ -33,6 +44,12 @@ int rdcu_cfg_buffers(struct rdcu_cfg *rcfg, uint16_t *data_to_compress,
 		     uint32_t rdcu_new_model_adr, uint32_t rdcu_buffer_adr,
 		     uint32_t rdcu_buffer_lenght);
 
+int rdcu_cfg_pipeline_buffers(struct rdcu_cfg *rcfg, uint16_t *data_to_compress,
+			      uint32_t data_samples, uint16_t *model_of_data,
+			      unsigned int layout);
+
+int rdcu_cfg_model_resident(struct rdcu_cfg *rcfg, const struct cmp_info *last_info);
+
 int rdcu_cfg_imagette(struct rdcu_cfg *rcfg,
 		      uint32_t golomb_par, uint32_t spillover_par,
 		      uint32_t ap1_golomb_par, uint32_t ap1_spillover_par,
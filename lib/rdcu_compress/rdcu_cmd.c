@@ -203,6 +203,57 @@ int rdcu_write_cmd_register(uint16_t trans_id, uint8_t *cmd, uint32_t addr)
 
 
 
+/**
+ * @brief generate a read command for a block of consecutive registers
+ *
+ * @param trans_id a transaction identifier
+ *
+ * @param cmd the command buffer; if NULL, the function returns the needed size
+ *
+ * @param addr the address of the first register
+ * @param size the number of bytes to read (4 bytes per register)
+ *
+ * @returns the size of the command data buffer or 0 on error
+ *
+ * @note this will configure a multi-address read command
+ */
+
+int rdcu_read_cmd_register_block(uint16_t trans_id, uint8_t *cmd,
+				 uint32_t addr, uint32_t size)
+{
+	return rdcu_read_cmd_data_internal(trans_id, cmd, addr, size);
+}
+
+
+/**
+ * @brief generate a write command for a block of consecutive registers
+ *
+ * @param trans_id a transaction identifier
+ *
+ * @param cmd the command buffer; if NULL, the function returns the needed size
+ *
+ * @param addr the address of the first register
+ * @param size the number of bytes to write (4 bytes per register)
+ *
+ * @returns the size of the command data buffer or 0 on error
+ *
+ * @note a single register is written with a verified write command (as
+ *	 rdcu_write_cmd_register() does), larger blocks with a multi-address
+ *	 write command with reply enabled, as the verify buffer of the RMAP
+ *	 target only holds a single word
+ */
+
+int rdcu_write_cmd_register_block(uint16_t trans_id, uint8_t *cmd,
+				  uint32_t addr, uint32_t size)
+{
+	if (size == 4)
+		return rdcu_write_cmd_register_internal(trans_id, cmd, addr);
+
+	return rdcu_write_cmd_data_internal(trans_id, cmd, addr, size);
+}
+
+
+
 
 /**
  * @brief create a command to read the RDCU FPGA version register
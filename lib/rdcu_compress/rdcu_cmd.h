@@ -99,6 +99,10 @@
 
 int rdcu_read_cmd_register(uint16_t trans_id, uint8_t *cmd, uint32_t addr);
 int rdcu_write_cmd_register(uint16_t trans_id, uint8_t *cmd, uint32_t addr);
+int rdcu_read_cmd_register_block(uint16_t trans_id, uint8_t *cmd,
+				 uint32_t addr, uint32_t size);
+int rdcu_write_cmd_register_block(uint16_t trans_id, uint8_t *cmd,
+				  uint32_t addr, uint32_t size);
 
 int rdcu_write_cmd_data(uint16_t trans_id, uint8_t *cmd,
 			uint32_t addr, uint32_t size);
@@ -61,8 +61,12 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <stddef.h>
+
 #include "../common/byteorder.h"
 #include "../common/cmp_debug.h"
+#include "../common/compiler.h"
+#include "../common/cmp_trace.h"
 #include "rdcu_cmd.h"
 #include "rdcu_ctrl.h"
 #include "rdcu_rmap.h"
@@ -71,6 +75,17 @@
 static struct rdcu_mirror *rdcu;
 
 
+/* the Data Compressor parameter registers are mirrored in address order */
+compile_time_assert(offsetof(struct rdcu_mirror, compr_data_buf_len) -
+		    offsetof(struct rdcu_mirror, compressor_param1) ==
+		    COMPR_DATA_BUF_LEN - COMPR_PARAM_1,
+		    RDCU_MIRROR_COMPR_PARAM_REGS_NOT_CONTIGUOUS);
+compile_time_assert(offsetof(struct rdcu_mirror, samples_used) -
+		    offsetof(struct rdcu_mirror, used_param1) ==
+		    USED_NUMBER_OF_SAMPLES - USED_COMPR_PARAM_1,
+		    RDCU_MIRROR_COMPR_INFO_REGS_NOT_CONTIGUOUS);
+
+
 /**
  * @brief get the 4 FPGA minor/major version digits
  * @see RDCU-FRS-FN-0522
@@ -1881,11 +1896,16 @@ int rdcu_sync_compr_status(void)
 /**
  * @brief sync the RDCU Reset register (write only)
  *
+ * @note a reset clears the Data Compressor registers, so they are all
+ *	 considered changed afterwards
+ *
  * @returns 0 on success, otherwise error
  */
 
 int rdcu_sync_rdcu_reset(void)
 {
+	rdcu_mark_compr_param_regs_dirty();
+
 	return rdcu_sync(rdcu_write_cmd_rdcu_reset,
 			 &rdcu->rdcu_reset, 4);
 }
@@ -1955,6 +1975,85 @@ int rdcu_sync_compr_ctrl(void)
 }
 
 
+/**
+ * @brief completion callback of a Data Compressor parameter register block
+ *	write
+ *
+ * The written values are only taken as the RDCU register content once all
+ * outstanding block writes are acknowledged without error.
+ *
+ * @param tr_id		transaction identifier (unused)
+ * @param status	0 if the write was successful, otherwise error
+ * @param data		unused
+ */
+
+static void rdcu_compr_param_regs_written(uint16_t tr_id, int status, void *data)
+{
+	unsigned int n;
+
+	(void)tr_id;
+	(void)data;
+
+	if (status)
+		rdcu->compr_param_write_failed = 1;
+
+	if (--rdcu->compr_param_writes_pending)
+		return;
+
+	if (!rdcu->compr_param_write_failed) {
+		for (n = 0; n < RDCU_COMPR_PARAM_REGS; n++)
+			if (rdcu->compr_param_written_mask & (1UL << n))
+				rdcu->compr_param_synced[n] = rdcu->compr_param_written[n];
+
+		rdcu->compr_param_synced_valid |= rdcu->compr_param_written_mask;
+	}
+	rdcu->compr_param_written_mask = 0;
+}
+
+
+/**
+ * @brief check if a Data Compressor parameter register differs from the
+ *	value last written to the RDCU
+ *
+ * @param n	index of the register, counted from the Compressor Parameter 1
+ *
+ * @returns non-zero if the register needs to be synced
+ */
+
+static int rdcu_compr_param_reg_is_dirty(unsigned int n)
+{
+	const uint32_t *regs = &rdcu->compressor_param1;
+
+	if (!(rdcu->compr_param_synced_valid & (1UL << n)))
+		return 1;
+
+	return regs[n] != rdcu->compr_param_synced[n];
+}
+
+
+/**
+ * @brief sync a single Data Compressor parameter register (write only)
+ *
+ * @param fn	the RDCU command generation function of the register
+ * @param reg	the local mirror of the register
+ *
+ * @returns 0 on success, otherwise error
+ */
+
+static int rdcu_sync_compr_param_reg(int (*fn)(uint16_t trans_id, uint8_t *cmd),
+				     uint32_t *reg)
+{
+	unsigned int n = (unsigned int)(reg - &rdcu->compressor_param1);
+
+	/* the register content is unknown until the write is acknowledged, so
+	 * the next rdcu_sync_compr_param_regs() call writes it again
+	 */
+	rdcu->compr_param_synced_valid &= ~(1UL << n);
+
+	return rdcu_sync(fn, reg, 4);
+}
+
+
 /**
  * @brief sync the Compressor Parameter 1 (write only)
  *
@@ -1963,8 +2062,8 @@ int rdcu_sync_compr_ctrl(void)
 
 int rdcu_sync_compressor_param1(void)
 {
-	return rdcu_sync(rdcu_write_cmd_compressor_param1,
-			 &rdcu->compressor_param1, 4);
+	return rdcu_sync_compr_param_reg(rdcu_write_cmd_compressor_param1,
+					 &rdcu->compressor_param1);
 }
 
 
@@ -1976,8 +2075,8 @@ int rdcu_sync_compressor_param1(void)
 
 int rdcu_sync_compressor_param2(void)
 {
-	return rdcu_sync(rdcu_write_cmd_compressor_param2,
-			 &rdcu->compressor_param2, 4);
+	return rdcu_sync_compr_param_reg(rdcu_write_cmd_compressor_param2,
+					 &rdcu->compressor_param2);
 }
 
 
@@ -1989,8 +2088,8 @@ int rdcu_sync_compressor_param2(void)
 
 int rdcu_sync_adaptive_param1(void)
 {
-	return rdcu_sync(rdcu_write_cmd_adaptive_param1,
-			 &rdcu->adaptive_param1, 4);
+	return rdcu_sync_compr_param_reg(rdcu_write_cmd_adaptive_param1,
+					 &rdcu->adaptive_param1);
 }
 
 
@@ -2002,8 +2101,8 @@ int rdcu_sync_adaptive_param1(void)
 
 int rdcu_sync_adaptive_param2(void)
 {
-	return rdcu_sync(rdcu_write_cmd_adaptive_param2,
-			 &rdcu->adaptive_param2, 4);
+	return rdcu_sync_compr_param_reg(rdcu_write_cmd_adaptive_param2,
+					 &rdcu->adaptive_param2);
 }
 
 
@@ -2015,8 +2114,8 @@ int rdcu_sync_adaptive_param2(void)
 
 int rdcu_sync_data_start_addr(void)
 {
-	return rdcu_sync(rdcu_write_cmd_data_start_addr,
-			 &rdcu->data_start_addr, 4);
+	return rdcu_sync_compr_param_reg(rdcu_write_cmd_data_start_addr,
+					 &rdcu->data_start_addr);
 }
 
 
@@ -2028,8 +2127,8 @@ int rdcu_sync_data_start_addr(void)
 
 int rdcu_sync_model_start_addr(void)
 {
-	return rdcu_sync(rdcu_write_cmd_model_start_addr,
-			 &rdcu->model_start_addr, 4);
+	return rdcu_sync_compr_param_reg(rdcu_write_cmd_model_start_addr,
+					 &rdcu->model_start_addr);
 }
 
 
@@ -2041,8 +2140,8 @@ int rdcu_sync_model_start_addr(void)
 
 int rdcu_sync_num_samples(void)
 {
-	return rdcu_sync(rdcu_write_cmd_num_samples,
-			 &rdcu->num_samples, 4);
+	return rdcu_sync_compr_param_reg(rdcu_write_cmd_num_samples,
+					 &rdcu->num_samples);
 }
 
 
@@ -2054,8 +2153,8 @@ int rdcu_sync_num_samples(void)
 
 int rdcu_sync_new_model_start_addr(void)
 {
-	return rdcu_sync(rdcu_write_cmd_new_model_start_addr,
-			 &rdcu->new_model_start_addr, 4);
+	return rdcu_sync_compr_param_reg(rdcu_write_cmd_new_model_start_addr,
+					 &rdcu->new_model_start_addr);
 }
 
 
@@ -2067,8 +2166,8 @@ int rdcu_sync_new_model_start_addr(void)
 
 int rdcu_sync_compr_data_buf_start_addr(void)
 {
-	return rdcu_sync(rdcu_write_cmd_compr_data_buf_start_addr,
-			 &rdcu->compr_data_buf_start_addr, 4);
+	return rdcu_sync_compr_param_reg(rdcu_write_cmd_compr_data_buf_start_addr,
+					 &rdcu->compr_data_buf_start_addr);
 }
 
 
@@ -2080,8 +2179,78 @@ int rdcu_sync_compr_data_buf_start_addr(void)
 
 int rdcu_sync_compr_data_buf_len(void)
 {
-	return rdcu_sync(rdcu_write_cmd_compr_data_buf_len,
-			 &rdcu->compr_data_buf_len, 4);
+	return rdcu_sync_compr_param_reg(rdcu_write_cmd_compr_data_buf_len,
+					 &rdcu->compr_data_buf_len);
+}
+
+
+/**
+ * @brief sync all changed Data Compressor parameter registers (write only)
+ *
+ * Only registers whose mirror value differs from the value last written to
+ * the RDCU are synced. Since the registers are located at consecutive
+ * addresses, all registers from the first to the last changed one are written
+ * with a single RMAP command. The written values are remembered when the RDCU
+ * acknowledges the write, not when it is submitted.
+ *
+ * @returns 0 on success, otherwise error
+ */
+
+int rdcu_sync_compr_param_regs(void)
+{
+	const uint32_t *regs = &rdcu->compressor_param1;
+	unsigned int first, last, n;
+
+	for (first = 0; first < RDCU_COMPR_PARAM_REGS; first++)
+		if (rdcu_compr_param_reg_is_dirty(first))
+			break;
+
+	if (first == RDCU_COMPR_PARAM_REGS)
+		return 0; /* nothing to do */
+
+	for (last = RDCU_COMPR_PARAM_REGS - 1; last > first; last--)
+		if (rdcu_compr_param_reg_is_dirty(last))
+			break;
+
+	if (!rdcu->compr_param_writes_pending) {
+		rdcu->compr_param_written_mask = 0;
+		rdcu->compr_param_write_failed = 0;
+	}
+
+	for (n = first; n <= last; n++) {
+		rdcu->compr_param_written[n] = regs[n];
+		rdcu->compr_param_written_mask |= 1UL << n;
+		rdcu->compr_param_synced_valid &= ~(1UL << n);
+	}
+	rdcu->compr_param_writes_pending++;
+
+	if (rdcu_sync_block(rdcu_write_cmd_register_block,
+			    COMPR_PARAM_1 + first * 4,
+			    &rdcu->compressor_param1 + first,
+			    (last - first + 1) * 4, 0,
+			    rdcu_compr_param_regs_written, NULL)) {
+		rdcu->compr_param_writes_pending--;
+		rdcu->compr_param_write_failed = 1;
+		return -1;
+	}
+
+	return 0;
+}
+
+
+/**
+ * @brief forget which values were written to the Data Compressor parameter
+ *	registers, so the next rdcu_sync_compr_param_regs() call writes all
+ *	of them
+ *
+ * @note call this after an RDCU reset or a failed synchronisation
+ */
+
+void rdcu_mark_compr_param_regs_dirty(void)
+{
+	rdcu->compr_param_synced_valid = 0;
+	/* ignore the acknowledgement of writes still in flight */
+	rdcu->compr_param_write_failed = 1;
 }
 
 
@@ -2200,6 +2369,25 @@ int rdcu_sync_samples_used(void)
 }
 
 
+/**
+ * @brief sync all Data Compressor information registers (read only)
+ *
+ * The registers from the Used Parameter 1 to the Used Number of Samples
+ * register are located at consecutive addresses and are read with a single
+ * RMAP command.
+ *
+ * @returns 0 on success, otherwise error
+ */
+
+int rdcu_sync_compr_info_regs(void)
+{
+	return rdcu_sync_block(rdcu_read_cmd_register_block, USED_COMPR_PARAM_1,
+			       &rdcu->used_param1,
+			       USED_NUMBER_OF_SAMPLES - USED_COMPR_PARAM_1 + 4, 1,
+			       NULL, NULL);
+}
+
+
 /**
  * @brief sync the SRAM EDAC Control (write only)
  *
@@ -2242,6 +2430,7 @@ int rdcu_sync_sram_edac_status(void)
 int rdcu_sync_mirror_to_sram(uint32_t addr, uint32_t size, uint32_t mtu)
 {
 	int ret;
+	int err = 0;
 
 	uint32_t sent = 0;
 	uint32_t tx_bytes;
@@ -2266,6 +2455,7 @@ int rdcu_sync_mirror_to_sram(uint32_t addr, uint32_t size, uint32_t mtu)
 		return -1;
 
 
+	CMP_TRACE_BEGIN(CMP_TRACE_SRAM_SYNC);
 	tx_bytes = size;
 
 	while (tx_bytes >= mtu) {
@@ -2275,8 +2465,10 @@ int rdcu_sync_mirror_to_sram(uint32_t addr, uint32_t size, uint32_t mtu)
 		if (ret > 0)
 			continue;
 
-		if (ret < 0)
-			return -1;
+		if (ret < 0) {
+			err = -1;
+			goto exit;
+		}
 
 
 		sent     += mtu;
@@ -2289,14 +2481,18 @@ int rdcu_sync_mirror_to_sram(uint32_t addr, uint32_t size, uint32_t mtu)
 		if (ret > 0)
 			continue;
 
-		if (ret < 0)
-			return -1;
+		if (ret < 0) {
+			err = -1;
+			goto exit;
+		}
 
 		tx_bytes = 0;
 	}
+exit:
+	CMP_TRACE_END(CMP_TRACE_SRAM_SYNC);
 
 
-	return 0;
+	return err;
 }
 
 
@@ -2316,6 +2512,7 @@ int rdcu_sync_mirror_to_sram(uint32_t addr, uint32_t size, uint32_t mtu)
 int rdcu_sync_sram_to_mirror(uint32_t addr, uint32_t size, uint32_t mtu)
 {
 	int ret;
+	int err = 0;
 
 	uint32_t recv = 0;
 	uint32_t rx_bytes;
@@ -2340,6 +2537,7 @@ int rdcu_sync_sram_to_mirror(uint32_t addr, uint32_t size, uint32_t mtu)
 		return -1;
 
 
+	CMP_TRACE_BEGIN(CMP_TRACE_SRAM_SYNC);
 	rx_bytes = size;
 
 	while (rx_bytes >= mtu) {
@@ -2355,8 +2553,10 @@ int rdcu_sync_sram_to_mirror(uint32_t addr, uint32_t size, uint32_t mtu)
 		if (ret > 0)
 			continue;
 
-		if (ret < 0)
-			return -1;
+		if (ret < 0) {
+			err = -1;
+			goto exit;
+		}
 
 		recv     += mtu;
 		rx_bytes -= mtu;
@@ -2368,14 +2568,18 @@ int rdcu_sync_sram_to_mirror(uint32_t addr, uint32_t size, uint32_t mtu)
 		if (ret > 0)
 			continue;
 
-		if (ret < 0)
-			return -1;
+		if (ret < 0) {
+			err = -1;
+			goto exit;
+		}
 
 		rx_bytes = 0;
 	}
+exit:
+	CMP_TRACE_END(CMP_TRACE_SRAM_SYNC);
 
 
-	return 0;
+	return err;
 }
 
 
@@ -23,6 +23,12 @@
 #include <stdint.h>
 
 
+/* number of Data Compressor parameter registers (COMPR_PARAM_1 to
+ * COMPR_DATA_BUF_LEN), see rdcu_sync_compr_param_regs()
+ */
+#define RDCU_COMPR_PARAM_REGS	10
+
+
 /**
  * @brief local mirror of the RDCU registers
  */
@@ -77,6 +83,16 @@ struct rdcu_mirror {
 	uint32_t sram_edac_ctrl;		/* RDCU-FRS-FN-1012 */
 	uint32_t sram_edac_status;		/* RDCU-FRS-FN-1032 */
 
+	/* last values written to the Data Compressor parameter registers */
+	uint32_t compr_param_synced[RDCU_COMPR_PARAM_REGS];
+	uint32_t compr_param_synced_valid;	/* bit n: compr_param_synced[n] valid */
+
+	/* Data Compressor parameter register writes not yet acknowledged */
+	uint32_t compr_param_written[RDCU_COMPR_PARAM_REGS];
+	uint32_t compr_param_written_mask;	/* bit n: compr_param_written[n] sent */
+	int compr_param_writes_pending;
+	int compr_param_write_failed;
+
 	uint8_t *sram;				/* RDCU-FRS-FN-0280 */
 };
 
@@ -113,6 +129,9 @@ int rdcu_sync_new_model_start_addr(void);
 int rdcu_sync_compr_data_buf_start_addr(void);
 int rdcu_sync_compr_data_buf_len(void);
 
+int rdcu_sync_compr_param_regs(void);
+void rdcu_mark_compr_param_regs_dirty(void);
+
 int rdcu_sync_used_param1(void);
 int rdcu_sync_used_param2(void);
 int rdcu_sync_compr_data_start_addr(void);
@@ -123,6 +142,8 @@ int rdcu_sync_compr_error(void);
 int rdcu_sync_new_model_addr_used(void);
 int rdcu_sync_samples_used(void);
 
+int rdcu_sync_compr_info_regs(void);
+
 /* SRAM EDAC registers */
 int rdcu_sync_sram_edac_ctrl(void);
 int rdcu_sync_sram_edac_status(void);
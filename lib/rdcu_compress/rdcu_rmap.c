@@ -27,7 +27,12 @@
  * To monitor the synchronisation status, we maintaining a transaction log
  * tracking the submitted command set. Response packets could be processed
  * by interrupt (or thread), but in this variant, we process the return packets
- * when the user calls rdcu_ctrl_sync_status()
+ * when the user calls rdcu_rmap_sync_status(), rdcu_poll() or rdcu_wait()
+ *
+ * A completion callback may be attached to the transactions submitted via
+ * rdcu_rmap_set_completion_cb(). It is called once for every transaction when
+ * its reply has been processed (or found to be faulty), so the caller can
+ * do other work in the meantime and only rdcu_poll() now and then.
  *
  * This is probably the nicest solution when it comes to call overhead, but it
  * requires 8 MiB of memory for the SRAM mirror and the some for the registers.
@@ -68,6 +73,7 @@
 
 #include "../common/byteorder.h"
 #include "../common/cmp_debug.h"
+#include "../common/cmp_trace.h"
 #include "rmap.h"
 #include "rdcu_rmap.h"
 
@@ -94,6 +100,16 @@ static uint32_t (*rmap_rx)(uint8_t *pkt);
 
 static uint32_t data_mtu;	/* maximum data transfer size per unit */
 
+/* optional time source used by rdcu_wait(), see rdcu_rmap_set_timer() */
+static uint64_t (*rmap_get_time_us)(void);
+
+/* rdcu_wait() poll limit without a time source, see rdcu_rmap_set_poll_limit() */
+static uint32_t wait_max_polls = RDCU_WAIT_DEFAULT_POLLS;
+
+/* completion callback attached to newly submitted transactions */
+static rdcu_completion_cb next_cb;
+static void *next_cb_data;
+
 
 
 
@@ -123,13 +139,22 @@ static uint32_t data_mtu;	/* maximum data transfer size per unit */
  * The local (mirror) start address of the requested remote address is stored
  * into the same slot in the "local_addr" array, so we'll know where to put the
  * data if we issue an RMAP_read command. This may be omitted for write
- * commands.
+ * commands. Register data is converted to the host byte order, SRAM data is
+ * stored as is, which is flagged in the "raw" array.
  *
  * Every time a response packet is received, the data (if any) is written to the
  * local address, using the length specified by RMAP packet, so be careful where
  * you place your buffers or registers. On success, the "in_use" slot is cleared
  * and the pending counter is improved.
  *
+ * If a completion callback was set when the slot was grabbed, it is called
+ * with the status of the transaction before the slot is released. The library
+ * itself may attach a second, internal callback ("done") to a transaction,
+ * e.g. to update its mirror bookkeeping once a register write is acknowledged;
+ * it is called before the user callback. Failed
+ * transactions (bad data CRC, non-zero RMAP reply status, ...) are counted
+ * in "failed", which is reported and cleared by rdcu_poll().
+ *
  * XXX: careful, no locking is used on any of the log data, so this is
  * single-thread-use only!
  *
@@ -138,9 +163,15 @@ static uint32_t data_mtu;	/* maximum data transfer size per unit */
 static struct {
 
 	uint8_t  in_use[TRANS_LOG_SIZE];
+	uint8_t  raw[TRANS_LOG_SIZE];
 	void    *local_addr[TRANS_LOG_SIZE];
+	rdcu_completion_cb cb[TRANS_LOG_SIZE];
+	void    *cb_data[TRANS_LOG_SIZE];
+	rdcu_completion_cb done[TRANS_LOG_SIZE];
+	void    *done_data[TRANS_LOG_SIZE];
 
 	int pending;
+	int failed;
 } trans_log;
 
 
@@ -165,7 +196,11 @@ static int trans_log_grab_slot(void *local_addr)
 		/* got one */
 		slot = i;
 		trans_log.in_use[slot] = 1;
+		trans_log.raw[slot] = 0;
 		trans_log.local_addr[slot] = local_addr;
+		trans_log.cb[slot] = next_cb;
+		trans_log.cb_data[slot] = next_cb_data;
+		trans_log.done[slot] = NULL;
 		trans_log.pending++;
 		break;
 	}
@@ -198,6 +233,40 @@ static void trans_log_release_slot(int slot)
 }
 
 
+/**
+ * @brief complete a transaction and release its slot in the transaction log
+ *
+ * @param slot the id of the slot
+ * @param status 0 if the transaction was successful, otherwise error
+ *
+ * @note the internal and the user completion callbacks of the slot (if any)
+ *	 are called before the slot is released
+ */
+
+static void trans_log_complete_slot(int slot, int status)
+{
+	if (slot < 0)
+		return;
+
+	if (slot >= TRANS_LOG_SIZE)
+		return;
+
+	if (!trans_log.in_use[slot])
+		return;
+
+	if (status)
+		trans_log.failed++;
+
+	if (trans_log.done[slot])
+		trans_log.done[slot]((uint16_t)slot, status, trans_log.done_data[slot]);
+
+	if (trans_log.cb[slot])
+		trans_log.cb[slot]((uint16_t)slot, status, trans_log.cb_data[slot]);
+
+	trans_log_release_slot(slot);
+}
+
+
 /**
  * @brief get the local address for a slot
  *
@@ -251,7 +320,9 @@ static int rdcu_process_rx(void)
 		}
 
 		/* read the packet */
+		CMP_TRACE_BEGIN(CMP_TRACE_RMAP_RX);
 		n = rmap_rx(spw_pckt);
+		CMP_TRACE_END(CMP_TRACE_RMAP_RX);
 
 		if (!n) {
 			debug_print("Unknown error in rmap_rx()");
@@ -281,9 +352,16 @@ static int rdcu_process_rx(void)
 			continue;
 		}
 
+		if (rp->status != RMAP_STATUS_SUCCESS) {
+			debug_print("Error: response packet reports RMAP error status %u, transaction dropped", rp->status);
+			trans_log_complete_slot(rp->tr_id, -1);
+			rmap_erase_packet(rp);
+			return -1;
+		}
+
 		if (rp->data_len & 0x3) {
 			debug_print("Error: response packet data size is not a multiple of 4, transaction dropped");
-			trans_log_release_slot(rp->tr_id);
+			trans_log_complete_slot(rp->tr_id, -1);
 			rmap_erase_packet(rp);
 			return -1;
 		}
@@ -291,9 +369,19 @@ static int rdcu_process_rx(void)
 		if (rp->data_len) {
 			uint8_t crc8;
 
+			/* the CRC is calculated over the data as transmitted */
+			crc8 = rmap_crc8(rp->data, rp->data_len);
+			if (crc8 != rp->data_crc) {
+				debug_print("Error: data CRC8 mismatch, data invalid or packet truncated. Transaction dropped");
+
+				trans_log_complete_slot(rp->tr_id, -1);
+				rmap_erase_packet(rp);
+				return -1;
+			}
+
 			/* convert endianness in-place if needed */
 #ifdef __LITTLE_ENDIAN
-			{
+			if (!trans_log.raw[rp->tr_id]) {
 				uint32_t i, tmp;
 
 				for (i = 0; i < rp->data_len; i += sizeof(tmp)) {
@@ -304,20 +392,11 @@ static int rdcu_process_rx(void)
 			}
 #endif /* __LITTLE_ENDIAN */
 
-			crc8 = rmap_crc8(rp->data, rp->data_len);
-			if (crc8 != rp->data_crc) {
-				debug_print("Error: data CRC8 mismatch, data invalid or packet truncated. Transaction dropped");
-
-				trans_log_release_slot(rp->tr_id);
-				rmap_erase_packet(rp);
-				return -1;
-			}
-
 			memcpy(local_addr, rp->data, rp->data_len);
 		}
 
 
-		trans_log_release_slot(rp->tr_id);
+		trans_log_complete_slot(rp->tr_id, 0);
 		rmap_erase_packet(rp);
 	}
 
@@ -339,6 +418,8 @@ static int rdcu_process_rx(void)
 int rdcu_submit_tx(const uint8_t *cmd,  uint32_t cmd_size,
 		   const uint8_t *data, uint32_t data_size)
 {
+	int err;
+
 	/* try to process pending responses */
 	rdcu_process_rx();
 
@@ -348,7 +429,10 @@ int rdcu_submit_tx(const uint8_t *cmd,  uint32_t cmd_size,
 	if (RDCU_CONFIG_DEBUG)
 		debug_print("Transmitting RMAP command");
 
-	if (rmap_tx(cmd, cmd_size, dpath_len, data, data_size)) {
+	CMP_TRACE_BEGIN(CMP_TRACE_RMAP_TX);
+	err = rmap_tx(cmd, cmd_size, dpath_len, data, data_size);
+	CMP_TRACE_END(CMP_TRACE_RMAP_TX);
+	if (err) {
 		debug_print("rmap_tx() returned error!");
 		return -1;
 	}
@@ -453,12 +537,14 @@ int rdcu_sync(int (*fn)(uint16_t trans_id, uint8_t *cmd),
 	n = fn((uint16_t)slot, NULL);
 	if (n <= 0) {
 		debug_print("Error creating command packet");
+		trans_log_release_slot(slot);
 		return -1;
 	}
 
 	rmap_cmd = (uint8_t *)malloc((size_t)n);
 	if (!rmap_cmd) {
 		debug_print("Error allocating rmap cmd");
+		trans_log_release_slot(slot);
 		return -1;
 	}
 
@@ -467,6 +553,7 @@ int rdcu_sync(int (*fn)(uint16_t trans_id, uint8_t *cmd),
 	if (n <= 0) {
 		debug_print("Error creating command packet");
 		free(rmap_cmd);
+		trans_log_release_slot(slot);
 		return -1;
 	}
 
@@ -487,11 +574,78 @@ int rdcu_sync(int (*fn)(uint16_t trans_id, uint8_t *cmd),
 	n = rdcu_submit_tx(rmap_cmd, (uint32_t)n, addr, data_len);
 	free(rmap_cmd);
 
+	/* no reply will arrive for a command that was not sent */
+	if (n)
+		trans_log_release_slot(slot);
+
 	return n;
 }
 
 
 
+/**
+ * @brief generate and submit a data transfer command for a grabbed slot
+ *
+ * @param fn an RDCU data transfer generation function
+ * @param slot the transaction log slot (used as transaction identifier)
+ * @param addr the remote address
+ * @param data the payload to transmit (NULL for read commands)
+ * @param data_len the length of the data to transfer
+ *
+ * @note the slot is released if the command was not sent
+ *
+ * @return 0 on success, otherwise error
+ */
+
+static int rdcu_submit_data_cmd(int (*fn)(uint16_t trans_id, uint8_t *cmd,
+					  uint32_t addr, uint32_t data_len),
+				int slot, uint32_t addr,
+				const void *data, uint32_t data_len)
+{
+	int n;
+
+	uint8_t *rmap_cmd;
+
+
+	/* determine size of command */
+	n = fn((uint16_t)slot, NULL, addr, data_len);
+	if (n <= 0) {
+		debug_print("Error creating command packet");
+		trans_log_release_slot(slot);
+		return -1;
+	}
+
+	rmap_cmd = (uint8_t *)malloc((size_t)n);
+	if (!rmap_cmd) {
+		debug_print("Error allocating rmap cmd");
+		trans_log_release_slot(slot);
+		return -1;
+	}
+
+	/* now fill actual command */
+	n = fn((uint16_t)slot, rmap_cmd, addr, data_len);
+	if (n <= 0) {
+		debug_print("Error creating command packet");
+		free(rmap_cmd);
+		trans_log_release_slot(slot);
+		return -1;
+	}
+
+	if (data)
+		n = rdcu_submit_tx(rmap_cmd, (uint32_t)n, data, data_len);
+	else
+		n = rdcu_submit_tx(rmap_cmd, (uint32_t)n, NULL, 0);
+
+	free(rmap_cmd);
+
+	/* no reply will arrive for a command that was not sent */
+	if (n)
+		trans_log_release_slot(slot);
+
+	return n;
+}
+
+
 /**
  * @brief submit a data sync command
  *
@@ -514,10 +668,8 @@ int rdcu_sync_data(int (*fn)(uint16_t trans_id, uint8_t *cmd,
 			     uint32_t addr, uint32_t data_len),
 		   uint32_t addr, void *data, uint32_t data_len, int read)
 {
-	int n;
 	int slot;
 
-	uint8_t *rmap_cmd;
 
 	rdcu_process_rx();
 
@@ -528,37 +680,70 @@ int rdcu_sync_data(int (*fn)(uint16_t trans_id, uint8_t *cmd,
 		return 1;
 	}
 
+	/* the SRAM mirror holds the big-endian data as is */
+	trans_log.raw[slot] = 1;
 
-	/* determine size of command */
-	n = fn((uint16_t)slot, NULL, addr, data_len);
-	if (n <= 0) {
-		debug_print("Error creating command packet");
-		return -1;
-	}
+	return rdcu_submit_data_cmd(fn, slot, addr, read ? NULL : data, data_len);
+}
 
 
-	rmap_cmd = (uint8_t *)malloc((size_t)n);
-	if (!rmap_cmd) {
-		debug_print("Error allocating rmap cmd");
+
+/**
+ * @brief submit a sync command for a block of consecutive registers
+ *
+ * @param fn an RDCU register block command generation function
+ * @param addr the remote address of the first register
+ * @param local the local (mirror) address of the first register
+ * @param data_len the length of the register block in bytes
+ * @param read 0: write, otherwise read
+ * @param done internal callback called when the transaction completes (may
+ *	  be NULL); it does not replace the user completion callback
+ * @param done_data data passed to the done callback
+ *
+ * @note data_len must be a multiple of 4
+ * @note unlike rdcu_sync_data(), all data is treated (and byte swapped) as 32
+ *	 bit words, just like in rdcu_sync()
+ *
+ * @return 0 on success, otherwise error
+ */
+
+int rdcu_sync_block(int (*fn)(uint16_t trans_id, uint8_t *cmd,
+			      uint32_t addr, uint32_t data_len),
+		    uint32_t addr, void *local, uint32_t data_len, int read,
+		    rdcu_completion_cb done, void *done_data)
+{
+	int slot;
+	void *data = NULL;
+
+
+	if (!data_len || data_len & 0x3)
 		return -1;
-	}
 
-	/* now fill actual command */
-	n = fn((uint16_t)slot, rmap_cmd, addr, data_len);
-	if (n <= 0) {
-		debug_print("Error creating command packet");
-		free(rmap_cmd);
+	slot = trans_log_grab_slot(local);
+	if (slot < 0 || slot > UINT16_MAX)
 		return -1;
-	}
 
-	if (read)
-		n = rdcu_submit_tx(rmap_cmd, (uint32_t)n, NULL, 0);
-	else
-		n = rdcu_submit_tx(rmap_cmd, (uint32_t)n, data, data_len);
+	trans_log.done[slot] = done;
+	trans_log.done_data[slot] = done_data;
 
-	free(rmap_cmd);
+	if (!read) {
+		data = local;
+		/* convert endianness if needed */
+#ifdef __LITTLE_ENDIAN
+		{
+			uint32_t i;
+			uint32_t *tmp_buf = alloca(data_len);
+			uint32_t *p = (uint32_t *)local;
 
-	return n;
+			for (i = 0; i < (data_len / 4); i++)
+				tmp_buf[i] = cpu_to_be32(p[i]);
+
+			data = tmp_buf;
+		}
+#endif /* __LITTLE_ENDIAN */
+	}
+
+	return rdcu_submit_data_cmd(fn, slot, addr, data, data_len);
 }
 
 
@@ -774,14 +959,153 @@ int rdcu_rmap_sync_status(void)
 }
 
 
+/**
+ * @brief process pending RMAP replies without blocking
+ *
+ * @returns the number of transactions still pending (0: synchronised) or -1
+ *	if a transaction failed since the last call of rdcu_poll() or
+ *	rdcu_wait()
+ */
+
+int rdcu_poll(void)
+{
+	int err = 0;
+
+	if (rdcu_process_rx() < 0)
+		err = 1;
+
+	if (trans_log.failed) {
+		trans_log.failed = 0;
+		err = 1;
+	}
+
+	if (err)
+		return -1;
+
+	return trans_log.pending;
+}
+
+
+/**
+ * @brief wait until all pending RMAP transactions are completed
+ *
+ * @param timeout_us	maximum time to wait in microseconds; only used if a
+ *			timer was set with rdcu_rmap_set_timer()
+ *
+ * @returns 0 when all transactions are completed successfully; -1 if a
+ *	transaction failed or the timeout expired
+ *
+ * @note without a timer, rdcu_wait() gives up after the number of rdcu_poll()
+ *	 rounds set with rdcu_rmap_set_poll_limit() (RDCU_WAIT_DEFAULT_POLLS by
+ *	 default), as there is no way to measure the time
+ *
+ * @note on a timeout, the unanswered transactions stay in the transaction log,
+ *	 a late reply is still processed; use rdcu_rmap_reset_log() to drop them
+ */
+
+int rdcu_wait(uint32_t timeout_us)
+{
+	uint64_t start = 0;
+	uint64_t elapsed = 0;
+	uint64_t limit = wait_max_polls;
+
+	if (rmap_get_time_us) {
+		start = rmap_get_time_us();
+		limit = timeout_us;
+	}
+
+	while (1) {
+		int pending = rdcu_poll();
+
+		if (pending < 0) {
+			debug_print("Error: RMAP transaction failed.");
+			return -1;
+		}
+		if (!pending)
+			return 0;
+
+		if (rmap_get_time_us)
+			elapsed = rmap_get_time_us() - start;
+		else
+			elapsed++;
+
+		if (elapsed >= limit) {
+			debug_print("Error: timeout, %d RMAP transactions still pending.", pending);
+			return -1;
+		}
+	}
+}
+
+
+/**
+ * @brief set the completion callback for subsequently submitted transactions
+ *
+ * @param cb	function called with the transaction identifier, the status
+ *		(0 on success, otherwise error) and the user data when the
+ *		transaction completes (NULL to disable)
+ * @param data	user data passed to the callback
+ *
+ * @note the callback is stored per transaction, changing it does not affect
+ *	 transactions already submitted
+ */
+
+void rdcu_rmap_set_completion_cb(rdcu_completion_cb cb, void *data)
+{
+	next_cb = cb;
+	next_cb_data = data;
+}
+
+
+/**
+ * @brief set the time source used for the rdcu_wait() timeout
+ *
+ * @param get_time_us	function returning a monotonic time in microseconds
+ *			(NULL to use the poll limit instead, see
+ *			rdcu_rmap_set_poll_limit())
+ */
+
+void rdcu_rmap_set_timer(uint64_t (*get_time_us)(void))
+{
+	rmap_get_time_us = get_time_us;
+}
+
+
+/**
+ * @brief set the maximum number of rdcu_poll() rounds of rdcu_wait() if no
+ *	timer is set
+ *
+ * @param max_polls	maximum number of poll rounds (0: RDCU_WAIT_DEFAULT_POLLS)
+ */
+
+void rdcu_rmap_set_poll_limit(uint32_t max_polls)
+{
+	if (!max_polls)
+		max_polls = RDCU_WAIT_DEFAULT_POLLS;
+
+	wait_max_polls = max_polls;
+}
+
+
 /**
  * @brief reset all entries in the RMAP transaction log
+ *
+ * @note the internal callbacks of dropped transactions are called with an
+ *	 error status, the user completion callbacks are not called
  */
 
 void rdcu_rmap_reset_log(void)
 {
+	int i;
+
+	for (i = 0; i < TRANS_LOG_SIZE; i++)
+		if (trans_log.in_use[i] && trans_log.done[i])
+			trans_log.done[i]((uint16_t)i, -1, trans_log.done_data[i]);
+
 	memset(trans_log.in_use, 0, sizeof(trans_log.in_use));  /* clear in_use buffer */
+	memset(trans_log.cb, 0, sizeof(trans_log.cb));
+	memset(trans_log.done, 0, sizeof(trans_log.done));
 	trans_log.pending = 0;
+	trans_log.failed = 0;
 }
 
 
@@ -22,6 +22,20 @@
 #include <stdint.h>
 
 
+/* default rdcu_wait() poll limit without a timer, see rdcu_rmap_set_poll_limit() */
+#define RDCU_WAIT_DEFAULT_POLLS	1000000UL
+
+
+/**
+ * @brief RMAP transaction completion callback
+ *
+ * @param tr_id		transaction identifier of the completed transaction
+ * @param status	0 on success, otherwise error
+ * @param data		user data given to rdcu_rmap_set_completion_cb()
+ */
+
+typedef void (*rdcu_completion_cb)(uint16_t tr_id, int status, void *data);
+
 
 int rdcu_submit_tx(const uint8_t *cmd,  uint32_t cmd_size,
 		   const uint8_t *data, uint32_t data_size);
@@ -38,6 +52,11 @@ int rdcu_sync_data(int (*fn)(uint16_t trans_id, uint8_t *cmd,
 			     uint32_t addr, uint32_t data_len),
 		   uint32_t addr, void *data, uint32_t data_len, int read);
 
+int rdcu_sync_block(int (*fn)(uint16_t trans_id, uint8_t *cmd,
+			      uint32_t addr, uint32_t data_len),
+		    uint32_t addr, void *local, uint32_t data_len, int read,
+		    rdcu_completion_cb done, void *done_data);
+
 uint32_t rdcu_package(uint8_t *blob,
 		      const uint8_t *cmd, uint32_t cmd_size,
 		      const uint8_t non_crc_bytes,
@@ -53,6 +72,13 @@ uint32_t rdcu_get_data_mtu(void);
 
 int rdcu_rmap_sync_status(void);
 
+int rdcu_poll(void);
+int rdcu_wait(uint32_t timeout_us);
+
+void rdcu_rmap_set_completion_cb(rdcu_completion_cb cb, void *data);
+void rdcu_rmap_set_timer(uint64_t (*get_time_us)(void));
+void rdcu_rmap_set_poll_limit(uint32_t max_polls);
+
 void rdcu_rmap_reset_log(void);
 
 int rdcu_rmap_init(uint32_t mtu,
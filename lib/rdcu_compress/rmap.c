@@ -488,6 +488,7 @@ struct rmap_pkt *rmap_pkt_from_buffer(uint8_t *buf, uint32_t len)
 {
 	size_t n = 0;
 	size_t i;
+	size_t hdr_crc_pos;
 	int min_hdr_size;
 
 	struct rmap_pkt *pkt = NULL;
@@ -565,7 +566,14 @@ struct rmap_pkt *rmap_pkt_from_buffer(uint8_t *buf, uint32_t len)
 				 (uint32_t)buf[RMAP_DATALEN_BYTE2 + n];
 	}
 
-	pkt->hdr_crc  = buf[RMAP_HEADER_CRC];
+	/* write replies end right after the transaction identifier */
+	if (!pkt->ri.cmd_resp && (pkt->ri.cmd & RMAP_CMD_BIT_WRITE))
+		hdr_crc_pos = RMAP_HDR_MIN_SIZE_WRITE_REP;
+	else
+		hdr_crc_pos = RMAP_HEADER_CRC + n;
+
+	if (hdr_crc_pos < len)
+		pkt->hdr_crc = buf[hdr_crc_pos];
 
 	if (pkt->data_len) {
 		size_t pkt_size = RMAP_DATA_START + n + pkt->data_len + 1; /* +1 for data CRC */
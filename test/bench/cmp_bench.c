@@ -0,0 +1,735 @@
+/**
+ * @file cmp_bench.c
+ * @date 2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief chunk compression and decompression throughput benchmark
+ *
+ * For every chunk type a representative chunk is generated and compressed
+ * with compress_chunk() and decompressed with decompress_cmp_entiy() in raw,
+ * 1d-differencing and model mode. The results are printed as CSV to stdout,
+ * one line per chunk type, compression mode and operation.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#  define HAS_CYCLE_COUNTER 1
+#endif
+
+#include "../test_common/pcg_basic.h"
+
+#include <cmp_chunk.h>
+#include <cmp_data_types.h>
+#include <cmp_entity.h>
+#include <decmp.h>
+
+
+#define BENCH_DEFAULT_SEED	0x5EEDC0DEULL
+#define BENCH_DEFAULT_TIME_MS	200
+#define BENCH_MIN_RUNS		3
+
+#define BENCH_GOLOMB_PAR	8
+#define BENCH_MODEL_VALUE	11
+
+#define ARRAY_SIZE(x) (sizeof(x)/sizeof((x)[0]))
+
+
+/* directories to write fuzzer seed corpora to; NULL if not used */
+static const char *chunk_corpus_dir;
+static const char *entity_corpus_dir;
+
+
+/**
+ * @brief collections of the same data type in a benchmark chunk
+ */
+
+struct bench_col {
+	enum cmp_data_type data_type;
+	uint32_t samples;	/**< number of samples per collection */
+	uint32_t num_col;	/**< number of collections of this type */
+};
+
+
+/**
+ * @brief definition of a benchmark chunk
+ */
+
+struct bench_chunk {
+	const char *name;
+	const struct bench_col *cols;
+	size_t num_cols;
+};
+
+
+static const struct bench_col ncam_imagette_cols[] = {
+	{DATA_TYPE_IMAGETTE, 2000, 16}
+};
+
+static const struct bench_col sat_imagette_cols[] = {
+	{DATA_TYPE_SAT_IMAGETTE, 2000, 16}
+};
+
+static const struct bench_col short_cadence_cols[] = {
+	{DATA_TYPE_S_FX, 1000, 4},
+	{DATA_TYPE_S_FX_EFX, 1000, 4},
+	{DATA_TYPE_S_FX_NCOB, 1000, 4},
+	{DATA_TYPE_S_FX_EFX_NCOB_ECOB, 1000, 4}
+};
+
+static const struct bench_col long_cadence_cols[] = {
+	{DATA_TYPE_L_FX, 1000, 2},
+	{DATA_TYPE_L_FX_EFX, 1000, 2},
+	{DATA_TYPE_L_FX_NCOB, 1000, 2},
+	{DATA_TYPE_L_FX_EFX_NCOB_ECOB, 1000, 2}
+};
+
+static const struct bench_col fast_cadence_cols[] = {
+	{DATA_TYPE_F_FX, 1000, 4},
+	{DATA_TYPE_F_FX_EFX, 1000, 4},
+	{DATA_TYPE_F_FX_NCOB, 1000, 4},
+	{DATA_TYPE_F_FX_EFX_NCOB_ECOB, 1000, 4}
+};
+
+static const struct bench_col offset_background_cols[] = {
+	{DATA_TYPE_OFFSET, 1000, 4},
+	{DATA_TYPE_BACKGROUND, 1000, 4}
+};
+
+static const struct bench_col smearing_cols[] = {
+	{DATA_TYPE_SMEARING, 1000, 8}
+};
+
+static const struct bench_col f_chain_cols[] = {
+	{DATA_TYPE_F_CAM_IMAGETTE, 2000, 8},
+	{DATA_TYPE_F_CAM_OFFSET, 1000, 2},
+	{DATA_TYPE_F_CAM_BACKGROUND, 1000, 2}
+};
+
+#define BENCH_CHUNK(name, cols) {name, cols, ARRAY_SIZE(cols)}
+
+static const struct bench_chunk bench_chunks[] = {
+	BENCH_CHUNK("ncam_imagette", ncam_imagette_cols),
+	BENCH_CHUNK("sat_imagette", sat_imagette_cols),
+	BENCH_CHUNK("short_cadence", short_cadence_cols),
+	BENCH_CHUNK("long_cadence", long_cadence_cols),
+	BENCH_CHUNK("fast_cadence", fast_cadence_cols),
+	BENCH_CHUNK("offset_background", offset_background_cols),
+	BENCH_CHUNK("smearing", smearing_cols),
+	BENCH_CHUNK("f_chain", f_chain_cols)
+};
+
+
+static const struct {
+	const char *name;
+	enum cmp_mode cmp_mode;
+} bench_modes[] = {
+	{"raw", CMP_MODE_RAW},
+	{"diff", CMP_MODE_DIFF_MULTI},
+	{"model", CMP_MODE_MODEL_MULTI}
+};
+
+
+/**
+ * @brief byte sizes of the fields of a sample of the different data types
+ *
+ * A field size of 1 or 3 bytes marks the exposure flags of the short and long
+ * cadence data types.
+ */
+
+static const uint8_t ima_fields[] = {2};
+static const uint8_t offset_fields[] = {4, 4};
+static const uint8_t background_fields[] = {4, 4, 2};
+static const uint8_t smearing_fields[] = {4, 4, 2};
+static const uint8_t s_fx_fields[] = {1, 4};
+static const uint8_t s_fx_efx_fields[] = {1, 4, 4};
+static const uint8_t s_fx_ncob_fields[] = {1, 4, 4, 4};
+static const uint8_t s_fx_efx_ncob_ecob_fields[] = {1, 4, 4, 4, 4, 4, 4};
+static const uint8_t l_fx_fields[] = {3, 4, 4};
+static const uint8_t l_fx_efx_fields[] = {3, 4, 4, 4};
+static const uint8_t l_fx_ncob_fields[] = {3, 4, 4, 4, 4, 4, 4};
+static const uint8_t l_fx_efx_ncob_ecob_fields[] = {3, 4, 4, 4, 4, 4, 4, 4, 4, 4};
+static const uint8_t f_fx_fields[] = {4};
+static const uint8_t f_fx_efx_fields[] = {4, 4};
+static const uint8_t f_fx_ncob_fields[] = {4, 4, 4};
+static const uint8_t f_fx_efx_ncob_ecob_fields[] = {4, 4, 4, 4, 4, 4};
+
+
+/**
+ * @brief get the field layout of a sample
+ *
+ * @param data_type	data type of the sample
+ * @param num_fields	pointer to store the number of fields
+ *
+ * @returns a pointer to the field sizes; NULL for unsupported data types
+ */
+
+static const uint8_t *get_sample_fields(enum cmp_data_type data_type,
+					size_t *num_fields)
+{
+	const uint8_t *fields;
+
+#define SET_FIELDS(x) do { fields = x; *num_fields = ARRAY_SIZE(x); } while (0)
+	switch (data_type) {
+	case DATA_TYPE_IMAGETTE:
+	case DATA_TYPE_SAT_IMAGETTE:
+	case DATA_TYPE_F_CAM_IMAGETTE:
+		SET_FIELDS(ima_fields);
+		break;
+	case DATA_TYPE_OFFSET:
+	case DATA_TYPE_F_CAM_OFFSET:
+		SET_FIELDS(offset_fields);
+		break;
+	case DATA_TYPE_BACKGROUND:
+	case DATA_TYPE_F_CAM_BACKGROUND:
+		SET_FIELDS(background_fields);
+		break;
+	case DATA_TYPE_SMEARING:
+		SET_FIELDS(smearing_fields);
+		break;
+	case DATA_TYPE_S_FX:
+		SET_FIELDS(s_fx_fields);
+		break;
+	case DATA_TYPE_S_FX_EFX:
+		SET_FIELDS(s_fx_efx_fields);
+		break;
+	case DATA_TYPE_S_FX_NCOB:
+		SET_FIELDS(s_fx_ncob_fields);
+		break;
+	case DATA_TYPE_S_FX_EFX_NCOB_ECOB:
+		SET_FIELDS(s_fx_efx_ncob_ecob_fields);
+		break;
+	case DATA_TYPE_L_FX:
+		SET_FIELDS(l_fx_fields);
+		break;
+	case DATA_TYPE_L_FX_EFX:
+		SET_FIELDS(l_fx_efx_fields);
+		break;
+	case DATA_TYPE_L_FX_NCOB:
+		SET_FIELDS(l_fx_ncob_fields);
+		break;
+	case DATA_TYPE_L_FX_EFX_NCOB_ECOB:
+		SET_FIELDS(l_fx_efx_ncob_ecob_fields);
+		break;
+	case DATA_TYPE_F_FX:
+		SET_FIELDS(f_fx_fields);
+		break;
+	case DATA_TYPE_F_FX_EFX:
+		SET_FIELDS(f_fx_efx_fields);
+		break;
+	case DATA_TYPE_F_FX_NCOB:
+		SET_FIELDS(f_fx_ncob_fields);
+		break;
+	case DATA_TYPE_F_FX_EFX_NCOB_ECOB:
+		SET_FIELDS(f_fx_efx_ncob_ecob_fields);
+		break;
+	default:
+		fields = NULL;
+		*num_fields = 0;
+		break;
+	}
+#undef SET_FIELDS
+
+	return fields;
+}
+
+
+/**
+ * @brief generate a random number following a geometric distribution
+ *
+ * @param rng	pointer to the random number generator state
+ * @param p	probability of geometric distribution (0 < p < 1)
+ *
+ * @returns random number following a geometric distribution
+ */
+
+static uint32_t rand_geometric(pcg32_random_t *rng, double p)
+{
+	double u = ldexp(pcg32_random_r(rng), -32);
+
+	if (u <= 0)
+		return 0;
+	return (uint32_t)(log(u) / log(1 - p));
+}
+
+
+/**
+ * @brief write a sample field in CPU endianness
+ */
+
+static void put_field(uint8_t *p, unsigned int size, uint32_t value)
+{
+	switch (size) {
+	case 1:
+		*p = (uint8_t)value;
+		break;
+	case 2: {
+		uint16_t v = (uint16_t)value;
+
+		memcpy(p, &v, sizeof(v));
+		break;
+	}
+	case 3: /* exp_flags of the long cadence entries */
+		((struct l_fx *)p)->exp_flags = value & 0xFFFFFF;
+		break;
+	default:
+		memcpy(p, &value, sizeof(value));
+		break;
+	}
+}
+
+
+/**
+ * @brief generate the science data of a collection
+ *
+ * Every field of a sample is modelled as a constant level plus geometric
+ * distributed noise with a random sign; the exposure flags are uniformly
+ * distributed over two flags. The levels are taken from level_rng so that a
+ * chunk and its model can be generated with the same levels but different
+ * noise.
+ *
+ * @param data		pointer to the science data of the collection
+ * @param data_type	data type of the collection
+ * @param samples	number of samples to generate
+ * @param level_rng	generator for the signal levels
+ * @param noise_rng	generator for the noise
+ *
+ * @returns 0 on success, -1 on error
+ */
+
+static int gen_col_data(uint8_t *data, enum cmp_data_type data_type, uint32_t samples,
+			pcg32_random_t *level_rng, pcg32_random_t *noise_rng)
+{
+	uint32_t level[16];
+	size_t num_fields, j, sample_size = 0;
+	const uint8_t *fields = get_sample_fields(data_type, &num_fields);
+	uint32_t i;
+
+	if (!fields || num_fields > ARRAY_SIZE(level))
+		return -1;
+
+	for (j = 0; j < num_fields; j++) {
+		unsigned int bits = fields[j] * 8U;
+
+		if (bits > 16)
+			bits = 16;
+		level[j] = pcg32_boundedrand_r(level_rng, 1U << (bits - 1));
+		sample_size += fields[j];
+	}
+	if (sample_size != size_of_a_sample(data_type))
+		return -1;
+
+	for (i = 0; i < samples; i++) {
+		for (j = 0; j < num_fields; j++) {
+			uint32_t v;
+
+			if (fields[j] == 1 || fields[j] == 3) {
+				v = pcg32_boundedrand_r(noise_rng, 4);
+			} else {
+				uint32_t noise = rand_geometric(noise_rng, 0.125);
+
+				if (pcg32_random_r(noise_rng) & 1)
+					v = level[j] + noise;
+				else
+					v = level[j] > noise ? level[j] - noise : 0;
+			}
+			put_field(data, fields[j], v);
+			data += fields[j];
+		}
+	}
+	return 0;
+}
+
+
+/**
+ * @brief generate a benchmark chunk
+ *
+ * @param chunk		pointer to the chunk buffer; if NULL only the chunk
+ *			size is calculated
+ * @param def		definition of the chunk
+ * @param level_seed	seed for the signal levels of the collections
+ * @param noise_rng	generator for the noise
+ * @param samples	pointer to store the number of samples in the chunk
+ *			(can be NULL)
+ *
+ * @returns the size of the chunk in bytes; 0 on error
+ */
+
+static uint32_t gen_chunk(uint8_t *chunk, const struct bench_chunk *def,
+			  uint64_t level_seed, pcg32_random_t *noise_rng,
+			  uint32_t *samples)
+{
+	pcg32_random_t level_rng;
+	uint32_t chunk_size = 0, num_samples = 0;
+	uint8_t sequence_num = 0;
+	size_t c;
+
+	pcg32_srandom_r(&level_rng, level_seed, 0);
+
+	for (c = 0; c < def->num_cols; c++) {
+		const struct bench_col *bcol = &def->cols[c];
+		size_t data_size = size_of_a_sample(bcol->data_type) * bcol->samples;
+		uint32_t n;
+
+		if (data_size > UINT16_MAX)
+			return 0;
+
+		for (n = 0; n < bcol->num_col; n++) {
+			if (chunk) {
+				struct collection_hdr *col = (struct collection_hdr *)(chunk + chunk_size);
+
+				memset(col, 0, COLLECTION_HDR_SIZE);
+				if (cmp_col_set_timestamp(col, 0x150D15AB1ED) ||
+				    cmp_col_set_pkt_type(col, COL_SCI_PKTS_TYPE) ||
+				    cmp_col_set_subservice(col, convert_cmp_data_type_to_subservice(bcol->data_type)) ||
+				    cmp_col_set_sequence_num(col, sequence_num++) ||
+				    cmp_col_set_data_length(col, (uint16_t)data_size))
+					return 0;
+				if (gen_col_data((uint8_t *)col->entry, bcol->data_type,
+						 bcol->samples, &level_rng, noise_rng))
+					return 0;
+			}
+			chunk_size += COLLECTION_HDR_SIZE + (uint32_t)data_size;
+			num_samples += bcol->samples;
+		}
+	}
+
+	if (samples)
+		*samples = num_samples;
+	return chunk_size;
+}
+
+
+/**
+ * @brief set the same Golomb parameter for all chunk types
+ */
+
+static void set_bench_cmp_par(struct cmp_par *par, enum cmp_mode cmp_mode)
+{
+	unsigned int i;
+
+	memset(par, 0, sizeof(*par));
+	par->cmp_mode = cmp_mode;
+	par->model_value = BENCH_MODEL_VALUE;
+	par->lossy_par = 0;
+
+	for (i = 0; i < CMP_PAR_NUM_SPECIFIC; i++)
+		*cmp_par_specific(par, i) = BENCH_GOLOMB_PAR;
+}
+
+
+/**
+ * @brief write a seed corpus file; the buffers are written one after another
+ *
+ * @returns 0 on success, -1 on error
+ */
+
+static int write_corpus_file(const char *dir, const char *name,
+			     const void *buf1, size_t size1,
+			     const void *buf2, size_t size2)
+{
+	char path[4096];
+	FILE *fp;
+	int err = 0;
+
+	snprintf(path, sizeof(path), "%s/%s.bin", dir, name);
+	fp = fopen(path, "wb");
+	if (!fp) {
+		perror(path);
+		return -1;
+	}
+	if (fwrite(buf1, 1, size1, fp) != size1)
+		err = -1;
+	if (buf2 && fwrite(buf2, 1, size2, fp) != size2)
+		err = -1;
+	if (fclose(fp))
+		err = -1;
+	if (err)
+		perror(path);
+
+	return err;
+}
+
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+static uint64_t now_cycles(void)
+{
+#ifdef HAS_CYCLE_COUNTER
+	/* note: the TSC ticks at a constant reference rate */
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+
+/**
+ * @brief timing result of a benchmarked operation
+ */
+
+struct bench_result {
+	uint64_t ns;		/**< fastest run in nanoseconds */
+	uint64_t cycles;	/**< cycles of the fastest run */
+};
+
+
+struct bench_ctx {
+	const uint8_t *chunk;
+	const uint8_t *model;
+	uint8_t *up_model;
+	uint8_t *decmp;
+	uint32_t chunk_size;
+	uint32_t *dst;
+	uint32_t dst_capacity;
+	const struct cmp_par *par;
+	uint32_t cmp_size;
+};
+
+
+static int run_compress(struct bench_ctx *ctx)
+{
+	ctx->cmp_size = compress_chunk(ctx->chunk, ctx->chunk_size, ctx->model,
+				       ctx->up_model, ctx->dst, ctx->dst_capacity,
+				       ctx->par);
+	return cmp_is_error(ctx->cmp_size) ? -1 : 0;
+}
+
+
+static int run_decompress(struct bench_ctx *ctx)
+{
+	const void *ent = ctx->dst;
+	int size = decompress_cmp_entiy(ent, ctx->model, ctx->up_model, ctx->decmp);
+
+	return size == (int)ctx->chunk_size ? 0 : -1;
+}
+
+
+/**
+ * @brief run an operation repeatedly and record the fastest run
+ *
+ * @param op		operation to benchmark
+ * @param ctx		benchmark context passed to the operation
+ * @param min_time_ns	minimum total benchmark time
+ * @param res		pointer to store the result
+ *
+ * @returns 0 on success, -1 if the operation failed
+ */
+
+static int bench_op(int (*op)(struct bench_ctx *), struct bench_ctx *ctx,
+		    uint64_t min_time_ns, struct bench_result *res)
+{
+	uint64_t start = now_ns();
+	unsigned int runs = 0;
+
+	res->ns = UINT64_MAX;
+	res->cycles = 0;
+
+	do {
+		uint64_t t0 = now_ns();
+		uint64_t c0 = now_cycles();
+		uint64_t t, c;
+
+		if (op(ctx))
+			return -1;
+
+		c = now_cycles() - c0;
+		t = now_ns() - t0;
+		if (t < res->ns) {
+			res->ns = t;
+			res->cycles = c;
+		}
+		runs++;
+	} while (runs < BENCH_MIN_RUNS || now_ns() - start < min_time_ns);
+
+	if (res->ns == 0)
+		res->ns = 1;
+	return 0;
+}
+
+
+static void print_result(const char *chunk_name, const char *mode_name,
+			 const char *op_name, uint32_t samples,
+			 uint32_t chunk_size, uint32_t cmp_size,
+			 const struct bench_result *res)
+{
+	printf("%s,%s,%s,%u,%u,%u,%.3f,%.2f,%.3f,", chunk_name, mode_name,
+	       op_name, samples, chunk_size, cmp_size,
+	       (double)chunk_size / cmp_size,
+	       (double)chunk_size * 1e3 / (double)res->ns,
+	       (double)res->ns / samples);
+#ifdef HAS_CYCLE_COUNTER
+	printf("%.2f\n", (double)res->cycles / samples);
+#else
+	printf("NA\n");
+#endif
+}
+
+
+/**
+ * @brief benchmark a chunk in all compression modes
+ *
+ * @returns 0 on success, -1 on error
+ */
+
+static int bench_chunk(const struct bench_chunk *def, uint64_t seed,
+		       uint64_t min_time_ns)
+{
+	pcg32_random_t noise_rng;
+	uint8_t *chunk, *model, *up_model, *decmp;
+	uint32_t *dst;
+	uint32_t chunk_size, samples, bound;
+	size_t m;
+	int err = -1;
+
+	chunk_size = gen_chunk(NULL, def, seed, NULL, &samples);
+	if (!chunk_size)
+		return -1;
+
+	chunk = malloc(chunk_size);
+	model = malloc(chunk_size);
+	up_model = malloc(chunk_size);
+	decmp = malloc(chunk_size);
+	dst = NULL;
+	if (!chunk || !model || !up_model || !decmp)
+		goto out;
+
+	/* the model shares the signal levels of the data but not the noise */
+	pcg32_srandom_r(&noise_rng, seed, 1);
+	if (!gen_chunk(chunk, def, seed, &noise_rng, NULL))
+		goto out;
+	if (!gen_chunk(model, def, seed, &noise_rng, NULL))
+		goto out;
+	if (chunk_corpus_dir &&
+	    write_corpus_file(chunk_corpus_dir, def->name, chunk, chunk_size, NULL, 0))
+		goto out;
+
+	bound = compress_chunk_cmp_size_bound(chunk, chunk_size);
+	if (cmp_is_error(bound))
+		goto out;
+	dst = malloc(bound);
+	if (!dst)
+		goto out;
+
+	for (m = 0; m < ARRAY_SIZE(bench_modes); m++) {
+		struct cmp_par par;
+		struct bench_ctx ctx;
+		struct bench_result res;
+		int model_mode = model_mode_is_used(bench_modes[m].cmp_mode);
+
+		set_bench_cmp_par(&par, bench_modes[m].cmp_mode);
+
+		ctx.chunk = chunk;
+		ctx.model = model_mode ? model : NULL;
+		ctx.up_model = model_mode ? up_model : NULL;
+		ctx.decmp = decmp;
+		ctx.chunk_size = chunk_size;
+		ctx.dst = dst;
+		ctx.dst_capacity = bound;
+		ctx.par = &par;
+
+		if (bench_op(run_compress, &ctx, min_time_ns, &res)) {
+			fprintf(stderr, "%s %s: compression failed: %s\n", def->name,
+				bench_modes[m].name, cmp_get_error_name(ctx.cmp_size));
+			goto out;
+		}
+		print_result(def->name, bench_modes[m].name, "compress", samples,
+			     chunk_size, ctx.cmp_size, &res);
+
+		/* the model follows the entity in the decompression corpus */
+		if (entity_corpus_dir) {
+			char name[256];
+
+			snprintf(name, sizeof(name), "%s_%s", def->name, bench_modes[m].name);
+			if (write_corpus_file(entity_corpus_dir, name, dst, ctx.cmp_size,
+					      ctx.model, chunk_size))
+				goto out;
+		}
+
+		if (bench_op(run_decompress, &ctx, min_time_ns, &res) ||
+		    memcmp(chunk, decmp, chunk_size)) {
+			fprintf(stderr, "%s %s: decompression failed\n", def->name,
+				bench_modes[m].name);
+			goto out;
+		}
+		print_result(def->name, bench_modes[m].name, "decompress", samples,
+			     chunk_size, ctx.cmp_size, &res);
+	}
+	err = 0;
+
+out:
+	free(chunk);
+	free(model);
+	free(up_model);
+	free(decmp);
+	free(dst);
+	return err;
+}
+
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "usage: %s [-s seed] [-t min_time_ms] [-c chunk_corpus_dir] [-e entity_corpus_dir]\n", prog);
+}
+
+
+int main(int argc, char *argv[])
+{
+	uint64_t seed = BENCH_DEFAULT_SEED;
+	unsigned long time_ms = BENCH_DEFAULT_TIME_MS;
+	size_t i;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "s:t:c:e:h")) != -1) {
+		switch (opt) {
+		case 's':
+			seed = strtoull(optarg, NULL, 0);
+			break;
+		case 't':
+			time_ms = strtoul(optarg, NULL, 0);
+			break;
+		case 'c':
+			chunk_corpus_dir = optarg;
+			break;
+		case 'e':
+			entity_corpus_dir = optarg;
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	printf("chunk_type,cmp_mode,operation,samples,chunk_bytes,cmp_bytes,"
+	       "cmp_ratio,mb_per_s,ns_per_sample,cycles_per_sample\n");
+
+	for (i = 0; i < ARRAY_SIZE(bench_chunks); i++) {
+		if (bench_chunk(&bench_chunks[i], seed + i, time_ms * 1000000ULL))
+			return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,271 @@
+/**
+ * @file   test_cmp_container.c
+ * @date   2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief compression entity container tests
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <unity.h>
+
+#include <cmp_entity.h>
+#include <cmp_data_types.h>
+#include <cmp_container.h>
+
+
+#define NUM_ENTITIES	5
+#define COL_DATA_SIZE	8
+
+
+/**
+ * @brief write a raw chunk entity with two collections
+ *
+ * @returns the size of the entity
+ */
+
+static uint32_t build_raw_chunk_entity(uint8_t *buf, uint64_t start_timestamp,
+				       uint8_t subservice, uint8_t ccd_id)
+{
+	struct cmp_ent_hdr hdr;
+	uint32_t const ent_size = GENERIC_HEADER_SIZE + 2*(COLLECTION_HDR_SIZE + COL_DATA_SIZE);
+	uint8_t *p = buf + GENERIC_HEADER_SIZE;
+	int i;
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.cmp_ent_size = ent_size;
+	hdr.original_size = ent_size - GENERIC_HEADER_SIZE;
+	hdr.start_timestamp = start_timestamp;
+	hdr.end_timestamp = start_timestamp + 1;
+	hdr.data_type = DATA_TYPE_CHUNK;
+	hdr.raw_mode_flag = 1;
+	hdr.model_id = (uint32_t)start_timestamp & 0xFFFF;
+	TEST_ASSERT_EQUAL_INT(0, cmp_ent_hdr_encode((struct cmp_entity *)buf, &hdr));
+
+	for (i = 0; i < 2; i++) {
+		struct collection_hdr *col = (struct collection_hdr *)p;
+
+		memset(p, 0, COLLECTION_HDR_SIZE + COL_DATA_SIZE);
+		TEST_ASSERT_FALSE(cmp_col_set_subservice(col, (uint8_t)(subservice + i)));
+		TEST_ASSERT_FALSE(cmp_col_set_ccd_id(col, ccd_id));
+		TEST_ASSERT_FALSE(cmp_col_set_data_length(col, COL_DATA_SIZE));
+		p += COLLECTION_HDR_SIZE + COL_DATA_SIZE;
+	}
+
+	return ent_size;
+}
+
+
+/**
+ * @brief write an imagette entity without collections
+ *
+ * @returns the size of the entity
+ */
+
+static uint32_t build_imagette_entity(uint8_t *buf, uint64_t start_timestamp)
+{
+	struct cmp_ent_hdr hdr;
+
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.cmp_ent_size = IMAGETTE_HEADER_SIZE + 4;
+	hdr.original_size = 20;
+	hdr.start_timestamp = start_timestamp;
+	hdr.end_timestamp = start_timestamp + 1;
+	hdr.data_type = DATA_TYPE_IMAGETTE;
+	hdr.cmp_mode = CMP_MODE_DIFF_ZERO;
+	hdr.model_counter = 7;
+	TEST_ASSERT_EQUAL_INT(0, cmp_ent_hdr_encode((struct cmp_entity *)buf, &hdr));
+	memset(buf + IMAGETTE_HEADER_SIZE, 0, 4);
+
+	return hdr.cmp_ent_size;
+}
+
+
+/**
+ * @test cmp_cont_scan
+ * @test cmp_cont_write_index
+ * @test cmp_cont_open
+ * @test cmp_cont_get_entry
+ * @test cmp_cont_get_entity
+ * @test cmp_cont_lower_bound
+ */
+
+void test_cmp_cont_round_trip(void)
+{
+	uint8_t *buf = malloc(4096);
+	struct cmp_cont_entry entries[NUM_ENTITIES], entry;
+	struct cmp_cont cont;
+	uint32_t size = 0, index_size, i;
+	int32_t n;
+
+	TEST_ASSERT_NOT_NULL(buf);
+	/* entities with the start timestamps 10, 20, 20, 30, 40 */
+	size += build_raw_chunk_entity(buf + size, 10, 3, 1);
+	size += build_imagette_entity(buf + size, 20);
+	size += build_raw_chunk_entity(buf + size, 20, 62, 3);
+	size += build_imagette_entity(buf + size, 30);
+	size += build_raw_chunk_entity(buf + size, 40, 0, 0);
+
+	TEST_ASSERT_EQUAL_INT32(NUM_ENTITIES, cmp_cont_scan(buf, size, NULL, 0));
+	n = cmp_cont_scan(buf, size, entries, NUM_ENTITIES);
+	TEST_ASSERT_EQUAL_INT32(NUM_ENTITIES, n);
+	TEST_ASSERT_EQUAL_UINT32(0, entries[0].offset);
+	TEST_ASSERT_EQUAL_UINT32(entries[0].size, entries[1].offset);
+	TEST_ASSERT_EQUAL_INT(DATA_TYPE_CHUNK, entries[0].data_type);
+	TEST_ASSERT_EQUAL_INT(1, entries[0].raw_mode_flag);
+	TEST_ASSERT_EQUAL_HEX64(0x18, entries[0].subservice_mask);
+	TEST_ASSERT_EQUAL_HEX32(0x2, entries[0].ccd_id_mask);
+	TEST_ASSERT_EQUAL_HEX64(0xC000000000000000ULL, entries[2].subservice_mask);
+	TEST_ASSERT_EQUAL_HEX32(0x8, entries[2].ccd_id_mask);
+	TEST_ASSERT_EQUAL_INT(DATA_TYPE_IMAGETTE, entries[1].data_type);
+	TEST_ASSERT_EQUAL_HEX64(0, entries[1].subservice_mask);
+	TEST_ASSERT_EQUAL_UINT32(7, entries[1].model_counter);
+
+	/* append the index */
+	index_size = cmp_cont_write_index(NULL, 0, entries, NUM_ENTITIES, size);
+	TEST_ASSERT_EQUAL_UINT32(NUM_ENTITIES*CMP_CONT_RECORD_SIZE + CMP_CONT_TRAILER_SIZE, index_size);
+	TEST_ASSERT_EQUAL_UINT32(index_size, cmp_cont_index_size(NUM_ENTITIES));
+	TEST_ASSERT_EQUAL_UINT32(0, cmp_cont_write_index(buf + size, index_size-1, entries,
+							 NUM_ENTITIES, size));
+	TEST_ASSERT_EQUAL_UINT32(index_size, cmp_cont_write_index(buf + size, index_size,
+								  entries, NUM_ENTITIES, size));
+
+	TEST_ASSERT_EQUAL_INT(0, cmp_cont_open(&cont, buf, size + index_size));
+	TEST_ASSERT_EQUAL_UINT32(NUM_ENTITIES, cont.num_entries);
+	TEST_ASSERT_EQUAL_UINT32(size, cont.entities_size);
+	for (i = 0; i < NUM_ENTITIES; i++) {
+		TEST_ASSERT_EQUAL_INT(0, cmp_cont_get_entry(&cont, i, &entry));
+		TEST_ASSERT_EQUAL_MEMORY(&entries[i], &entry, sizeof(entry));
+		TEST_ASSERT_EQUAL_PTR(buf + entries[i].offset, cmp_cont_get_entity(&cont, i));
+	}
+	TEST_ASSERT_EQUAL_INT(-1, cmp_cont_get_entry(&cont, NUM_ENTITIES, &entry));
+	TEST_ASSERT_NULL(cmp_cont_get_entity(&cont, NUM_ENTITIES));
+
+	/* binary search of the start timestamp */
+	TEST_ASSERT_EQUAL_UINT32(0, cmp_cont_lower_bound(&cont, 0));
+	TEST_ASSERT_EQUAL_UINT32(0, cmp_cont_lower_bound(&cont, 10));
+	TEST_ASSERT_EQUAL_UINT32(1, cmp_cont_lower_bound(&cont, 11));
+	TEST_ASSERT_EQUAL_UINT32(1, cmp_cont_lower_bound(&cont, 20));
+	TEST_ASSERT_EQUAL_UINT32(3, cmp_cont_lower_bound(&cont, 21));
+	TEST_ASSERT_EQUAL_UINT32(4, cmp_cont_lower_bound(&cont, 40));
+	TEST_ASSERT_EQUAL_UINT32(NUM_ENTITIES, cmp_cont_lower_bound(&cont, 41));
+
+	/* an empty container */
+	TEST_ASSERT_EQUAL_INT32(0, cmp_cont_scan(buf, 0, entries, 0));
+	TEST_ASSERT_EQUAL_UINT32(CMP_CONT_TRAILER_SIZE,
+				 cmp_cont_write_index(buf, CMP_CONT_TRAILER_SIZE, NULL, 0, 0));
+	TEST_ASSERT_EQUAL_INT(0, cmp_cont_open(&cont, buf, CMP_CONT_TRAILER_SIZE));
+	TEST_ASSERT_EQUAL_UINT32(0, cont.num_entries);
+	TEST_ASSERT_EQUAL_UINT32(0, cmp_cont_lower_bound(&cont, 0));
+
+	free(buf);
+}
+
+
+/**
+ * @test cmp_cont_scan
+ * @test cmp_cont_write_index
+ * @test cmp_cont_open
+ */
+
+void test_cmp_cont_error_cases(void)
+{
+	uint8_t *buf = malloc(4096);
+	struct cmp_cont_entry entries[2];
+	struct cmp_cont cont;
+	uint32_t size, index_size;
+
+	TEST_ASSERT_NOT_NULL(buf);
+	size = build_raw_chunk_entity(buf, 20, 1, 0);
+	size += build_raw_chunk_entity(buf + size, 10, 1, 0);
+
+	/* too small entries array */
+	TEST_ASSERT_EQUAL_INT32(-1, cmp_cont_scan(buf, size, entries, 1));
+	/* truncated entity */
+	TEST_ASSERT_EQUAL_INT32(-1, cmp_cont_scan(buf, size-1, entries, 2));
+	TEST_ASSERT_EQUAL_INT32(-1, cmp_cont_scan(NULL, size, entries, 2));
+	TEST_ASSERT_EQUAL_INT32(2, cmp_cont_scan(buf, size, entries, 2));
+
+	/* entries not sorted by start timestamp */
+	index_size = cmp_cont_index_size(2);
+	TEST_ASSERT_EQUAL_UINT32(0, cmp_cont_write_index(buf + size, index_size, entries, 2, size));
+	entries[1].start_timestamp = 20;
+	/* entry outside of the entity area */
+	TEST_ASSERT_EQUAL_UINT32(0, cmp_cont_write_index(buf + size, index_size, entries, 2, size-1));
+	TEST_ASSERT_EQUAL_UINT32(index_size, cmp_cont_write_index(buf + size, index_size, entries, 2, size));
+
+	/* corrupted trailer */
+	TEST_ASSERT_EQUAL_INT(-1, cmp_cont_open(&cont, buf, size + index_size - 1));
+	TEST_ASSERT_EQUAL_INT(-1, cmp_cont_open(&cont, buf + 1, size + index_size - 1));
+	TEST_ASSERT_EQUAL_INT(-1, cmp_cont_open(&cont, buf, CMP_CONT_TRAILER_SIZE - 1));
+	TEST_ASSERT_EQUAL_INT(-1, cmp_cont_open(NULL, buf, size + index_size));
+	buf[size + index_size - 1] ^= 1; /* magic */
+	TEST_ASSERT_EQUAL_INT(-1, cmp_cont_open(&cont, buf, size + index_size));
+	buf[size + index_size - 1] ^= 1;
+	TEST_ASSERT_EQUAL_INT(0, cmp_cont_open(&cont, buf, size + index_size));
+
+	/* corrupted index entry */
+	buf[size + 4] = 0xFF; /* size of the first entry */
+	TEST_ASSERT_NULL(cmp_cont_get_entity(&cont, 0));
+	TEST_ASSERT_NOT_NULL(cmp_cont_get_entity(&cont, 1));
+
+	free(buf);
+}
+
+
+/**
+ * @test cmp_cont_scan
+ * @test cmp_cont_index_entity
+ */
+
+void test_cmp_cont_truncated_archive(void)
+{
+	uint8_t hdr_buf[NON_IMAGETTE_HEADER_SIZE];
+	uint8_t *buf;
+	struct cmp_cont_entry entries[2];
+	struct cmp_ent_hdr hdr;
+	uint32_t const tail_size = 40;
+	uint32_t size;
+
+	/* a compressed chunk entity claiming 200 bytes */
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.cmp_ent_size = 200;
+	hdr.original_size = 300;
+	hdr.data_type = DATA_TYPE_CHUNK;
+	hdr.cmp_mode = CMP_MODE_DIFF_ZERO;
+	TEST_ASSERT_EQUAL_INT(0, cmp_ent_hdr_encode((struct cmp_entity *)hdr_buf, &hdr));
+
+	/*
+	 * the archive ends 40 bytes into the entity, before its specific
+	 * header; the buffer is allocated exactly so that an overread is
+	 * caught by a memory checker
+	 */
+	size = GENERIC_HEADER_SIZE + 2*(COLLECTION_HDR_SIZE + COL_DATA_SIZE);
+	buf = malloc(size + tail_size);
+	TEST_ASSERT_NOT_NULL(buf);
+	TEST_ASSERT_EQUAL_UINT32(size, build_raw_chunk_entity(buf, 10, 1, 0));
+	memcpy(buf + size, hdr_buf, tail_size);
+
+	TEST_ASSERT_EQUAL_INT32(1, cmp_cont_scan(buf, size, entries, 2));
+	TEST_ASSERT_EQUAL_INT32(-1, cmp_cont_scan(buf, size + tail_size, entries, 2));
+	TEST_ASSERT_EQUAL_INT32(-1, cmp_cont_scan(buf + size, tail_size, entries, 2));
+	TEST_ASSERT_EQUAL_INT(-1, cmp_cont_index_entity((struct cmp_entity *)(buf + size),
+							tail_size, size, &entries[0]));
+	/* less than a generic header */
+	TEST_ASSERT_EQUAL_INT32(-1, cmp_cont_scan(buf, size + GENERIC_HEADER_SIZE - 1,
+						  entries, 2));
+
+	free(buf);
+}
@@ -0,0 +1,80 @@
+/* AUTOGENERATED FILE. DO NOT EDIT. */
+
+/*=======Automagically Detected Files To Include=====*/
+#include "unity.h"
+
+/*=======External Functions This Runner Calls=====*/
+extern void test_cmp_cont_round_trip(void);
+extern void test_cmp_cont_error_cases(void);
+extern void test_cmp_cont_truncated_archive(void);
+
+
+/*=======Mock Management=====*/
+static void CMock_Init(void)
+{
+}
+static void CMock_Verify(void)
+{
+}
+static void CMock_Destroy(void)
+{
+}
+
+/*=======Setup (stub)=====*/
+void setUp(void) {}
+
+/*=======Teardown (stub)=====*/
+void tearDown(void) {}
+
+/*=======Test Reset Options=====*/
+void resetTest(void)
+{
+  tearDown();
+  CMock_Verify();
+  CMock_Destroy();
+  CMock_Init();
+  setUp();
+}
+void verifyTest(void)
+{
+  CMock_Verify();
+}
+
+/*=======Test Runner Used To Run Each Test=====*/
+static void run_test(UnityTestFunction func, const char* name, UNITY_LINE_TYPE line_num)
+{
+    Unity.CurrentTestName = name;
+    Unity.CurrentTestLineNumber = line_num;
+#ifdef UNITY_USE_COMMAND_LINE_ARGS
+    if (!UnityTestMatches())
+        return;
+#endif
+    Unity.NumberOfTests++;
+    UNITY_CLR_DETAILS();
+    UNITY_EXEC_TIME_START();
+    CMock_Init();
+    if (TEST_PROTECT())
+    {
+        setUp();
+        func();
+    }
+    if (TEST_PROTECT())
+    {
+        tearDown();
+        CMock_Verify();
+    }
+    CMock_Destroy();
+    UNITY_EXEC_TIME_STOP();
+    UnityConcludeTest();
+}
+
+/*=======MAIN=====*/
+int main(void)
+{
+  UnityBegin("../test/cmp_container/test_cmp_container.c");
+  run_test(test_cmp_cont_round_trip, "test_cmp_cont_round_trip", 105);
+  run_test(test_cmp_cont_error_cases, "test_cmp_cont_error_cases", 183);
+  run_test(test_cmp_cont_truncated_archive, "test_cmp_cont_truncated_archive", 233);
+
+  return UnityEnd();
+}
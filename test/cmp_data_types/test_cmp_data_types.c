@@ -23,6 +23,7 @@
 
 #include <unity.h>
 #include <cmp_data_types.h>
+#include <byteorder.h>
 
 
 /**
@@ -155,6 +156,7 @@ void test_cmp_col_get_and_set(void)
 void test_convert_subservice_functions(void)
 {
 	enum cmp_data_type data_type;
+	unsigned int i, num_known = 0;
 
 	for (data_type = 0; data_type <= DATA_TYPE_CHUNK; data_type++) {
 		uint8_t sst = convert_cmp_data_type_to_subservice(data_type);
@@ -163,6 +165,19 @@ void test_convert_subservice_functions(void)
 
 		TEST_ASSERT_EQUAL(sst_convert, sst);
 	}
+
+	/* every known subservice converts back to itself */
+	for (i = 0; i <= UINT8_MAX; i++) {
+		data_type = convert_subservice_to_cmp_data_type((uint8_t)i);
+		if (data_type == DATA_TYPE_UNKNOWN)
+			continue;
+		num_known++;
+		TEST_ASSERT_EQUAL(i, convert_cmp_data_type_to_subservice(data_type));
+		TEST_ASSERT_NOT_EQUAL(0, size_of_a_sample(data_type));
+	}
+	TEST_ASSERT_EQUAL(20, num_known);
+	TEST_ASSERT_EQUAL(DATA_TYPE_UNKNOWN, convert_subservice_to_cmp_data_type(8));
+	TEST_ASSERT_EQUAL(DATA_TYPE_UNKNOWN, convert_subservice_to_cmp_data_type(64+3));
 }
 
 
@@ -730,3 +745,153 @@ void test_cmp_input_big_to_cpu_endianness_error_cases(void)
 	}
 
 }
+
+
+/**
+ * @test be_to_cpu_data_type
+ */
+
+void test_be_to_cpu_data_type_many_samples(void)
+{
+	enum { MAX_SAMPLES = 97 };
+	uint8_t *data = malloc(MAX_SAMPLES * sizeof(struct l_fx_efx_ncob_ecob));
+	uint8_t *ref = malloc(MAX_SAMPLES * sizeof(struct l_fx_efx_ncob_ecob));
+	enum cmp_data_type data_type;
+	uint32_t samples, i;
+
+	TEST_ASSERT(data && ref);
+
+	for (data_type = DATA_TYPE_IMAGETTE; data_type <= DATA_TYPE_F_CAM_BACKGROUND; data_type++) {
+		uint32_t const sample_size = (uint32_t)size_of_a_sample(data_type);
+
+		if (sample_size == 0)
+			continue;
+		/* different sample numbers to hit the vector and the tail path */
+		for (samples = 1; samples <= MAX_SAMPLES; samples += 16) {
+			uint32_t const size = samples * sample_size;
+
+			for (i = 0; i < size; i++)
+				data[i] = ref[i] = (uint8_t)(i * 7 + samples);
+
+			/* sample by sample conversion as reference */
+			TEST_ASSERT_EQUAL_INT(0, be_to_cpu_data_type(data, size, data_type));
+			for (i = 0; i < samples; i++)
+				TEST_ASSERT_EQUAL_INT(0, be_to_cpu_data_type(ref + i * sample_size,
+									 sample_size, data_type));
+			TEST_ASSERT_EQUAL_HEX8_ARRAY(ref, data, size);
+
+			/* a second conversion restores the original data */
+			TEST_ASSERT_EQUAL_INT(0, cpu_to_be_data_type(data, size, data_type));
+			for (i = 0; i < size; i++)
+				TEST_ASSERT_EQUAL_HEX8((uint8_t)(i * 7 + samples), data[i]);
+		}
+	}
+
+	free(data);
+	free(ref);
+}
+
+
+/**
+ * @test be_to_cpu_data_type_copy
+ * @test be_to_cpu_chunk_copy
+ */
+
+void test_be_to_cpu_copy(void)
+{
+	enum { MAX_SAMPLES = 33 };
+	uint32_t const col_size = COLLECTION_HDR_SIZE + 3*sizeof(struct background);
+	uint8_t *src = malloc(2 * MAX_SAMPLES * sizeof(struct l_fx_efx_ncob_ecob));
+	uint8_t *dst = malloc(MAX_SAMPLES * sizeof(struct l_fx_efx_ncob_ecob));
+	uint8_t *ref = malloc(MAX_SAMPLES * sizeof(struct l_fx_efx_ncob_ecob));
+	enum cmp_data_type data_type;
+	uint32_t samples, i;
+
+	TEST_ASSERT(src && dst && ref);
+
+	for (data_type = DATA_TYPE_IMAGETTE; data_type <= DATA_TYPE_F_CAM_BACKGROUND; data_type++) {
+		uint32_t const sample_size = (uint32_t)size_of_a_sample(data_type);
+
+		if (sample_size == 0)
+			continue;
+		for (samples = 1; samples <= MAX_SAMPLES; samples += 8) {
+			uint32_t const size = samples * sample_size;
+
+			for (i = 0; i < size; i++)
+				src[i] = (uint8_t)(i * 13 + samples);
+			memset(dst, 0xAA, size);
+
+			/* memcpy() followed by an in-place conversion as reference */
+			memcpy(ref, src, size);
+			TEST_ASSERT_EQUAL_INT(0, be_to_cpu_data_type(ref, size, data_type));
+			TEST_ASSERT_EQUAL_INT(0, be_to_cpu_data_type_copy(dst, src, size, data_type));
+			TEST_ASSERT_EQUAL_HEX8_ARRAY(ref, dst, size);
+
+			/* the source is not changed */
+			for (i = 0; i < size; i++)
+				TEST_ASSERT_EQUAL_HEX8((uint8_t)(i * 13 + samples), src[i]);
+
+			/* in place and overlapping buffers */
+			TEST_ASSERT_EQUAL_INT(0, cpu_to_be_data_type_copy(dst, dst, size, data_type));
+			TEST_ASSERT_EQUAL_HEX8_ARRAY(src, dst, size);
+			memmove(src + sample_size, src, size);
+			TEST_ASSERT_EQUAL_INT(0, be_to_cpu_data_type_copy(src, src + sample_size,
+									  size, data_type));
+			TEST_ASSERT_EQUAL_HEX8_ARRAY(ref, src, size);
+		}
+	}
+
+	/* the layouts with equally wide fields are swapped as a stream of words */
+	for (i = 0; i < MAX_SAMPLES * sizeof(struct f_fx_ncob); i++)
+		src[i] = (uint8_t)i;
+	TEST_ASSERT_EQUAL_INT(0, be_to_cpu_data_type_copy(dst, src, MAX_SAMPLES * sizeof(struct f_fx_ncob),
+							  DATA_TYPE_F_FX_NCOB));
+	for (i = 0; i < MAX_SAMPLES * sizeof(struct f_fx_ncob); i += 4) {
+		uint32_t word, word_be;
+
+		memcpy(&word, dst + i, sizeof(word));
+		memcpy(&word_be, src + i, sizeof(word_be));
+		TEST_ASSERT_EQUAL_HEX32(be32_to_cpu(word_be), word);
+	}
+	TEST_ASSERT_EQUAL_INT(0, be_to_cpu_data_type_copy(dst, src, MAX_SAMPLES * sizeof(uint16_t),
+							  DATA_TYPE_IMAGETTE));
+	for (i = 0; i < MAX_SAMPLES * sizeof(uint16_t); i += 2) {
+		uint16_t word, word_be;
+
+		memcpy(&word, dst + i, sizeof(word));
+		memcpy(&word_be, src + i, sizeof(word_be));
+		TEST_ASSERT_EQUAL_HEX16(be16_to_cpu(word_be), word);
+	}
+
+	/* error cases */
+	TEST_ASSERT_EQUAL_INT(0, be_to_cpu_data_type_copy(dst, NULL, 8, DATA_TYPE_OFFSET));
+	TEST_ASSERT_EQUAL_INT(-1, be_to_cpu_data_type_copy(NULL, src, 8, DATA_TYPE_OFFSET));
+	TEST_ASSERT_EQUAL_INT(-1, be_to_cpu_data_type_copy(dst, src, 7, DATA_TYPE_OFFSET));
+	TEST_ASSERT_EQUAL_INT(-1, be_to_cpu_data_type_copy(dst, src, 8, DATA_TYPE_UNKNOWN));
+
+	/* a chunk with two background collections */
+	for (i = 0; i < 2*col_size; i++)
+		src[i] = (uint8_t)i;
+	for (i = 0; i < 2; i++) {
+		cmp_col_set_subservice((void *)(src + i*col_size), SST_NCxx_S_SCIENCE_BACKGROUND);
+		cmp_col_set_data_length((void *)(src + i*col_size), 3*sizeof(struct background));
+	}
+	memcpy(ref, src, 2*col_size);
+	TEST_ASSERT_EQUAL_INT(0, be_to_cpu_chunk(ref, 2*col_size));
+	TEST_ASSERT_EQUAL_INT(0, be_to_cpu_chunk_copy(dst, src, 2*col_size));
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(ref, dst, 2*col_size);
+	TEST_ASSERT_EQUAL_INT(0, cpu_to_be_chunk_copy(dst, dst, 2*col_size));
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(src, dst, 2*col_size);
+
+	/* on a chunk size mismatch the remaining bytes are copied unchanged */
+	memset(dst, 0, 2*col_size);
+	TEST_ASSERT_EQUAL_INT(-1, be_to_cpu_chunk_copy(dst, src, 2*col_size - 1));
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(ref, dst, col_size);
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(src + col_size, dst + col_size, col_size - 1);
+	TEST_ASSERT_EQUAL_INT(0, be_to_cpu_chunk_copy(dst, NULL, col_size));
+	TEST_ASSERT_EQUAL_INT(-1, be_to_cpu_chunk_copy(NULL, src, col_size));
+
+	free(src);
+	free(dst);
+	free(ref);
+}
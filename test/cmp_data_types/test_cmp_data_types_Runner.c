@@ -12,6 +12,8 @@ extern void test_cmp_input_big_to_cpu_endianness(void);
 extern void test_be_to_cpu_chunk(void);
 extern void test_be_to_cpu_chunk_error_cases(void);
 extern void test_cmp_input_big_to_cpu_endianness_error_cases(void);
+extern void test_be_to_cpu_data_type_many_samples(void);
+extern void test_be_to_cpu_copy(void);
 
 
 /*=======Mock Management=====*/
@@ -85,6 +87,8 @@ int main(void)
   run_test(test_be_to_cpu_chunk, "test_be_to_cpu_chunk", 283);
   run_test(test_be_to_cpu_chunk_error_cases, "test_be_to_cpu_chunk_error_cases", 620);
   run_test(test_cmp_input_big_to_cpu_endianness_error_cases, "test_cmp_input_big_to_cpu_endianness_error_cases", 675);
+  run_test(test_be_to_cpu_data_type_many_samples, "test_be_to_cpu_data_type_many_samples", 739);
+  run_test(test_be_to_cpu_copy, "test_be_to_cpu_copy", 785);
 
   return UnityEnd();
 }
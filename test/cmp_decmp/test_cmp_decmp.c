@@ -486,7 +486,7 @@ uint32_t generate_random_collection_hdr(struct collection_hdr *col, enum cmp_dat
 		TEST_ASSERT_FALSE(cmp_col_set_pkt_type(col, COL_SCI_PKTS_TYPE));
 		TEST_ASSERT_FALSE(cmp_col_set_subservice(col, convert_cmp_data_type_to_subservice(data_type)));
 		TEST_ASSERT_FALSE(cmp_col_set_ccd_id(col, (uint8_t)cmp_rand_between(0, 3)));
-		TEST_ASSERT_FALSE(cmp_col_set_sequence_num(col, sequence_num++));
+		TEST_ASSERT_FALSE(cmp_col_set_sequence_num(col, sequence_num++ & 0x7F));
 
 		TEST_ASSERT_FALSE(cmp_col_set_data_length(col, (uint16_t)data_size));
 	}
@@ -687,6 +687,11 @@ void generate_random_cmp_par(struct cmp_par *par)
 	par->l_ecob = cmp_rand_between(MIN_NON_IMA_GOLOMB_PAR, MAX_NON_IMA_GOLOMB_PAR);
 	par->l_fx_cob_variance = cmp_rand_between(MIN_NON_IMA_GOLOMB_PAR, MAX_NON_IMA_GOLOMB_PAR);
 
+	par->f_fx = cmp_rand_between(MIN_NON_IMA_GOLOMB_PAR, MAX_NON_IMA_GOLOMB_PAR);
+	par->f_ncob = cmp_rand_between(MIN_NON_IMA_GOLOMB_PAR, MAX_NON_IMA_GOLOMB_PAR);
+	par->f_efx = cmp_rand_between(MIN_NON_IMA_GOLOMB_PAR, MAX_NON_IMA_GOLOMB_PAR);
+	par->f_ecob = cmp_rand_between(MIN_NON_IMA_GOLOMB_PAR, MAX_NON_IMA_GOLOMB_PAR);
+
 	par->saturated_imagette = cmp_rand_between(MIN_NON_IMA_GOLOMB_PAR, MAX_NON_IMA_GOLOMB_PAR);
 
 	par->nc_offset_mean = cmp_rand_between(MIN_NON_IMA_GOLOMB_PAR, MAX_NON_IMA_GOLOMB_PAR);
@@ -928,6 +933,11 @@ void test_random_compression_decompress_rdcu_data(void)
 	for (i = 0; i < N_SAMPLES; i++)
 		TEST_ASSERT_EQUAL_HEX16(data[i], decompressed_data[i]);
 
+	/* the uncompressed data do not fit in the compressed data size */
+	info.cmp_size -= 8;
+	s = decompress_rdcu_data(compressed_data, &info, NULL, NULL, decompressed_data);
+	TEST_ASSERT_EQUAL(-1, s);
+
 	free(compressed_data);
 	free(decompressed_data);
 }
@@ -999,7 +1009,7 @@ void test_random_collection_round_trip(void)
 			size = generate_random_collection(model, data_type, samples, gen_data_f, extra);
 			TEST_ASSERT(size <= MAX_DATA_TO_COMPRESS_SIZE);
 
-			for (cmp_mode = CMP_MODE_RAW; cmp_mode <= CMP_MODE_DIFF_MULTI; cmp_mode++) {
+			for (cmp_mode = CMP_MODE_RAW; cmp_mode <= CMP_MODE_DIFF_ADAPTIVE; cmp_mode++) {
 				struct cmp_par par;
 				uint32_t cmp_size, cmp_size2;
 
@@ -1012,14 +1022,15 @@ void test_random_collection_round_trip(void)
 				cmp_size = chunk_round_trip(data, (uint32_t)size, model, updated_model,
 							   cmp_data, cmp_data_capacity,
 							   &par, 1, model_mode_is_used(par.cmp_mode));
-				/* No chunk is defined for fast cadence subservices */
-				if (data_type == DATA_TYPE_F_FX || data_type == DATA_TYPE_F_FX_EFX ||
-				    data_type == DATA_TYPE_F_FX_NCOB || data_type == DATA_TYPE_F_FX_EFX_NCOB_ECOB) {
-					TEST_ASSERT_EQUAL_INT(CMP_ERROR_COL_SUBSERVICE_UNSUPPORTED, cmp_get_error_code(cmp_size));
-					continue;
-				} else {
-					TEST_ASSERT_EQUAL_INT(CMP_ERROR_NO_ERROR, cmp_get_error_code(cmp_size));
-				}
+				TEST_ASSERT_EQUAL_INT(CMP_ERROR_NO_ERROR, cmp_get_error_code(cmp_size));
+
+				/* the lossy round trip compares against the rounded data */
+				par.lossy_par = cmp_rand_between(1, MAX_ICU_ROUND);
+				cmp_size2 = chunk_round_trip(data, (uint32_t)size, model, updated_model,
+							     cmp_data, cmp_data_capacity,
+							     &par, 1, model_mode_is_used(par.cmp_mode));
+				TEST_ASSERT_EQUAL_INT(CMP_ERROR_NO_ERROR, cmp_get_error_code(cmp_size2));
+				par.lossy_par = CMP_LOSSLESS;
 
 
 				/* test with minimum compressed data capacity */
@@ -1691,3 +1702,738 @@ void test_cmp_decmp_diff(void)
 	free(dst);
 	free(chunk);
 }
+
+
+/**
+ * @test compress_chunk
+ * @test decompress_cmp_entiy
+ */
+
+void test_cmp_decmp_lossy(void)
+{
+	struct chunk_def chunk_def[2] = {{DATA_TYPE_OFFSET, 10}, {DATA_TYPE_BACKGROUND, 20}};
+	enum cmp_mode const cmp_modes[] = {CMP_MODE_DIFF_ZERO, CMP_MODE_MODEL_MULTI};
+	uint32_t const lossy_par = 2;
+	double p = 0.01;
+	uint32_t chunk_size, dst_capacity, cmp_size;
+	uint8_t *chunk, *model, *up_model, *up_model_decmp, *exp_data, *decmp_data;
+	uint32_t *dst;
+	struct cmp_par par = {0};
+	size_t i, m;
+	int decmp_size;
+
+	chunk_size = generate_random_chunk(NULL, chunk_def, ARRAY_SIZE(chunk_def),
+					   gen_geometric_data, &p);
+	chunk = malloc(chunk_size);
+	model = malloc(chunk_size);
+	up_model = malloc(chunk_size);
+	up_model_decmp = malloc(chunk_size);
+	exp_data = malloc(chunk_size);
+	decmp_data = malloc(chunk_size);
+	dst_capacity = COMPRESS_CHUNK_BOUND(chunk_size, ARRAY_SIZE(chunk_def));
+	dst = malloc(dst_capacity);
+	TEST_ASSERT(chunk && model && up_model && up_model_decmp && exp_data &&
+		    decmp_data && dst);
+	generate_random_chunk(chunk, chunk_def, ARRAY_SIZE(chunk_def),
+			      gen_geometric_data, &p);
+	generate_random_chunk(model, chunk_def, ARRAY_SIZE(chunk_def),
+			      gen_geometric_data, &p);
+
+	/* the decompressed values have the lossy_par least significant bits cleared */
+	memcpy(exp_data, chunk, chunk_size);
+	{
+		struct collection_hdr *col = (struct collection_hdr *)exp_data;
+		struct offset *offset = (struct offset *)col->entry;
+		struct background *background;
+
+		for (i = 0; i < chunk_def[0].samples; i++) {
+			offset[i].mean = round_inv(round_fwd(offset[i].mean, lossy_par), lossy_par);
+			offset[i].variance = round_inv(round_fwd(offset[i].variance, lossy_par), lossy_par);
+		}
+		col = (struct collection_hdr *)((uint8_t *)col + cmp_col_get_size(col));
+		background = (struct background *)col->entry;
+		for (i = 0; i < chunk_def[1].samples; i++) {
+			background[i].mean = round_inv(round_fwd(background[i].mean, lossy_par), lossy_par);
+			background[i].variance = round_inv(round_fwd(background[i].variance, lossy_par), lossy_par);
+			background[i].outlier_pixels = (uint16_t)round_inv(round_fwd(
+				background[i].outlier_pixels, lossy_par), lossy_par);
+		}
+	}
+
+	par.model_value = 11;
+	par.lossy_par = lossy_par;
+	par.nc_offset_mean = 2;
+	par.nc_offset_variance = 4;
+	par.nc_background_mean = 2;
+	par.nc_background_variance = 4;
+	par.nc_background_outlier_pixels = 2;
+
+	for (m = 0; m < ARRAY_SIZE(cmp_modes); m++) {
+		par.cmp_mode = cmp_modes[m];
+		cmp_size = compress_chunk(chunk, chunk_size, model, up_model, dst,
+					  dst_capacity, &par);
+		TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+		TEST_ASSERT_EQUAL_UINT16(lossy_par,
+			cmp_ent_get_lossy_cmp_par((struct cmp_entity *)dst));
+
+		decmp_size = decompress_cmp_entiy((struct cmp_entity *)dst, model,
+						  up_model_decmp, decmp_data);
+		TEST_ASSERT_EQUAL_INT(chunk_size, decmp_size);
+		TEST_ASSERT_EQUAL_HEX8_ARRAY(exp_data, decmp_data, chunk_size);
+		if (model_mode_is_used(par.cmp_mode))
+			TEST_ASSERT_EQUAL_HEX8_ARRAY(up_model, up_model_decmp, chunk_size);
+	}
+
+	/* lossy compression is not supported for short cadence chunks */
+	{
+		struct chunk_def s_fx_def[1] = {{DATA_TYPE_S_FX, 5}};
+		uint32_t s_fx_size = generate_random_chunk(NULL, s_fx_def, 1,
+							   gen_geometric_data, &p);
+
+		TEST_ASSERT(s_fx_size <= chunk_size);
+		generate_random_chunk(chunk, s_fx_def, 1, gen_geometric_data, &p);
+		par.cmp_mode = CMP_MODE_DIFF_ZERO;
+		par.s_exp_flags = 1;
+		par.s_fx = 2;
+		cmp_size = compress_chunk(chunk, s_fx_size, NULL, NULL, dst,
+					  dst_capacity, &par);
+		TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+		TEST_ASSERT_EQUAL_UINT16(0, cmp_ent_get_lossy_cmp_par((struct cmp_entity *)dst));
+		decmp_size = decompress_cmp_entiy((struct cmp_entity *)dst, NULL, NULL,
+						  decmp_data);
+		TEST_ASSERT_EQUAL_INT(s_fx_size, decmp_size);
+		TEST_ASSERT_EQUAL_HEX8_ARRAY(chunk, decmp_data, s_fx_size);
+	}
+
+	/* error: lossy_par too large */
+	generate_random_chunk(chunk, chunk_def, ARRAY_SIZE(chunk_def),
+			      gen_geometric_data, &p);
+	par.lossy_par = MAX_ICU_ROUND + 1;
+	cmp_size = compress_chunk(chunk, chunk_size, NULL, NULL, dst, dst_capacity, &par);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_PAR_GENERIC, cmp_get_error_code(cmp_size));
+
+	free(chunk);
+	free(model);
+	free(up_model);
+	free(up_model_decmp);
+	free(exp_data);
+	free(decmp_data);
+	free(dst);
+}
+
+
+/**
+ * @test compress_chunk
+ * @test decompress_cmp_entiy
+ *
+ * @brief the adaptive compression modes select the compression parameter per
+ *	block; the data change their statistics in the middle of the collection
+ */
+
+void test_cmp_decmp_adaptive(void)
+{
+	struct chunk_def chunk_def[1] = {{DATA_TYPE_IMAGETTE, 2048}};
+	enum cmp_mode const cmp_modes[] = {CMP_MODE_DIFF_ADAPTIVE, CMP_MODE_MODEL_ADAPTIVE};
+	double p = 0.01;
+	uint32_t chunk_size, dst_capacity, cmp_size, cmp_size_multi;
+	uint8_t *chunk, *model, *up_model, *up_model_decmp, *decmp_data;
+	uint32_t *dst;
+	struct cmp_par par = {0};
+	uint16_t *ima;
+	size_t i, m;
+	int decmp_size;
+
+	chunk_size = generate_random_chunk(NULL, chunk_def, ARRAY_SIZE(chunk_def),
+					   gen_geometric_data, &p);
+	chunk = malloc(chunk_size);
+	model = malloc(chunk_size);
+	up_model = malloc(chunk_size);
+	up_model_decmp = malloc(chunk_size);
+	decmp_data = malloc(chunk_size);
+	dst_capacity = COMPRESS_CHUNK_BOUND(chunk_size, ARRAY_SIZE(chunk_def));
+	dst = malloc(dst_capacity);
+	TEST_ASSERT(chunk && model && up_model && up_model_decmp && decmp_data && dst);
+	generate_random_chunk(chunk, chunk_def, ARRAY_SIZE(chunk_def),
+			      gen_geometric_data, &p);
+
+	/* a quiet first half and a noisy second half */
+	ima = (uint16_t *)((struct collection_hdr *)chunk)->entry;
+	for (i = 0; i < chunk_def[0].samples; i++) {
+		if (i < chunk_def[0].samples/2)
+			ima[i] = (uint16_t)cmp_rand_between(1000, 1003);
+		else
+			ima[i] = (uint16_t)cmp_rand_between(1000, 1511);
+	}
+	memcpy(model, chunk, chunk_size);
+	ima = (uint16_t *)((struct collection_hdr *)model)->entry;
+	for (i = 0; i < chunk_def[0].samples; i++)
+		ima[i] = (uint16_t)(ima[i] ^ 1);
+
+	par.model_value = 8;
+	par.nc_imagette = 16;
+
+	par.cmp_mode = CMP_MODE_DIFF_MULTI;
+	cmp_size_multi = compress_chunk(chunk, chunk_size, NULL, NULL, dst,
+					dst_capacity, &par);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size_multi));
+
+	for (m = 0; m < ARRAY_SIZE(cmp_modes); m++) {
+		par.cmp_mode = cmp_modes[m];
+		cmp_size = compress_chunk(chunk, chunk_size, model, up_model, dst,
+					  dst_capacity, &par);
+		TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+		TEST_ASSERT_EQUAL_INT(cmp_modes[m], cmp_ent_get_cmp_mode((struct cmp_entity *)dst));
+		if (par.cmp_mode == CMP_MODE_DIFF_ADAPTIVE)
+			TEST_ASSERT_LESS_THAN_UINT32(cmp_size_multi, cmp_size);
+
+		decmp_size = decompress_cmp_entiy((struct cmp_entity *)dst, model,
+						  up_model_decmp, decmp_data);
+		TEST_ASSERT_EQUAL_INT(chunk_size, decmp_size);
+		TEST_ASSERT_EQUAL_HEX8_ARRAY(chunk, decmp_data, chunk_size);
+		if (model_mode_is_used(par.cmp_mode))
+			TEST_ASSERT_EQUAL_HEX8_ARRAY(up_model, up_model_decmp, chunk_size);
+	}
+
+	free(chunk);
+	free(model);
+	free(up_model);
+	free(up_model_decmp);
+	free(decmp_data);
+	free(dst);
+}
+
+
+/**
+ * @test decompress_cmp_batch
+ * @test decompress_cmp_batch_size
+ * @test decompress_cmp_archive_fd
+ */
+
+void test_cmp_decmp_batch(void)
+{
+	struct chunk_def chunk_def[2] = {{DATA_TYPE_OFFSET, 10}, {DATA_TYPE_BACKGROUND, 20}};
+	enum cmp_mode const cmp_modes[] = {CMP_MODE_DIFF_ZERO, CMP_MODE_MODEL_MULTI,
+		CMP_MODE_MODEL_ZERO};
+	double p = 0.3;
+	uint32_t chunk_size, dst_capacity, archive_size = 0;
+	uint8_t *chunks, *model, *up_model, *archive, *decmp_data, *trunc_archive;
+	struct cmp_par par = {0};
+	size_t decmp_size, trunc_size, i;
+
+	chunk_size = generate_random_chunk(NULL, chunk_def, ARRAY_SIZE(chunk_def),
+					   gen_geometric_data, &p);
+	dst_capacity = COMPRESS_CHUNK_BOUND(chunk_size, ARRAY_SIZE(chunk_def));
+	chunks = malloc(ARRAY_SIZE(cmp_modes) * chunk_size);
+	model = malloc(chunk_size);
+	up_model = malloc(chunk_size);
+	archive = malloc(ARRAY_SIZE(cmp_modes) * dst_capacity);
+	decmp_data = malloc(ARRAY_SIZE(cmp_modes) * chunk_size);
+	TEST_ASSERT(chunks && model && up_model && archive && decmp_data);
+
+	/* a model chain: the first chunk is the model of the second one, the
+	 * updated model the model of the third one */
+	par.model_value = 11;
+	par.nc_offset_mean = 4;
+	par.nc_offset_variance = 5;
+	par.nc_background_mean = 6;
+	par.nc_background_variance = 7;
+	par.nc_background_outlier_pixels = 8;
+	for (i = 0; i < ARRAY_SIZE(cmp_modes); i++) {
+		uint8_t *chunk = chunks + i * chunk_size;
+		uint32_t cmp_size;
+
+		generate_random_chunk(chunk, chunk_def, ARRAY_SIZE(chunk_def),
+				      gen_geometric_data, &p);
+		par.cmp_mode = cmp_modes[i];
+		cmp_size = compress_chunk(chunk, chunk_size, model, up_model,
+					  (uint32_t *)(archive + archive_size),
+					  dst_capacity, &par);
+		TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+		archive_size += cmp_size;
+		if (model_mode_is_used(par.cmp_mode))
+			memcpy(model, up_model, chunk_size);
+		else
+			memcpy(model, chunk, chunk_size);
+	}
+
+	TEST_ASSERT_EQUAL_INT(0, decompress_cmp_batch_size(archive, archive_size, &decmp_size));
+	TEST_ASSERT_EQUAL_size_t(ARRAY_SIZE(cmp_modes) * chunk_size, decmp_size);
+
+	/* the first model is taken from the output buffer, the model buffer
+	 * only receives the updated models */
+	memset(model, 0, chunk_size);
+	TEST_ASSERT_EQUAL_INT(0, decompress_cmp_batch(archive, archive_size, model, chunk_size,
+						      decmp_data, decmp_size, &decmp_size));
+	TEST_ASSERT_EQUAL_size_t(ARRAY_SIZE(cmp_modes) * chunk_size, decmp_size);
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(chunks, decmp_data, decmp_size);
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(up_model, model, chunk_size);
+	TEST_ASSERT_EQUAL_INT(0, decompress_cmp_batch(archive, archive_size, model, chunk_size,
+						      NULL, 0, NULL));
+
+	/* error cases */
+	TEST_ASSERT_EQUAL_INT(-1, decompress_cmp_batch(archive, archive_size, NULL, 0,
+						       decmp_data, decmp_size, NULL));
+	TEST_ASSERT_EQUAL_INT(-1, decompress_cmp_batch(archive, archive_size, model, chunk_size-1,
+						       decmp_data, decmp_size, NULL));
+	TEST_ASSERT_EQUAL_INT(-1, decompress_cmp_batch(archive, archive_size, model, chunk_size,
+						       decmp_data, decmp_size-1, NULL));
+	TEST_ASSERT_EQUAL_INT(-1, decompress_cmp_batch(archive, archive_size-1, model, chunk_size,
+						       decmp_data, decmp_size, NULL));
+	TEST_ASSERT_EQUAL_INT(-1, decompress_cmp_batch_size(archive, archive_size-1, &decmp_size));
+
+	/* the archive ends 40 bytes into the second entity, before the end of
+	 * its header; the buffer is allocated exactly so that an overread is
+	 * caught by a memory checker */
+	trunc_size = cmp_ent_get_size((struct cmp_entity *)archive) + 40;
+	trunc_archive = malloc(trunc_size);
+	TEST_ASSERT_NOT_NULL(trunc_archive);
+	memcpy(trunc_archive, archive, trunc_size);
+	TEST_ASSERT_EQUAL_INT(-1, decompress_cmp_batch_size(trunc_archive, trunc_size, &decmp_size));
+	TEST_ASSERT_EQUAL_INT(-1, decompress_cmp_batch(trunc_archive, trunc_size, model, chunk_size,
+						       decmp_data, chunk_size, NULL));
+	TEST_ASSERT_EQUAL_INT(-1, decompress_cmp_batch(trunc_archive, trunc_size, model, chunk_size,
+						       NULL, 0, NULL));
+
+#if defined __has_include
+#  if __has_include(<sys/mman.h>) && __has_include(<unistd.h>)
+	{
+		FILE *archive_fp = tmpfile();
+		FILE *out_fp = tmpfile();
+		size_t out_size;
+
+		TEST_ASSERT(archive_fp && out_fp);
+		TEST_ASSERT_EQUAL_size_t(archive_size, fwrite(archive, 1, archive_size, archive_fp));
+		TEST_ASSERT_EQUAL_INT(0, fflush(archive_fp));
+
+		TEST_ASSERT_EQUAL_INT(0, decompress_cmp_archive_fd(fileno(archive_fp), fileno(out_fp),
+								   model, chunk_size, &out_size));
+		TEST_ASSERT_EQUAL_size_t(ARRAY_SIZE(cmp_modes) * chunk_size, out_size);
+		memset(decmp_data, 0, out_size);
+		rewind(out_fp);
+		TEST_ASSERT_EQUAL_size_t(out_size, fread(decmp_data, 1, out_size + 1, out_fp));
+		TEST_ASSERT_EQUAL_HEX8_ARRAY(chunks, decmp_data, out_size);
+
+		/* a truncated archive file ends inside the mapping of the archive */
+		fclose(archive_fp);
+		archive_fp = tmpfile();
+		TEST_ASSERT_NOT_NULL(archive_fp);
+		TEST_ASSERT_EQUAL_size_t(trunc_size, fwrite(trunc_archive, 1, trunc_size, archive_fp));
+		TEST_ASSERT_EQUAL_INT(0, fflush(archive_fp));
+		TEST_ASSERT_EQUAL_INT(-1, decompress_cmp_archive_fd(fileno(archive_fp), fileno(out_fp),
+								    model, chunk_size, &out_size));
+
+		fclose(archive_fp);
+		fclose(out_fp);
+	}
+#  endif
+#endif
+
+	free(trunc_archive);
+	free(chunks);
+	free(model);
+	free(up_model);
+	free(archive);
+	free(decmp_data);
+}
+
+
+/**
+ * @test compress_chunk_split_plan
+ * @test compress_chunk_split
+ */
+
+void test_compress_chunk_split(void)
+{
+	struct chunk_def chunk_def[5] = {{DATA_TYPE_OFFSET, 10}, {DATA_TYPE_OFFSET, 10},
+		{DATA_TYPE_OFFSET, 10}, {DATA_TYPE_OFFSET, 10}, {DATA_TYPE_OFFSET, 10}};
+	double p = 0.3;
+	uint32_t chunk_size, col_size, dst_capacity, cmp_size, ref_size, n, i;
+	uint32_t part_sizes[3], ent_sizes[3], num_ent;
+	uint8_t *chunk, *model, *up_model, *ref_up_model, *decmp_data;
+	uint32_t *dst;
+	struct cmp_par par = {0};
+	size_t offset = 0, data_offset = 0;
+
+	chunk_size = generate_random_chunk(NULL, chunk_def, ARRAY_SIZE(chunk_def),
+					   gen_geometric_data, &p);
+	col_size = chunk_size / ARRAY_SIZE(chunk_def);
+	dst_capacity = COMPRESS_CHUNK_BOUND(chunk_size, ARRAY_SIZE(chunk_def)) + 3*(NON_IMAGETTE_HEADER_SIZE + 3);
+	chunk = malloc(chunk_size);
+	model = malloc(chunk_size);
+	up_model = malloc(chunk_size);
+	ref_up_model = malloc(chunk_size);
+	decmp_data = malloc(chunk_size);
+	dst = malloc(dst_capacity);
+	TEST_ASSERT(chunk && model && up_model && ref_up_model && decmp_data && dst);
+	generate_random_chunk(chunk, chunk_def, ARRAY_SIZE(chunk_def), gen_geometric_data, &p);
+	generate_random_chunk(model, chunk_def, ARRAY_SIZE(chunk_def), gen_geometric_data, &p);
+
+	/* two collections per part */
+	n = compress_chunk_split_plan(chunk, chunk_size, 2*col_size+1, NULL, 0);
+	TEST_ASSERT_EQUAL_UINT32(3, n);
+	n = compress_chunk_split_plan(chunk, chunk_size, 2*col_size+1, part_sizes, 3);
+	TEST_ASSERT_EQUAL_UINT32(3, n);
+	TEST_ASSERT_EQUAL_UINT32(2*col_size, part_sizes[0]);
+	TEST_ASSERT_EQUAL_UINT32(2*col_size, part_sizes[1]);
+	TEST_ASSERT_EQUAL_UINT32(col_size, part_sizes[2]);
+	/* the default maximum part size fits the whole chunk into one part */
+	TEST_ASSERT_EQUAL_UINT32(1, compress_chunk_split_plan(chunk, chunk_size, 0, NULL, 0));
+
+	par.cmp_mode = CMP_MODE_MODEL_ZERO;
+	par.model_value = 11;
+	par.nc_offset_mean = 4;
+	par.nc_offset_variance = 5;
+	ref_size = compress_chunk(chunk, chunk_size, model, ref_up_model, NULL, 0, &par);
+	TEST_ASSERT_FALSE(cmp_is_error(ref_size));
+
+	cmp_size = compress_chunk_split(chunk, chunk_size, model, up_model, NULL, 0, &par,
+					2*col_size, ent_sizes, 3, &num_ent);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	TEST_ASSERT_EQUAL_UINT32(3, num_ent);
+	TEST_ASSERT_EQUAL_UINT32(ent_sizes[0] + ent_sizes[1] + ent_sizes[2], cmp_size);
+	/* every additional entity has its own header */
+	TEST_ASSERT_EQUAL_UINT32(ref_size + 2*NON_IMAGETTE_HEADER_SIZE, cmp_size);
+
+	cmp_size = compress_chunk_split(chunk, chunk_size, model, up_model, dst, dst_capacity,
+					&par, 2*col_size, ent_sizes, 3, &num_ent);
+	TEST_ASSERT_EQUAL_UINT32(ref_size + 2*NON_IMAGETTE_HEADER_SIZE, cmp_size);
+	TEST_ASSERT_EQUAL_UINT32(3, num_ent);
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(ref_up_model, up_model, chunk_size);
+
+	/* the entities are packed one after another */
+	for (i = 0; i < num_ent; i++) {
+		const struct cmp_entity *ent = (const struct cmp_entity *)((uint8_t *)dst + offset);
+		int decmp_size;
+
+		TEST_ASSERT_EQUAL_UINT32(ent_sizes[i], cmp_ent_get_size(ent));
+		decmp_size = decompress_cmp_entiy(ent, model + data_offset, NULL,
+						  decmp_data + data_offset);
+		TEST_ASSERT_EQUAL_INT(part_sizes[i], decmp_size);
+		offset += ent_sizes[i];
+		data_offset += (size_t)decmp_size;
+	}
+	TEST_ASSERT_EQUAL_size_t(chunk_size, data_offset);
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(chunk, decmp_data, chunk_size);
+
+	/* the entities after an entity with an unaligned size are compressed at
+	 * their unaligned position without additional alignment space
+	 */
+	for (i = 1; i <= 16 && !(ent_sizes[0] & 0x3); i++) {
+		par.nc_offset_mean = i;
+		cmp_size = compress_chunk_split(chunk, chunk_size, model, up_model, NULL, 0,
+						&par, 2*col_size, ent_sizes, 3, &num_ent);
+		TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	}
+	TEST_ASSERT(ent_sizes[0] & 0x3);
+	memset(dst, 0xFF, dst_capacity);
+	cmp_size = compress_chunk_split(chunk, chunk_size, model, up_model, dst,
+					ROUND_UP_TO_4(cmp_size), &par, 2*col_size,
+					ent_sizes, 3, &num_ent);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	TEST_ASSERT_EQUAL_UINT32(3, num_ent);
+	memset(decmp_data, 0, chunk_size);
+	for (i = 0, offset = 0, data_offset = 0; i < num_ent; i++) {
+		const struct cmp_entity *ent = (const struct cmp_entity *)((uint8_t *)dst + offset);
+		int decmp_size;
+
+		TEST_ASSERT_EQUAL_UINT32(ent_sizes[i], cmp_ent_get_size(ent));
+		decmp_size = decompress_cmp_entiy(ent, model + data_offset, NULL,
+						  decmp_data + data_offset);
+		TEST_ASSERT_EQUAL_INT(part_sizes[i], decmp_size);
+		offset += ent_sizes[i];
+		data_offset += (size_t)decmp_size;
+	}
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(chunk, decmp_data, chunk_size);
+
+	/* error cases */
+	cmp_size = compress_chunk_split_plan(chunk, chunk_size, col_size-1, NULL, 0);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_CHUNK_TOO_LARGE, cmp_get_error_code(cmp_size));
+	cmp_size = compress_chunk_split_plan(chunk, chunk_size, 2*col_size, part_sizes, 2);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_SMALL_BUFFER, cmp_get_error_code(cmp_size));
+	cmp_size = compress_chunk_split_plan(chunk, chunk_size-1, 0, NULL, 0);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_CHUNK_SIZE_INCONSISTENT, cmp_get_error_code(cmp_size));
+	cmp_size = compress_chunk_split_plan(NULL, chunk_size, 0, NULL, 0);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_CHUNK_NULL, cmp_get_error_code(cmp_size));
+	cmp_size = compress_chunk_split(chunk, chunk_size, model, up_model, dst, dst_capacity,
+					&par, 2*col_size, ent_sizes, 2, &num_ent);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_SMALL_BUFFER, cmp_get_error_code(cmp_size));
+	cmp_size = compress_chunk_split(chunk, chunk_size, model, up_model, dst, ent_sizes[0],
+					&par, 2*col_size, ent_sizes, 3, &num_ent);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_SMALL_BUFFER, cmp_get_error_code(cmp_size));
+	cmp_size = compress_chunk_split(chunk, chunk_size, model, up_model, dst, dst_capacity,
+					&par, 2*col_size, NULL, 3, &num_ent);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_PAR_NULL, cmp_get_error_code(cmp_size));
+
+	free(chunk);
+	free(model);
+	free(up_model);
+	free(ref_up_model);
+	free(decmp_data);
+	free(dst);
+}
+
+/**
+ * @brief fill a chunk with copies of a random collection
+ *
+ * @param chunk		pointer to the chunk buffer
+ * @param num_col	number of collections in the chunk
+ * @param data_type	data type of the collections
+ * @param samples	number of samples per collection
+ *
+ * @returns the byte size of a collection
+ */
+
+static uint32_t fill_chunk_with_copies(uint8_t *chunk, uint32_t num_col,
+				       enum cmp_data_type data_type, uint32_t samples)
+{
+	uint32_t col_size, i;
+
+	col_size = (uint32_t)generate_random_collection((struct collection_hdr *)chunk, data_type,
+							samples, gen_uniform_data, NULL);
+	for (i = 1; i < num_col; i++)
+		memcpy(chunk + i * col_size, chunk, col_size);
+
+	return col_size;
+}
+
+
+/**
+ * @test compress_chunk_split_plan
+ * @test compress_chunk_cmp_size_bound
+ */
+
+void test_compress_chunk_split_plan_large_chunk(void)
+{
+	/* chunks of many small and of the largest collections */
+	static const uint32_t samples[] = {1, (UINT16_MAX - COLLECTION_HDR_SIZE) / 2};
+	uint32_t const max_part_size = CMP_ENTITY_MAX_ORIGINAL_SIZE
+		- NON_IMAGETTE_HEADER_SIZE - CMP_COLLECTION_FILD_SIZE;
+	uint32_t col_size, num_col, chunk_size, n, k, i;
+	uint32_t part_sizes[3];
+	uint8_t *chunk;
+
+	for (i = 0; i < ARRAY_SIZE(samples); i++) {
+		/* the chunk is larger than a compression entity can hold */
+		col_size = (uint32_t)generate_random_collection(NULL, DATA_TYPE_IMAGETTE, samples[i],
+								gen_uniform_data, NULL);
+		num_col = CMP_ENTITY_MAX_ORIGINAL_SIZE / col_size + 1;
+		chunk_size = num_col * col_size;
+		TEST_ASSERT(chunk_size > CMP_ENTITY_MAX_ORIGINAL_SIZE);
+		chunk = malloc(chunk_size);
+		TEST_ASSERT_NOT_NULL(chunk);
+		fill_chunk_with_copies(chunk, num_col, DATA_TYPE_IMAGETTE, samples[i]);
+
+		n = compress_chunk_split_plan(chunk, chunk_size, 0, part_sizes,
+					      ARRAY_SIZE(part_sizes));
+		TEST_ASSERT_EQUAL_UINT32(2, n);
+		TEST_ASSERT_EQUAL_UINT32(chunk_size, part_sizes[0] + part_sizes[1]);
+		TEST_ASSERT_EQUAL_UINT32(0, part_sizes[0] % col_size);
+
+		/* the worst-case compressed size and not the maximum part size
+		 * ends the first part
+		 */
+		k = part_sizes[0] / col_size;
+		TEST_ASSERT(COMPRESS_CHUNK_BOUND_UNSAFE(part_sizes[0], k) <= CMP_ENTITY_MAX_SIZE);
+		TEST_ASSERT(COMPRESS_CHUNK_BOUND_UNSAFE(part_sizes[0] + col_size, k + 1) > CMP_ENTITY_MAX_SIZE);
+		TEST_ASSERT(part_sizes[0] + col_size <= max_part_size);
+
+		/* every part fits into a compression entity, the whole chunk not */
+		TEST_ASSERT_EQUAL_UINT32(COMPRESS_CHUNK_BOUND_UNSAFE(part_sizes[0], k),
+					 compress_chunk_cmp_size_bound(chunk, part_sizes[0]));
+		TEST_ASSERT_FALSE(cmp_is_error(compress_chunk_cmp_size_bound(chunk + part_sizes[0],
+									     part_sizes[1])));
+		TEST_ASSERT_EQUAL_INT(CMP_ERROR_CHUNK_TOO_LARGE,
+				      cmp_get_error_code(compress_chunk_cmp_size_bound(chunk, chunk_size)));
+
+		/* a smaller maximum part size ends the parts earlier */
+		n = compress_chunk_split_plan(chunk, chunk_size, part_sizes[0] - 1, part_sizes,
+					      ARRAY_SIZE(part_sizes));
+		TEST_ASSERT_EQUAL_UINT32((num_col + k - 2) / (k - 1), n);
+		TEST_ASSERT_EQUAL_UINT32((k - 1) * col_size, part_sizes[0]);
+		free(chunk);
+	}
+}
+
+
+/**
+ * @test compress_chunk_iov
+ */
+
+void test_compress_chunk_iov(void)
+{
+	struct chunk_def chunk_def[3] = {{DATA_TYPE_OFFSET, 10}, {DATA_TYPE_OFFSET, 3},
+		{DATA_TYPE_OFFSET, 7}};
+	double p = 0.3;
+	uint32_t chunk_size, col0_size, dst_capacity, ref_size, cmp_size;
+	uint8_t *chunk, *model, *ref_up_model, *up_model, *pieces;
+	uint32_t *ref_dst, *dst;
+	struct cmp_par par = {0};
+	struct cmp_chunk_iov iov[3];
+
+	chunk_size = generate_random_chunk(NULL, chunk_def, ARRAY_SIZE(chunk_def),
+					   gen_geometric_data, &p);
+	dst_capacity = COMPRESS_CHUNK_BOUND(chunk_size, ARRAY_SIZE(chunk_def));
+	chunk = malloc(chunk_size);
+	model = malloc(chunk_size);
+	ref_up_model = malloc(chunk_size);
+	up_model = malloc(chunk_size);
+	pieces = malloc(chunk_size);
+	ref_dst = malloc(dst_capacity);
+	dst = malloc(dst_capacity);
+	TEST_ASSERT(chunk && model && ref_up_model && up_model && pieces && ref_dst && dst);
+	generate_random_chunk(chunk, chunk_def, ARRAY_SIZE(chunk_def), gen_geometric_data, &p);
+	generate_random_chunk(model, chunk_def, ARRAY_SIZE(chunk_def), gen_geometric_data, &p);
+	col0_size = cmp_col_get_size((struct collection_hdr *)chunk);
+
+	par.cmp_mode = CMP_MODE_MODEL_MULTI;
+	par.model_value = 8;
+	par.nc_offset_mean = 3;
+	par.nc_offset_variance = 9;
+	ref_size = compress_chunk(chunk, chunk_size, model, ref_up_model, ref_dst,
+				  dst_capacity, &par);
+	TEST_ASSERT_FALSE(cmp_is_error(ref_size));
+
+	/* the first collection and the other two collections in separate
+	 * buffers, with an empty piece in between
+	 */
+	memcpy(pieces, chunk + col0_size, chunk_size - col0_size);
+	memcpy(pieces + chunk_size - col0_size, chunk, col0_size);
+	iov[0].data = pieces + chunk_size - col0_size;
+	iov[0].model = model;
+	iov[0].up_model = up_model;
+	iov[0].size = col0_size;
+	iov[1].data = pieces;
+	iov[1].model = NULL;
+	iov[1].up_model = NULL;
+	iov[1].size = 0;
+	iov[2].data = pieces;
+	iov[2].model = model + col0_size;
+	iov[2].up_model = up_model + col0_size;
+	iov[2].size = chunk_size - col0_size;
+
+	TEST_ASSERT_EQUAL_UINT32(ref_size, compress_chunk_iov(iov, 3, NULL, 0, &par));
+	cmp_size = compress_chunk_iov(iov, 3, dst, dst_capacity, &par);
+	TEST_ASSERT_EQUAL_UINT32(ref_size, cmp_size);
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(ref_dst, dst, ref_size);
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(ref_up_model, up_model, chunk_size);
+
+	/* error cases */
+	iov[2].size--;
+	cmp_size = compress_chunk_iov(iov, 3, dst, dst_capacity, &par);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_CHUNK_SIZE_INCONSISTENT, cmp_get_error_code(cmp_size));
+	iov[2].size++;
+	iov[2].model = NULL;
+	cmp_size = compress_chunk_iov(iov, 3, dst, dst_capacity, &par);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_PAR_NO_MODEL, cmp_get_error_code(cmp_size));
+	iov[2].data = NULL;
+	cmp_size = compress_chunk_iov(iov, 3, dst, dst_capacity, &par);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_CHUNK_NULL, cmp_get_error_code(cmp_size));
+	cmp_size = compress_chunk_iov(iov, 0, dst, dst_capacity, &par);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_CHUNK_NULL, cmp_get_error_code(cmp_size));
+	cmp_size = compress_chunk_iov(iov, 1, dst, dst_capacity, NULL);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_PAR_NULL, cmp_get_error_code(cmp_size));
+
+	free(chunk);
+	free(model);
+	free(ref_up_model);
+	free(up_model);
+	free(pieces);
+	free(ref_dst);
+	free(dst);
+}
+
+
+/**
+ * @test compress_chunk_seg
+ */
+
+void test_compress_chunk_seg(void)
+{
+	enum { MAX_SEG = 64 };
+	/* unaligned segments use the staging buffer, aligned ones are written
+	 * directly if a collection fits
+	 */
+	static const uint32_t seg_sizes[] = {37, 256};
+	struct chunk_def chunk_def[3] = {{DATA_TYPE_BACKGROUND, 41}, {DATA_TYPE_BACKGROUND, 1},
+		{DATA_TYPE_BACKGROUND, 17}};
+	enum cmp_mode const cmp_modes[] = {CMP_MODE_DIFF_ZERO, CMP_MODE_MODEL_MULTI, CMP_MODE_RAW};
+	double p = 0.3;
+	uint32_t chunk_size, dst_capacity, ref_size, cmp_size, seg_size = 0, i, j, s;
+	uint8_t *chunk, *model, *ref_up_model, *up_model, *out;
+	uint32_t *ref_dst, *stage;
+	void *seg[MAX_SEG];
+	struct cmp_seg_sink sink;
+	struct cmp_par par = {0};
+
+	chunk_size = generate_random_chunk(NULL, chunk_def, ARRAY_SIZE(chunk_def),
+					   gen_geometric_data, &p);
+	dst_capacity = COMPRESS_CHUNK_BOUND(chunk_size, ARRAY_SIZE(chunk_def));
+	TEST_ASSERT(dst_capacity <= seg_sizes[0] * MAX_SEG);
+	chunk = malloc(chunk_size);
+	model = malloc(chunk_size);
+	ref_up_model = malloc(chunk_size);
+	up_model = malloc(chunk_size);
+	ref_dst = malloc(dst_capacity);
+	out = malloc(seg_sizes[ARRAY_SIZE(seg_sizes)-1] * MAX_SEG);
+	stage = malloc(CMP_SEG_STAGE_SIZE);
+	TEST_ASSERT(chunk && model && ref_up_model && up_model && ref_dst && out && stage);
+	generate_random_chunk(chunk, chunk_def, ARRAY_SIZE(chunk_def), gen_geometric_data, &p);
+	generate_random_chunk(model, chunk_def, ARRAY_SIZE(chunk_def), gen_geometric_data, &p);
+
+	par.model_value = 5;
+	par.nc_background_mean = 2;
+	par.nc_background_variance = 3;
+	par.nc_background_outlier_pixels = 4;
+	for (j = 0; j < ARRAY_SIZE(seg_sizes); j++) {
+		seg_size = seg_sizes[j];
+
+		/* the segments are not in memory order */
+		for (s = 0; s < MAX_SEG; s++)
+			seg[s] = out + (MAX_SEG - 1 - s) * seg_size;
+		sink.seg = seg;
+		sink.num_seg = MAX_SEG;
+		sink.seg_size = seg_size;
+		sink.stage = stage;
+
+		for (i = 0; i < ARRAY_SIZE(cmp_modes); i++) {
+			par.cmp_mode = cmp_modes[i];
+			ref_size = compress_chunk(chunk, chunk_size, model, ref_up_model, ref_dst,
+						  dst_capacity, &par);
+			TEST_ASSERT_FALSE(cmp_is_error(ref_size));
+
+			cmp_size = compress_chunk_seg(chunk, chunk_size, model, up_model, &sink, &par);
+			TEST_ASSERT_EQUAL_UINT32(ref_size, cmp_size);
+			for (s = 0; s * seg_size < cmp_size; s++) {
+				uint32_t n = cmp_size - s * seg_size;
+
+				TEST_ASSERT_EQUAL_HEX8_ARRAY((uint8_t *)ref_dst + s * seg_size, seg[s],
+							     n < seg_size ? n : seg_size);
+			}
+			if (model_mode_is_used(par.cmp_mode))
+				TEST_ASSERT_EQUAL_HEX8_ARRAY(ref_up_model, up_model, chunk_size);
+		}
+	}
+
+	/* error cases */
+	sink.num_seg = (cmp_size - 1) / seg_size;
+	cmp_size = compress_chunk_seg(chunk, chunk_size, model, up_model, &sink, &par);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_SMALL_BUFFER, cmp_get_error_code(cmp_size));
+	sink.num_seg = MAX_SEG;
+	sink.stage = NULL;
+	cmp_size = compress_chunk_seg(chunk, chunk_size, model, up_model, &sink, &par);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_PAR_NULL, cmp_get_error_code(cmp_size));
+	sink.stage = stage;
+	sink.seg_size = 0;
+	cmp_size = compress_chunk_seg(chunk, chunk_size, model, up_model, &sink, &par);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_PAR_BUFFERS, cmp_get_error_code(cmp_size));
+	cmp_size = compress_chunk_seg(chunk, chunk_size, model, up_model, NULL, &par);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_PAR_NULL, cmp_get_error_code(cmp_size));
+
+	free(chunk);
+	free(model);
+	free(ref_up_model);
+	free(up_model);
+	free(ref_dst);
+	free(out);
+	free(stage);
+}
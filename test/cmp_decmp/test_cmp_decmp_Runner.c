@@ -14,6 +14,13 @@ extern void test_cmp_collection_imagette_worst_case(void);
 extern void test_cmp_decmp_chunk_raw(void);
 extern void test_cmp_decmp_chunk_worst_case(void);
 extern void test_cmp_decmp_diff(void);
+extern void test_cmp_decmp_lossy(void);
+extern void test_cmp_decmp_adaptive(void);
+extern void test_cmp_decmp_batch(void);
+extern void test_compress_chunk_split(void);
+extern void test_compress_chunk_split_plan_large_chunk(void);
+extern void test_compress_chunk_iov(void);
+extern void test_compress_chunk_seg(void);
 
 
 /*=======Mock Management=====*/
@@ -76,16 +83,23 @@ static void run_test(UnityTestFunction func, const char* name, UNITY_LINE_TYPE l
 int main(void)
 {
   UnityBegin("../test/cmp_decmp/test_cmp_decmp.c");
-  run_test(test_random_round_trip_like_rdcu_compression, "test_random_round_trip_like_rdcu_compression", 808);
-  run_test(test_random_compression_decompress_rdcu_data, "test_random_compression_decompress_rdcu_data", 893);
-  run_test(test_random_collection_round_trip, "test_random_collection_round_trip", 944);
-  run_test(test_cmp_collection_raw, "test_cmp_collection_raw", 1063);
-  run_test(test_cmp_collection_diff, "test_cmp_collection_diff", 1133);
-  run_test(test_cmp_collection_worst_case, "test_cmp_collection_worst_case", 1217);
-  run_test(test_cmp_collection_imagette_worst_case, "test_cmp_collection_imagette_worst_case", 1304);
-  run_test(test_cmp_decmp_chunk_raw, "test_cmp_decmp_chunk_raw", 1390);
-  run_test(test_cmp_decmp_chunk_worst_case, "test_cmp_decmp_chunk_worst_case", 1491);
-  run_test(test_cmp_decmp_diff, "test_cmp_decmp_diff", 1602);
+  run_test(test_random_round_trip_like_rdcu_compression, "test_random_round_trip_like_rdcu_compression", 816);
+  run_test(test_random_compression_decompress_rdcu_data, "test_random_compression_decompress_rdcu_data", 901);
+  run_test(test_random_collection_round_trip, "test_random_collection_round_trip", 957);
+  run_test(test_cmp_collection_raw, "test_cmp_collection_raw", 1077);
+  run_test(test_cmp_collection_diff, "test_cmp_collection_diff", 1147);
+  run_test(test_cmp_collection_worst_case, "test_cmp_collection_worst_case", 1231);
+  run_test(test_cmp_collection_imagette_worst_case, "test_cmp_collection_imagette_worst_case", 1318);
+  run_test(test_cmp_decmp_chunk_raw, "test_cmp_decmp_chunk_raw", 1404);
+  run_test(test_cmp_decmp_chunk_worst_case, "test_cmp_decmp_chunk_worst_case", 1505);
+  run_test(test_cmp_decmp_diff, "test_cmp_decmp_diff", 1616);
+  run_test(test_cmp_decmp_lossy, "test_cmp_decmp_lossy", 1712);
+  run_test(test_cmp_decmp_adaptive, "test_cmp_decmp_adaptive", 1833);
+  run_test(test_cmp_decmp_batch, "test_cmp_decmp_batch", 1912);
+  run_test(test_compress_chunk_split, "test_compress_chunk_split", 2041);
+  run_test(test_compress_chunk_split_plan_large_chunk, "test_compress_chunk_split_plan_large_chunk", 2171);
+  run_test(test_compress_chunk_iov, "test_compress_chunk_iov", 2237);
+  run_test(test_compress_chunk_seg, "test_compress_chunk_seg", 2325);
 
   return UnityEnd();
 }
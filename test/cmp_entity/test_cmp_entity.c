@@ -1741,6 +1741,156 @@ void test_cmp_ent_write_rdcu_cmp_pars(void)
 }
 
 
+/**
+ * @test cmp_ent_hdr_encode
+ * @test cmp_ent_hdr_decode
+ */
+
+void test_cmp_ent_hdr_encode_decode(void)
+{
+	uint8_t ent_buf[NON_IMAGETTE_HEADER_SIZE];
+	struct cmp_entity *ent = (struct cmp_entity *)ent_buf;
+	struct cmp_ent_hdr hdr, hdr_read;
+	unsigned int i;
+
+	/* non-imagette header; the fields have to match the get functions */
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.version_id = 0x80000042;
+	hdr.cmp_ent_size = NON_IMAGETTE_HEADER_SIZE;
+	hdr.original_size = 0xFEDCBA;
+	hdr.start_timestamp = 0x123456789ABCULL;
+	hdr.end_timestamp = 0xFFFFFFFFFFFFULL;
+	hdr.data_type = DATA_TYPE_CHUNK;
+	hdr.cmp_mode = CMP_MODE_DIFF_MULTI;
+	hdr.model_value = 11;
+	hdr.model_id = 0xABCD;
+	hdr.model_counter = 0xEF;
+	hdr.reserved = 0x55;
+	hdr.lossy_cmp_par = 0x1234;
+	for (i = 0; i < CMP_ENT_MAX_PARS; i++) {
+		hdr.spill[i] = 0xFFFFFF - i;
+		hdr.cmp_par[i] = 0xFFFF - i;
+	}
+	memset(ent_buf, 0xFF, sizeof(ent_buf));
+	TEST_ASSERT_EQUAL_INT(0, cmp_ent_hdr_encode(ent, &hdr));
+
+	TEST_ASSERT_EQUAL_HEX32(hdr.version_id, cmp_ent_get_version_id(ent));
+	TEST_ASSERT_EQUAL_UINT32(hdr.cmp_ent_size, cmp_ent_get_size(ent));
+	TEST_ASSERT_EQUAL_UINT32(hdr.original_size, cmp_ent_get_original_size(ent));
+	TEST_ASSERT_EQUAL_HEX64(hdr.start_timestamp, cmp_ent_get_start_timestamp(ent));
+	TEST_ASSERT_EQUAL_HEX64(hdr.end_timestamp, cmp_ent_get_end_timestamp(ent));
+	TEST_ASSERT_EQUAL_INT(DATA_TYPE_CHUNK, cmp_ent_get_data_type(ent));
+	TEST_ASSERT_EQUAL_INT(0, cmp_ent_get_data_type_raw_bit(ent));
+	TEST_ASSERT_EQUAL_INT(CMP_MODE_DIFF_MULTI, cmp_ent_get_cmp_mode(ent));
+	TEST_ASSERT_EQUAL_INT(11, cmp_ent_get_model_value(ent));
+	TEST_ASSERT_EQUAL_HEX16(0xABCD, cmp_ent_get_model_id(ent));
+	TEST_ASSERT_EQUAL_HEX8(0xEF, cmp_ent_get_model_counter(ent));
+	TEST_ASSERT_EQUAL_HEX8(0x55, cmp_ent_get_reserved(ent));
+	TEST_ASSERT_EQUAL_HEX16(0x1234, cmp_ent_get_lossy_cmp_par(ent));
+	TEST_ASSERT_EQUAL_HEX32(0xFFFFFF, cmp_ent_get_non_ima_spill1(ent));
+	TEST_ASSERT_EQUAL_HEX16(0xFFFF, cmp_ent_get_non_ima_cmp_par1(ent));
+	TEST_ASSERT_EQUAL_HEX32(0xFFFFFE, cmp_ent_get_non_ima_spill2(ent));
+	TEST_ASSERT_EQUAL_HEX16(0xFFFE, cmp_ent_get_non_ima_cmp_par2(ent));
+	TEST_ASSERT_EQUAL_HEX32(0xFFFFFD, cmp_ent_get_non_ima_spill3(ent));
+	TEST_ASSERT_EQUAL_HEX16(0xFFFD, cmp_ent_get_non_ima_cmp_par3(ent));
+	TEST_ASSERT_EQUAL_HEX32(0xFFFFFC, cmp_ent_get_non_ima_spill4(ent));
+	TEST_ASSERT_EQUAL_HEX16(0xFFFC, cmp_ent_get_non_ima_cmp_par4(ent));
+	TEST_ASSERT_EQUAL_HEX32(0xFFFFFB, cmp_ent_get_non_ima_spill5(ent));
+	TEST_ASSERT_EQUAL_HEX16(0xFFFB, cmp_ent_get_non_ima_cmp_par5(ent));
+	TEST_ASSERT_EQUAL_HEX32(0xFFFFFA, cmp_ent_get_non_ima_spill6(ent));
+	TEST_ASSERT_EQUAL_HEX16(0xFFFA, cmp_ent_get_non_ima_cmp_par6(ent));
+	TEST_ASSERT_EQUAL_HEX16(0, ent->non_ima.spare);
+
+	TEST_ASSERT_EQUAL_INT(0, cmp_ent_hdr_decode(ent, sizeof(ent_buf), &hdr_read));
+	TEST_ASSERT_EQUAL_MEMORY(&hdr, &hdr_read, sizeof(hdr));
+
+	/* adaptive imagette header */
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.cmp_ent_size = IMAGETTE_ADAPTIVE_HEADER_SIZE + 4;
+	hdr.data_type = DATA_TYPE_SAT_IMAGETTE_ADAPTIVE;
+	hdr.cmp_mode = CMP_MODE_MODEL_ZERO;
+	for (i = 0; i < 3; i++) {
+		hdr.spill[i] = 0xFFFF - i;
+		hdr.cmp_par[i] = 0xFF - i;
+	}
+	memset(ent_buf, 0xFF, sizeof(ent_buf));
+	TEST_ASSERT_EQUAL_INT(0, cmp_ent_hdr_encode(ent, &hdr));
+	TEST_ASSERT_EQUAL_INT(DATA_TYPE_SAT_IMAGETTE_ADAPTIVE, cmp_ent_get_data_type(ent));
+	TEST_ASSERT_EQUAL_HEX16(0xFFFF, cmp_ent_get_ima_spill(ent));
+	TEST_ASSERT_EQUAL_HEX8(0xFF, cmp_ent_get_ima_golomb_par(ent));
+	TEST_ASSERT_EQUAL_HEX16(0xFFFE, cmp_ent_get_ima_ap1_spill(ent));
+	TEST_ASSERT_EQUAL_HEX8(0xFE, cmp_ent_get_ima_ap1_golomb_par(ent));
+	TEST_ASSERT_EQUAL_HEX16(0xFFFD, cmp_ent_get_ima_ap2_spill(ent));
+	TEST_ASSERT_EQUAL_HEX8(0xFD, cmp_ent_get_ima_ap2_golomb_par(ent));
+	TEST_ASSERT_EQUAL_HEX8(0, ent->ima.spare2);
+	TEST_ASSERT_EQUAL_HEX16(0, ent->ima.spare3);
+	TEST_ASSERT_EQUAL_INT(0, cmp_ent_hdr_decode(ent, sizeof(ent_buf), &hdr_read));
+	TEST_ASSERT_EQUAL_MEMORY(&hdr, &hdr_read, sizeof(hdr));
+
+	/* raw mode headers have no specific header */
+	memset(&hdr, 0, sizeof(hdr));
+	hdr.cmp_ent_size = GENERIC_HEADER_SIZE;
+	hdr.data_type = DATA_TYPE_IMAGETTE;
+	hdr.raw_mode_flag = 1;
+	memset(ent_buf, 0xFF, sizeof(ent_buf));
+	TEST_ASSERT_EQUAL_INT(0, cmp_ent_hdr_encode(ent, &hdr));
+	TEST_ASSERT_EQUAL_INT(1, cmp_ent_get_data_type_raw_bit(ent));
+	TEST_ASSERT_EQUAL_HEX8(0xFF, ent_buf[GENERIC_HEADER_SIZE]);
+	TEST_ASSERT_EQUAL_INT(0, cmp_ent_hdr_decode(ent, sizeof(ent_buf), &hdr_read));
+	TEST_ASSERT_EQUAL_MEMORY(&hdr, &hdr_read, sizeof(hdr));
+
+	/* error cases */
+	memcpy(&hdr_read, &hdr, sizeof(hdr));
+	hdr_read.lossy_cmp_par = 0x10000;
+	memset(ent_buf, 0xAB, sizeof(ent_buf));
+	TEST_ASSERT_EQUAL_INT(-1, cmp_ent_hdr_encode(ent, &hdr_read));
+	TEST_ASSERT_EQUAL_HEX8(0xAB, ent_buf[0]); /* the entity is not modified */
+	hdr_read = hdr;
+	hdr_read.end_timestamp = 0x1000000000000ULL;
+	TEST_ASSERT_EQUAL_INT(-1, cmp_ent_hdr_encode(ent, &hdr_read));
+	hdr_read = hdr;
+	hdr_read.data_type = DATA_TYPE_UNKNOWN;
+	TEST_ASSERT_EQUAL_INT(-1, cmp_ent_hdr_encode(ent, &hdr_read));
+	hdr_read = hdr;
+	hdr_read.raw_mode_flag = 0;
+	hdr_read.spill[0] = 0x10000;
+	TEST_ASSERT_EQUAL_INT(-1, cmp_ent_hdr_encode(ent, &hdr_read));
+	TEST_ASSERT_EQUAL_INT(-1, cmp_ent_hdr_encode(NULL, &hdr));
+	TEST_ASSERT_EQUAL_INT(-1, cmp_ent_hdr_encode(ent, NULL));
+
+	/* the entity is smaller than its header */
+	hdr_read = hdr;
+	hdr_read.raw_mode_flag = 0;
+	hdr_read.cmp_ent_size = IMAGETTE_HEADER_SIZE - 1;
+	TEST_ASSERT_EQUAL_INT(0, cmp_ent_hdr_encode(ent, &hdr_read));
+	TEST_ASSERT_EQUAL_INT(-1, cmp_ent_hdr_decode(ent, sizeof(ent_buf), &hdr_read));
+	/* unknown data product type */
+	cmp_ent_set_size(ent, IMAGETTE_HEADER_SIZE);
+	ent->data_type = 0xFFFF;
+	TEST_ASSERT_EQUAL_INT(-1, cmp_ent_hdr_decode(ent, sizeof(ent_buf), &hdr_read));
+	TEST_ASSERT_EQUAL_INT(DATA_TYPE_UNKNOWN, hdr_read.data_type);
+
+	/* the entity is truncated by the end of the buffer */
+	hdr_read = hdr;
+	hdr_read.raw_mode_flag = 0;
+	hdr_read.data_type = DATA_TYPE_CHUNK;
+	hdr_read.cmp_ent_size = NON_IMAGETTE_HEADER_SIZE;
+	TEST_ASSERT_EQUAL_INT(0, cmp_ent_hdr_encode(ent, &hdr_read));
+	TEST_ASSERT_EQUAL_INT(0, cmp_ent_hdr_decode(ent, NON_IMAGETTE_HEADER_SIZE, &hdr_read));
+	TEST_ASSERT_EQUAL_INT(-1, cmp_ent_hdr_decode(ent, NON_IMAGETTE_HEADER_SIZE-1, &hdr_read));
+	TEST_ASSERT_EQUAL_INT(-1, cmp_ent_hdr_decode(ent, GENERIC_HEADER_SIZE, &hdr_read));
+	TEST_ASSERT_EQUAL_INT(-1, cmp_ent_hdr_decode(ent, GENERIC_HEADER_SIZE-1, &hdr_read));
+	TEST_ASSERT_EQUAL_INT(-1, cmp_ent_hdr_decode(ent, 0, &hdr_read));
+	/* the header claims more data than the buffer holds */
+	cmp_ent_set_size(ent, 200);
+	TEST_ASSERT_EQUAL_INT(-1, cmp_ent_hdr_decode(ent, sizeof(ent_buf), &hdr_read));
+	TEST_ASSERT_EQUAL_INT(0, cmp_ent_hdr_decode(ent, 200, &hdr_read));
+
+	TEST_ASSERT_EQUAL_INT(-1, cmp_ent_hdr_decode(NULL, sizeof(ent_buf), &hdr_read));
+	TEST_ASSERT_EQUAL_INT(-1, cmp_ent_hdr_decode(ent, sizeof(ent_buf), NULL));
+}
+
+
 /**
  * @test cmp_ent_create
  */
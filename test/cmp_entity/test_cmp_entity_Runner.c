@@ -44,6 +44,7 @@ extern void test_cmp_ent_get_data_buf_const(void);
 extern void test_cmp_ent_get_cmp_data(void);
 extern void test_cmp_ent_get_cmp_data_size(void);
 extern void test_cmp_ent_write_rdcu_cmp_pars(void);
+extern void test_cmp_ent_hdr_encode_decode(void);
 extern void test_cmp_ent_create(void);
 extern void test_cmp_ent_create_timestamp(void);
 extern void test_cmp_ent_print(void);
@@ -113,50 +114,51 @@ static void run_test(UnityTestFunction func, const char* name, UNITY_LINE_TYPE l
 int main(void)
 {
   UnityBegin("../test/cmp_entity/test_cmp_entity.c");
-  run_test(test_cmp_ent_cal_hdr_size, "test_cmp_ent_cal_hdr_size", 40);
-  run_test(test_ent_version_id, "test_ent_version_id", 95);
-  run_test(test_ent_size, "test_ent_size", 129);
-  run_test(test_ent_original_size, "test_ent_original_size", 165);
-  run_test(test_ent_start_timestamp, "test_ent_start_timestamp", 201);
-  run_test(test_ent_coarse_start_time, "test_ent_coarse_start_time", 247);
-  run_test(test_ent_fine_start_time, "test_ent_fine_start_time", 281);
-  run_test(test_ent_end_timestamp, "test_ent_end_timestamp", 313);
-  run_test(test_ent_coarse_end_time, "test_ent_coarse_end_time", 359);
-  run_test(test_ent_fine_end_time, "test_ent_fine_end_time", 393);
-  run_test(test_cmp_ent_data_type, "test_cmp_ent_data_type", 426);
-  run_test(test_ent_cmp_mode, "test_ent_cmp_mode", 484);
-  run_test(test_ent_model_value, "test_ent_model_value", 517);
-  run_test(test_ent_model_id, "test_ent_model_id", 550);
-  run_test(test_ent_model_counter, "test_ent_model_counter", 584);
-  run_test(test_ent_reserved, "test_ent_reserved", 617);
-  run_test(test_ent_lossy_cmp_par, "test_ent_lossy_cmp_par", 647);
-  run_test(test_ent_ima_spill, "test_ent_ima_spill", 681);
-  run_test(test_ent_ima_golomb_par, "test_ent_ima_golomb_par", 715);
-  run_test(test_ent_ima_ap1_spill, "test_ent_ima_ap1_spill", 748);
-  run_test(test_ent_ima_ap1_golomb_par, "test_ent_ima_ap1_golomb_par", 782);
-  run_test(test_ent_ima_ap2_spill, "test_ent_ima_ap2_spill", 815);
-  run_test(test_ent_ima_ap2_golomb_par, "test_ent_ima_ap2_golomb_par", 849);
-  run_test(test_ent_non_ima_spill1, "test_ent_non_ima_spill1", 882);
-  run_test(test_ent_non_ima_cmp_par1, "test_ent_non_ima_cmp_par1", 917);
-  run_test(test_ent_non_ima_spill2, "test_ent_non_ima_spill2", 951);
-  run_test(test_ent_non_ima_cmp_par2, "test_ent_non_ima_cmp_par2", 986);
-  run_test(test_ent_non_ima_spill3, "test_ent_non_ima_spill3", 1020);
-  run_test(test_ent_non_ima_cmp_par3, "test_ent_non_ima_cmp_par3", 1055);
-  run_test(test_ent_non_ima_spill4, "test_ent_non_ima_spill4", 1089);
-  run_test(test_ent_non_ima_cmp_par4, "test_ent_non_ima_cmp_par4", 1124);
-  run_test(test_ent_non_ima_spill5, "test_ent_non_ima_spill5", 1158);
-  run_test(test_ent_non_ima_cmp_par5, "test_ent_non_ima_cmp_par5", 1193);
-  run_test(test_ent_non_ima_spill6, "test_ent_non_ima_spill6", 1227);
-  run_test(test_ent_non_ima_cmp_par6, "test_ent_non_ima_cmp_par6", 1262);
-  run_test(test_cmp_ent_get_data_buf, "test_cmp_ent_get_data_buf", 1295);
-  run_test(test_cmp_ent_get_data_buf_const, "test_cmp_ent_get_data_buf_const", 1351);
-  run_test(test_cmp_ent_get_cmp_data, "test_cmp_ent_get_cmp_data", 1407);
-  run_test(test_cmp_ent_get_cmp_data_size, "test_cmp_ent_get_cmp_data_size", 1461);
-  run_test(test_cmp_ent_write_rdcu_cmp_pars, "test_cmp_ent_write_rdcu_cmp_pars", 1489);
-  run_test(test_cmp_ent_create, "test_cmp_ent_create", 1745);
-  run_test(test_cmp_ent_create_timestamp, "test_cmp_ent_create_timestamp", 1856);
-  run_test(test_cmp_ent_print, "test_cmp_ent_print", 1898);
-  run_test(test_cmp_ent_parse, "test_cmp_ent_parse", 1965);
+  run_test(test_cmp_ent_cal_hdr_size, "test_cmp_ent_cal_hdr_size", 43);
+  run_test(test_ent_version_id, "test_ent_version_id", 98);
+  run_test(test_ent_size, "test_ent_size", 132);
+  run_test(test_ent_original_size, "test_ent_original_size", 168);
+  run_test(test_ent_start_timestamp, "test_ent_start_timestamp", 204);
+  run_test(test_ent_coarse_start_time, "test_ent_coarse_start_time", 250);
+  run_test(test_ent_fine_start_time, "test_ent_fine_start_time", 284);
+  run_test(test_ent_end_timestamp, "test_ent_end_timestamp", 316);
+  run_test(test_ent_coarse_end_time, "test_ent_coarse_end_time", 362);
+  run_test(test_ent_fine_end_time, "test_ent_fine_end_time", 396);
+  run_test(test_cmp_ent_data_type, "test_cmp_ent_data_type", 429);
+  run_test(test_ent_cmp_mode, "test_ent_cmp_mode", 487);
+  run_test(test_ent_model_value, "test_ent_model_value", 520);
+  run_test(test_ent_model_id, "test_ent_model_id", 553);
+  run_test(test_ent_model_counter, "test_ent_model_counter", 587);
+  run_test(test_ent_reserved, "test_ent_reserved", 620);
+  run_test(test_ent_lossy_cmp_par, "test_ent_lossy_cmp_par", 650);
+  run_test(test_ent_ima_spill, "test_ent_ima_spill", 684);
+  run_test(test_ent_ima_golomb_par, "test_ent_ima_golomb_par", 718);
+  run_test(test_ent_ima_ap1_spill, "test_ent_ima_ap1_spill", 751);
+  run_test(test_ent_ima_ap1_golomb_par, "test_ent_ima_ap1_golomb_par", 785);
+  run_test(test_ent_ima_ap2_spill, "test_ent_ima_ap2_spill", 818);
+  run_test(test_ent_ima_ap2_golomb_par, "test_ent_ima_ap2_golomb_par", 852);
+  run_test(test_ent_non_ima_spill1, "test_ent_non_ima_spill1", 885);
+  run_test(test_ent_non_ima_cmp_par1, "test_ent_non_ima_cmp_par1", 920);
+  run_test(test_ent_non_ima_spill2, "test_ent_non_ima_spill2", 954);
+  run_test(test_ent_non_ima_cmp_par2, "test_ent_non_ima_cmp_par2", 989);
+  run_test(test_ent_non_ima_spill3, "test_ent_non_ima_spill3", 1023);
+  run_test(test_ent_non_ima_cmp_par3, "test_ent_non_ima_cmp_par3", 1058);
+  run_test(test_ent_non_ima_spill4, "test_ent_non_ima_spill4", 1092);
+  run_test(test_ent_non_ima_cmp_par4, "test_ent_non_ima_cmp_par4", 1127);
+  run_test(test_ent_non_ima_spill5, "test_ent_non_ima_spill5", 1161);
+  run_test(test_ent_non_ima_cmp_par5, "test_ent_non_ima_cmp_par5", 1196);
+  run_test(test_ent_non_ima_spill6, "test_ent_non_ima_spill6", 1230);
+  run_test(test_ent_non_ima_cmp_par6, "test_ent_non_ima_cmp_par6", 1265);
+  run_test(test_cmp_ent_get_data_buf, "test_cmp_ent_get_data_buf", 1298);
+  run_test(test_cmp_ent_get_data_buf_const, "test_cmp_ent_get_data_buf_const", 1354);
+  run_test(test_cmp_ent_get_cmp_data, "test_cmp_ent_get_cmp_data", 1410);
+  run_test(test_cmp_ent_get_cmp_data_size, "test_cmp_ent_get_cmp_data_size", 1464);
+  run_test(test_cmp_ent_write_rdcu_cmp_pars, "test_cmp_ent_write_rdcu_cmp_pars", 1492);
+  run_test(test_cmp_ent_hdr_encode_decode, "test_cmp_ent_hdr_encode_decode", 1749);
+  run_test(test_cmp_ent_create, "test_cmp_ent_create", 1881);
+  run_test(test_cmp_ent_create_timestamp, "test_cmp_ent_create_timestamp", 1992);
+  run_test(test_cmp_ent_print, "test_cmp_ent_print", 2034);
+  run_test(test_cmp_ent_parse, "test_cmp_ent_parse", 2101);
 
   return UnityEnd();
 }
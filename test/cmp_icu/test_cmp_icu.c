@@ -36,6 +36,7 @@
 #include <cmp_icu.h>
 #include <cmp_data_types.h>
 #include <cmp_rdcu_cfg.h>
+#define CMP_TRACE 1 /* compile in the timing instrumentation */
 #include "../../lib/icu_compress/cmp_icu.c" /* this is a hack to test static functions */
 
 
@@ -65,6 +66,11 @@ void setUp(void)
 		cmp_rand_seed(seed);
 		printf("seed: 0x%08"PRIx32"%08"PRIx32"\n", seed_up, seed_down);
 	}
+
+	/* a failed test may leave a statistics sink or a trace buffer on its
+	 * stack behind */
+	compress_chunk_set_stats(NULL);
+	cmp_trace_init(NULL, NULL, 0);
 }
 
 
@@ -1249,6 +1255,127 @@ void test_compress_imagette_diff(void)
 	rcfg.icu_output_buf = NULL;
 	cmp_size = compress_like_rdcu(&rcfg, NULL);
 	TEST_ASSERT_EQUAL_INT(66, cmp_size);
+
+	/* the RDCU has no adaptive compression modes */
+	rcfg.cmp_mode = CMP_MODE_DIFF_ADAPTIVE;
+	cmp_size = compress_like_rdcu(&rcfg, NULL);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_PAR_GENERIC, cmp_get_error_code(cmp_size));
+}
+
+
+/**
+ * @test compress_like_rdcu_trials
+ * @test compress_like_rdcu
+ * @test compress_imagette
+ */
+
+void test_compress_like_rdcu_trials(void)
+{
+	enum {SAMPLES = 200};
+	static const enum cmp_mode modes[] = {CMP_MODE_RAW, CMP_MODE_MODEL_ZERO,
+		CMP_MODE_DIFF_ZERO, CMP_MODE_MODEL_MULTI, CMP_MODE_DIFF_MULTI};
+	uint16_t data[SAMPLES], model[SAMPLES], up_model[SAMPLES], up_model_ref[SAMPLES];
+	uint32_t output_buf[SAMPLES], output_buf_ref[SAMPLES];
+	struct cmp_par_trial trials[CMP_MAX_PAR_TRIALS] = {
+		{1, 8, 0}, {2, 20, 0}, {3, 30, 0}, {4, 60, 0}, {7, 100, 0},
+		{16, 500, 0}, {63, 1000, 0},
+		{2, 1000, 0} /* invalid spillover threshold */
+	};
+	struct rdcu_cfg rcfg;
+	struct cmp_info info, info_ref;
+	struct cmp_cfg cfg = {0};
+	struct cmp_col_stats col_stats = {0};
+	uint32_t cmp_size, cmp_size_ref, i;
+	size_t m;
+
+	for (i = 0; i < SAMPLES; i++) {
+		data[i] = (uint16_t)cmp_rand_between(0, 200);
+		model[i] = (uint16_t)cmp_rand_between(0, 200);
+	}
+
+	for (m = 0; m < ARRAY_SIZE(modes); m++) {
+		TEST_ASSERT_FALSE(rdcu_cfg_create(&rcfg, modes[m], 8, CMP_LOSSLESS));
+		rcfg.input_buf = data;
+		rcfg.model_buf = model;
+		rcfg.samples = SAMPLES;
+		rcfg.buffer_length = 2*SAMPLES;
+		rcfg.golomb_par = 5;
+		rcfg.spill = 40;
+
+		/* reference: a compression for every parameter pair */
+		rcfg.icu_output_buf = output_buf_ref;
+		rcfg.icu_new_model_buf = up_model_ref;
+		cmp_size_ref = compress_like_rdcu(&rcfg, &info_ref);
+		TEST_ASSERT_FALSE(cmp_is_error(cmp_size_ref));
+
+		rcfg.icu_output_buf = output_buf;
+		rcfg.icu_new_model_buf = up_model;
+		cmp_size = compress_like_rdcu_trials(&rcfg, &info, trials, ARRAY_SIZE(trials));
+		TEST_ASSERT_EQUAL_UINT32(cmp_size_ref, cmp_size);
+		TEST_ASSERT_EQUAL_UINT32(cmp_size_ref, info.cmp_size);
+		TEST_ASSERT_EQUAL_HEX8_ARRAY(output_buf_ref, output_buf, (cmp_size+7)/8);
+		if (model_mode_is_used(modes[m]))
+			TEST_ASSERT_EQUAL_HEX16_ARRAY(up_model_ref, up_model, SAMPLES);
+
+		rcfg.icu_output_buf = NULL;
+		rcfg.icu_new_model_buf = NULL;
+		for (i = 0; i < ARRAY_SIZE(trials); i++) {
+			rcfg.golomb_par = trials[i].golomb_par;
+			rcfg.spill = trials[i].spill;
+			cmp_size_ref = compress_like_rdcu(&rcfg, NULL);
+			if (cmp_is_error(cmp_size_ref))
+				cmp_size_ref = 0;
+			TEST_ASSERT_EQUAL_UINT32(cmp_size_ref, trials[i].cmp_size);
+		}
+		if (!raw_mode_is_used(modes[m]))
+			TEST_ASSERT_EQUAL_UINT32(0, trials[ARRAY_SIZE(trials)-1].cmp_size);
+	}
+
+	/* the adaptive sizes of compress_like_rdcu() are parameter trials */
+	rcfg.golomb_par = 5;
+	rcfg.spill = 40;
+	rcfg.ap1_golomb_par = trials[1].golomb_par;
+	rcfg.ap1_spill = trials[1].spill;
+	rcfg.ap2_golomb_par = trials[4].golomb_par;
+	rcfg.ap2_spill = trials[4].spill;
+	cmp_size = compress_like_rdcu(&rcfg, &info);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	TEST_ASSERT_EQUAL_UINT32(trials[1].cmp_size, info.ap1_cmp_size);
+	TEST_ASSERT_EQUAL_UINT32(trials[4].cmp_size, info.ap2_cmp_size);
+
+	/* error cases */
+	cmp_size = compress_like_rdcu_trials(&rcfg, NULL, trials, CMP_MAX_PAR_TRIALS+1);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_PAR_GENERIC, cmp_get_error_code(cmp_size));
+	cmp_size = compress_like_rdcu_trials(&rcfg, NULL, NULL, 1);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_PAR_NULL, cmp_get_error_code(cmp_size));
+
+	/* small buffer error */
+	rcfg.icu_output_buf = output_buf;
+	rcfg.buffer_length = 2;
+	cmp_size = compress_like_rdcu_trials(&rcfg, &info, trials, ARRAY_SIZE(trials));
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_SMALL_BUFFER, cmp_get_error_code(cmp_size));
+	TEST_ASSERT_EQUAL_HEX(0x1, info.cmp_err);
+	for (i = 0; i < ARRAY_SIZE(trials); i++)
+		TEST_ASSERT_EQUAL_UINT32(0, trials[i].cmp_size);
+
+	/* the parameter trials do not take statistics fields */
+	cfg.data_type = DATA_TYPE_IMAGETTE;
+	cfg.cmp_mode = CMP_MODE_DIFF_ZERO;
+	cfg.src = data;
+	cfg.samples = SAMPLES;
+	cfg.dst = output_buf;
+	cfg.stream_size = sizeof(output_buf);
+	cfg.cmp_par_imagette = 5;
+	cfg.spill_imagette = 40;
+	cfg.par_trials = trials;
+	cfg.num_par_trials = ARRAY_SIZE(trials);
+	cfg.col_stats = &col_stats;
+	cmp_size = compress_imagette(&cfg, 0);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	TEST_ASSERT_EQUAL_UINT32(1, col_stats.num_fields);
+	TEST_ASSERT_EQUAL_UINT32(5, col_stats.field[0].cmp_par);
+	TEST_ASSERT_EQUAL_UINT32(SAMPLES, col_stats.field[0].values);
+	TEST_ASSERT_EQUAL_UINT32(cmp_size, col_stats.field[0].bits);
 }
 
 
@@ -1609,19 +1736,7 @@ void test_compress_data_internal_error_cases(void)
 	cmp_size = compress_data_internal(&cfg, 0);
 	TEST_ASSERT_EQUAL_INT(CMP_ERROR_INT_DATA_TYPE_UNSUPPORTED, cmp_get_error_code(cmp_size));
 
-	cfg.data_type = DATA_TYPE_F_FX_EFX;
-	cmp_size = compress_data_internal(&cfg, 0);
-	TEST_ASSERT_EQUAL_INT(CMP_ERROR_INT_DATA_TYPE_UNSUPPORTED, cmp_get_error_code(cmp_size));
-
-	cfg.data_type = DATA_TYPE_F_FX_NCOB;
-	cmp_size = compress_data_internal(&cfg, 0);
-	TEST_ASSERT_EQUAL_INT(CMP_ERROR_INT_DATA_TYPE_UNSUPPORTED, cmp_get_error_code(cmp_size));
-
-	cfg.data_type = DATA_TYPE_F_FX_EFX_NCOB_ECOB;
-	cmp_size = compress_data_internal(&cfg, 0);
-	TEST_ASSERT_EQUAL_INT(CMP_ERROR_INT_DATA_TYPE_UNSUPPORTED, cmp_get_error_code(cmp_size));
-
-	cfg.data_type = DATA_TYPE_F_FX_EFX_NCOB_ECOB;
+	cfg.data_type = DATA_TYPE_CHUNK;
 	cmp_size = compress_data_internal(&cfg, 0);
 	TEST_ASSERT_EQUAL_INT(CMP_ERROR_INT_DATA_TYPE_UNSUPPORTED, cmp_get_error_code(cmp_size));
 
@@ -1898,7 +2013,7 @@ void test_compress_chunk_aux(void)
 
 	/* wrong cmp_mode */
 	cmp_par.nc_background_outlier_pixels = MAX_CHUNK_CMP_PAR;
-	cmp_par.cmp_mode = 5;
+	cmp_par.cmp_mode = (enum cmp_mode)(CMP_MODE_DIFF_ADAPTIVE + 1);
 	cmp_size = compress_chunk(chunk, CHUNK_SIZE, NULL, NULL, dst,
 				  dst_capacity, &cmp_par);
 	TEST_ASSERT_EQUAL_INT(CMP_ERROR_PAR_GENERIC, cmp_get_error_code(cmp_size));
@@ -1913,6 +2028,432 @@ void test_compress_chunk_aux(void)
 }
 
 
+/**
+ * @test compress_chunk
+ * @test compress_chunk_set_stats
+ */
+
+void test_compress_chunk_stats(void)
+{
+	enum {	DATA_SIZE_1 = 2*sizeof(struct offset),
+		DATA_SIZE_2 = 3*sizeof(struct background),
+		CHUNK_SIZE = 2*COLLECTION_HDR_SIZE + DATA_SIZE_1 + DATA_SIZE_2
+	};
+	uint8_t chunk[CHUNK_SIZE];
+	struct collection_hdr *col1 = (struct collection_hdr *)chunk;
+	struct collection_hdr *col2;
+	struct offset *data1 = (struct offset *)col1->entry;
+	struct background *data2;
+	struct cmp_par cmp_par = {0};
+	struct cmp_col_stats col_stats[2];
+	struct cmp_stats stats;
+	uint32_t small_dst[(NON_IMAGETTE_HEADER_SIZE + CMP_COLLECTION_FILD_SIZE +
+			    COLLECTION_HDR_SIZE)/4 + 1];
+	uint32_t cmp_size, i, bits;
+
+	/* create a chunk with two collection */
+	memset(chunk, 0, sizeof(chunk));
+	TEST_ASSERT_FALSE(cmp_col_set_subservice(col1, SST_NCxx_S_SCIENCE_OFFSET));
+	TEST_ASSERT_FALSE(cmp_col_set_data_length(col1, DATA_SIZE_1));
+	data1[0].mean = 0;
+	data1[0].variance = 1;
+	data1[1].mean = 0xF0;
+	data1[1].variance = 0x1001;
+	col2 = (struct collection_hdr *)(chunk + COLLECTION_HDR_SIZE + DATA_SIZE_1);
+	TEST_ASSERT_FALSE(cmp_col_set_subservice(col2, SST_NCxx_S_SCIENCE_BACKGROUND));
+	TEST_ASSERT_FALSE(cmp_col_set_data_length(col2, DATA_SIZE_2));
+	data2 = (struct background *)col2->entry;
+	for (i = 0; i < 3; i++) {
+		data2[i].mean = 1000 + i;
+		data2[i].variance = 10;
+		data2[i].outlier_pixels = 0;
+	}
+
+	cmp_par.cmp_mode = CMP_MODE_DIFF_MULTI;
+	cmp_par.nc_offset_mean = 1;
+	cmp_par.nc_offset_variance = UINT16_MAX;
+	cmp_par.nc_background_mean = 1;
+	cmp_par.nc_background_variance = 1;
+	cmp_par.nc_background_outlier_pixels = 1;
+
+	memset(col_stats, 0xFF, sizeof(col_stats));
+	stats.col = col_stats;
+	stats.max_cols = 2;
+	stats.num_cols = 42;
+	compress_chunk_set_stats(&stats);
+
+	cmp_size = compress_chunk(chunk, CHUNK_SIZE, NULL, NULL, NULL, 0, &cmp_par);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	TEST_ASSERT_EQUAL_UINT32(2, stats.num_cols);
+
+	/* offset collection */
+	TEST_ASSERT_EQUAL_INT(DATA_TYPE_OFFSET, col_stats[0].data_type);
+	TEST_ASSERT_EQUAL_UINT32(2, col_stats[0].samples);
+	TEST_ASSERT_FALSE(col_stats[0].raw_fallback);
+	TEST_ASSERT_EQUAL_UINT32(2, col_stats[0].num_fields);
+	TEST_ASSERT_EQUAL_UINT32(1, col_stats[0].field[0].cmp_par);
+	TEST_ASSERT_EQUAL_UINT32(2, col_stats[0].field[0].values);
+	TEST_ASSERT_EQUAL_INT32(0, col_stats[0].field[0].residual_min);
+	TEST_ASSERT_EQUAL_INT32(0xF0, col_stats[0].field[0].residual_max);
+	TEST_ASSERT_EQUAL_INT64(0xF0, col_stats[0].field[0].residual_sum);
+	TEST_ASSERT_EQUAL_UINT32(1, col_stats[0].field[0].outliers);
+	TEST_ASSERT_GREATER_THAN_UINT32(0, col_stats[0].field[0].outlier_bits);
+	TEST_ASSERT_LESS_THAN_UINT32(col_stats[0].field[0].bits, col_stats[0].field[0].outlier_bits);
+	TEST_ASSERT_EQUAL_UINT32(UINT16_MAX, col_stats[0].field[1].cmp_par);
+	TEST_ASSERT_EQUAL_UINT32(2, col_stats[0].field[1].values);
+	TEST_ASSERT_EQUAL_INT32(1, col_stats[0].field[1].residual_min);
+	TEST_ASSERT_EQUAL_INT32(0x1000, col_stats[0].field[1].residual_max);
+	TEST_ASSERT_EQUAL_INT64(0x1001, col_stats[0].field[1].residual_sum);
+	TEST_ASSERT_EQUAL_UINT32(0, col_stats[0].field[1].outliers);
+	bits = col_stats[0].field[0].bits + col_stats[0].field[1].bits;
+	TEST_ASSERT_EQUAL_UINT32(bits, col_stats[0].cmp_bits);
+
+	/* background collection */
+	TEST_ASSERT_EQUAL_INT(DATA_TYPE_BACKGROUND, col_stats[1].data_type);
+	TEST_ASSERT_EQUAL_UINT32(3, col_stats[1].samples);
+	TEST_ASSERT_EQUAL_UINT32(3, col_stats[1].num_fields);
+	TEST_ASSERT_EQUAL_INT32(1, col_stats[1].field[0].residual_min);
+	TEST_ASSERT_EQUAL_INT32(1000, col_stats[1].field[0].residual_max);
+	TEST_ASSERT_EQUAL_INT64(1002, col_stats[1].field[0].residual_sum);
+	TEST_ASSERT_EQUAL_INT32(0, col_stats[1].field[2].residual_min);
+	TEST_ASSERT_EQUAL_INT32(0, col_stats[1].field[2].residual_max);
+	TEST_ASSERT_EQUAL_UINT32(0, col_stats[1].field[2].outliers);
+
+	/* only the first collection fits into the sink */
+	stats.max_cols = 1;
+	memset(&col_stats[1], 0xFF, sizeof(col_stats[1]));
+	cmp_size = compress_chunk(chunk, CHUNK_SIZE, NULL, NULL, NULL, 0, &cmp_par);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	TEST_ASSERT_EQUAL_UINT32(2, stats.num_cols);
+	TEST_ASSERT_EQUAL_UINT32(bits, col_stats[0].cmp_bits);
+	TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFF, col_stats[1].samples);
+
+	/* raw mode has no field statistics */
+	stats.max_cols = 2;
+	cmp_par.cmp_mode = CMP_MODE_RAW;
+	cmp_size = compress_chunk(chunk, CHUNK_SIZE, NULL, NULL, NULL, 0, &cmp_par);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	TEST_ASSERT_EQUAL_UINT32(0, col_stats[0].num_fields);
+	TEST_ASSERT_EQUAL_UINT32(DATA_SIZE_1 * 8, col_stats[0].cmp_bits);
+	TEST_ASSERT_EQUAL_UINT32(DATA_SIZE_2 * 8, col_stats[1].cmp_bits);
+
+	/* not compressible data are stored uncompressed */
+	cmp_par.cmp_mode = CMP_MODE_DIFF_ZERO;
+	data1[0].mean = 0xFFFFFFFF;
+	data1[0].variance = 0x7FFFFFFF;
+	cmp_size = compress_chunk(chunk, CHUNK_SIZE, NULL, NULL, NULL, 0, &cmp_par);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	TEST_ASSERT_TRUE(col_stats[0].raw_fallback);
+	TEST_ASSERT_EQUAL_UINT32(DATA_SIZE_1 * 8, col_stats[0].cmp_bits);
+	TEST_ASSERT_FALSE(col_stats[1].raw_fallback);
+
+	/* a compression aborted before the variance field leaves a field
+	 * without values and residual range
+	 */
+	cmp_size = compress_chunk(chunk, CHUNK_SIZE, NULL, NULL, small_dst, sizeof(small_dst),
+				  &cmp_par);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_SMALL_BUFFER, cmp_get_error_code(cmp_size));
+	TEST_ASSERT_EQUAL_UINT32(1, stats.num_cols);
+	TEST_ASSERT_EQUAL_UINT32(2, col_stats[0].num_fields);
+	TEST_ASSERT_EQUAL_UINT32(0, col_stats[0].field[1].values);
+	TEST_ASSERT_EQUAL_INT32(0, col_stats[0].field[1].residual_min);
+	TEST_ASSERT_EQUAL_INT32(0, col_stats[0].field[1].residual_max);
+
+	compress_chunk_set_stats(NULL);
+	cmp_size = compress_chunk(chunk, CHUNK_SIZE, NULL, NULL, NULL, 0, &cmp_par);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	TEST_ASSERT_EQUAL_UINT32(1, stats.num_cols);
+}
+
+
+static uint32_t trace_cycles;
+
+static uint32_t get_trace_cycles(void)
+{
+	return trace_cycles += 10;
+}
+
+
+/**
+ * @brief check that every recorded trace span is ended
+ */
+
+static void assert_trace_balanced(void)
+{
+	struct cmp_trace_event events[32];
+	uint16_t open_stages[32];
+	uint32_t num_events, depth = 0, i;
+
+	num_events = cmp_trace_get_events(events, ARRAY_SIZE(events));
+	TEST_ASSERT_EQUAL_UINT32(cmp_trace_get_count(), num_events);
+	for (i = 0; i < num_events; i++) {
+		if (events[i].type == CMP_TRACE_EV_BEGIN) {
+			open_stages[depth++] = events[i].stage;
+		} else {
+			TEST_ASSERT_GREATER_THAN_UINT32(0, depth);
+			TEST_ASSERT_EQUAL_UINT16(open_stages[--depth], events[i].stage);
+		}
+	}
+	TEST_ASSERT_EQUAL_UINT32(0, depth);
+}
+
+
+/**
+ * @test compress_chunk
+ * @test cmp_trace_init
+ * @test cmp_trace_get_events
+ */
+
+void test_compress_chunk_trace(void)
+{
+	enum {	DATA_SIZE = 4*sizeof(uint16_t),
+		CHUNK_SIZE = COLLECTION_HDR_SIZE + DATA_SIZE
+	};
+	static const uint16_t exp_stages[] = {
+		CMP_TRACE_HDR_SETUP, CMP_TRACE_HDR_SETUP,
+		CMP_TRACE_VALIDATION, CMP_TRACE_VALIDATION,
+		CMP_TRACE_ENCODE, CMP_TRACE_ENCODE,
+		CMP_TRACE_PAD, CMP_TRACE_PAD,
+		CMP_TRACE_HDR_SETUP, CMP_TRACE_HDR_SETUP
+	};
+	uint8_t chunk[CHUNK_SIZE];
+	struct cmp_par cmp_par = {0};
+	struct cmp_trace_event buf[16], events[16];
+	uint32_t small_dst[(GENERIC_HEADER_SIZE + COLLECTION_HDR_SIZE)/4 + 1];
+	uint32_t cmp_size, num_events, i;
+
+	memset(chunk, 0, sizeof(chunk));
+	TEST_ASSERT_FALSE(cmp_col_set_subservice((struct collection_hdr *)chunk,
+						 SST_NCxx_S_SCIENCE_IMAGETTE));
+	TEST_ASSERT_FALSE(cmp_col_set_data_length((struct collection_hdr *)chunk,
+						  DATA_SIZE));
+	cmp_par.cmp_mode = CMP_MODE_DIFF_ZERO;
+	cmp_par.nc_imagette = 1;
+
+	trace_cycles = 0;
+	cmp_trace_init(get_trace_cycles, buf, ARRAY_SIZE(buf));
+
+	cmp_size = compress_chunk(chunk, CHUNK_SIZE, NULL, NULL, NULL, 0, &cmp_par);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	TEST_ASSERT_EQUAL_UINT32(ARRAY_SIZE(exp_stages), cmp_trace_get_count());
+
+	num_events = cmp_trace_get_events(events, ARRAY_SIZE(events));
+	TEST_ASSERT_EQUAL_UINT32(ARRAY_SIZE(exp_stages), num_events);
+	for (i = 0; i < num_events; i++) {
+		TEST_ASSERT_EQUAL_UINT16(exp_stages[i], events[i].stage);
+		TEST_ASSERT_EQUAL_UINT16(i & 1 ? CMP_TRACE_EV_END : CMP_TRACE_EV_BEGIN,
+					 events[i].type);
+		TEST_ASSERT_EQUAL_UINT32(10 * (i + 1), events[i].cycles);
+	}
+
+	/* the ring buffer keeps the most recent events */
+	cmp_trace_init(get_trace_cycles, buf, 3);
+	cmp_size = compress_chunk(chunk, CHUNK_SIZE, NULL, NULL, NULL, 0, &cmp_par);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	TEST_ASSERT_EQUAL_UINT32(ARRAY_SIZE(exp_stages), cmp_trace_get_count());
+	TEST_ASSERT_EQUAL_UINT32(3, cmp_trace_get_events(events, ARRAY_SIZE(events)));
+	TEST_ASSERT_EQUAL_UINT16(CMP_TRACE_PAD, events[0].stage);
+	TEST_ASSERT_EQUAL_UINT16(CMP_TRACE_EV_END, events[0].type);
+	TEST_ASSERT_EQUAL_UINT16(CMP_TRACE_HDR_SETUP, events[2].stage);
+	TEST_ASSERT_EQUAL_UINT16(CMP_TRACE_EV_END, events[2].type);
+	TEST_ASSERT_EQUAL_UINT32(2, cmp_trace_get_events(events, 2));
+	TEST_ASSERT_EQUAL_UINT16(CMP_TRACE_HDR_SETUP, events[0].stage);
+	TEST_ASSERT_EQUAL_UINT16(CMP_TRACE_EV_BEGIN, events[0].type);
+
+	/* the error paths end their spans */
+	cmp_trace_init(get_trace_cycles, buf, ARRAY_SIZE(buf));
+	cmp_par.nc_imagette = 0; /* invalid compression parameter */
+	cmp_size = compress_chunk(chunk, CHUNK_SIZE, NULL, NULL, NULL, 0, &cmp_par);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_PAR_SPECIFIC, cmp_get_error_code(cmp_size));
+	TEST_ASSERT_EQUAL_UINT32(4, cmp_trace_get_count());
+	assert_trace_balanced();
+
+	cmp_trace_reset();
+	cmp_par.cmp_mode = CMP_MODE_RAW;
+	cmp_size = compress_chunk(chunk, CHUNK_SIZE, NULL, NULL, small_dst,
+				  GENERIC_HEADER_SIZE + COLLECTION_HDR_SIZE, &cmp_par);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_SMALL_BUFFER, cmp_get_error_code(cmp_size));
+	assert_trace_balanced();
+
+	cmp_trace_reset();
+	cmp_par.cmp_mode = CMP_MODE_DIFF_ZERO;
+	cmp_par.nc_imagette = 1;
+	cmp_size = compress_chunk(chunk, CHUNK_SIZE, NULL, NULL, small_dst, GENERIC_HEADER_SIZE,
+				  &cmp_par);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_SMALL_BUFFER, cmp_get_error_code(cmp_size));
+	assert_trace_balanced();
+
+	/* without a cycle counter nothing is recorded */
+	cmp_trace_init(NULL, buf, ARRAY_SIZE(buf));
+	cmp_size = compress_chunk(chunk, CHUNK_SIZE, NULL, NULL, NULL, 0, &cmp_par);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	TEST_ASSERT_EQUAL_UINT32(0, cmp_trace_get_count());
+	TEST_ASSERT_EQUAL_UINT32(0, cmp_trace_get_events(events, ARRAY_SIZE(events)));
+}
+
+
+/**
+ * @test compress_chunk_budget
+ */
+
+void test_compress_chunk_budget(void)
+{
+	enum {	SAMPLES = 256,
+		DATA_SIZE = SAMPLES*sizeof(uint16_t),
+		CHUNK_SIZE = COLLECTION_HDR_SIZE + DATA_SIZE,
+		DST_CAPACITY = COMPRESS_CHUNK_BOUND(CHUNK_SIZE, 1)
+	};
+	uint8_t chunk[CHUNK_SIZE];
+	uint16_t *data = (uint16_t *)(chunk + COLLECTION_HDR_SIZE);
+	uint32_t dst[DST_CAPACITY/sizeof(uint32_t)];
+	uint32_t dst_ref[DST_CAPACITY/sizeof(uint32_t)];
+	struct cmp_par cmp_par = {0};
+	struct cmp_col_stats col_stats;
+	struct cmp_stats stats;
+	uint32_t budget, min_size, cmp_size, cmp_size_ref, i;
+
+	memset(chunk, 0, sizeof(chunk));
+	TEST_ASSERT_FALSE(cmp_col_set_subservice((struct collection_hdr *)chunk,
+						 SST_NCxx_S_SCIENCE_IMAGETTE));
+	TEST_ASSERT_FALSE(cmp_col_set_data_length((struct collection_hdr *)chunk,
+						  DATA_SIZE));
+	for (i = 0; i < SAMPLES; i++)
+		data[i] = (uint16_t)cmp_rand_between(1000, 1040);
+	cmp_par.cmp_mode = CMP_MODE_DIFF_ZERO;
+	cmp_par.nc_imagette = 1;
+
+	/* with the start parameter the data are not compressible */
+	cmp_size = compress_chunk(chunk, CHUNK_SIZE, NULL, NULL, NULL, 0, &cmp_par);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	budget = cmp_size - 64;
+
+	cmp_size = compress_chunk_budget(chunk, CHUNK_SIZE, NULL, NULL, dst, budget,
+					 &cmp_par, 0);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	TEST_ASSERT_LESS_OR_EQUAL_UINT32(budget, cmp_size);
+	TEST_ASSERT_GREATER_THAN_UINT32(1, cmp_par.nc_imagette);
+	TEST_ASSERT_EQUAL_UINT32(0, cmp_par.lossy_par);
+	/* the reported parameters are the ones used for the compression */
+	cmp_size_ref = compress_chunk(chunk, CHUNK_SIZE, NULL, NULL, dst_ref,
+				      sizeof(dst_ref), &cmp_par);
+	TEST_ASSERT_EQUAL_UINT32(cmp_size_ref, cmp_size);
+	TEST_ASSERT_EQUAL_HEX8_ARRAY((uint8_t *)dst_ref + NON_IMAGETTE_HEADER_SIZE,
+				     (uint8_t *)dst + NON_IMAGETTE_HEADER_SIZE,
+				     cmp_size - NON_IMAGETTE_HEADER_SIZE);
+	min_size = cmp_size;
+
+	/* without a dst buffer only the size and the parameters are determined */
+	cmp_par.nc_imagette = 1;
+	cmp_size = compress_chunk_budget(chunk, CHUNK_SIZE, NULL, NULL, NULL, budget,
+					 &cmp_par, 0);
+	TEST_ASSERT_EQUAL_UINT32(min_size, cmp_size);
+
+	/* a budget which is already met does not change the parameters */
+	cmp_size = compress_chunk_budget(chunk, CHUNK_SIZE, NULL, NULL, dst, budget,
+					 &cmp_par, 0);
+	TEST_ASSERT_EQUAL_UINT32(min_size, cmp_size);
+
+	/* budget can not be met without lossy compression */
+	cmp_par.nc_imagette = 1;
+	cmp_size = compress_chunk_budget(chunk, CHUNK_SIZE, NULL, NULL, dst,
+					 NON_IMAGETTE_HEADER_SIZE + 64, &cmp_par, 0);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_SMALL_BUFFER, cmp_get_error_code(cmp_size));
+	TEST_ASSERT_GREATER_THAN_UINT32(1, cmp_par.nc_imagette);
+	TEST_ASSERT_EQUAL_UINT32(0, cmp_par.lossy_par);
+	min_size = compress_chunk(chunk, CHUNK_SIZE, NULL, NULL, NULL, 0, &cmp_par);
+	TEST_ASSERT_FALSE(cmp_is_error(min_size));
+
+	cmp_par.nc_imagette = 1;
+	budget = min_size - 16;
+	cmp_size = compress_chunk_budget(chunk, CHUNK_SIZE, NULL, NULL, dst, budget,
+					 &cmp_par, MAX_ICU_ROUND);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	TEST_ASSERT_LESS_OR_EQUAL_UINT32(budget, cmp_size);
+	TEST_ASSERT_GREATER_THAN_UINT32(0, cmp_par.lossy_par);
+	TEST_ASSERT_EQUAL_UINT16(cmp_par.lossy_par, cmp_ent_get_lossy_cmp_par((struct cmp_entity *)dst));
+
+	/* lossy_par is not escalated if lossy compression does not reduce the
+	 * size, here because it is not supported for saturated imagettes */
+	TEST_ASSERT_FALSE(cmp_col_set_subservice((struct collection_hdr *)chunk,
+						 SST_NCxx_S_SCIENCE_SAT_IMAGETTE));
+	cmp_par.lossy_par = 0;
+	cmp_par.saturated_imagette = 1;
+	cmp_size = compress_chunk_budget(chunk, CHUNK_SIZE, NULL, NULL, dst,
+					 NON_IMAGETTE_HEADER_SIZE + 64, &cmp_par,
+					 MAX_ICU_ROUND);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_SMALL_BUFFER, cmp_get_error_code(cmp_size));
+	TEST_ASSERT_GREATER_THAN_UINT32(1, cmp_par.saturated_imagette);
+	TEST_ASSERT_EQUAL_UINT32(0, cmp_par.lossy_par);
+
+	/* the estimation passes do not fill the statistics sink, only the
+	 * final compression does */
+	TEST_ASSERT_FALSE(cmp_col_set_subservice((struct collection_hdr *)chunk,
+						 SST_NCxx_S_SCIENCE_IMAGETTE));
+	cmp_par.nc_imagette = 1;
+	cmp_size = compress_chunk(chunk, CHUNK_SIZE, NULL, NULL, NULL, 0, &cmp_par);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	budget = cmp_size - 64;
+	memset(&col_stats, 0xFF, sizeof(col_stats));
+	stats.col = &col_stats;
+	stats.max_cols = 1;
+	stats.num_cols = 42;
+	compress_chunk_set_stats(&stats);
+	cmp_size = compress_chunk_budget(chunk, CHUNK_SIZE, NULL, NULL, NULL, budget,
+					 &cmp_par, 0);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	TEST_ASSERT_EQUAL_UINT32(42, stats.num_cols);
+	TEST_ASSERT_EQUAL_HEX32(0xFFFFFFFF, col_stats.samples);
+	cmp_par.nc_imagette = 1;
+	cmp_size = compress_chunk_budget(chunk, CHUNK_SIZE, NULL, NULL, dst, budget,
+					 &cmp_par, 0);
+	TEST_ASSERT_FALSE(cmp_is_error(cmp_size));
+	TEST_ASSERT_EQUAL_UINT32(1, stats.num_cols);
+	TEST_ASSERT_EQUAL_UINT32(SAMPLES, col_stats.samples);
+	TEST_ASSERT_EQUAL_UINT32(cmp_par.nc_imagette, col_stats.field[0].cmp_par);
+	compress_chunk_set_stats(NULL);
+
+	/* error cases */
+	cmp_size = compress_chunk_budget(chunk, CHUNK_SIZE, NULL, NULL, dst, budget,
+					 NULL, 0);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_PAR_NULL, cmp_get_error_code(cmp_size));
+	cmp_size = compress_chunk_budget(NULL, CHUNK_SIZE, NULL, NULL, dst, budget,
+					 &cmp_par, 0);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_CHUNK_NULL, cmp_get_error_code(cmp_size));
+}
+
+
+/**
+ * @test cmp_par_specific
+ */
+
+void test_cmp_par_specific(void)
+{
+	struct cmp_par par;
+	unsigned int i;
+
+	memset(&par, 0, sizeof(par));
+	for (i = 0; i < CMP_PAR_NUM_SPECIFIC; i++) {
+		uint32_t *p = cmp_par_specific(&par, i);
+
+		TEST_ASSERT_NOT_NULL(p);
+		TEST_ASSERT_EQUAL_UINT32(0, *p); /* every parameter is only visited once */
+		*p = i + 1;
+	}
+	TEST_ASSERT_EQUAL_UINT32(1, par.nc_imagette);
+	TEST_ASSERT_EQUAL_UINT32(3, par.s_fx);
+	TEST_ASSERT_EQUAL_UINT32(27, par.fc_background_outlier_pixels);
+	TEST_ASSERT_EQUAL_UINT32(28, par.f_fx);
+	TEST_ASSERT_EQUAL_UINT32(31, par.f_ecob);
+	/* the general parameters are not specific parameters */
+	TEST_ASSERT_EQUAL_INT(0, par.cmp_mode);
+	TEST_ASSERT_EQUAL_UINT32(0, par.model_value);
+	TEST_ASSERT_EQUAL_UINT32(0, par.lossy_par);
+
+	TEST_ASSERT_NULL(cmp_par_specific(&par, CMP_PAR_NUM_SPECIFIC));
+	TEST_ASSERT_NULL(cmp_par_specific(NULL, 0));
+}
+
+
 /**
  * @test compress_chunk
  */
@@ -2451,6 +2992,74 @@ void test_compress_chunk_cmp_size_bound(void)
 }
 
 
+/**
+ * @test compress_chunk_scan
+ */
+
+void test_compress_chunk_scan(void)
+{
+	uint8_t chunk[3*COLLECTION_HDR_SIZE + 4 + 6] = {0};
+	struct collection_hdr *col1 = (struct collection_hdr *)chunk;
+	struct collection_hdr *col2 = (struct collection_hdr *)(chunk + COLLECTION_HDR_SIZE + 4);
+	struct collection_hdr *col3 = (struct collection_hdr *)(chunk + 2*COLLECTION_HDR_SIZE + 4);
+	struct cmp_col_desc desc[3];
+	uint32_t num_col;
+
+	TEST_ASSERT_FALSE(cmp_col_set_subservice(col1, SST_NCxx_S_SCIENCE_IMAGETTE));
+	TEST_ASSERT_FALSE(cmp_col_set_data_length(col1, 4));
+	TEST_ASSERT_FALSE(cmp_col_set_subservice(col2, SST_NCxx_S_SCIENCE_IMAGETTE));
+	TEST_ASSERT_FALSE(cmp_col_set_data_length(col2, 0));
+	TEST_ASSERT_FALSE(cmp_col_set_subservice(col3, SST_NCxx_S_SCIENCE_IMAGETTE));
+	TEST_ASSERT_FALSE(cmp_col_set_data_length(col3, 6));
+
+	num_col = compress_chunk_scan(chunk, sizeof(chunk), desc, ARRAY_SIZE(desc));
+	TEST_ASSERT_EQUAL_UINT32(3, num_col);
+	TEST_ASSERT_EQUAL_UINT32(0, desc[0].offset);
+	TEST_ASSERT_EQUAL_UINT32(COLLECTION_HDR_SIZE + 4, desc[0].size);
+	TEST_ASSERT_EQUAL_INT(DATA_TYPE_IMAGETTE, desc[0].data_type);
+	TEST_ASSERT_EQUAL_UINT32(2, desc[0].samples);
+	TEST_ASSERT_EQUAL_UINT32(COLLECTION_HDR_SIZE + 4, desc[1].offset);
+	TEST_ASSERT_EQUAL_UINT32(COLLECTION_HDR_SIZE, desc[1].size);
+	TEST_ASSERT_EQUAL_UINT32(0, desc[1].samples);
+	TEST_ASSERT_EQUAL_UINT32(2*COLLECTION_HDR_SIZE + 4, desc[2].offset);
+	TEST_ASSERT_EQUAL_UINT32(3, desc[2].samples);
+	TEST_ASSERT_EQUAL_UINT32(compress_chunk_cmp_size_bound(chunk, sizeof(chunk)),
+				 COMPRESS_CHUNK_BOUND(sizeof(chunk), num_col));
+
+	/* only check the chunk */
+	TEST_ASSERT_EQUAL_UINT32(3, compress_chunk_scan(chunk, sizeof(chunk), NULL, 0));
+
+	/* too small descriptor array */
+	num_col = compress_chunk_scan(chunk, sizeof(chunk), desc, 2);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_SMALL_BUFFER, cmp_get_error_code(num_col));
+
+	/* chunk size does not match the collection sizes */
+	num_col = compress_chunk_scan(chunk, sizeof(chunk)-1, desc, ARRAY_SIZE(desc));
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_CHUNK_SIZE_INCONSISTENT, cmp_get_error_code(num_col));
+	num_col = compress_chunk_scan(chunk, COLLECTION_HDR_SIZE-1, NULL, 0);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_CHUNK_SIZE_INCONSISTENT, cmp_get_error_code(num_col));
+
+	/* collection data length is not a multiple of the sample size */
+	TEST_ASSERT_FALSE(cmp_col_set_data_length(col2, 1));
+	num_col = compress_chunk_scan(chunk, sizeof(chunk)+1-6, NULL, 0);
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_COL_SIZE_INCONSISTENT, cmp_get_error_code(num_col));
+	TEST_ASSERT_FALSE(cmp_col_set_data_length(col2, 0));
+
+	/* collections of different chunk types */
+	TEST_ASSERT_FALSE(cmp_col_set_subservice(col3, SST_NCxx_S_SCIENCE_OFFSET));
+	num_col = compress_chunk_scan(chunk, sizeof(chunk), desc, ARRAY_SIZE(desc));
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_CHUNK_SUBSERVICE_INCONSISTENT, cmp_get_error_code(num_col));
+
+	/* unknown subservice */
+	TEST_ASSERT_FALSE(cmp_col_set_subservice(col1, 0));
+	num_col = compress_chunk_scan(chunk, sizeof(chunk), desc, ARRAY_SIZE(desc));
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_COL_SUBSERVICE_UNSUPPORTED, cmp_get_error_code(num_col));
+
+	num_col = compress_chunk_scan(NULL, sizeof(chunk), desc, ARRAY_SIZE(desc));
+	TEST_ASSERT_EQUAL_INT(CMP_ERROR_CHUNK_NULL, cmp_get_error_code(num_col));
+}
+
+
 /**
  * @test compress_chunk_set_model_id_and_counter
  */
@@ -2516,7 +3125,7 @@ void test_support_function_call_NULL(void)
 	TEST_ASSERT_FALSE(cmp_aux_data_type_is_used(DATA_TYPE_S_FX));
 	TEST_ASSERT_TRUE(cmp_cfg_fx_cob_get_need_pars(DATA_TYPE_S_FX, NULL));
 	TEST_ASSERT_TRUE(check_compression_buffers(NULL));
-	cfg.cmp_mode = 5;
+	cfg.cmp_mode = (enum cmp_mode)(CMP_MODE_DIFF_ADAPTIVE + 1);
 	TEST_ASSERT_TRUE(cmp_cfg_imagette_is_invalid(&cfg));
 }
 
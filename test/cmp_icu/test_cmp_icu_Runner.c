@@ -12,6 +12,7 @@ extern void test_encode_value_zero(void);
 extern void test_encode_value_multi(void);
 extern void test_encode_value(void);
 extern void test_compress_imagette_diff(void);
+extern void test_compress_like_rdcu_trials(void);
 extern void test_compress_imagette_model(void);
 extern void test_compress_imagette_raw(void);
 extern void test_compress_imagette_error_cases(void);
@@ -20,11 +21,16 @@ extern void test_compress_data_internal_error_cases(void);
 extern void test_compress_chunk_raw_singel_col(void);
 extern void test_compress_chunk_raw_two_col(void);
 extern void test_compress_chunk_aux(void);
+extern void test_compress_chunk_stats(void);
+extern void test_compress_chunk_trace(void);
+extern void test_compress_chunk_budget(void);
+extern void test_cmp_par_specific(void);
 extern void test_collection_zero_data_length(void);
 extern void test_compress_chunk_error_cases(void);
 extern void test_zero_escape_mech_is_used(void);
 extern void test_COMPRESS_CHUNK_BOUND(void);
 extern void test_compress_chunk_cmp_size_bound(void);
+extern void test_compress_chunk_scan(void);
 extern void test_compress_chunk_set_model_id_and_counter(void);
 extern void test_support_function_call_NULL(void);
 extern void test_missing_cmp_cfg_fx_cob_get_need_pars(void);
@@ -93,33 +99,39 @@ static void run_test(UnityTestFunction func, const char* name, UNITY_LINE_TYPE l
 int main(void)
 {
   UnityBegin("../test/cmp_icu/test_cmp_icu.c");
-  run_test(test_map_to_pos, "test_map_to_pos", 73);
-  run_test(test_put_n_bits32, "test_put_n_bits32", 177);
-  run_test(test_rice_encoder, "test_rice_encoder", 583);
-  run_test(test_golomb_encoder, "test_golomb_encoder", 652);
-  run_test(test_encode_value_zero, "test_encode_value_zero", 796);
-  run_test(test_encode_value_multi, "test_encode_value_multi", 920);
-  run_test(test_encode_value, "test_encode_value", 1036);
-  run_test(test_compress_imagette_diff, "test_compress_imagette_diff", 1149);
-  run_test(test_compress_imagette_model, "test_compress_imagette_model", 1257);
-  run_test(test_compress_imagette_raw, "test_compress_imagette_raw", 1311);
-  run_test(test_compress_imagette_error_cases, "test_compress_imagette_error_cases", 1384);
-  run_test(test_pad_bitstream, "test_pad_bitstream", 1502);
-  run_test(test_compress_data_internal_error_cases, "test_compress_data_internal_error_cases", 1575);
-  run_test(test_compress_chunk_raw_singel_col, "test_compress_chunk_raw_singel_col", 1636);
-  run_test(test_compress_chunk_raw_two_col, "test_compress_chunk_raw_two_col", 1706);
-  run_test(test_compress_chunk_aux, "test_compress_chunk_aux", 1827);
-  run_test(test_collection_zero_data_length, "test_collection_zero_data_length", 1918);
-  run_test(test_compress_chunk_error_cases, "test_compress_chunk_error_cases", 1987);
-  run_test(test_zero_escape_mech_is_used, "test_zero_escape_mech_is_used", 2229);
-  run_test(test_COMPRESS_CHUNK_BOUND, "test_COMPRESS_CHUNK_BOUND", 2250);
-  run_test(test_compress_chunk_cmp_size_bound, "test_compress_chunk_cmp_size_bound", 2363);
-  run_test(test_compress_chunk_set_model_id_and_counter, "test_compress_chunk_set_model_id_and_counter", 2453);
-  run_test(test_support_function_call_NULL, "test_support_function_call_NULL", 2495);
-  run_test(test_missing_cmp_cfg_fx_cob_get_need_pars, "test_missing_cmp_cfg_fx_cob_get_need_pars", 2523);
-  run_test(test_print_cmp_info, "test_print_cmp_info", 2543);
-  run_test(test_buffer_overlaps, "test_buffer_overlaps", 2569);
-  run_test(test_cmp_get_error_string, "test_cmp_get_error_string", 2599);
+  run_test(test_map_to_pos, "test_map_to_pos", 81);
+  run_test(test_put_n_bits32, "test_put_n_bits32", 185);
+  run_test(test_rice_encoder, "test_rice_encoder", 591);
+  run_test(test_golomb_encoder, "test_golomb_encoder", 660);
+  run_test(test_encode_value_zero, "test_encode_value_zero", 804);
+  run_test(test_encode_value_multi, "test_encode_value_multi", 928);
+  run_test(test_encode_value, "test_encode_value", 1044);
+  run_test(test_compress_imagette_diff, "test_compress_imagette_diff", 1157);
+  run_test(test_compress_like_rdcu_trials, "test_compress_like_rdcu_trials", 1271);
+  run_test(test_compress_imagette_model, "test_compress_imagette_model", 1364);
+  run_test(test_compress_imagette_raw, "test_compress_imagette_raw", 1418);
+  run_test(test_compress_imagette_error_cases, "test_compress_imagette_error_cases", 1491);
+  run_test(test_pad_bitstream, "test_pad_bitstream", 1609);
+  run_test(test_compress_data_internal_error_cases, "test_compress_data_internal_error_cases", 1682);
+  run_test(test_compress_chunk_raw_singel_col, "test_compress_chunk_raw_singel_col", 1731);
+  run_test(test_compress_chunk_raw_two_col, "test_compress_chunk_raw_two_col", 1801);
+  run_test(test_compress_chunk_aux, "test_compress_chunk_aux", 1922);
+  run_test(test_compress_chunk_stats, "test_compress_chunk_stats", 2014);
+  run_test(test_compress_chunk_trace, "test_compress_chunk_trace", 2147);
+  run_test(test_compress_chunk_budget, "test_compress_chunk_budget", 2215);
+  run_test(test_cmp_par_specific, "test_cmp_par_specific", 2343);
+  run_test(test_collection_zero_data_length, "test_collection_zero_data_length", 2375);
+  run_test(test_compress_chunk_error_cases, "test_compress_chunk_error_cases", 2444);
+  run_test(test_zero_escape_mech_is_used, "test_zero_escape_mech_is_used", 2686);
+  run_test(test_COMPRESS_CHUNK_BOUND, "test_COMPRESS_CHUNK_BOUND", 2707);
+  run_test(test_compress_chunk_cmp_size_bound, "test_compress_chunk_cmp_size_bound", 2820);
+  run_test(test_compress_chunk_scan, "test_compress_chunk_scan", 2913);
+  run_test(test_compress_chunk_set_model_id_and_counter, "test_compress_chunk_set_model_id_and_counter", 2981);
+  run_test(test_support_function_call_NULL, "test_support_function_call_NULL", 3023);
+  run_test(test_missing_cmp_cfg_fx_cob_get_need_pars, "test_missing_cmp_cfg_fx_cob_get_need_pars", 3051);
+  run_test(test_print_cmp_info, "test_print_cmp_info", 3071);
+  run_test(test_buffer_overlaps, "test_buffer_overlaps", 3097);
+  run_test(test_cmp_get_error_string, "test_cmp_get_error_string", 3127);
 
   return UnityEnd();
 }
@@ -0,0 +1,867 @@
+/**
+ * @file test_cmp_rdcu.c
+ * @date 2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief RDCU control path tests against the RDCU simulator
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unity.h>
+#include "../test_common/test_common.h"
+#include "../test_common/rdcu_sim.h"
+
+#include <cmp_rdcu.h>
+#include <cmp_icu.h>
+#include <cmp_chunk.h>
+#include <cmp_rdcu_cfg.h>
+#include <cmp_rdcu_testing.h>
+#include <rdcu_ctrl.h>
+#include <rdcu_rmap.h>
+#include <rdcu_cmd.h>
+#include <rmap.h>
+
+#define TEST_MTU	4096
+#define TEST_SAMPLES	1000
+
+
+/**
+ * @brief connect the RDCU control library to a fresh RDCU simulator
+ */
+
+void setUp(void)
+{
+	static int ctrl_initialised;
+
+	if (!ctrl_initialised) {
+		TEST_ASSERT_EQUAL_INT(0, rdcu_ctrl_init());
+		ctrl_initialised = 1;
+	}
+
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sim_init());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_rmap_init(TEST_MTU, rdcu_sim_tx, rdcu_sim_rx));
+	rdcu_rmap_set_timer(rdcu_sim_get_time_us);
+	rdcu_rmap_reset_log();
+
+	/* the simulator starts with reset registers */
+	rdcu_mark_compr_param_regs_dirty();
+
+	cmp_rand_seed(42);
+}
+
+
+void tearDown(void)
+{
+	rdcu_rmap_set_timer(NULL);
+	rdcu_rmap_set_poll_limit(0);
+	rdcu_rmap_set_completion_cb(NULL, NULL);
+	rdcu_sim_exit();
+}
+
+
+/**
+ * @brief generate random test data and model
+ */
+
+static void gen_test_data(uint16_t *data, uint16_t *model, uint32_t samples)
+{
+	uint32_t i;
+
+	for (i = 0; i < samples; i++) {
+		data[i] = (uint16_t)cmp_rand_between(1000, 1100);
+		if (model)
+			model[i] = (uint16_t)cmp_rand_between(1000, 1100);
+	}
+}
+
+
+/**
+ * @brief wait until the simulated compression is finished
+ */
+
+static void wait_for_compression(void)
+{
+	struct cmp_status status;
+	int i;
+
+	for (i = 0; i < 100000; i++) {
+		TEST_ASSERT_EQUAL_INT(0, rdcu_read_cmp_status(&status));
+		if (status.cmp_ready)
+			break;
+	}
+	TEST_ASSERT_TRUE(status.cmp_ready);
+	TEST_ASSERT_FALSE(status.cmp_active);
+}
+
+
+/**
+ * @brief compress with the simulated RDCU and compare the result against
+ *	a software compression like the RDCU
+ */
+
+static void check_rdcu_compression(enum cmp_mode cmp_mode)
+{
+	struct rdcu_cfg rcfg;
+	struct cmp_info info, sw_info;
+	uint16_t data[TEST_SAMPLES], model[TEST_SAMPLES];
+	uint16_t up_model[TEST_SAMPLES], sw_up_model[TEST_SAMPLES];
+	uint32_t bitstream[TEST_SAMPLES], sw_bitstream[TEST_SAMPLES];
+	uint32_t sw_size;
+	int size;
+
+	gen_test_data(data, model, TEST_SAMPLES);
+
+	TEST_ASSERT_FALSE(rdcu_cfg_create(&rcfg, cmp_mode, 8, CMP_LOSSLESS));
+	TEST_ASSERT_FALSE(rdcu_cfg_buffers(&rcfg, data, TEST_SAMPLES, model,
+					   CMP_DEF_IMA_MODEL_RDCU_DATA_ADR,
+					   CMP_DEF_IMA_MODEL_RDCU_MODEL_ADR,
+					   CMP_DEF_IMA_MODEL_RDCU_UP_MODEL_ADR,
+					   CMP_DEF_IMA_MODEL_RDCU_BUFFER_ADR,
+					   TEST_SAMPLES * 2));
+	TEST_ASSERT_FALSE(rdcu_cfg_imagette_default(&rcfg));
+
+	TEST_ASSERT_EQUAL_INT(0, rdcu_compress_data(&rcfg));
+	wait_for_compression();
+
+	TEST_ASSERT_EQUAL_INT(0, rdcu_read_cmp_info(&info));
+	TEST_ASSERT_EQUAL_HEX16(0, info.cmp_err);
+
+	size = rdcu_read_cmp_bitstream(&info, bitstream);
+	TEST_ASSERT_GREATER_THAN(0, size);
+
+	/* the same compression in software */
+	rcfg.icu_output_buf = sw_bitstream;
+	rcfg.icu_new_model_buf = sw_up_model;
+	sw_size = compress_like_rdcu(&rcfg, &sw_info);
+	TEST_ASSERT_FALSE(cmp_is_error(sw_size));
+
+	TEST_ASSERT_EQUAL_UINT32(sw_info.cmp_size, info.cmp_size);
+	TEST_ASSERT_EQUAL_UINT32(sw_info.ap1_cmp_size, info.ap1_cmp_size);
+	TEST_ASSERT_EQUAL_UINT32(sw_info.ap2_cmp_size, info.ap2_cmp_size);
+	TEST_ASSERT_EQUAL_UINT32(cmp_mode, info.cmp_mode_used);
+	TEST_ASSERT_EQUAL_UINT32(TEST_SAMPLES, info.samples_used);
+	TEST_ASSERT_EQUAL_UINT32(CMP_DEF_IMA_MODEL_RDCU_BUFFER_ADR, info.rdcu_cmp_adr_used);
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(sw_bitstream, bitstream, (info.cmp_size + 7) / 8);
+
+	if (model_mode_is_used(cmp_mode)) {
+		TEST_ASSERT_EQUAL_INT(TEST_SAMPLES * 2, rdcu_read_model(&info, up_model));
+		TEST_ASSERT_EQUAL_HEX16_ARRAY(sw_up_model, up_model, TEST_SAMPLES);
+	}
+}
+
+
+/**
+ * @test rdcu_compress_data
+ * @test rdcu_read_cmp_info
+ * @test rdcu_read_cmp_bitstream
+ */
+
+void test_rdcu_compress_data_diff(void)
+{
+	check_rdcu_compression(CMP_MODE_DIFF_ZERO);
+}
+
+
+/**
+ * @test rdcu_compress_data
+ * @test rdcu_read_model
+ */
+
+void test_rdcu_compress_data_model(void)
+{
+	check_rdcu_compression(CMP_MODE_MODEL_MULTI);
+}
+
+
+/**
+ * @test rdcu_read_model
+ */
+
+void test_rdcu_read_model_byte_order(void)
+{
+	static const uint8_t sram_model[] = {0x12, 0x34, 0x56, 0x78, 0x9A, 0xBC};
+	uint32_t const adr = CMP_DEF_IMA_MODEL_RDCU_UP_MODEL_ADR;
+	struct cmp_info info;
+	uint16_t model[4] = {0};
+
+	/* the RDCU stores the model samples big-endian */
+	memcpy(&rdcu_sim_get_sram()[adr], sram_model, sizeof(sram_model));
+
+	memset(&info, 0, sizeof(info));
+	info.cmp_mode_used = CMP_MODE_MODEL_ZERO;
+	info.samples_used = 3;
+	info.rdcu_new_model_adr_used = adr;
+
+	TEST_ASSERT_EQUAL_INT(sizeof(sram_model), rdcu_read_model(&info, NULL));
+	TEST_ASSERT_EQUAL_INT(sizeof(sram_model), rdcu_read_model(&info, model));
+	TEST_ASSERT_EQUAL_HEX16(0x1234, model[0]);
+	TEST_ASSERT_EQUAL_HEX16(0x5678, model[1]);
+	TEST_ASSERT_EQUAL_HEX16(0x9ABC, model[2]);
+	/* the read is padded to 4 bytes in the mirror, not in the model */
+	TEST_ASSERT_EQUAL_HEX16(0, model[3]);
+
+	TEST_ASSERT_EQUAL_INT(-1, rdcu_read_model(NULL, model));
+}
+
+
+/**
+ * @test rdcu_sync_fpga_version
+ * @test rdcu_wait
+ */
+
+void test_rdcu_read_reply_data_crc(void)
+{
+	struct rdcu_sim_stats stats;
+
+	/* the data CRC is checked over the data as transmitted (big-endian) */
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_fpga_version());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_wait(1000));
+	TEST_ASSERT_EQUAL_HEX16(RDCU_SIM_FPGA_VERSION, rdcu_get_fpga_version());
+
+	/* a reply with a wrong data CRC is dropped */
+	rdcu_sim_corrupt_replies(1);
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_fpga_version());
+	TEST_ASSERT_EQUAL_INT(-1, rdcu_wait(1000));
+	TEST_ASSERT_EQUAL_INT(0, rdcu_rmap_sync_status());
+	TEST_ASSERT_EQUAL_HEX16(RDCU_SIM_FPGA_VERSION, rdcu_get_fpga_version());
+
+	/* the RDCU did not notice anything */
+	rdcu_sim_get_stats(&stats);
+	TEST_ASSERT_EQUAL_UINT64(0, stats.rmap_errors);
+
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_fpga_version());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_wait(1000));
+}
+
+
+/**
+ * @test rdcu_poll
+ */
+
+void test_rdcu_poll(void)
+{
+	int pending = 0;
+	int i;
+
+	/* every poll without a reply takes 10 us, the reply arrives after 100 us */
+	rdcu_sim_set_link(100, 0);
+	rdcu_sim_set_poll_time(10);
+
+	TEST_ASSERT_EQUAL_INT(0, rdcu_poll());
+
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_fpga_version());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_rdcu_status());
+	TEST_ASSERT_EQUAL_INT(2, rdcu_poll());
+	for (i = 0; i < 100; i++) {
+		pending = rdcu_poll();
+		if (pending <= 0)
+			break;
+	}
+	TEST_ASSERT_EQUAL_INT(0, pending);
+	TEST_ASSERT_GREATER_THAN_INT(1, i);
+	TEST_ASSERT_EQUAL_HEX16(RDCU_SIM_FPGA_VERSION, rdcu_get_fpga_version());
+
+	/* a failed transaction is reported once */
+	rdcu_sim_corrupt_replies(1);
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_fpga_version());
+	for (i = 0; i < 100; i++) {
+		pending = rdcu_poll();
+		if (pending <= 0)
+			break;
+	}
+	TEST_ASSERT_EQUAL_INT(-1, pending);
+	TEST_ASSERT_EQUAL_INT(0, rdcu_poll());
+}
+
+
+/**
+ * @test rdcu_wait
+ * @test rdcu_rmap_set_poll_limit
+ */
+
+void test_rdcu_wait_poll_limit(void)
+{
+	/* without a timer the poll rounds are counted, not the time */
+	rdcu_rmap_set_timer(NULL);
+	rdcu_sim_set_link(1000, 0);
+	rdcu_sim_set_poll_time(10);
+
+	/* the reply needs about 100 polls to arrive */
+	rdcu_rmap_set_poll_limit(10);
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_fpga_version());
+	TEST_ASSERT_EQUAL_INT(-1, rdcu_wait(UINT32_MAX));
+	TEST_ASSERT_EQUAL_INT(1, rdcu_rmap_sync_status());
+
+	/* the timeout argument is not taken as poll limit */
+	rdcu_rmap_set_poll_limit(1000);
+	TEST_ASSERT_EQUAL_INT(0, rdcu_wait(0));
+	TEST_ASSERT_EQUAL_HEX16(RDCU_SIM_FPGA_VERSION, rdcu_get_fpga_version());
+
+	/* the default limit */
+	rdcu_rmap_set_poll_limit(0);
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_fpga_version());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_wait(0));
+}
+
+
+/* record of the calls of record_completion() */
+static struct {
+	int calls;
+	int status;
+	void *data;
+} completion;
+
+
+/**
+ * @brief completion callback recording its calls
+ */
+
+static void record_completion(uint16_t tr_id UNUSED, int status, void *data)
+{
+	completion.calls++;
+	completion.status = status;
+	completion.data = data;
+}
+
+
+/**
+ * @test rdcu_rmap_set_completion_cb
+ */
+
+void test_rdcu_completion_cb(void)
+{
+	int user_data;
+
+	memset(&completion, 0, sizeof(completion));
+	rdcu_rmap_set_completion_cb(record_completion, &user_data);
+
+	/* the callback is called once a reply was processed */
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_fpga_version());
+	TEST_ASSERT_EQUAL_INT(0, completion.calls);
+	TEST_ASSERT_EQUAL_INT(0, rdcu_wait(1000));
+	TEST_ASSERT_EQUAL_INT(1, completion.calls);
+	TEST_ASSERT_EQUAL_INT(0, completion.status);
+	TEST_ASSERT_EQUAL_PTR(&user_data, completion.data);
+
+	/* and with an error status for a faulty reply */
+	rdcu_sim_corrupt_replies(1);
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_fpga_version());
+	TEST_ASSERT_EQUAL_INT(-1, rdcu_wait(1000));
+	TEST_ASSERT_EQUAL_INT(2, completion.calls);
+	TEST_ASSERT_NOT_EQUAL_INT(0, completion.status);
+
+	/* the callback is stored with the transaction when it is submitted */
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_fpga_version());
+	rdcu_rmap_set_completion_cb(NULL, NULL);
+	TEST_ASSERT_EQUAL_INT(0, rdcu_wait(1000));
+	TEST_ASSERT_EQUAL_INT(3, completion.calls);
+
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_fpga_version());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_wait(1000));
+	TEST_ASSERT_EQUAL_INT(3, completion.calls);
+}
+
+
+/**
+ * @test rdcu_read_cmp_bitstream
+ * @test rdcu_sync_sram_to_mirror
+ * @test rdcu_sync_fpga_version
+ */
+
+void test_rdcu_read_sram_raw(void)
+{
+	static const uint8_t sram_data[] = {0x01, 0x23, 0x45, 0x67,
+					    0x89, 0xAB, 0xCD, 0xEF};
+	uint32_t const adr = CMP_DEF_IMA_DIFF_RDCU_BUFFER_ADR;
+	struct cmp_info info;
+	uint8_t buf[sizeof(sram_data)];
+
+	memcpy(&rdcu_sim_get_sram()[adr], sram_data, sizeof(sram_data));
+
+	/* SRAM data is returned as stored, without a 32 bit word swap */
+	memset(&info, 0, sizeof(info));
+	info.cmp_size = sizeof(sram_data) * 8;
+	info.rdcu_cmp_adr_used = adr;
+	TEST_ASSERT_EQUAL_INT(sizeof(sram_data), rdcu_read_cmp_bitstream(&info, buf));
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(sram_data, buf, sizeof(sram_data));
+
+	/* the transaction slot is reused for a register, which is converted */
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_fpga_version());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_wait(1000));
+	TEST_ASSERT_EQUAL_HEX16(RDCU_SIM_FPGA_VERSION, rdcu_get_fpga_version());
+
+	/* SRAM and register reads in flight at the same time */
+	memset(buf, 0, sizeof(buf));
+	memset(&rdcu_sim_get_sram()[adr], 0, sizeof(sram_data));
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_sram_to_mirror(adr, sizeof(sram_data), TEST_MTU));
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_fpga_version());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_wait(1000));
+	TEST_ASSERT_EQUAL_INT(sizeof(sram_data), rdcu_read_sram(buf, adr, sizeof(sram_data)));
+	TEST_ASSERT_EACH_EQUAL_HEX8(0, buf, sizeof(buf));
+	TEST_ASSERT_EQUAL_HEX16(RDCU_SIM_FPGA_VERSION, rdcu_get_fpga_version());
+}
+
+
+/**
+ * @brief build an RMAP reply without a reply address
+ *
+ * @param buf		buffer for the packet; the size must match the packet
+ * @param cmd		the command code of the reply
+ * @param data		the data of a read reply (NULL for a write reply)
+ * @param data_len	the length of the data
+ *
+ * @returns the size of the packet
+ */
+
+static uint32_t build_rmap_reply(uint8_t *buf, uint8_t cmd,
+				 const uint8_t *data, uint32_t data_len)
+{
+	struct rmap_instruction ri;
+	uint32_t n = 0;
+
+	memset(&ri, 0, sizeof(ri));
+	ri.cmd = cmd & 0xF;
+
+	buf[n++] = 0xFE;			/* initiator */
+	buf[n++] = RMAP_PROTOCOL_ID;
+	memcpy(&buf[n++], &ri, sizeof(ri));
+	buf[n++] = RMAP_STATUS_SUCCESS;
+	buf[n++] = 0xEF;			/* target */
+	buf[n++] = 0x12;			/* transaction id */
+	buf[n++] = 0x34;
+
+	if (!(cmd & RMAP_CMD_BIT_WRITE)) {
+		buf[n++] = 0x0;			/* reserved */
+		buf[n++] = (uint8_t)(data_len >> 16);
+		buf[n++] = (uint8_t)(data_len >> 8);
+		buf[n++] = (uint8_t)data_len;
+	}
+
+	buf[n] = rmap_crc8(buf, n);
+	n++;
+
+	if (!(cmd & RMAP_CMD_BIT_WRITE)) {
+		memcpy(&buf[n], data, data_len);
+		buf[n + data_len] = rmap_crc8(data, data_len);
+		n += data_len + 1;
+	}
+
+	return n;
+}
+
+
+/**
+ * @test rmap_pkt_from_buffer
+ */
+
+void test_rmap_pkt_from_buffer_reply_hdr_crc(void)
+{
+	static const uint8_t data[] = {0xDE, 0xAD, 0xBE, 0xEF};
+	struct rmap_pkt *pkt;
+	uint8_t *buf;
+	uint32_t n;
+
+	/* a write reply ends with the header CRC after the transaction id */
+	buf = malloc(RMAP_HDR_MIN_SIZE_WRITE_REP + 1);
+	TEST_ASSERT_NOT_NULL(buf);
+	n = build_rmap_reply(buf, RMAP_WRITE_ADDR_INC_VERIFY_REPLY, NULL, 0);
+	TEST_ASSERT_EQUAL_UINT32(RMAP_HDR_MIN_SIZE_WRITE_REP + 1, n);
+
+	pkt = rmap_pkt_from_buffer(buf, n);
+	TEST_ASSERT_NOT_NULL(pkt);
+	TEST_ASSERT_EQUAL_HEX16(0x1234, pkt->tr_id);
+	TEST_ASSERT_EQUAL_UINT32(0, pkt->data_len);
+	TEST_ASSERT_EQUAL_HEX8(buf[RMAP_HDR_MIN_SIZE_WRITE_REP], pkt->hdr_crc);
+	TEST_ASSERT_EQUAL_HEX8(rmap_crc8(buf, RMAP_HDR_MIN_SIZE_WRITE_REP), pkt->hdr_crc);
+	rmap_erase_packet(pkt);
+	free(buf);
+
+	/* a read reply has the header CRC after the data length */
+	buf = malloc(RMAP_HDR_MIN_SIZE_READ_REP + 1 + sizeof(data) + 1);
+	TEST_ASSERT_NOT_NULL(buf);
+	n = build_rmap_reply(buf, RMAP_READ_ADDR_INC, data, sizeof(data));
+
+	pkt = rmap_pkt_from_buffer(buf, n);
+	TEST_ASSERT_NOT_NULL(pkt);
+	TEST_ASSERT_EQUAL_HEX16(0x1234, pkt->tr_id);
+	TEST_ASSERT_EQUAL_UINT32(sizeof(data), pkt->data_len);
+	TEST_ASSERT_EQUAL_HEX8(rmap_crc8(buf, RMAP_HDR_MIN_SIZE_READ_REP), pkt->hdr_crc);
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(data, pkt->data, sizeof(data));
+	TEST_ASSERT_EQUAL_HEX8(rmap_crc8(data, sizeof(data)), pkt->data_crc);
+	rmap_erase_packet(pkt);
+
+	/* a read reply without its data is rejected */
+	TEST_ASSERT_NULL(rmap_pkt_from_buffer(buf, RMAP_HDR_MIN_SIZE_READ_REP + 1));
+	free(buf);
+}
+
+
+/**
+ * @test rdcu_interrupt_compression
+ */
+
+void test_rdcu_interrupt_compression(void)
+{
+	struct rdcu_cfg rcfg;
+	struct cmp_status status;
+	struct cmp_info info;
+	uint16_t data[TEST_SAMPLES];
+
+	gen_test_data(data, NULL, TEST_SAMPLES);
+	TEST_ASSERT_FALSE(rdcu_cfg_create(&rcfg, CMP_MODE_DIFF_ZERO, 0, CMP_LOSSLESS));
+	TEST_ASSERT_FALSE(rdcu_cfg_buffers(&rcfg, data, TEST_SAMPLES, NULL,
+					   CMP_DEF_IMA_DIFF_RDCU_DATA_ADR,
+					   CMP_DEF_IMA_DIFF_RDCU_MODEL_ADR,
+					   CMP_DEF_IMA_DIFF_RDCU_UP_MODEL_ADR,
+					   CMP_DEF_IMA_DIFF_RDCU_BUFFER_ADR,
+					   TEST_SAMPLES * 2));
+	TEST_ASSERT_FALSE(rdcu_cfg_imagette_default(&rcfg));
+
+	/* one sample per second, the compression is still running */
+	rdcu_sim_set_cmp_rate(1);
+	TEST_ASSERT_EQUAL_INT(0, rdcu_compress_data(&rcfg));
+
+	TEST_ASSERT_EQUAL_INT(0, rdcu_read_cmp_status(&status));
+	TEST_ASSERT_TRUE(status.cmp_active);
+	TEST_ASSERT_FALSE(status.cmp_ready);
+
+	/* the information registers are blocked during a compression */
+	TEST_ASSERT_EQUAL_INT(-1, rdcu_read_cmp_info(&info));
+
+	TEST_ASSERT_EQUAL_INT(0, rdcu_interrupt_compression());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_read_cmp_status(&status));
+	TEST_ASSERT_FALSE(status.cmp_active);
+	TEST_ASSERT_TRUE(status.cmp_ready);
+	TEST_ASSERT_TRUE(status.cmp_interrupted);
+	TEST_ASSERT_FALSE(status.data_valid);
+}
+
+
+/**
+ * @test rdcu_transfer_data
+ * @test rdcu_wait
+ */
+
+void test_rdcu_transfer_data_link_timing(void)
+{
+	struct rdcu_cfg rcfg;
+	struct rdcu_sim_stats stats;
+	static uint16_t data[RDCU_PIPELINE_MAX_SAMPLES / 16];
+	uint32_t const samples = sizeof(data) / sizeof(data[0]);
+	uint32_t const bit_rate = 100000000;
+	uint64_t min_time_us;
+
+	gen_test_data(data, NULL, samples);
+	TEST_ASSERT_FALSE(rdcu_cfg_create(&rcfg, CMP_MODE_DIFF_ZERO, 0, CMP_LOSSLESS));
+	TEST_ASSERT_FALSE(rdcu_cfg_pipeline_buffers(&rcfg, data, samples, NULL, 0));
+
+	rdcu_sim_set_link(50, bit_rate);
+	TEST_ASSERT_EQUAL_INT(0, rdcu_transfer_data(&rcfg));
+
+	rdcu_sim_get_stats(&stats);
+	TEST_ASSERT_EQUAL_UINT64((samples * 2 + TEST_MTU - 1) / TEST_MTU, stats.cmd_pkts);
+	TEST_ASSERT_EQUAL_UINT64(stats.cmd_pkts, stats.reply_pkts);
+	TEST_ASSERT_EQUAL_UINT64(0, stats.rmap_errors);
+
+	/* the transfer is limited by the link bit rate, not by the latency */
+	min_time_us = stats.cmd_bytes * 10 * 1000000 / bit_rate;
+	TEST_ASSERT_GREATER_OR_EQUAL_UINT64(min_time_us, rdcu_sim_get_time_us());
+	TEST_ASSERT_LESS_THAN_UINT64(min_time_us + 50 * stats.cmd_pkts, rdcu_sim_get_time_us());
+
+	/* the data has arrived in the simulated SRAM in big-endian order */
+	TEST_ASSERT_EQUAL_HEX8(data[samples-1] >> 8,
+			       rdcu_sim_get_sram()[rcfg.rdcu_data_adr + (samples-1) * 2]);
+	TEST_ASSERT_EQUAL_HEX8(data[samples-1] & 0xFF,
+			       rdcu_sim_get_sram()[rcfg.rdcu_data_adr + (samples-1) * 2 + 1]);
+}
+
+
+/**
+ * @brief get the number of RMAP commands the simulated RDCU received
+ */
+
+static uint64_t sim_cmd_pkts(void)
+{
+	struct rdcu_sim_stats stats;
+
+	rdcu_sim_get_stats(&stats);
+	return stats.cmd_pkts;
+}
+
+
+/**
+ * @test rdcu_sync_compr_param_regs
+ */
+
+void test_rdcu_sync_compr_param_regs_coalescing(void)
+{
+	uint64_t cmd_pkts;
+
+	TEST_ASSERT_EQUAL_INT(0, rdcu_set_num_samples(TEST_SAMPLES));
+	TEST_ASSERT_EQUAL_INT(0, rdcu_set_compr_data_buf_len(TEST_SAMPLES));
+
+	/* every register synced on its own takes one RMAP command */
+	cmd_pkts = sim_cmd_pkts();
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_compressor_param1());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_compressor_param2());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_adaptive_param1());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_adaptive_param2());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_data_start_addr());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_model_start_addr());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_num_samples());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_new_model_start_addr());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_compr_data_buf_start_addr());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_compr_data_buf_len());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_wait(1000000));
+	TEST_ASSERT_EQUAL_UINT64(RDCU_COMPR_PARAM_REGS, sim_cmd_pkts() - cmd_pkts);
+
+	/* the coalesced sync writes all of them with a single command */
+	cmd_pkts = sim_cmd_pkts();
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_compr_param_regs());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_wait(1000000));
+	TEST_ASSERT_EQUAL_UINT64(1, sim_cmd_pkts() - cmd_pkts);
+
+	/* unchanged registers are not written again */
+	cmd_pkts = sim_cmd_pkts();
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_compr_param_regs());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_wait(1000000));
+	TEST_ASSERT_EQUAL_UINT64(0, sim_cmd_pkts() - cmd_pkts);
+
+	/* a changed register is written once */
+	cmd_pkts = sim_cmd_pkts();
+	TEST_ASSERT_EQUAL_INT(0, rdcu_set_num_samples(TEST_SAMPLES / 2));
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_compr_param_regs());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_wait(1000000));
+	TEST_ASSERT_EQUAL_UINT64(1, sim_cmd_pkts() - cmd_pkts);
+
+	/* a write only counts as synced once the RDCU acknowledged it */
+	cmd_pkts = sim_cmd_pkts();
+	TEST_ASSERT_EQUAL_INT(0, rdcu_set_num_samples(TEST_SAMPLES));
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_compr_param_regs());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_compr_param_regs());
+	TEST_ASSERT_EQUAL_UINT64(2, sim_cmd_pkts() - cmd_pkts);
+	TEST_ASSERT_EQUAL_INT(0, rdcu_wait(1000000));
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_compr_param_regs());
+	TEST_ASSERT_EQUAL_UINT64(2, sim_cmd_pkts() - cmd_pkts);
+
+	/* a dropped write is not taken as synced */
+	cmd_pkts = sim_cmd_pkts();
+	TEST_ASSERT_EQUAL_INT(0, rdcu_set_num_samples(TEST_SAMPLES / 2));
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_compr_param_regs());
+	rdcu_rmap_reset_log();
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_compr_param_regs());
+	TEST_ASSERT_EQUAL_INT(0, rdcu_wait(1000000));
+	TEST_ASSERT_EQUAL_UINT64(2, sim_cmd_pkts() - cmd_pkts);
+}
+
+
+/**
+ * @test rdcu_wait
+ */
+
+void test_rdcu_wait_timeout(void)
+{
+	/* the reply arrives 2 s after the command was sent */
+	rdcu_sim_set_link(1000000, 0);
+
+	TEST_ASSERT_EQUAL_INT(0, rdcu_sync_compr_status());
+	TEST_ASSERT_EQUAL_INT(-1, rdcu_wait(1000000));
+
+	/* a late reply is still processed */
+	TEST_ASSERT_EQUAL_INT(0, rdcu_wait(2000000));
+}
+
+
+/**
+ * @brief check that data have arrived in the simulated SRAM in big-endian order
+ */
+
+static void check_sim_sram(const uint16_t *data, uint32_t adr, uint32_t samples)
+{
+	const uint8_t *sram = rdcu_sim_get_sram() + adr;
+	uint32_t i;
+
+	for (i = 0; i < samples; i++) {
+		TEST_ASSERT_EQUAL_HEX8(data[i] >> 8, sram[2*i]);
+		TEST_ASSERT_EQUAL_HEX8(data[i] & 0xFF, sram[2*i + 1]);
+	}
+}
+
+
+/**
+ * @brief compare the bitstream read back from the RDCU with a software
+ *	compression like the RDCU of the same job
+ */
+
+static void check_job_bitstream(const struct rdcu_cfg *job, const struct cmp_info *info,
+				const uint32_t *bitstream)
+{
+	struct rdcu_cfg sw_cfg = *job;
+	struct cmp_info sw_info;
+	uint32_t sw_bitstream[TEST_SAMPLES];
+
+	sw_cfg.icu_output_buf = sw_bitstream;
+	sw_cfg.icu_new_model_buf = NULL;
+	sw_cfg.buffer_length = TEST_SAMPLES * 2;
+	TEST_ASSERT_FALSE(cmp_is_error(compress_like_rdcu(&sw_cfg, &sw_info)));
+
+	TEST_ASSERT_EQUAL_HEX16(0, info->cmp_err);
+	TEST_ASSERT_EQUAL_UINT32(sw_info.cmp_size, info->cmp_size);
+	TEST_ASSERT_EQUAL_UINT32(job->rdcu_buffer_adr, info->rdcu_cmp_adr_used);
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(sw_bitstream, bitstream, (info->cmp_size + 7) / 8);
+}
+
+
+/**
+ * @test rdcu_compress_data_parallel
+ * @test rdcu_cfg_pipeline_buffers
+ */
+
+void test_rdcu_compress_data_parallel(void)
+{
+	enum { NUM_JOBS = 3 };
+	struct rdcu_cfg job[NUM_JOBS];
+	struct cmp_info info[NUM_JOBS];
+	struct cmp_status status;
+	struct rdcu_sim_stats stats;
+	static uint16_t data[NUM_JOBS][TEST_SAMPLES];
+	uint32_t bitstream[TEST_SAMPLES];
+	int size;
+	unsigned int n;
+
+	/* a compression takes 10 ms, a data transfer well below 1 ms */
+	rdcu_sim_set_link(50, 100000000);
+	rdcu_sim_set_cmp_rate(100000);
+
+	for (n = 0; n < NUM_JOBS; n++) {
+		gen_test_data(data[n], NULL, TEST_SAMPLES);
+		TEST_ASSERT_FALSE(rdcu_cfg_create(&job[n], CMP_MODE_DIFF_ZERO, 0, CMP_LOSSLESS));
+		TEST_ASSERT_FALSE(rdcu_cfg_pipeline_buffers(&job[n], data[n], TEST_SAMPLES, NULL, n));
+		TEST_ASSERT_FALSE(rdcu_cfg_imagette_default(&job[n]));
+	}
+
+	TEST_ASSERT_EQUAL_INT(0, rdcu_transfer_data(&job[0]));
+	TEST_ASSERT_EQUAL_INT(0, rdcu_compress_data_parallel(&job[0], NULL));
+
+	for (n = 1; n < NUM_JOBS; n++) {
+		/* the transfer of the next job overlaps the running compression */
+		TEST_ASSERT_EQUAL_INT(0, rdcu_transfer_data(&job[n]));
+		TEST_ASSERT_EQUAL_INT(0, rdcu_read_cmp_status(&status));
+		TEST_ASSERT_TRUE(status.cmp_active);
+		check_sim_sram(data[n], job[n].rdcu_data_adr, TEST_SAMPLES);
+
+		wait_for_compression();
+		TEST_ASSERT_EQUAL_INT(0, rdcu_read_cmp_info(&info[n-1]));
+
+		/* start the next job and read back the bitstream of the previous one */
+		TEST_ASSERT_EQUAL_INT(0, rdcu_compress_data_parallel(&job[n], &info[n-1]));
+		TEST_ASSERT_EQUAL_INT(0, rdcu_read_cmp_status(&status));
+		TEST_ASSERT_TRUE(status.cmp_active);
+		size = rdcu_read_sram(bitstream, info[n-1].rdcu_cmp_adr_used,
+				      (uint32_t)rdcu_read_cmp_bitstream(&info[n-1], NULL));
+		TEST_ASSERT_GREATER_THAN(0, size);
+		check_job_bitstream(&job[n-1], &info[n-1], bitstream);
+	}
+
+	wait_for_compression();
+	TEST_ASSERT_EQUAL_INT(0, rdcu_read_cmp_info(&info[NUM_JOBS-1]));
+	TEST_ASSERT_GREATER_THAN(0, rdcu_read_cmp_bitstream(&info[NUM_JOBS-1], bitstream));
+	check_job_bitstream(&job[NUM_JOBS-1], &info[NUM_JOBS-1], bitstream);
+
+	rdcu_sim_get_stats(&stats);
+	TEST_ASSERT_EQUAL_UINT64(NUM_JOBS, stats.compressions);
+	TEST_ASSERT_EQUAL_UINT64(0, stats.rmap_errors);
+
+	/* error: the compressed data buffer of a job in the same layout overlaps
+	 * the bitstream still to be read back */
+	TEST_ASSERT_EQUAL_INT(-1, rdcu_compress_data_parallel(&job[0], &info[NUM_JOBS-1]));
+	TEST_ASSERT_EQUAL_INT(-1, rdcu_compress_data_parallel(NULL, NULL));
+}
+
+
+/**
+ * @test rdcu_cfg_model_resident
+ * @test rdcu_compress_data
+ */
+
+void test_rdcu_compress_data_model_resident(void)
+{
+	struct rdcu_cfg rcfg[2], sw_cfg;
+	struct cmp_info info[2], sw_info;
+	struct rdcu_sim_stats stats;
+	uint16_t data[2][TEST_SAMPLES], model[TEST_SAMPLES];
+	uint16_t up_model[TEST_SAMPLES], sw_up_model[2][TEST_SAMPLES];
+	uint32_t bitstream[TEST_SAMPLES], sw_bitstream[TEST_SAMPLES];
+	uint64_t cmd_bytes;
+	unsigned int n;
+
+	gen_test_data(data[0], model, TEST_SAMPLES);
+	gen_test_data(data[1], NULL, TEST_SAMPLES);
+
+	for (n = 0; n < 2; n++) {
+		TEST_ASSERT_FALSE(rdcu_cfg_create(&rcfg[n], CMP_MODE_MODEL_MULTI, 8, CMP_LOSSLESS));
+		TEST_ASSERT_FALSE(rdcu_cfg_buffers(&rcfg[n], data[n], TEST_SAMPLES, model,
+						   CMP_DEF_IMA_MODEL_RDCU_DATA_ADR,
+						   CMP_DEF_IMA_MODEL_RDCU_MODEL_ADR,
+						   CMP_DEF_IMA_MODEL_RDCU_UP_MODEL_ADR,
+						   CMP_DEF_IMA_MODEL_RDCU_BUFFER_ADR,
+						   TEST_SAMPLES * 2));
+		TEST_ASSERT_FALSE(rdcu_cfg_imagette_default(&rcfg[n]));
+	}
+
+	/* the first compression uploads the model */
+	TEST_ASSERT_EQUAL_INT(0, rdcu_compress_data(&rcfg[0]));
+	wait_for_compression();
+	TEST_ASSERT_EQUAL_INT(0, rdcu_read_cmp_info(&info[0]));
+	TEST_ASSERT_EQUAL_HEX16(0, info[0].cmp_err);
+
+	/* the second one uses the updated model left in the SRAM */
+	TEST_ASSERT_FALSE(rdcu_cfg_model_resident(&rcfg[1], &info[0]));
+	TEST_ASSERT_NULL(rcfg[1].model_buf);
+	TEST_ASSERT_EQUAL_HEX32(CMP_DEF_IMA_MODEL_RDCU_UP_MODEL_ADR, rcfg[1].rdcu_model_adr);
+	TEST_ASSERT_EQUAL_HEX32(CMP_DEF_IMA_MODEL_RDCU_MODEL_ADR, rcfg[1].rdcu_new_model_adr);
+
+	rdcu_sim_get_stats(&stats);
+	cmd_bytes = stats.cmd_bytes;
+	TEST_ASSERT_EQUAL_INT(0, rdcu_compress_data(&rcfg[1]));
+	rdcu_sim_get_stats(&stats);
+	/* only the data are uploaded, the model stays in the SRAM */
+	TEST_ASSERT_GREATER_OR_EQUAL_UINT64(TEST_SAMPLES * 2, stats.cmd_bytes - cmd_bytes);
+	TEST_ASSERT_LESS_THAN_UINT64(2 * TEST_SAMPLES * 2, stats.cmd_bytes - cmd_bytes);
+
+	wait_for_compression();
+	TEST_ASSERT_EQUAL_INT(0, rdcu_read_cmp_info(&info[1]));
+	TEST_ASSERT_EQUAL_HEX16(0, info[1].cmp_err);
+	TEST_ASSERT_EQUAL_HEX32(CMP_DEF_IMA_MODEL_RDCU_MODEL_ADR, info[1].rdcu_new_model_adr_used);
+
+	/* the same two compressions in software */
+	for (n = 0; n < 2; n++) {
+		sw_cfg = rcfg[n];
+		sw_cfg.model_buf = n ? sw_up_model[0] : model;
+		sw_cfg.icu_new_model_buf = sw_up_model[n];
+		sw_cfg.icu_output_buf = sw_bitstream;
+		TEST_ASSERT_FALSE(cmp_is_error(compress_like_rdcu(&sw_cfg, &sw_info)));
+	}
+
+	TEST_ASSERT_EQUAL_UINT32(sw_info.cmp_size, info[1].cmp_size);
+	TEST_ASSERT_GREATER_THAN(0, rdcu_read_cmp_bitstream(&info[1], bitstream));
+	TEST_ASSERT_EQUAL_HEX8_ARRAY(sw_bitstream, bitstream, (info[1].cmp_size + 7) / 8);
+	TEST_ASSERT_EQUAL_INT(TEST_SAMPLES * 2, rdcu_read_model(&info[1], up_model));
+	TEST_ASSERT_EQUAL_HEX16_ARRAY(sw_up_model[1], up_model, TEST_SAMPLES);
+
+	rdcu_sim_get_stats(&stats);
+	TEST_ASSERT_EQUAL_UINT64(2, stats.compressions);
+	TEST_ASSERT_EQUAL_UINT64(0, stats.rmap_errors);
+}
@@ -0,0 +1,98 @@
+/* AUTOGENERATED FILE. DO NOT EDIT. */
+
+/*=======Automagically Detected Files To Include=====*/
+#include "unity.h"
+
+/*=======External Functions This Runner Calls=====*/
+extern void test_rdcu_compress_data_diff(void);
+extern void test_rdcu_compress_data_model(void);
+extern void test_rdcu_read_model_byte_order(void);
+extern void test_rdcu_read_reply_data_crc(void);
+extern void test_rdcu_poll(void);
+extern void test_rdcu_wait_poll_limit(void);
+extern void test_rdcu_completion_cb(void);
+extern void test_rdcu_read_sram_raw(void);
+extern void test_rmap_pkt_from_buffer_reply_hdr_crc(void);
+extern void test_rdcu_interrupt_compression(void);
+extern void test_rdcu_transfer_data_link_timing(void);
+extern void test_rdcu_sync_compr_param_regs_coalescing(void);
+extern void test_rdcu_wait_timeout(void);
+extern void test_rdcu_compress_data_parallel(void);
+extern void test_rdcu_compress_data_model_resident(void);
+
+
+/*=======Mock Management=====*/
+static void CMock_Init(void)
+{
+}
+static void CMock_Verify(void)
+{
+}
+static void CMock_Destroy(void)
+{
+}
+
+/*=======Test Reset Options=====*/
+void resetTest(void)
+{
+  tearDown();
+  CMock_Verify();
+  CMock_Destroy();
+  CMock_Init();
+  setUp();
+}
+void verifyTest(void)
+{
+  CMock_Verify();
+}
+
+/*=======Test Runner Used To Run Each Test=====*/
+static void run_test(UnityTestFunction func, const char* name, UNITY_LINE_TYPE line_num)
+{
+    Unity.CurrentTestName = name;
+    Unity.CurrentTestLineNumber = line_num;
+#ifdef UNITY_USE_COMMAND_LINE_ARGS
+    if (!UnityTestMatches())
+        return;
+#endif
+    Unity.NumberOfTests++;
+    UNITY_CLR_DETAILS();
+    UNITY_EXEC_TIME_START();
+    CMock_Init();
+    if (TEST_PROTECT())
+    {
+        setUp();
+        func();
+    }
+    if (TEST_PROTECT())
+    {
+        tearDown();
+        CMock_Verify();
+    }
+    CMock_Destroy();
+    UNITY_EXEC_TIME_STOP();
+    UnityConcludeTest();
+}
+
+/*=======MAIN=====*/
+int main(void)
+{
+  UnityBegin("../test/cmp_rdcu/test_cmp_rdcu.c");
+  run_test(test_rdcu_compress_data_diff, "test_rdcu_compress_data_diff", 171);
+  run_test(test_rdcu_compress_data_model, "test_rdcu_compress_data_model", 182);
+  run_test(test_rdcu_read_model_byte_order, "test_rdcu_read_model_byte_order", 192);
+  run_test(test_rdcu_read_reply_data_crc, "test_rdcu_read_reply_data_crc", 224);
+  run_test(test_rdcu_poll, "test_rdcu_poll", 253);
+  run_test(test_rdcu_wait_poll_limit, "test_rdcu_wait_poll_limit", 294);
+  run_test(test_rdcu_completion_cb, "test_rdcu_completion_cb", 343);
+  run_test(test_rdcu_read_sram_raw, "test_rdcu_read_sram_raw", 383);
+  run_test(test_rmap_pkt_from_buffer_reply_hdr_crc, "test_rmap_pkt_from_buffer_reply_hdr_crc", 469);
+  run_test(test_rdcu_interrupt_compression, "test_rdcu_interrupt_compression", 515);
+  run_test(test_rdcu_transfer_data_link_timing, "test_rdcu_transfer_data_link_timing", 557);
+  run_test(test_rdcu_sync_compr_param_regs_coalescing, "test_rdcu_sync_compr_param_regs_coalescing", 608);
+  run_test(test_rdcu_wait_timeout, "test_rdcu_wait_timeout", 674);
+  run_test(test_rdcu_compress_data_parallel, "test_rdcu_compress_data_parallel", 732);
+  run_test(test_rdcu_compress_data_model_resident, "test_rdcu_compress_data_model_resident", 799);
+
+  return UnityEnd();
+}
@@ -385,6 +385,158 @@ void test_rdcu_cfg_buffers_model(void)
 }
 
 
+/**
+ * @test rdcu_cfg_pipeline_buffers
+ */
+
+void test_rdcu_cfg_pipeline_buffers(void)
+{
+	int error;
+	struct rdcu_cfg rcfg;
+	uint16_t data_to_compress[4] = {0x23, 0x42, 0xFF, 0x32};
+	uint16_t model_of_data[4] = {0xFF, 0x12, 0x34, 0xAB};
+	uint32_t data_samples = 4;
+
+	error = rdcu_cfg_create(&rcfg, CMP_MODE_MODEL_MULTI, MAX_MODEL_VALUE,
+				CMP_LOSSLESS);
+	TEST_ASSERT_FALSE(error);
+
+	/* first layout */
+	error = rdcu_cfg_pipeline_buffers(&rcfg, data_to_compress, data_samples,
+					  model_of_data, 0);
+	TEST_ASSERT_FALSE(error);
+	TEST_ASSERT_EQUAL(data_to_compress, rcfg.input_buf);
+	TEST_ASSERT_EQUAL(data_samples, rcfg.samples);
+	TEST_ASSERT_EQUAL(model_of_data, rcfg.model_buf);
+	TEST_ASSERT_EQUAL_HEX(0x000000, rcfg.rdcu_data_adr);
+	TEST_ASSERT_EQUAL_HEX(0x100000, rcfg.rdcu_model_adr);
+	TEST_ASSERT_EQUAL_HEX(0x200000, rcfg.rdcu_new_model_adr);
+	TEST_ASSERT_EQUAL_HEX(0x300000, rcfg.rdcu_buffer_adr);
+	TEST_ASSERT_EQUAL(RDCU_PIPELINE_MAX_SAMPLES, rcfg.buffer_length);
+
+	/* second layout; only the lowest bit of the layout is used */
+	error = rdcu_cfg_pipeline_buffers(&rcfg, data_to_compress, data_samples,
+					  model_of_data, 3);
+	TEST_ASSERT_FALSE(error);
+	TEST_ASSERT_EQUAL_HEX(0x400000, rcfg.rdcu_data_adr);
+	TEST_ASSERT_EQUAL_HEX(0x500000, rcfg.rdcu_model_adr);
+	TEST_ASSERT_EQUAL_HEX(0x600000, rcfg.rdcu_new_model_adr);
+	TEST_ASSERT_EQUAL_HEX(0x700000, rcfg.rdcu_buffer_adr);
+	TEST_ASSERT_EQUAL(RDCU_PIPELINE_MAX_SAMPLES, rcfg.buffer_length);
+
+	/* largest possible job */
+	error = rdcu_cfg_pipeline_buffers(&rcfg, NULL, RDCU_PIPELINE_MAX_SAMPLES,
+					  NULL, 1);
+	TEST_ASSERT_FALSE(error);
+
+	/* error: too many samples for a layout */
+	error = rdcu_cfg_pipeline_buffers(&rcfg, NULL, RDCU_PIPELINE_MAX_SAMPLES+1,
+					  NULL, 0);
+	TEST_ASSERT_TRUE(error);
+
+	/* error: cfg is NULL */
+	error = rdcu_cfg_pipeline_buffers(NULL, data_to_compress, data_samples,
+					  model_of_data, 0);
+	TEST_ASSERT_TRUE(error);
+}
+
+
+/**
+ * @test rdcu_cfg_model_resident
+ */
+
+void test_rdcu_cfg_model_resident(void)
+{
+	int error;
+	struct rdcu_cfg rcfg, rcfg_ref;
+	struct cmp_info info = {0};
+	uint16_t data_to_compress[4] = {0x23, 0x42, 0xFF, 0x32};
+	uint16_t model_of_data[4] = {0xFF, 0x12, 0x34, 0xAB};
+	uint32_t data_samples = 4;
+
+	error = rdcu_cfg_create(&rcfg, CMP_MODE_MODEL_ZERO, 8, CMP_LOSSLESS);
+	TEST_ASSERT_FALSE(error);
+	error = rdcu_cfg_buffers(&rcfg, data_to_compress, data_samples, model_of_data,
+				 0x0, 0x8, 0x10, 0x18, 4);
+	TEST_ASSERT_FALSE(error);
+
+	info.cmp_mode_used = CMP_MODE_MODEL_ZERO;
+	info.samples_used = data_samples;
+	info.rdcu_new_model_adr_used = 0x10;
+
+	/* the model and updated model roles are swapped */
+	error = rdcu_cfg_model_resident(&rcfg, &info);
+	TEST_ASSERT_FALSE(error);
+	TEST_ASSERT_EQUAL_HEX(0x10, rcfg.rdcu_model_adr);
+	TEST_ASSERT_EQUAL_HEX(0x8, rcfg.rdcu_new_model_adr);
+	TEST_ASSERT_NULL(rcfg.model_buf);
+	TEST_ASSERT_EQUAL(data_to_compress, rcfg.input_buf);
+
+	/* ... and back again */
+	info.rdcu_new_model_adr_used = 0x8;
+	error = rdcu_cfg_model_resident(&rcfg, &info);
+	TEST_ASSERT_FALSE(error);
+	TEST_ASSERT_EQUAL_HEX(0x8, rcfg.rdcu_model_adr);
+	TEST_ASSERT_EQUAL_HEX(0x10, rcfg.rdcu_new_model_adr);
+
+	/* in-place model update */
+	rcfg.rdcu_new_model_adr = 0x8;
+	error = rdcu_cfg_model_resident(&rcfg, &info);
+	TEST_ASSERT_FALSE(error);
+	TEST_ASSERT_EQUAL_HEX(0x8, rcfg.rdcu_model_adr);
+	TEST_ASSERT_EQUAL_HEX(0x8, rcfg.rdcu_new_model_adr);
+
+	/* on error the configuration is not modified */
+	rcfg_ref = rcfg;
+
+	/* error: updated model of the last compression overlaps the data */
+	info.rdcu_new_model_adr_used = 0x4;
+	error = rdcu_cfg_model_resident(&rcfg, &info);
+	TEST_ASSERT_TRUE(error);
+	TEST_ASSERT_EQUAL_MEMORY(&rcfg_ref, &rcfg, sizeof(rcfg));
+	rcfg = rcfg_ref;
+	info.rdcu_new_model_adr_used = 0x8;
+
+	/* error: number of samples do not match */
+	info.samples_used = data_samples - 1;
+	error = rdcu_cfg_model_resident(&rcfg, &info);
+	TEST_ASSERT_TRUE(error);
+	TEST_ASSERT_EQUAL_MEMORY(&rcfg_ref, &rcfg, sizeof(rcfg));
+	rcfg = rcfg_ref;
+	info.samples_used = data_samples;
+
+	/* error: last compression failed */
+	info.cmp_err = 1;
+	error = rdcu_cfg_model_resident(&rcfg, &info);
+	TEST_ASSERT_TRUE(error);
+	TEST_ASSERT_EQUAL_MEMORY(&rcfg_ref, &rcfg, sizeof(rcfg));
+	rcfg = rcfg_ref;
+	info.cmp_err = 0;
+
+	/* error: last compression was not a model mode compression */
+	info.cmp_mode_used = CMP_MODE_DIFF_ZERO;
+	error = rdcu_cfg_model_resident(&rcfg, &info);
+	TEST_ASSERT_TRUE(error);
+	TEST_ASSERT_EQUAL_MEMORY(&rcfg_ref, &rcfg, sizeof(rcfg));
+	rcfg = rcfg_ref;
+	info.cmp_mode_used = CMP_MODE_MODEL_ZERO;
+
+	/* error: no model mode used */
+	rcfg.cmp_mode = CMP_MODE_DIFF_MULTI;
+	error = rdcu_cfg_model_resident(&rcfg, &info);
+	TEST_ASSERT_TRUE(error);
+	TEST_ASSERT_EQUAL_HEX(rcfg_ref.rdcu_model_adr, rcfg.rdcu_model_adr);
+	TEST_ASSERT_EQUAL_HEX(rcfg_ref.rdcu_new_model_adr, rcfg.rdcu_new_model_adr);
+	rcfg = rcfg_ref;
+
+	/* error: NULL pointers */
+	error = rdcu_cfg_model_resident(NULL, &info);
+	TEST_ASSERT_TRUE(error);
+	error = rdcu_cfg_model_resident(&rcfg, NULL);
+	TEST_ASSERT_TRUE(error);
+}
+
+
 /**
  * @test rdcu_cfg_imagette
  */
@@ -7,6 +7,8 @@
 extern void test_rdcu_cfg_create(void);
 extern void test_rdcu_cfg_buffers_raw_diff(void);
 extern void test_rdcu_cfg_buffers_model(void);
+extern void test_rdcu_cfg_pipeline_buffers(void);
+extern void test_rdcu_cfg_model_resident(void);
 extern void test_rdcu_cfg_imagette(void);
 extern void test_rdcu_cfg_imagette_default(void);
 extern void test_rdcu_cmp_cfg_is_invalid(void);
@@ -78,9 +80,11 @@ int main(void)
   run_test(test_rdcu_cfg_create, "test_rdcu_cfg_create", 31);
   run_test(test_rdcu_cfg_buffers_raw_diff, "test_rdcu_cfg_buffers_raw_diff", 106);
   run_test(test_rdcu_cfg_buffers_model, "test_rdcu_cfg_buffers_model", 237);
-  run_test(test_rdcu_cfg_imagette, "test_rdcu_cfg_imagette", 392);
-  run_test(test_rdcu_cfg_imagette_default, "test_rdcu_cfg_imagette_default", 622);
-  run_test(test_rdcu_cmp_cfg_is_invalid, "test_rdcu_cmp_cfg_is_invalid", 665);
+  run_test(test_rdcu_cfg_pipeline_buffers, "test_rdcu_cfg_pipeline_buffers", 392);
+  run_test(test_rdcu_cfg_model_resident, "test_rdcu_cfg_model_resident", 448);
+  run_test(test_rdcu_cfg_imagette, "test_rdcu_cfg_imagette", 531);
+  run_test(test_rdcu_cfg_imagette_default, "test_rdcu_cfg_imagette_default", 761);
+  run_test(test_rdcu_cmp_cfg_is_invalid, "test_rdcu_cmp_cfg_is_invalid", 804);
 
   return UnityEnd();
 }
@@ -25,6 +25,7 @@
 #include <compiler.h>
 #include <cmp_entity.h>
 #include <cmp_data_types.h>
+#define CMP_TRACE 1 /* compile in the timing instrumentation */
 #include "../../lib/icu_compress/cmp_icu.c" /* .c file included to test static functions */
 #include "../../lib/decompress/decmp.c" /* .c file included to test static functions */
 
@@ -1099,6 +1100,56 @@ void test_decompress_imagette_chunk_raw(void)
 }
 
 
+static uint32_t trace_cycles;
+
+static uint32_t get_trace_cycles(void)
+{
+	return trace_cycles += 10;
+}
+
+
+/**
+ * @test decompressed_data_internal
+ * @test cmp_trace_get_events
+ */
+
+void test_decompress_chunk_raw_error_trace(void)
+{
+	enum {	SAMPLES = 4,
+		DATA_SIZE = SAMPLES*sizeof(uint16_t),
+		CHUNK_SIZE = COLLECTION_HDR_SIZE + DATA_SIZE
+	};
+	uint8_t chunk[CHUNK_SIZE], decompressed_data[CHUNK_SIZE];
+	struct cmp_trace_event buf[8], events[8];
+	struct cmp_cfg cfg = {0};
+
+	/* the collection claims more data than the chunk holds */
+	memset(chunk, 0, sizeof(chunk));
+	TEST_ASSERT_FALSE(cmp_col_set_subservice((struct collection_hdr *)chunk,
+						 SST_NCxx_S_SCIENCE_IMAGETTE));
+	TEST_ASSERT_FALSE(cmp_col_set_data_length((struct collection_hdr *)chunk,
+						  DATA_SIZE + 2));
+	cfg.data_type = DATA_TYPE_IMAGETTE;
+	cfg.cmp_mode = CMP_MODE_RAW;
+	cfg.src = chunk;
+	cfg.dst = decompressed_data;
+	cfg.samples = SAMPLES;
+	cfg.stream_size = CHUNK_SIZE;
+
+	trace_cycles = 0;
+	cmp_trace_init(get_trace_cycles, buf, ARRAY_SIZE(buf));
+	TEST_ASSERT_EQUAL_INT(-1, decompressed_data_internal(&cfg, ICU_DECOMRESSION));
+
+	/* the decode span is ended on the error path */
+	TEST_ASSERT_EQUAL_UINT32(2, cmp_trace_get_events(events, ARRAY_SIZE(events)));
+	TEST_ASSERT_EQUAL_UINT16(CMP_TRACE_DECODE, events[0].stage);
+	TEST_ASSERT_EQUAL_UINT16(CMP_TRACE_EV_BEGIN, events[0].type);
+	TEST_ASSERT_EQUAL_UINT16(CMP_TRACE_DECODE, events[1].stage);
+	TEST_ASSERT_EQUAL_UINT16(CMP_TRACE_EV_END, events[1].type);
+
+	cmp_trace_init(NULL, buf, ARRAY_SIZE(buf));
+}
+
 void test_decompression_error_cases(void)
 {
 	/* TODO: error cases model decompression without a model Buffer */
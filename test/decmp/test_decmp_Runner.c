@@ -17,6 +17,7 @@ extern void test_re_map_to_pos(void);
 extern void test_cmp_decmp_rdcu_raw(void);
 extern void test_decompress_imagette_model(void);
 extern void test_decompress_imagette_chunk_raw(void);
+extern void test_decompress_chunk_raw_error_trace(void);
 extern void test_decompression_error_cases(void);
 
 
@@ -96,7 +97,8 @@ int main(void)
   run_test(test_cmp_decmp_rdcu_raw, "test_cmp_decmp_rdcu_raw", 953);
   run_test(test_decompress_imagette_model, "test_decompress_imagette_model", 1010);
   run_test(test_decompress_imagette_chunk_raw, "test_decompress_imagette_chunk_raw", 1056);
-  run_test(test_decompression_error_cases, "test_decompression_error_cases", 1102);
+  run_test(test_decompress_chunk_raw_error_trace, "test_decompress_chunk_raw_error_trace", 1116);
+  run_test(test_decompression_error_cases, "test_decompression_error_cases", 1153);
 
   return UnityEnd();
 }
@@ -0,0 +1,86 @@
+/**
+ * @file fuzz_data_producer.c
+ * @date 2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief derive parameters from the end of the fuzzer input
+ */
+
+#include "fuzz_helpers.h"
+#include "fuzz_data_producer.h"
+
+
+/**
+ * @brief initialise a data producer
+ *
+ * @param fp	pointer to the data producer
+ * @param data	pointer to the fuzzer input
+ * @param size	size of the fuzzer input in bytes
+ */
+
+void fuzz_producer_init(struct fuzz_data_producer *fp, const uint8_t *data,
+			size_t size)
+{
+	FUZZ_ASSERT(fp);
+	FUZZ_ASSERT(data || !size);
+
+	fp->data = data;
+	fp->size = size;
+}
+
+
+/**
+ * @brief consume a value in a range from the end of the input
+ *
+ * @param fp	pointer to the data producer
+ * @param min	minimum of the range (inclusive)
+ * @param max	maximum of the range (inclusive)
+ *
+ * @returns a value in the range [min, max]
+ */
+
+uint32_t fuzz_producer_uint32_range(struct fuzz_data_producer *fp,
+				    uint32_t min, uint32_t max)
+{
+	uint32_t const range = max - min;
+	uint32_t rolling = range;
+	uint32_t result = 0;
+
+	FUZZ_ASSERT(min <= max);
+
+	/* only consume as many bytes as needed to cover the range */
+	while (rolling > 0 && fp->size > 0) {
+		fp->size--;
+		result = (result << 8) | fp->data[fp->size];
+		rolling >>= 8;
+	}
+
+	if (range == UINT32_MAX)
+		return result;
+
+	return min + result % (range + 1);
+}
+
+
+/**
+ * @brief get the size of the not consumed input
+ *
+ * @param fp	pointer to the data producer
+ *
+ * @returns the number of bytes at the start of the input not used for
+ *	parameters
+ */
+
+size_t fuzz_producer_remaining_size(const struct fuzz_data_producer *fp)
+{
+	return fp->size;
+}
@@ -0,0 +1,43 @@
+/**
+ * @file fuzz_data_producer.h
+ * @date 2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief derive parameters from the end of the fuzzer input
+ *
+ * The parameters are consumed from the end of the input, so the start of the
+ * input (e.g. a chunk or compressed data from the seed corpus) stays intact.
+ * If the input is exhausted, the minimum of the requested range is returned.
+ */
+
+#ifndef FUZZ_DATA_PRODUCER_H
+#define FUZZ_DATA_PRODUCER_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+
+struct fuzz_data_producer {
+	const uint8_t *data;
+	size_t size;
+};
+
+
+void fuzz_producer_init(struct fuzz_data_producer *fp, const uint8_t *data,
+			size_t size);
+
+uint32_t fuzz_producer_uint32_range(struct fuzz_data_producer *fp,
+				    uint32_t min, uint32_t max);
+
+size_t fuzz_producer_remaining_size(const struct fuzz_data_producer *fp);
+
+#endif /* FUZZ_DATA_PRODUCER_H */
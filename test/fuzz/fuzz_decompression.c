@@ -0,0 +1,76 @@
+/**
+ * @file fuzz_decompression.c
+ * @date 2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief fuzz target for decompress_cmp_entiy()
+ *
+ * The input is a compression entity, optionally followed by the model of the
+ * data. A missing or too short model is padded with zeros.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fuzz_helpers.h"
+
+#include <cmp_entity.h>
+#include <decmp.h>
+
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	struct cmp_entity *ent;
+	uint8_t *model = NULL, *up_model = NULL, *decmp_data = NULL;
+	uint32_t ent_size, model_size;
+	int decmp_size, decmp_size2;
+
+	if (size < GENERIC_HEADER_SIZE)
+		return 0;
+
+	/* the entity must be 4 byte aligned */
+	ent = malloc(size);
+	FUZZ_ASSERT(ent);
+	memcpy(ent, data, size);
+
+	/* the decompression trusts the entity size field */
+	ent_size = cmp_ent_get_size(ent);
+	if (ent_size < GENERIC_HEADER_SIZE || ent_size > size)
+		goto out;
+
+	decmp_size = (int)cmp_ent_get_original_size(ent);
+	if (decmp_size <= 0)
+		goto out;
+
+	model_size = (uint32_t)(size - ent_size);
+	if (model_size > (uint32_t)decmp_size)
+		model_size = (uint32_t)decmp_size;
+	model = calloc(1, (size_t)decmp_size);
+	up_model = malloc((size_t)decmp_size);
+	decmp_data = malloc((size_t)decmp_size);
+	FUZZ_ASSERT(model && up_model && decmp_data);
+	memcpy(model, data + ent_size, model_size);
+
+	/* first only get the decompressed size, then decompress the data */
+	decmp_size2 = decompress_cmp_entiy(ent, model, NULL, NULL);
+	FUZZ_ASSERT(decmp_size2 < 0 || decmp_size2 == decmp_size);
+	decmp_size2 = decompress_cmp_entiy(ent, model, up_model, decmp_data);
+	FUZZ_ASSERT(decmp_size2 < 0 || decmp_size2 == decmp_size);
+
+out:
+	free(ent);
+	free(model);
+	free(up_model);
+	free(decmp_data);
+	return 0;
+}
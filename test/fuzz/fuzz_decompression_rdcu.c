@@ -0,0 +1,87 @@
+/**
+ * @file fuzz_decompression_rdcu.c
+ * @date 2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief fuzz target for decompress_rdcu_data()
+ *
+ * The compression information is taken from the end of the input, the rest of
+ * the input is used as compressed bitstream and as model.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fuzz_helpers.h"
+#include "fuzz_data_producer.h"
+
+#include <cmp_support.h>
+#include <cmp_cal_up_model.h>
+#include <decmp.h>
+
+/* limit the number of samples to keep the fuzzer fast */
+#define FUZZ_MAX_SAMPLES	0x4000
+
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	struct fuzz_data_producer fp;
+	struct cmp_info info;
+	uint32_t *bitstream;
+	uint16_t *model, *up_model, *decmp_data;
+	size_t bitstream_size, data_size, i;
+	int decmp_size;
+
+	fuzz_producer_init(&fp, data, size);
+
+	memset(&info, 0, sizeof(info));
+	info.cmp_mode_used = fuzz_producer_uint32_range(&fp, 0, MAX_RDCU_CMP_MODE + 1);
+	info.golomb_par_used = fuzz_producer_uint32_range(&fp, 0, MAX_IMA_GOLOMB_PAR + 1);
+	info.spill_used = fuzz_producer_uint32_range(&fp, 0, UINT16_MAX);
+	info.model_value_used = (uint8_t)fuzz_producer_uint32_range(&fp, 0, MAX_MODEL_VALUE + 1);
+	info.round_used = (uint8_t)fuzz_producer_uint32_range(&fp, 0, MAX_RDCU_ROUND + 1);
+	info.samples_used = fuzz_producer_uint32_range(&fp, 0, FUZZ_MAX_SAMPLES);
+
+	bitstream_size = fuzz_producer_remaining_size(&fp);
+	info.cmp_size = (uint32_t)bitstream_size * 8;
+	info.cmp_size -= fuzz_producer_uint32_range(&fp, 0, info.cmp_size < 7 ? info.cmp_size : 7);
+
+	data_size = info.samples_used * sizeof(uint16_t);
+
+	/* the bitstream must be 4 byte aligned and readable in 32 bit words */
+	bitstream = calloc(1, (bitstream_size + 3) & ~(size_t)3);
+	model = malloc(data_size + 1);
+	up_model = malloc(data_size + 1);
+	decmp_data = malloc(data_size + 1);
+	FUZZ_ASSERT(model && up_model && decmp_data);
+	if (bitstream_size) {
+		FUZZ_ASSERT(bitstream);
+		memcpy(bitstream, data, bitstream_size);
+	} else if (!bitstream) {
+		goto out;
+	}
+
+	/* use the input as model */
+	for (i = 0; i < data_size; i++)
+		((uint8_t *)model)[i] = bitstream_size ? data[i % bitstream_size] : 0;
+
+	decmp_size = decompress_rdcu_data(bitstream, &info, model, up_model, decmp_data);
+	FUZZ_ASSERT(decmp_size < 0 || (size_t)decmp_size == data_size);
+
+out:
+	free(bitstream);
+	free(model);
+	free(up_model);
+	free(decmp_data);
+	return 0;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file fuzz_helpers.h
+ * @date 2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief helper macros for the fuzz targets
+ */
+
+#ifndef FUZZ_HELPERS_H
+#define FUZZ_HELPERS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+
+
+#define FUZZ_QUOTE_IMPL(x) #x
+#define FUZZ_QUOTE(x) FUZZ_QUOTE_IMPL(x)
+
+
+/**
+ * @brief assert even if NDEBUG is defined; the fuzzer treats the abort as a
+ *	crash and stores the input which triggers it
+ */
+
+#define FUZZ_ASSERT_MSG(cond, msg)						\
+	do {									\
+		if (!(cond)) {							\
+			fprintf(stderr, "%s:%d: Assertion `%s` failed. %s\n",	\
+				__FILE__, __LINE__, FUZZ_QUOTE(cond), (msg));	\
+			abort();						\
+		}								\
+	} while (0)
+
+#define FUZZ_ASSERT(cond) FUZZ_ASSERT_MSG((cond), "")
+
+
+/* entry point called by libFuzzer or by the regression driver */
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size);
+
+#endif /* FUZZ_HELPERS_H */
@@ -0,0 +1,60 @@
+/**
+ * @file fuzz_rmap_pkt.c
+ * @date 2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief fuzz target for rmap_pkt_from_buffer()
+ *
+ * The input is a received SpaceWire packet. If it is accepted as RMAP packet,
+ * the header is built again from the parsed packet.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fuzz_helpers.h"
+
+#include <rmap.h>
+
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	uint8_t *buf;
+	struct rmap_pkt *pkt;
+	int hdr_size;
+
+	if (size > UINT32_MAX)
+		return 0;
+
+	/* a copy of exactly the input size lets the sanitizer catch overreads */
+	buf = malloc(size ? size : 1);
+	FUZZ_ASSERT(buf);
+	memcpy(buf, data, size);
+
+	pkt = rmap_pkt_from_buffer(buf, (uint32_t)size);
+	free(buf);
+	if (!pkt)
+		return 0;
+
+	hdr_size = rmap_build_hdr(pkt, NULL);
+	if (hdr_size > 0) {
+		uint8_t *hdr = malloc((size_t)hdr_size);
+
+		FUZZ_ASSERT(hdr);
+		FUZZ_ASSERT(rmap_build_hdr(pkt, hdr) == hdr_size);
+		free(hdr);
+	}
+
+	rmap_erase_packet(pkt);
+	return 0;
+}
@@ -0,0 +1,140 @@
+/**
+ * @file fuzz_round_trip.c
+ * @date 2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief chunk compression/decompression round trip fuzz target
+ *
+ * The input starts with a chunk; the chunk ends after the last complete
+ * collection. The bytes after the chunk are used to select the compression
+ * parameters and the buffer configuration. A chunk of the seed corpus without
+ * trailing bytes is compressed with the minimum parameters.
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fuzz_helpers.h"
+#include "fuzz_data_producer.h"
+#include "../test_common/chunk_round_trip.h"
+
+#include <cmp_chunk.h>
+#include <cmp_data_types.h>
+#include <cmp_cal_up_model.h>
+
+
+/**
+ * @brief get the size of the complete collections at the start of the input
+ */
+
+static uint32_t get_chunk_size(const uint8_t *data, size_t size)
+{
+	uint32_t chunk_size = 0;
+
+	if (size > CMP_ENTITY_MAX_ORIGINAL_SIZE)
+		size = CMP_ENTITY_MAX_ORIGINAL_SIZE;
+
+	while (chunk_size + COLLECTION_HDR_SIZE <= size) {
+		const struct collection_hdr *col =
+			(const struct collection_hdr *)(data + chunk_size);
+		uint32_t const col_size = cmp_col_get_size(col);
+
+		if (chunk_size + col_size > size)
+			break;
+		chunk_size += col_size;
+	}
+
+	return chunk_size;
+}
+
+
+int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+	static const enum cmp_mode cmp_modes[] = {
+		CMP_MODE_DIFF_MULTI, CMP_MODE_MODEL_MULTI, CMP_MODE_DIFF_ZERO,
+		CMP_MODE_MODEL_ZERO, CMP_MODE_RAW, CMP_MODE_MODEL_ADAPTIVE,
+		CMP_MODE_DIFF_ADAPTIVE
+	};
+	struct fuzz_data_producer fp;
+	struct cmp_par cmp_par;
+	uint8_t *chunk, *model = NULL, *up_model = NULL;
+	uint32_t *dst = NULL;
+	uint32_t chunk_size, dst_capacity, bound, i, shift;
+	int use_decmp_buf, use_decmp_up_model;
+
+	chunk_size = get_chunk_size(data, size);
+	fuzz_producer_init(&fp, data + chunk_size, size - chunk_size);
+
+	/* sometimes also give the trailing bytes to the compressor */
+	if (fuzz_producer_uint32_range(&fp, 0, 7) == 7 && size <= CMP_ENTITY_MAX_ORIGINAL_SIZE) {
+		chunk_size = (uint32_t)size;
+		fuzz_producer_init(&fp, NULL, 0);
+	}
+	if (chunk_size == 0)
+		return 0;
+
+	memset(&cmp_par, 0, sizeof(cmp_par));
+	cmp_par.cmp_mode = cmp_modes[fuzz_producer_uint32_range(&fp, 0, ARRAY_SIZE(cmp_modes)-1)];
+	cmp_par.model_value = fuzz_producer_uint32_range(&fp, 0, MAX_MODEL_VALUE);
+	cmp_par.lossy_par = fuzz_producer_uint32_range(&fp, 0, MAX_ICU_ROUND);
+	for (i = 0; i < CMP_PAR_NUM_SPECIFIC; i++)
+		*cmp_par_specific(&cmp_par, i) = fuzz_producer_uint32_range(&fp,
+			MIN_NON_IMA_GOLOMB_PAR, MAX_NON_IMA_GOLOMB_PAR);
+	use_decmp_buf = (int)fuzz_producer_uint32_range(&fp, 0, 1);
+	use_decmp_up_model = (int)fuzz_producer_uint32_range(&fp, 0, 1);
+
+	chunk = malloc(chunk_size);
+	FUZZ_ASSERT(chunk);
+	memcpy(chunk, data, chunk_size);
+
+	if (model_mode_is_used(cmp_par.cmp_mode)) {
+		/* the model is a shifted copy of the chunk */
+		model = malloc(chunk_size);
+		FUZZ_ASSERT(model);
+		shift = fuzz_producer_uint32_range(&fp, 0, chunk_size-1);
+		for (i = 0; i < chunk_size; i++)
+			model[i] = chunk[(i + shift) % chunk_size];
+
+		switch (fuzz_producer_uint32_range(&fp, 0, 2)) {
+		case 0: /* in-place model update */
+			up_model = model;
+			break;
+		case 1:
+			up_model = malloc(chunk_size);
+			FUZZ_ASSERT(up_model);
+			break;
+		default: /* no updated model */
+			break;
+		}
+	}
+
+	bound = compress_chunk_cmp_size_bound(chunk, chunk_size);
+	if (cmp_is_error(bound))
+		bound = chunk_size + 4096;
+	dst_capacity = fuzz_producer_uint32_range(&fp, 0, 3) != 3 ?
+		bound : fuzz_producer_uint32_range(&fp, 0, bound);
+	if (fuzz_producer_uint32_range(&fp, 0, 15) != 15) {
+		dst = malloc(dst_capacity ? dst_capacity : 1);
+		FUZZ_ASSERT(dst);
+	}
+
+	chunk_round_trip(chunk, chunk_size, model, up_model, dst, dst_capacity,
+			 &cmp_par, use_decmp_buf, use_decmp_up_model);
+
+	if (up_model != model)
+		free(up_model);
+	free(model);
+	free(chunk);
+	free(dst);
+	return 0;
+}
@@ -0,0 +1,371 @@
+/**
+ * @file gen_seed_corpus.c
+ * @date 2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief generate the seed corpora of the RDCU fuzz targets
+ *
+ * The chunk and entity corpora are written by the benchmark. This generator
+ * writes RDCU mode bitstreams for fuzz_decompression_rdcu, with the
+ * compression information appended in the format of the fuzz data producer,
+ * and the RMAP commands and replies exchanged with the RDCU simulator during
+ * a compression for fuzz_rmap_pkt.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "../test_common/test_common.h"
+#include "../test_common/rdcu_sim.h"
+
+#include <cmp_support.h>
+#include <cmp_chunk.h>
+#include <cmp_cal_up_model.h>
+#include <cmp_icu.h>
+#include <cmp_rdcu.h>
+#include <cmp_rdcu_cfg.h>
+#include <rdcu_ctrl.h>
+#include <rdcu_rmap.h>
+
+#define SEED_SAMPLES	256	/* keep the seeds small, the fuzzer stays fast */
+#define SEED_MTU	256	/* split the SRAM transfers in several packets */
+#define SEED_MAX_PKTS	64
+
+#define ARRAY_SIZE(x) (sizeof(x)/sizeof((x)[0]))
+
+
+/* directories to write the seed corpora to; NULL if not used */
+static const char *rdcu_corpus_dir;
+static const char *rmap_corpus_dir;
+
+static unsigned int num_rmap_pkts;
+
+
+/**
+ * @brief write a seed corpus file
+ *
+ * @returns 0 on success, -1 on error
+ */
+
+static int write_seed(const char *dir, const char *name, const void *buf,
+		      size_t size)
+{
+	char path[4096];
+	FILE *fp;
+	int err = 0;
+
+	snprintf(path, sizeof(path), "%s/%s.bin", dir, name);
+	fp = fopen(path, "wb");
+	if (!fp) {
+		perror(path);
+		return -1;
+	}
+	if (fwrite(buf, 1, size, fp) != size)
+		err = -1;
+	if (fclose(fp))
+		err = -1;
+	if (err)
+		perror(path);
+
+	return err;
+}
+
+
+/**
+ * @brief append a value the way fuzz_producer_uint32_range() consumes it
+ *
+ * The producer consumes the parameters from the end of the input, the most
+ * significant byte first, so they are stored in reverse order.
+ *
+ * @param params	buffer for the parameter bytes, in consumption order
+ * @param n		number of bytes already in the buffer
+ * @param min		minimum of the range of the consumer
+ * @param max		maximum of the range of the consumer
+ * @param value		the value to encode
+ *
+ * @returns the number of bytes in the buffer
+ */
+
+static size_t put_producer_value(uint8_t *params, size_t n, uint32_t min,
+				 uint32_t max, uint32_t value)
+{
+	uint32_t rolling = max - min;
+	unsigned int num_bytes = 0;
+
+	while (rolling > 0) {
+		num_bytes++;
+		rolling >>= 8;
+	}
+
+	value -= min;
+	while (num_bytes--)
+		params[n++] = (uint8_t)(value >> (8 * num_bytes));
+
+	return n;
+}
+
+
+/**
+ * @brief write a fuzz_decompression_rdcu seed of an RDCU compression
+ *
+ * @returns 0 on success, -1 on error
+ */
+
+static int write_rdcu_seed(enum cmp_mode cmp_mode, uint32_t golomb_par,
+			   uint32_t round)
+{
+	static uint16_t data[SEED_SAMPLES], model[SEED_SAMPLES];
+	static uint8_t seed[SEED_SAMPLES * sizeof(uint16_t) * 2 + 64];
+	struct rdcu_cfg rcfg;
+	struct cmp_info info;
+	uint8_t params[16];
+	size_t bitstream_size, n = 0, i;
+	uint32_t cmp_size;
+	char name[64];
+
+	for (i = 0; i < SEED_SAMPLES; i++) {
+		data[i] = (uint16_t)cmp_rand_between(1000, 1100);
+		model[i] = (uint16_t)cmp_rand_between(1000, 1100);
+	}
+
+	if (rdcu_cfg_create(&rcfg, cmp_mode, CMP_DEF_IMA_MODEL_MODEL_VALUE, round) ||
+	    rdcu_cfg_buffers(&rcfg, data, SEED_SAMPLES, model,
+			     CMP_DEF_IMA_MODEL_RDCU_DATA_ADR,
+			     CMP_DEF_IMA_MODEL_RDCU_MODEL_ADR,
+			     CMP_DEF_IMA_MODEL_RDCU_UP_MODEL_ADR,
+			     CMP_DEF_IMA_MODEL_RDCU_BUFFER_ADR,
+			     SEED_SAMPLES * 2) ||
+	    rdcu_cfg_imagette(&rcfg, golomb_par, cmp_ima_max_spill(golomb_par),
+			      golomb_par, cmp_ima_max_spill(golomb_par),
+			      golomb_par, cmp_ima_max_spill(golomb_par)))
+		return -1;
+	rcfg.icu_output_buf = (uint32_t *)seed;
+	rcfg.icu_new_model_buf = NULL;
+
+	cmp_size = compress_like_rdcu(&rcfg, &info);
+	if (cmp_is_error(cmp_size) || info.cmp_err)
+		return -1;
+
+	/* one zero byte after the bitstream consumed as cmp_size reduction */
+	bitstream_size = (cmp_size + 7) / 8;
+	seed[bitstream_size++] = 0;
+
+	/* in the order in which the fuzz target consumes them */
+	n = put_producer_value(params, n, 0, MAX_RDCU_CMP_MODE + 1, info.cmp_mode_used);
+	n = put_producer_value(params, n, 0, MAX_IMA_GOLOMB_PAR + 1, info.golomb_par_used);
+	n = put_producer_value(params, n, 0, UINT16_MAX, info.spill_used);
+	n = put_producer_value(params, n, 0, MAX_MODEL_VALUE + 1, info.model_value_used);
+	n = put_producer_value(params, n, 0, MAX_RDCU_ROUND + 1, info.round_used);
+	n = put_producer_value(params, n, 0, 0x4000, info.samples_used);
+
+	for (i = 0; i < n; i++)
+		seed[bitstream_size + i] = params[n - 1 - i];
+
+	snprintf(name, sizeof(name), "rdcu_mode%d_golomb%u_round%u",
+		 cmp_mode, golomb_par, round);
+	return write_seed(rdcu_corpus_dir, name, seed, bitstream_size + n);
+}
+
+
+/**
+ * @brief write the seeds of the fuzz_decompression_rdcu corpus
+ *
+ * @returns 0 on success, -1 on error
+ */
+
+static int gen_rdcu_corpus(void)
+{
+	static const enum cmp_mode modes[] = {
+		CMP_MODE_RAW, CMP_MODE_MODEL_ZERO, CMP_MODE_DIFF_ZERO,
+		CMP_MODE_MODEL_MULTI, CMP_MODE_DIFF_MULTI
+	};
+	static const uint32_t golomb_pars[] = {1, 4, 9, MAX_IMA_GOLOMB_PAR};
+	size_t m, g;
+	uint32_t round;
+
+	for (m = 0; m < ARRAY_SIZE(modes); m++) {
+		for (g = 0; g < ARRAY_SIZE(golomb_pars); g++) {
+			for (round = 0; round <= MAX_RDCU_ROUND; round += 2) {
+				if (write_rdcu_seed(modes[m], golomb_pars[g], round)) {
+					fprintf(stderr, "RDCU seed generation failed\n");
+					return -1;
+				}
+			}
+		}
+	}
+
+	return 0;
+}
+
+
+/**
+ * @brief record an RMAP packet as seed
+ *
+ * @param pkt	the packet, starting at the target logical address
+ * @param size	the size of the packet
+ */
+
+static void record_rmap_pkt(const uint8_t *pkt, uint32_t size)
+{
+	char name[32];
+
+	if (num_rmap_pkts >= SEED_MAX_PKTS)
+		return;
+
+	snprintf(name, sizeof(name), "rmap_pkt_%02u", num_rmap_pkts++);
+	if (write_seed(rmap_corpus_dir, name, pkt, size))
+		exit(EXIT_FAILURE);
+}
+
+
+/**
+ * @brief rmap_tx function recording the commands sent to the simulator
+ */
+
+static int32_t seed_tx(const void *hdr, uint32_t hdr_size,
+		       const uint8_t non_crc_bytes,
+		       const void *data, uint32_t data_size)
+{
+	uint8_t *blob;
+	uint32_t n;
+
+	n = rdcu_package(NULL, hdr, hdr_size, non_crc_bytes, data, data_size);
+	blob = malloc(n ? n : 1);
+	if (!n || !blob) {
+		free(blob);
+		return -1;
+	}
+	n = rdcu_package(blob, hdr, hdr_size, non_crc_bytes, data, data_size);
+
+	/* the target path is stripped before a packet is parsed */
+	record_rmap_pkt(blob + non_crc_bytes, n - non_crc_bytes);
+	free(blob);
+
+	return rdcu_sim_tx(hdr, hdr_size, non_crc_bytes, data, data_size);
+}
+
+
+/**
+ * @brief rmap_rx function recording the replies of the simulator
+ */
+
+static uint32_t seed_rx(uint8_t *pkt)
+{
+	uint32_t n = rdcu_sim_rx(pkt);
+
+	if (pkt && n)
+		record_rmap_pkt(pkt, n);
+
+	return n;
+}
+
+
+/**
+ * @brief write the seeds of the fuzz_rmap_pkt corpus
+ *
+ * A model mode compression on the RDCU simulator produces register and SRAM
+ * write and read commands and their replies.
+ *
+ * @returns 0 on success, -1 on error
+ */
+
+static int gen_rmap_corpus(void)
+{
+	static uint16_t data[SEED_SAMPLES], model[SEED_SAMPLES];
+	static uint16_t up_model[SEED_SAMPLES];
+	static uint32_t bitstream[SEED_SAMPLES];
+	struct rdcu_cfg rcfg;
+	struct cmp_status status;
+	struct cmp_info info;
+	size_t i;
+	int err = -1;
+
+	for (i = 0; i < SEED_SAMPLES; i++) {
+		data[i] = (uint16_t)cmp_rand_between(1000, 1100);
+		model[i] = (uint16_t)cmp_rand_between(1000, 1100);
+	}
+
+	if (rdcu_ctrl_init() || rdcu_sim_init())
+		goto out;
+	if (rdcu_rmap_init(SEED_MTU, seed_tx, seed_rx))
+		goto out;
+	rdcu_rmap_set_timer(rdcu_sim_get_time_us);
+
+	if (rdcu_cfg_create(&rcfg, CMP_MODE_MODEL_MULTI, CMP_DEF_IMA_MODEL_MODEL_VALUE,
+			    CMP_LOSSLESS) ||
+	    rdcu_cfg_buffers(&rcfg, data, SEED_SAMPLES, model,
+			     CMP_DEF_IMA_MODEL_RDCU_DATA_ADR,
+			     CMP_DEF_IMA_MODEL_RDCU_MODEL_ADR,
+			     CMP_DEF_IMA_MODEL_RDCU_UP_MODEL_ADR,
+			     CMP_DEF_IMA_MODEL_RDCU_BUFFER_ADR,
+			     SEED_SAMPLES * 2) ||
+	    rdcu_cfg_imagette_default(&rcfg))
+		goto out;
+
+	if (rdcu_compress_data(&rcfg))
+		goto out;
+	do {
+		if (rdcu_read_cmp_status(&status))
+			goto out;
+	} while (!status.cmp_ready);
+
+	if (rdcu_read_cmp_info(&info) ||
+	    rdcu_read_cmp_bitstream(&info, bitstream) < 0 ||
+	    rdcu_read_model(&info, up_model) < 0)
+		goto out;
+
+	err = 0;
+out:
+	if (err)
+		fprintf(stderr, "RMAP seed generation failed\n");
+	rdcu_rmap_set_timer(NULL);
+	rdcu_sim_exit();
+	return err;
+}
+
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "usage: %s [-r rdcu_corpus_dir] [-p rmap_pkt_corpus_dir]\n", prog);
+}
+
+
+int main(int argc, char *argv[])
+{
+	int opt;
+
+	while ((opt = getopt(argc, argv, "r:p:h")) != -1) {
+		switch (opt) {
+		case 'r':
+			rdcu_corpus_dir = optarg;
+			break;
+		case 'p':
+			rmap_corpus_dir = optarg;
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	cmp_rand_seed(0x5EEDC0DEULL);
+
+	if (rdcu_corpus_dir && gen_rdcu_corpus())
+		return EXIT_FAILURE;
+	if (rmap_corpus_dir && gen_rmap_corpus())
+		return EXIT_FAILURE;
+
+	return EXIT_SUCCESS;
+}
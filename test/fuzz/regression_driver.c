@@ -0,0 +1,202 @@
+/**
+ * @file regression_driver.c
+ * @date 2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief run a fuzz target on a corpus without libFuzzer
+ *
+ * Every file given on the command line, or found in a given directory, is
+ * passed once to LLVMFuzzerTestOneInput(). Besides crashes, the driver reports
+ * the throughput (exec/s) and the slowest input, so performance cliffs (e.g.
+ * quadratic parsing of crafted inputs) show up as well. The driver fails if
+ * no input was found, so an empty corpus does not pass unnoticed. With -t the
+ * driver also fails if an input takes longer than the given time.
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "fuzz_helpers.h"
+
+#define MAX_PATH_LEN	4096
+
+
+struct driver_stats {
+	unsigned long execs;		/**< number of executed inputs */
+	uint64_t total_ns;		/**< time spent in the fuzz target */
+	uint64_t worst_ns;		/**< time of the slowest input */
+	char worst_path[MAX_PATH_LEN];	/**< path of the slowest input */
+};
+
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+
+/**
+ * @brief run the fuzz target on a single file
+ *
+ * @returns 0 on success, -1 if the file can not be read
+ */
+
+static int run_file(const char *path, struct driver_stats *stats)
+{
+	FILE *fp;
+	uint8_t *buf;
+	long size;
+	uint64_t t;
+
+	fp = fopen(path, "rb");
+	if (!fp) {
+		perror(path);
+		return -1;
+	}
+	if (fseek(fp, 0, SEEK_END) || (size = ftell(fp)) < 0 ||
+	    fseek(fp, 0, SEEK_SET)) {
+		perror(path);
+		fclose(fp);
+		return -1;
+	}
+
+	/* an exactly sized buffer lets the sanitizers catch overreads */
+	buf = malloc(size ? (size_t)size : 1);
+	FUZZ_ASSERT(buf);
+	if (fread(buf, 1, (size_t)size, fp) != (size_t)size) {
+		perror(path);
+		free(buf);
+		fclose(fp);
+		return -1;
+	}
+	fclose(fp);
+
+	t = now_ns();
+	LLVMFuzzerTestOneInput(buf, (size_t)size);
+	t = now_ns() - t;
+
+	stats->execs++;
+	stats->total_ns += t;
+	if (t >= stats->worst_ns) {
+		stats->worst_ns = t;
+		snprintf(stats->worst_path, sizeof(stats->worst_path), "%s", path);
+	}
+
+	free(buf);
+	return 0;
+}
+
+
+/**
+ * @brief run the fuzz target on a file or on all files in a directory
+ *
+ * @returns 0 on success, -1 on error
+ */
+
+static int run_path(const char *path, struct driver_stats *stats)
+{
+	struct stat st;
+	DIR *dir;
+	struct dirent *de;
+	int err = 0;
+
+	if (stat(path, &st)) {
+		perror(path);
+		return -1;
+	}
+	if (!S_ISDIR(st.st_mode))
+		return run_file(path, stats);
+
+	dir = opendir(path);
+	if (!dir) {
+		perror(path);
+		return -1;
+	}
+	while ((de = readdir(dir)) != NULL) {
+		char file_path[MAX_PATH_LEN];
+
+		if (de->d_name[0] == '.')
+			continue;
+		snprintf(file_path, sizeof(file_path), "%s/%s", path, de->d_name);
+		if (stat(file_path, &st) || !S_ISREG(st.st_mode))
+			continue;
+		if (run_file(file_path, stats))
+			err = -1;
+	}
+	closedir(dir);
+
+	return err;
+}
+
+
+static void usage(const char *prog)
+{
+	fprintf(stderr, "usage: %s [-t max_ms_per_input] file_or_dir...\n", prog);
+}
+
+
+int main(int argc, char *argv[])
+{
+	struct driver_stats stats;
+	unsigned long max_ms = 0;
+	int opt, i, err = 0;
+
+	while ((opt = getopt(argc, argv, "t:h")) != -1) {
+		switch (opt) {
+		case 't':
+			max_ms = strtoul(optarg, NULL, 0);
+			break;
+		default:
+			usage(argv[0]);
+			return opt == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+	if (optind >= argc) {
+		usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	memset(&stats, 0, sizeof(stats));
+	for (i = optind; i < argc; i++) {
+		if (run_path(argv[i], &stats))
+			err = 1;
+	}
+
+	printf("%s: %lu inputs in %.3f s, %.0f exec/s\n", argv[0], stats.execs,
+	       (double)stats.total_ns / 1e9,
+	       stats.total_ns ? (double)stats.execs * 1e9 / (double)stats.total_ns : 0.);
+	if (stats.execs)
+		printf("%s: slowest input %.3f ms: %s\n", argv[0],
+		       (double)stats.worst_ns / 1e6, stats.worst_path);
+
+	if (!stats.execs) {
+		fprintf(stderr, "%s: no inputs found, is the corpus empty?\n", argv[0]);
+		err = 1;
+	}
+
+	if (max_ms && stats.worst_ns > max_ms * 1000000ULL) {
+		fprintf(stderr, "%s: input exceeds the time limit of %lu ms: %s\n",
+			argv[0], max_ms, stats.worst_path);
+		err = 1;
+	}
+
+	return err ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -22,6 +22,9 @@
 #include "../test_common/test_common.h"
 #include "../../lib/cmp_chunk.h"
 #include "../../lib/decmp.h"
+#include "../../lib/common/cmp_data_types.h"
+#include "../../lib/common/cmp_cal_up_model.h"
+#include "../../lib/icu_compress/cmp_chunk_type.h"
 #include "chunk_round_trip.h"
 
 #ifdef FUZZING_BUILD_MODE_UNSAFE_FOR_PRODUCTION
@@ -53,6 +56,116 @@ static void *TEST_malloc(size_t size)
 }
 
 
+/**
+ * @brief get the data expected from a lossy decompression of a chunk
+ *
+ * For the chunk types supporting lossy compression, the lossy_par least
+ * significant bits of every value are lost.
+ *
+ * @param chunk		pointer to the chunk to round in place
+ * @param chunk_size	byte size of the chunk
+ * @param lossy_par	lossy compression parameter
+ */
+
+static void round_chunk(uint8_t *chunk, uint32_t chunk_size, uint32_t lossy_par)
+{
+	uint32_t pos = 0;
+
+	while (pos < chunk_size) {
+		struct collection_hdr *col = (struct collection_hdr *)(chunk + pos);
+		enum chunk_type chunk_type = cmp_col_get_chunk_type(col);
+		uint32_t data_len = cmp_col_get_data_length(col);
+		uint32_t i;
+
+		pos += cmp_col_get_size(col);
+
+		if (!chunk_type_supports_lossy(chunk_type))
+			continue;
+
+		switch (convert_subservice_to_cmp_data_type(cmp_col_get_subservice(col))) {
+		case DATA_TYPE_IMAGETTE:
+		case DATA_TYPE_IMAGETTE_ADAPTIVE:
+		case DATA_TYPE_F_CAM_IMAGETTE:
+		case DATA_TYPE_F_CAM_IMAGETTE_ADAPTIVE: {
+			uint16_t *ima = (uint16_t *)col->entry;
+
+			for (i = 0; i < data_len / sizeof(*ima); i++)
+				ima[i] = (uint16_t)round_inv(round_fwd(ima[i], lossy_par), lossy_par);
+			break;
+		}
+		case DATA_TYPE_OFFSET:
+		case DATA_TYPE_F_CAM_OFFSET: {
+			struct offset *offset = (struct offset *)col->entry;
+
+			for (i = 0; i < data_len / sizeof(*offset); i++) {
+				offset[i].mean = round_inv(round_fwd(offset[i].mean, lossy_par), lossy_par);
+				offset[i].variance = round_inv(round_fwd(offset[i].variance, lossy_par), lossy_par);
+			}
+			break;
+		}
+		case DATA_TYPE_BACKGROUND:
+		case DATA_TYPE_F_CAM_BACKGROUND: {
+			struct background *bg = (struct background *)col->entry;
+
+			for (i = 0; i < data_len / sizeof(*bg); i++) {
+				bg[i].mean = round_inv(round_fwd(bg[i].mean, lossy_par), lossy_par);
+				bg[i].variance = round_inv(round_fwd(bg[i].variance, lossy_par), lossy_par);
+				bg[i].outlier_pixels = (uint16_t)round_inv(round_fwd(
+					bg[i].outlier_pixels, lossy_par), lossy_par);
+			}
+			break;
+		}
+		case DATA_TYPE_SMEARING: {
+			struct smearing *smear = (struct smearing *)col->entry;
+
+			for (i = 0; i < data_len / sizeof(*smear); i++) {
+				smear[i].mean = round_inv(round_fwd(smear[i].mean, lossy_par), lossy_par);
+				smear[i].variance_mean = round_inv(round_fwd(smear[i].variance_mean, lossy_par), lossy_par);
+				smear[i].outlier_pixels = (uint16_t)round_inv(round_fwd(
+					smear[i].outlier_pixels, lossy_par), lossy_par);
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+}
+
+
+/**
+ * @brief check the result of a lossy decompression of a chunk
+ *
+ * A collection which can not be compressed is stored uncompressed (raw
+ * fallback) and is therefore decompressed without loss; every other collection
+ * has to match the rounded data.
+ *
+ * @param chunk		pointer to the original chunk
+ * @param decmp_chunk	pointer to the decompressed chunk
+ * @param chunk_size	byte size of the chunk
+ * @param lossy_par	lossy compression parameter
+ */
+
+static void check_lossy_chunk(const uint8_t *chunk, const uint8_t *decmp_chunk,
+			      uint32_t chunk_size, uint32_t lossy_par)
+{
+	uint8_t *exp_chunk = TEST_malloc(chunk_size);
+	uint32_t pos = 0;
+
+	memcpy(exp_chunk, chunk, chunk_size);
+	round_chunk(exp_chunk, chunk_size, lossy_par);
+
+	while (pos < chunk_size) {
+		uint32_t col_size = cmp_col_get_size((const struct collection_hdr *)(chunk + pos));
+
+		TEST_ASSERT(!memcmp(exp_chunk + pos, decmp_chunk + pos, col_size) ||
+			    !memcmp(chunk + pos, decmp_chunk + pos, col_size));
+		pos += col_size;
+	}
+	free(exp_chunk);
+}
+
+
 /**
  * @brief performs chunk compression and checks if a decompression is possible
  *
@@ -149,7 +262,13 @@ uint32_t chunk_round_trip(const void *chunk, uint32_t chunk_size,
 		TEST_ASSERT((uint32_t)decmp_size == chunk_size);
 
 		if (use_decmp_buf) {
-			TEST_ASSERT(!memcmp(chunk, decmp_data, chunk_size));
+			if (cmp_par->lossy_par == CMP_LOSSLESS ||
+			    cmp_par->cmp_mode == CMP_MODE_RAW) {
+				TEST_ASSERT(!memcmp(chunk, decmp_data, chunk_size));
+			} else {
+				check_lossy_chunk(chunk, (uint8_t *)decmp_data, chunk_size,
+						  cmp_par->lossy_par);
+			}
 
 			/*
 			 * the model is only updated when the decompressed_data
@@ -0,0 +1,926 @@
+/**
+ * @file rdcu_sim.c
+ * @date 2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief in-process RDCU simulator behind the rmap_tx/rmap_rx interface
+ *
+ * The simulator acts as the RMAP target of the RDCU: rdcu_sim_tx() and
+ * rdcu_sim_rx() can be given to rdcu_rmap_init() in place of a real SpaceWire
+ * interface. The commands are decoded and executed on a model of the RDCU
+ * register map and the 8 MiB SRAM; a compression started through the
+ * compressor control register is executed with compress_like_rdcu().
+ *
+ * All timing is simulated, nothing sleeps. Every packet occupies its
+ * direction of the link for its size (10 bits per byte, as a SpaceWire data
+ * character) at the configured bit rate and arrives after the configured
+ * latency. A reply can only be received once it has arrived; every
+ * unsuccessful rdcu_sim_rx() poll advances the simulated clock by the poll
+ * time. Use rdcu_sim_get_time_us() as rdcu_rmap_set_timer() time source so
+ * that the timeouts of rdcu_wait() run on the simulated clock.
+ *
+ * @note the logical addresses and the destination key are not checked
+ * @note read-modify-write commands are answered with an "unused RMAP packet
+ *	 type or command code" error
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "../../lib/common/byteorder.h"
+#include "../../lib/common/cmp_support.h"
+#include "../../lib/common/cmp_cal_up_model.h"
+#include "../../lib/cmp_chunk.h"
+#include "../../lib/cmp_icu.h"
+#include "../../lib/cmp_rdcu.h"
+#include "../../lib/rdcu_compress/rmap.h"
+#include "../../lib/rdcu_compress/rdcu_cmd.h"
+#include "../../lib/rdcu_compress/rdcu_rmap.h"
+#include "rdcu_sim.h"
+
+
+#define RDCU_SIM_BITS_PER_BYTE	10	/* SpW data character: parity, flag, 8 bit */
+
+/* compressor control register bits */
+#define RDCU_SIM_CMP_START	(1UL << 0)
+#define RDCU_SIM_CMP_INTERRUPT	(1UL << 1)
+#define RDCU_SIM_RDCU_INT_EN	(1UL << 8)
+
+/* compressor status register bits */
+#define RDCU_SIM_STAT_ACTIVE	(1UL << 0)
+#define RDCU_SIM_STAT_INTERRUPTED (1UL << 1)
+#define RDCU_SIM_STAT_READY	(1UL << 4)
+#define RDCU_SIM_STAT_VALID	(1UL << 5)
+#define RDCU_SIM_STAT_INT_EN	(1UL << 8)
+
+/* RDCU reset register bits */
+#define RDCU_SIM_BOARD_RESET	(1UL << 1)
+
+#define RDCU_SIM_NUM_REGS(first, last)	(((last) - (first)) / 4 + 1)
+
+
+/* a reply packet on its way to the ICU */
+struct rdcu_sim_pkt {
+	struct rdcu_sim_pkt *next;
+	uint64_t due_ns;	/* arrival time at the ICU */
+	uint32_t size;
+	uint8_t data[];
+};
+
+
+static struct {
+	uint8_t *sram;
+
+	uint32_t ctrl_regs[RDCU_SIM_NUM_REGS(FPGA_VERSION, COMPR_CTRL)];
+	uint32_t compr_regs[RDCU_SIM_NUM_REGS(COMPR_PARAM_1, USED_NUMBER_OF_SAMPLES)];
+	uint32_t edac_regs[RDCU_SIM_NUM_REGS(SRAM_EDAC_CTRL, SRAM_EDAC_STATUS)];
+
+	/* link and compressor timing */
+	uint64_t now_ns;
+	uint64_t uplink_free_ns;
+	uint64_t downlink_free_ns;
+	uint64_t latency_ns;
+	uint32_t bit_rate;
+	uint32_t cmp_rate;
+	uint64_t poll_ns;
+	uint32_t corrupt_replies;
+
+	/* state of the data compressor */
+	uint32_t cmp_status;
+	uint64_t cmp_start_ns;
+	uint64_t cmp_done_ns;
+	struct rdcu_cfg rcfg;
+	struct cmp_info info;
+	uint32_t *cmp_out;
+	uint16_t *cmp_model;
+
+	struct rdcu_sim_pkt *rx_head;
+	struct rdcu_sim_pkt *rx_tail;
+
+	struct rdcu_sim_stats stats;
+} sim;
+
+
+/**
+ * @brief get the model of a register
+ *
+ * @param addr	the register address
+ *
+ * @returns a pointer to the register value, NULL if there is no register
+ */
+
+static uint32_t *rdcu_sim_reg(uint32_t addr)
+{
+	if (addr & 0x3)
+		return NULL;
+
+	if (addr >= FPGA_VERSION && addr <= COMPR_CTRL)
+		return &sim.ctrl_regs[(addr - FPGA_VERSION) / 4];
+
+	if (addr >= COMPR_PARAM_1 && addr <= USED_NUMBER_OF_SAMPLES)
+		return &sim.compr_regs[(addr - COMPR_PARAM_1) / 4];
+
+	if (addr >= SRAM_EDAC_CTRL && addr <= SRAM_EDAC_STATUS)
+		return &sim.edac_regs[(addr - SRAM_EDAC_CTRL) / 4];
+
+	return NULL;
+}
+
+
+/**
+ * @brief check if an SRAM area is in the RDCU SRAM
+ */
+
+static int rdcu_sim_in_sram(uint32_t addr, uint32_t size)
+{
+	if (addr > RDCU_SRAM_END)
+		return 0;
+
+	return size <= RDCU_SRAM_SIZE - addr;
+}
+
+
+/**
+ * @brief set the RDCU registers to their reset values
+ */
+
+static void rdcu_sim_reset_regs(void)
+{
+	memset(sim.ctrl_regs, 0, sizeof(sim.ctrl_regs));
+	memset(sim.compr_regs, 0, sizeof(sim.compr_regs));
+	memset(sim.edac_regs, 0, sizeof(sim.edac_regs));
+
+	*rdcu_sim_reg(FPGA_VERSION) = RDCU_SIM_FPGA_VERSION;
+
+	free(sim.cmp_out);
+	free(sim.cmp_model);
+	sim.cmp_out = NULL;
+	sim.cmp_model = NULL;
+	sim.cmp_status = RDCU_SIM_STAT_READY;
+}
+
+
+/**
+ * @brief put a packet on a link direction
+ *
+ * @param link_free_ns	time when the link direction is free again
+ * @param start_ns	earliest time to send the packet
+ * @param size		size of the packet in bytes
+ *
+ * @returns the arrival time of the packet
+ */
+
+static uint64_t rdcu_sim_link(uint64_t *link_free_ns, uint64_t start_ns,
+			      uint32_t size)
+{
+	if (start_ns < *link_free_ns)
+		start_ns = *link_free_ns;
+
+	*link_free_ns = start_ns;
+	if (sim.bit_rate)
+		*link_free_ns += (uint64_t)size * RDCU_SIM_BITS_PER_BYTE *
+			1000000000ULL / sim.bit_rate;
+
+	return *link_free_ns + sim.latency_ns;
+}
+
+
+/**
+ * @brief write the results of a finished compression to the SRAM and the
+ *	  compressor information registers
+ */
+
+static void rdcu_sim_cmp_finish(void)
+{
+	const struct rdcu_cfg *rcfg = &sim.rcfg;
+	const struct cmp_info *info = &sim.info;
+
+	if (sim.cmp_out) {
+		uint32_t size = ((info->cmp_size + 31) / 32) * 4;
+		uint32_t buf_size = ((rcfg->buffer_length * sizeof(uint16_t)) + 3) & ~3U;
+
+		if (size > buf_size)
+			size = buf_size;
+		memcpy(&sim.sram[rcfg->rdcu_buffer_adr], sim.cmp_out, size);
+	}
+
+	if (sim.cmp_model) {
+		uint32_t i;
+
+		for (i = 0; i < rcfg->samples; i++) {
+			uint16_t v = cpu_to_be16(sim.cmp_model[i]);
+
+			memcpy(&sim.sram[rcfg->rdcu_new_model_adr + i * sizeof(v)],
+			       &v, sizeof(v));
+		}
+	}
+
+	*rdcu_sim_reg(USED_COMPR_PARAM_1) = info->cmp_mode_used |
+		((uint32_t)info->model_value_used << 8) |
+		((uint32_t)info->round_used << 16);
+	*rdcu_sim_reg(USED_COMPR_PARAM_2) = info->golomb_par_used |
+		(info->spill_used << 8);
+	*rdcu_sim_reg(COMPR_DATA_START_ADDR) = info->rdcu_cmp_adr_used;
+	*rdcu_sim_reg(COMPR_DATA_SIZE) = info->cmp_size;
+	*rdcu_sim_reg(COMPR_DATA_ADAPTIVE_1_SIZE) = info->ap1_cmp_size;
+	*rdcu_sim_reg(COMPR_DATA_ADAPTIVE_2_SIZE) = info->ap2_cmp_size;
+	*rdcu_sim_reg(COMPR_ERROR) = info->cmp_err;
+	*rdcu_sim_reg(USED_UPDATED_MODEL_START_ADDR) = info->rdcu_new_model_adr_used;
+	*rdcu_sim_reg(USED_NUMBER_OF_SAMPLES) = info->samples_used;
+
+	free(sim.cmp_out);
+	free(sim.cmp_model);
+	sim.cmp_out = NULL;
+	sim.cmp_model = NULL;
+
+	sim.stats.cmp_busy_us += (sim.cmp_done_ns - sim.cmp_start_ns) / 1000;
+
+	sim.cmp_status = RDCU_SIM_STAT_READY;
+	if (!info->cmp_err)
+		sim.cmp_status |= RDCU_SIM_STAT_VALID;
+}
+
+
+/**
+ * @brief advance the state of the data compressor to a given time
+ */
+
+static void rdcu_sim_update(uint64_t t_ns)
+{
+	if ((sim.cmp_status & RDCU_SIM_STAT_ACTIVE) && t_ns >= sim.cmp_done_ns)
+		rdcu_sim_cmp_finish();
+}
+
+
+/**
+ * @brief read a big-endian 16-bit array from the SRAM
+ *
+ * @returns a host order copy or NULL on error
+ */
+
+static uint16_t *rdcu_sim_sram_to_host(uint32_t addr, uint32_t samples)
+{
+	uint32_t i;
+	uint16_t *buf = malloc(samples * sizeof(*buf) + 1);
+
+	if (!buf)
+		return NULL;
+
+	for (i = 0; i < samples; i++) {
+		memcpy(&buf[i], &sim.sram[addr + i * sizeof(*buf)], sizeof(*buf));
+		be16_to_cpus(&buf[i]);
+	}
+
+	return buf;
+}
+
+
+/**
+ * @brief start a compression with the parameters in the compressor registers
+ *
+ * @param t_ns	time of the start command
+ *
+ * @note the compression is executed immediately, the results become visible
+ *	 when the simulated compression time has elapsed
+ */
+
+static void rdcu_sim_cmp_start(uint64_t t_ns)
+{
+	struct rdcu_cfg *rcfg = &sim.rcfg;
+	uint16_t *data = NULL;
+	uint16_t *model = NULL;
+	uint32_t size, cmp_size;
+	uint32_t p1 = *rdcu_sim_reg(COMPR_PARAM_1);
+	uint32_t p2 = *rdcu_sim_reg(COMPR_PARAM_2);
+	uint32_t ap1 = *rdcu_sim_reg(ADAPTIVE_PARAM_1);
+	uint32_t ap2 = *rdcu_sim_reg(ADAPTIVE_PARAM_2);
+
+	if (sim.cmp_status & RDCU_SIM_STAT_ACTIVE)
+		return;
+
+	memset(rcfg, 0, sizeof(*rcfg));
+	rcfg->cmp_mode = (enum cmp_mode)(p1 & 0xFFUL);
+	rcfg->model_value = (p1 >> 8) & 0x1FUL;
+	rcfg->round = (p1 >> 16) & 0x3UL;
+	rcfg->golomb_par = p2 & 0x3FUL;
+	rcfg->spill = (p2 >> 8) & 0x3FFUL;
+	rcfg->ap1_golomb_par = ap1 & 0x3FUL;
+	rcfg->ap1_spill = (ap1 >> 8) & 0x3FFUL;
+	rcfg->ap2_golomb_par = ap2 & 0x3FUL;
+	rcfg->ap2_spill = (ap2 >> 8) & 0x3FFUL;
+	rcfg->rdcu_data_adr = *rdcu_sim_reg(DATA_START_ADDR) & 0x00FFFFFFUL;
+	rcfg->rdcu_model_adr = *rdcu_sim_reg(MODEL_START_ADDR) & 0x00FFFFFFUL;
+	rcfg->samples = *rdcu_sim_reg(NUM_SAMPLES) & 0x00FFFFFFUL;
+	rcfg->rdcu_new_model_adr = *rdcu_sim_reg(UPDATED_MODEL_START_ADDR) & 0x00FFFFFFUL;
+	rcfg->rdcu_buffer_adr = *rdcu_sim_reg(COMPR_DATA_BUF_START_ADDR) & 0x00FFFFFFUL;
+	rcfg->buffer_length = *rdcu_sim_reg(COMPR_DATA_BUF_LEN) & 0x00FFFFFFUL;
+
+	size = rcfg->samples * sizeof(uint16_t);
+
+	sim.stats.compressions++;
+	sim.cmp_start_ns = t_ns;
+	sim.cmp_done_ns = t_ns;
+	if (sim.cmp_rate)
+		sim.cmp_done_ns += (uint64_t)rcfg->samples * 1000000000ULL / sim.cmp_rate;
+	sim.cmp_status = RDCU_SIM_STAT_ACTIVE;
+
+	if (!rdcu_sim_in_sram(rcfg->rdcu_data_adr, size) ||
+	    !rdcu_sim_in_sram(rcfg->rdcu_buffer_adr, rcfg->buffer_length * sizeof(uint16_t)) ||
+	    (model_mode_is_used(rcfg->cmp_mode) &&
+	     (!rdcu_sim_in_sram(rcfg->rdcu_model_adr, size) ||
+	      !rdcu_sim_in_sram(rcfg->rdcu_new_model_adr, size)))) {
+		memset(&sim.info, 0, sizeof(sim.info));
+		sim.info.cmp_err = 1U << INVALID_ADDRESS_ERR_BIT;
+		rdcu_sim_update(t_ns);
+		return;
+	}
+
+	data = rdcu_sim_sram_to_host(rcfg->rdcu_data_adr, rcfg->samples);
+	sim.cmp_out = calloc(1, ((rcfg->buffer_length * sizeof(uint16_t)) + 3) & ~3U);
+	if (model_mode_is_used(rcfg->cmp_mode)) {
+		model = rdcu_sim_sram_to_host(rcfg->rdcu_model_adr, rcfg->samples);
+		sim.cmp_model = calloc(1, size + 1);
+	}
+
+	rcfg->input_buf = data;
+	rcfg->model_buf = model;
+	rcfg->icu_output_buf = sim.cmp_out;
+	rcfg->icu_new_model_buf = sim.cmp_model;
+
+	cmp_size = compress_like_rdcu(rcfg, &sim.info);
+	if (cmp_is_error(cmp_size) &&
+	    cmp_get_error_code(cmp_size) != CMP_ERROR_SMALL_BUFFER) {
+		if (!cmp_mode_is_supported(rcfg->cmp_mode) ||
+		    adaptive_mode_is_used(rcfg->cmp_mode))
+			sim.info.cmp_err |= 1U << CMP_MODE_ERR_BIT;
+		else if (rcfg->model_value > MAX_MODEL_VALUE)
+			sim.info.cmp_err |= 1U << MODEL_VALUE_ERR_BIT;
+		else
+			sim.info.cmp_err |= 1U << CMP_PAR_ERR_BIT;
+	}
+
+	rcfg->input_buf = NULL;
+	rcfg->model_buf = NULL;
+	rcfg->icu_output_buf = NULL;
+	rcfg->icu_new_model_buf = NULL;
+	free(data);
+	free(model);
+
+	if (sim.info.cmp_err) {
+		free(sim.cmp_out);
+		free(sim.cmp_model);
+		sim.cmp_out = NULL;
+		sim.cmp_model = NULL;
+	}
+
+	rdcu_sim_update(t_ns);
+}
+
+
+/**
+ * @brief abort a running compression
+ */
+
+static void rdcu_sim_cmp_interrupt(void)
+{
+	if (!(sim.cmp_status & RDCU_SIM_STAT_ACTIVE))
+		return;
+
+	free(sim.cmp_out);
+	free(sim.cmp_model);
+	sim.cmp_out = NULL;
+	sim.cmp_model = NULL;
+
+	sim.cmp_status = RDCU_SIM_STAT_READY | RDCU_SIM_STAT_INTERRUPTED;
+}
+
+
+/**
+ * @brief read a register
+ *
+ * @returns an RMAP status code
+ */
+
+static uint8_t rdcu_sim_read_reg(uint32_t addr, uint32_t *val)
+{
+	uint32_t *reg = rdcu_sim_reg(addr);
+
+	if (!reg)
+		return RMAP_STATUS_GENERAL_ERROR;
+
+	/* the information registers are blocked during a compression */
+	if (addr >= USED_COMPR_PARAM_1 && addr <= USED_NUMBER_OF_SAMPLES &&
+	    (sim.cmp_status & RDCU_SIM_STAT_ACTIVE))
+		return RMAP_STATUS_GENERAL_ERROR;
+
+	if (addr == COMPR_STATUS) {
+		*val = sim.cmp_status;
+		if (*rdcu_sim_reg(COMPR_CTRL) & RDCU_SIM_RDCU_INT_EN)
+			*val |= RDCU_SIM_STAT_INT_EN;
+		return RMAP_STATUS_SUCCESS;
+	}
+
+	*val = *reg;
+
+	return RMAP_STATUS_SUCCESS;
+}
+
+
+/**
+ * @brief write a register
+ *
+ * @returns an RMAP status code
+ */
+
+static uint8_t rdcu_sim_write_reg(uint32_t addr, uint32_t val, uint64_t t_ns)
+{
+	uint32_t *reg = rdcu_sim_reg(addr);
+
+	if (!reg)
+		return RMAP_STATUS_GENERAL_ERROR;
+
+	/* the status and information registers are read only */
+	if ((addr >= FPGA_VERSION && addr <= COMPR_STATUS) ||
+	    (addr >= USED_COMPR_PARAM_1 && addr <= USED_NUMBER_OF_SAMPLES) ||
+	    addr == SRAM_EDAC_STATUS)
+		return RMAP_STATUS_CMD_NOT_IMPL_OR_AUTH;
+
+	/* the compressor registers are blocked during a compression */
+	if (addr >= COMPR_PARAM_1 && addr <= COMPR_DATA_BUF_LEN &&
+	    (sim.cmp_status & RDCU_SIM_STAT_ACTIVE))
+		return RMAP_STATUS_GENERAL_ERROR;
+
+	*reg = val;
+
+	switch (addr) {
+	case COMPR_CTRL:
+		if (val & RDCU_SIM_CMP_INTERRUPT)
+			rdcu_sim_cmp_interrupt();
+		else if (val & RDCU_SIM_CMP_START)
+			rdcu_sim_cmp_start(t_ns);
+		break;
+	case RDCU_RESET:
+		if (val & RDCU_SIM_BOARD_RESET)
+			rdcu_sim_reset_regs();
+		break;
+	default:
+		break;
+	}
+
+	return RMAP_STATUS_SUCCESS;
+}
+
+
+/**
+ * @brief execute the data access of an RMAP command
+ *
+ * @param addr	the (first) address
+ * @param buf	the big-endian data to write or the buffer to read to
+ * @param len	the data length in bytes
+ * @param inc	0: all data accesses the same address
+ * @param write	0: read, otherwise write
+ * @param t_ns	the execution time of the command
+ *
+ * @returns an RMAP status code
+ */
+
+static uint8_t rdcu_sim_access(uint32_t addr, uint8_t *buf, uint32_t len,
+			       int inc, int write, uint64_t t_ns)
+{
+	uint32_t i;
+	uint8_t status;
+
+	if ((addr & 0x3) || (len & 0x3))
+		return RMAP_STATUS_GENERAL_ERROR;
+
+	rdcu_sim_update(t_ns);
+
+	if (rdcu_sim_in_sram(addr, inc ? len : 4)) {
+		for (i = 0; i < len; i += 4) {
+			uint8_t *p = &sim.sram[inc ? addr + i : addr];
+
+			if (write)
+				memcpy(p, &buf[i], 4);
+			else
+				memcpy(&buf[i], p, 4);
+		}
+		return RMAP_STATUS_SUCCESS;
+	}
+
+	for (i = 0; i < len; i += 4) {
+		uint32_t a = inc ? addr + i : addr;
+		uint32_t val;
+
+		if (write) {
+			memcpy(&val, &buf[i], sizeof(val));
+			status = rdcu_sim_write_reg(a, be32_to_cpu(val), t_ns);
+		} else {
+			status = rdcu_sim_read_reg(a, &val);
+			val = cpu_to_be32(val);
+			memcpy(&buf[i], &val, sizeof(val));
+		}
+		if (status != RMAP_STATUS_SUCCESS)
+			return status;
+	}
+
+	return RMAP_STATUS_SUCCESS;
+}
+
+
+/**
+ * @brief queue a reply packet for the ICU
+ *
+ * @param cmd		the header of the command (starting at the target
+ *			logical address)
+ * @param rpath_len	the length of the reply address field of the command
+ * @param status	the RMAP status of the reply
+ * @param data		the data of a read reply (NULL for a write reply)
+ * @param data_len	the length of the data
+ * @param t_ns		the time the reply is sent
+ */
+
+static void rdcu_sim_reply(const uint8_t *cmd, uint32_t rpath_len,
+			   uint8_t status, const uint8_t *data,
+			   uint32_t data_len, uint64_t t_ns)
+{
+	struct rmap_instruction ri;
+	struct rdcu_sim_pkt *pkt;
+	uint32_t n = 0;
+	uint32_t size;
+
+	memcpy(&ri, &cmd[RMAP_INSTRUCTION], sizeof(ri));
+	ri.cmd_resp = 0;
+
+	size = RMAP_HDR_MIN_SIZE_WRITE_REP + 1;
+	if (!(ri.cmd & RMAP_CMD_BIT_WRITE))
+		size = RMAP_HDR_MIN_SIZE_READ_REP + 1 + data_len + 1;
+
+	pkt = malloc(sizeof(*pkt) + size);
+	if (!pkt)
+		return;
+
+	pkt->data[n++] = cmd[RMAP_SRC_ADDR + rpath_len];	/* initiator */
+	pkt->data[n++] = RMAP_PROTOCOL_ID;
+	memcpy(&pkt->data[n++], &ri, sizeof(ri));
+	pkt->data[n++] = status;
+	pkt->data[n++] = cmd[RMAP_DEST_ADDRESS];		/* target */
+	pkt->data[n++] = cmd[RMAP_TRANS_ID_BYTE0 + rpath_len];
+	pkt->data[n++] = cmd[RMAP_TRANS_ID_BYTE1 + rpath_len];
+
+	if (!(ri.cmd & RMAP_CMD_BIT_WRITE)) {
+		pkt->data[n++] = 0x0;	/* reserved */
+		pkt->data[n++] = (uint8_t)(data_len >> 16);
+		pkt->data[n++] = (uint8_t)(data_len >> 8);
+		pkt->data[n++] = (uint8_t)data_len;
+	}
+
+	pkt->data[n] = rmap_crc8(pkt->data, n);
+	n++;
+
+	if (!(ri.cmd & RMAP_CMD_BIT_WRITE)) {
+		if (data_len)
+			memcpy(&pkt->data[n], data, data_len);
+		pkt->data[n + data_len] = rmap_crc8(&pkt->data[n], data_len);
+
+		/* a bit error on the link after the CRC was calculated */
+		if (data_len && sim.corrupt_replies) {
+			pkt->data[n] ^= 0x1;
+			sim.corrupt_replies--;
+		}
+	}
+
+	pkt->size = size;
+	pkt->next = NULL;
+	pkt->due_ns = rdcu_sim_link(&sim.downlink_free_ns, t_ns, size);
+
+	if (sim.rx_tail)
+		sim.rx_tail->next = pkt;
+	else
+		sim.rx_head = pkt;
+	sim.rx_tail = pkt;
+
+	sim.stats.reply_pkts++;
+	sim.stats.reply_bytes += size;
+}
+
+
+/**
+ * @brief execute an RMAP command received by the RDCU
+ *
+ * @param cmd	the command packet (starting at the target logical address)
+ * @param len	the length of the packet
+ * @param t_ns	the arrival time of the packet
+ */
+
+static void rdcu_sim_exec(const uint8_t *cmd, uint32_t len, uint64_t t_ns)
+{
+	struct rmap_instruction ri;
+	uint32_t rpath_len, hdr_len, addr, data_len;
+	uint8_t status = RMAP_STATUS_SUCCESS;
+	uint8_t *buf = NULL;
+	int inc;
+
+	if (len < RMAP_HDR_MIN_SIZE_WRITE_CMD + 1 ||
+	    cmd[RMAP_PROTOCOL_ID] != RMAP_PROTOCOL_ID) {
+		sim.stats.rmap_errors++;
+		return;
+	}
+
+	memcpy(&ri, &cmd[RMAP_INSTRUCTION], sizeof(ri));
+	rpath_len = (uint32_t)ri.reply_addr_len * 4;
+	hdr_len = RMAP_HDR_MIN_SIZE_WRITE_CMD + rpath_len;
+
+	/* a command with a corrupted header is discarded without a reply */
+	if (!ri.cmd_resp || len < hdr_len + 1 ||
+	    rmap_crc8(cmd, hdr_len) != cmd[hdr_len]) {
+		sim.stats.rmap_errors++;
+		return;
+	}
+
+	addr = ((uint32_t)cmd[RMAP_ADDR_BYTE0 + rpath_len] << 24) |
+	       ((uint32_t)cmd[RMAP_ADDR_BYTE1 + rpath_len] << 16) |
+	       ((uint32_t)cmd[RMAP_ADDR_BYTE2 + rpath_len] <<  8) |
+		(uint32_t)cmd[RMAP_ADDR_BYTE3 + rpath_len];
+	data_len = ((uint32_t)cmd[RMAP_DATALEN_BYTE0 + rpath_len + 4] << 16) |
+		   ((uint32_t)cmd[RMAP_DATALEN_BYTE1 + rpath_len + 4] <<  8) |
+		    (uint32_t)cmd[RMAP_DATALEN_BYTE2 + rpath_len + 4];
+	inc = ri.cmd & RMAP_CMD_BIT_INC;
+
+	switch (ri.cmd) {
+	case RMAP_READ_ADDR_SINGLE:
+	case RMAP_READ_ADDR_INC:
+		buf = malloc(data_len + 1);
+		if (!buf)
+			return;
+		status = rdcu_sim_access(addr, buf, data_len, inc, 0, t_ns);
+		if (status != RMAP_STATUS_SUCCESS)
+			data_len = 0;
+		rdcu_sim_reply(cmd, rpath_len, status, buf, data_len, t_ns);
+		free(buf);
+		break;
+	case RMAP_WRITE_ADDR_SINGLE:
+	case RMAP_WRITE_ADDR_INC:
+	case RMAP_WRITE_ADDR_SINGLE_REPLY:
+	case RMAP_WRITE_ADDR_INC_REPLY:
+	case RMAP_WRITE_ADDR_SINGLE_VERIFY:
+	case RMAP_WRITE_ADDR_INC_VERIFY:
+	case RMAP_WRITE_ADDR_SINGLE_VERIFY_REPLY:
+	case RMAP_WRITE_ADDR_INC_VERIFY_REPLY:
+		if (len < hdr_len + 1 + data_len + 1)
+			status = RMAP_STATUS_EARLY_EOP;
+		else if (len > hdr_len + 1 + data_len + 1)
+			status = RMAP_STATUS_TOO_MUCH_DATA;
+		else if (rmap_crc8(&cmd[hdr_len + 1], data_len) !=
+			 cmd[hdr_len + 1 + data_len])
+			status = RMAP_STATUS_INVALID_DATA_CRC;
+		else {
+			buf = malloc(data_len + 1);
+			if (!buf)
+				return;
+			memcpy(buf, &cmd[hdr_len + 1], data_len);
+			status = rdcu_sim_access(addr, buf, data_len, inc, 1, t_ns);
+			free(buf);
+		}
+		if (ri.cmd & RMAP_CMD_BIT_REPLY)
+			rdcu_sim_reply(cmd, rpath_len, status, NULL, 0, t_ns);
+		break;
+	default:
+		status = RMAP_STATUS_UNUSED_TYPE_OR_CODE;
+		rdcu_sim_reply(cmd, rpath_len, status, NULL, 0, t_ns);
+		break;
+	}
+
+	if (status != RMAP_STATUS_SUCCESS)
+		sim.stats.rmap_errors++;
+}
+
+
+/**
+ * @brief transmit an RMAP command to the simulated RDCU
+ *
+ * @note the signature matches the tx function of rdcu_rmap_init()
+ *
+ * @returns 0 on success, otherwise error
+ */
+
+int32_t rdcu_sim_tx(const void *hdr, uint32_t hdr_size,
+		    const uint8_t non_crc_bytes,
+		    const void *data, uint32_t data_size)
+{
+	uint8_t *blob;
+	uint32_t n;
+	uint64_t arrival_ns;
+
+	if (!sim.sram || !hdr || hdr_size <= non_crc_bytes)
+		return -1;
+
+	n = rdcu_package(NULL, hdr, hdr_size, non_crc_bytes, data, data_size);
+	if (!n)
+		return -1;
+
+	blob = malloc(n);
+	if (!blob)
+		return -1;
+
+	n = rdcu_package(blob, hdr, hdr_size, non_crc_bytes, data, data_size);
+
+	/* the path bytes are consumed by the routers on the way to the RDCU */
+	n -= non_crc_bytes;
+
+	sim.stats.cmd_pkts++;
+	sim.stats.cmd_bytes += n;
+
+	arrival_ns = rdcu_sim_link(&sim.uplink_free_ns, sim.now_ns, n);
+	rdcu_sim_exec(&blob[non_crc_bytes], n, arrival_ns);
+
+	free(blob);
+
+	return 0;
+}
+
+
+/**
+ * @brief receive an RMAP reply from the simulated RDCU
+ *
+ * @param pkt	the buffer to store the packet in; if NULL, the size of the
+ *		next packet is returned
+ *
+ * @note the signature matches the rx function of rdcu_rmap_init()
+ *
+ * @returns the size of the packet, 0 if no packet has arrived yet
+ */
+
+uint32_t rdcu_sim_rx(uint8_t *pkt)
+{
+	struct rdcu_sim_pkt *p = sim.rx_head;
+	uint32_t size;
+
+	if (!p)
+		return 0;
+
+	if (p->due_ns > sim.now_ns) {
+		/* nothing to receive, the poll takes its time */
+		if (!sim.poll_ns || sim.now_ns + sim.poll_ns > p->due_ns)
+			sim.now_ns = p->due_ns;
+		else
+			sim.now_ns += sim.poll_ns;
+		return 0;
+	}
+
+	size = p->size;
+	if (!pkt)
+		return size;
+
+	memcpy(pkt, p->data, size);
+
+	sim.rx_head = p->next;
+	if (!sim.rx_head)
+		sim.rx_tail = NULL;
+	free(p);
+
+	return size;
+}
+
+
+/**
+ * @brief set the simulated link characteristics
+ *
+ * @param latency_us	one-way latency of a packet in microseconds
+ * @param bit_rate	link bit rate in bit/s (0: unlimited)
+ */
+
+void rdcu_sim_set_link(uint32_t latency_us, uint32_t bit_rate)
+{
+	sim.latency_ns = (uint64_t)latency_us * 1000;
+	sim.bit_rate = bit_rate;
+}
+
+
+/**
+ * @brief set the simulated data compressor throughput
+ *
+ * @param samples_per_sec	compressed samples per second (0: compression
+ *				takes no time)
+ */
+
+void rdcu_sim_set_cmp_rate(uint32_t samples_per_sec)
+{
+	sim.cmp_rate = samples_per_sec;
+}
+
+
+/**
+ * @brief set the time a rdcu_sim_rx() poll without a received packet takes
+ *
+ * @param poll_us	poll time in microseconds; 0: the clock jumps directly
+ *			to the arrival of the next reply
+ */
+
+void rdcu_sim_set_poll_time(uint32_t poll_us)
+{
+	sim.poll_ns = (uint64_t)poll_us * 1000;
+}
+
+
+/**
+ * @brief corrupt the data of the next read replies
+ *
+ * @param num_replies	number of read replies with a flipped data bit and
+ *			therefore a wrong data CRC
+ */
+
+void rdcu_sim_corrupt_replies(uint32_t num_replies)
+{
+	sim.corrupt_replies = num_replies;
+}
+
+
+/**
+ * @brief get the simulated time
+ *
+ * @note can be used as time source for rdcu_rmap_set_timer()
+ *
+ * @returns the simulated time since rdcu_sim_init() in microseconds
+ */
+
+uint64_t rdcu_sim_get_time_us(void)
+{
+	return sim.now_ns / 1000;
+}
+
+
+/**
+ * @brief get the statistics of the simulator
+ *
+ * @param stats	the structure to store the statistics
+ */
+
+void rdcu_sim_get_stats(struct rdcu_sim_stats *stats)
+{
+	if (stats)
+		*stats = sim.stats;
+}
+
+
+/**
+ * @brief get the simulated RDCU SRAM
+ *
+ * @returns a pointer to the RDCU_SRAM_SIZE bytes of the SRAM
+ */
+
+uint8_t *rdcu_sim_get_sram(void)
+{
+	return sim.sram;
+}
+
+
+/**
+ * @brief release all resources of the simulator
+ */
+
+void rdcu_sim_exit(void)
+{
+	while (sim.rx_head) {
+		struct rdcu_sim_pkt *p = sim.rx_head;
+
+		sim.rx_head = p->next;
+		free(p);
+	}
+
+	free(sim.cmp_out);
+	free(sim.cmp_model);
+	free(sim.sram);
+
+	memset(&sim, 0, sizeof(sim));
+}
+
+
+/**
+ * @brief initialise the simulator to a powered up RDCU with an unlimited link
+ *
+ * @returns 0 on success, otherwise error
+ */
+
+int rdcu_sim_init(void)
+{
+	rdcu_sim_exit();
+
+	sim.sram = calloc(1, RDCU_SRAM_SIZE);
+	if (!sim.sram)
+		return -1;
+
+	rdcu_sim_reset_regs();
+	rdcu_sim_set_poll_time(1);
+
+	return 0;
+}
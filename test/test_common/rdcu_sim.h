@@ -0,0 +1,60 @@
+/**
+ * @file rdcu_sim.h
+ * @date 2024
+ *
+ * @copyright GPLv2
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms and conditions of the GNU General Public License,
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * @brief in-process RDCU simulator behind the rmap_tx/rmap_rx interface
+ */
+
+#ifndef RDCU_SIM_H
+#define RDCU_SIM_H
+
+#include <stdint.h>
+
+
+#define RDCU_SIM_FPGA_VERSION	0x0101UL	/* FPGA version of the simulated RDCU */
+
+
+/**
+ * @brief statistics of the simulated SpaceWire link and RDCU
+ */
+
+struct rdcu_sim_stats {
+	uint64_t cmd_pkts;	/**< number of received RMAP commands */
+	uint64_t cmd_bytes;	/**< bytes received on the link to the RDCU */
+	uint64_t reply_pkts;	/**< number of sent RMAP replies */
+	uint64_t reply_bytes;	/**< bytes sent on the link to the ICU */
+	uint64_t rmap_errors;	/**< commands rejected or dropped by the target */
+	uint64_t compressions;	/**< number of started compressions */
+	uint64_t cmp_busy_us;	/**< time the compressor was active */
+};
+
+
+int rdcu_sim_init(void);
+void rdcu_sim_exit(void);
+
+int32_t rdcu_sim_tx(const void *hdr, uint32_t hdr_size,
+		    const uint8_t non_crc_bytes,
+		    const void *data, uint32_t data_size);
+uint32_t rdcu_sim_rx(uint8_t *pkt);
+
+void rdcu_sim_set_link(uint32_t latency_us, uint32_t bit_rate);
+void rdcu_sim_set_cmp_rate(uint32_t samples_per_sec);
+void rdcu_sim_set_poll_time(uint32_t poll_us);
+void rdcu_sim_corrupt_replies(uint32_t num_replies);
+
+uint64_t rdcu_sim_get_time_us(void);
+void rdcu_sim_get_stats(struct rdcu_sim_stats *stats);
+
+uint8_t *rdcu_sim_get_sram(void);
+
+#endif /* RDCU_SIM_H */
@@ -302,7 +302,7 @@ static void check_compressed_data(const uint16_t *data_to_compress, uint16_t *mo
 				printf("Error occurred by reading in the updated model from the RDCU\n");
 				assert(0);
 			}
-			/* check if updated model are check up */
+			/* both models are in host byte order */
 			for (i = 0; i < info.samples_used; i++)
 				assert(updated_model_exp[i] == updated_model[i]);
 		}